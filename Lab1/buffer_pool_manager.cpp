@@ -35,7 +35,7 @@ bool BufferPoolManager::find_victim_page(frame_id_t* frame_id) {
 void BufferPoolManager::update_page(Page *page, PageId new_page_id, frame_id_t new_frame_id) {
     // 如果页为脏，将其数据写回磁盘，然后把脏标志设置为false
     if (page->is_dirty()) {
-        disk_manager_->write_page(page->get_page_id().fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
+        write_page_back(page);
         page->is_dirty_ = false;
     }
     page->pin_count_ = 0;
@@ -141,7 +141,7 @@ bool BufferPoolManager::flush_page(PageId page_id) {
     Page& page = pages_[frame_id];
 
     // 将页数据写回磁盘，并更新脏状态
-    disk_manager_->write_page(page_id.fd, page_id.page_no, page.get_data(), PAGE_SIZE);
+    write_page_back(&page);
     page.is_dirty_ = false;
     return true;
 }
@@ -198,7 +198,7 @@ bool BufferPoolManager::delete_page(PageId page_id) {
     }
 
     // 将目标页数据写回磁盘，重置页元数据，并移除页表中的记录
-    disk_manager_->write_page(page->get_page_id().fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
+    write_page_back(page);
     page_table_.erase(page_id);
     page->reset_memory();
     page->is_dirty_ = false;
@@ -219,7 +219,7 @@ void BufferPoolManager::flush_all_pages(int fd) {
     for (size_t i = 0; i < pool_size_; i++) {
         page = pages_ + i;
         if ((page->get_page_id().fd == fd) && (page->get_page_id().page_no != INVALID_PAGE_ID)) {
-            disk_manager_->write_page(fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
+            write_page_back(page);
             page->is_dirty_ = false;
         }
     }
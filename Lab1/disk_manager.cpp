@@ -31,13 +31,12 @@ DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<
  */
 void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
     // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用write()函数
+    // 1.pin_file()获得系统文件句柄，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
+    // 2.调用pwrite()函数，写完后unpin_file()
     // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager::write_page Error");
-    if (lseek(fd, page_no * PAGE_SIZE, SEEK_SET) == -1) {
-        throw UnixError();
-    }
-    ssize_t bytes_written = write(fd, offset, num_bytes);
+    int os_fd = pin_file(fd);
+    ssize_t bytes_written = pwrite(os_fd, offset, num_bytes, (off_t)page_no * PAGE_SIZE);
+    unpin_file(fd);
     if (bytes_written != num_bytes) {
         throw InternalError("DiskManager::write_page Error");
     }
@@ -52,13 +51,12 @@ void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int
  */
 void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
     // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用read()函数
+    // 1.pin_file()获得系统文件句柄，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
+    // 2.调用pread()函数，读完后unpin_file()
     // 注意read返回值与num_bytes不等时，throw InternalError("DiskManager::read_page Error");
-    if (lseek(fd, page_no * PAGE_SIZE, SEEK_SET) == -1) {
-        throw UnixError();
-    }
-    ssize_t bytes_read = read(fd, offset, num_bytes);
+    int os_fd = pin_file(fd);
+    ssize_t bytes_read = pread(os_fd, offset, num_bytes, (off_t)page_no * PAGE_SIZE);
+    unpin_file(fd);
     if (bytes_read != num_bytes) {
         throw InternalError("DiskManager::read_page Error");
     }
@@ -135,10 +133,10 @@ void DiskManager::destroy_file(const std::string &path) {
     // Todo:
     // 调用unlink()函数
     // 注意不能删除未关闭的文件
-    auto found = path2fd_.find(path);
+    std::lock_guard<std::mutex> lock(files_latch_);
     if (!is_file(path)) {
         throw FileNotFoundError(path);
-    } else if (found != path2fd_.end()) {
+    } else if (path2fd_.count(path)) {
         throw FileNotClosedError(path);
     }
     if (unlink(path.c_str()) == -1) {
@@ -153,21 +151,12 @@ void DiskManager::destroy_file(const std::string &path) {
  */
 int DiskManager::open_file(const std::string &path) {
     // Todo:
-    // 调用open()函数，使用O_RDWR模式
+    // 调用register_file()分配文件句柄，系统文件句柄在第一次读写时才由pin_file()打开
     // 注意不能重复打开相同文件，并且需要更新文件打开列表
-    auto found = path2fd_.find(path);
     if (!is_file(path)) {
         throw FileNotFoundError(path);
-    } else if (found != path2fd_.end()) {
-        throw FileNotClosedError(path);
-    }
-    int fd = open(path.c_str(), O_RDWR);
-    if (fd == -1) {
-        throw UnixError();
     }
-    path2fd_[path] = fd;
-    fd2path_[fd] = path;
-    return fd;
+    return register_file(path);
 }
 
 /**
@@ -176,18 +165,9 @@ int DiskManager::open_file(const std::string &path) {
  */
 void DiskManager::close_file(int fd) {
     // Todo:
-    // 调用close()函数
+    // 调用unregister_file()，关闭已经打开的系统文件句柄
     // 注意不能关闭未打开的文件，并且需要更新文件打开列表
-    auto found = fd2path_.find(fd);
-    if (found != fd2path_.end()) {
-        if (close(fd) == -1) {
-            throw UnixError();
-        }
-        path2fd_.erase(found->second);
-        fd2path_.erase(fd);
-    } else {
-        throw FileNotOpenError(fd);
-    }
+    unregister_file(fd);
 }
 
 /**
@@ -209,6 +189,7 @@ int DiskManager::get_file_size(const std::string &file_name) {
  * @param {int} fd 文件句柄
  */
 std::string DiskManager::get_file_name(int fd) {
+    std::lock_guard<std::mutex> lock(files_latch_);
     if (!fd2path_.count(fd)) {
         throw FileNotOpenError(fd);
     }
@@ -221,10 +202,14 @@ std::string DiskManager::get_file_name(int fd) {
  * @param {string} &file_name 文件名
  */
 int DiskManager::get_file_fd(const std::string &file_name) {
-    if (!path2fd_.count(file_name)) {
-        return open_file(file_name);
+    {
+        std::lock_guard<std::mutex> lock(files_latch_);
+        auto found = path2fd_.find(file_name);
+        if (found != path2fd_.end()) {
+            return found->second;
+        }
     }
-    return path2fd_[file_name];
+    return open_file(file_name);
 }
 
 /**
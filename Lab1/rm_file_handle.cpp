@@ -25,7 +25,7 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid, Context* cont
     // 1. 获取指定记录所在的page handle
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
     // 2. 初始化一个指向RmRecord的指针（赋值其内部的data和size）
-    return std::make_unique<RmRecord>(file_hdr_.record_size, page_handle.get_slot(rid.slot_no));
+    return page_handle.get_record(rid.slot_no);
 }
 
 /**
@@ -43,9 +43,8 @@ Rid RmFileHandle::insert_record(char* buf, Context* context) {
     RmPageHandle page_handle = create_page_handle();
     // 2. 在page handle中找到空闲slot位置
     int first_free_slot_no = Bitmap::first_bit(0, page_handle.bitmap, file_hdr_.num_records_per_page);
-    char* first_free_slot = page_handle.get_slot(first_free_slot_no);
     // 3. 将buf复制到空闲slot位置
-    memcpy(first_free_slot, buf, file_hdr_.record_size);
+    page_handle.set_record(first_free_slot_no, buf);
     Bitmap::set(page_handle.bitmap, first_free_slot_no);
     // 4. 更新page_handle.page_hdr中的数据结构
     page_handle.page_hdr->num_records++;
@@ -64,16 +63,14 @@ Rid RmFileHandle::insert_record(char* buf, Context* context) {
 void RmFileHandle::insert_record(const Rid& rid, char* buf) {
     // 获取页面句柄
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
-    // 获取指定 slot 的地址
-    char* obj_slot = page_handle.get_slot(rid.slot_no);
     // 将记录数据拷贝到 slot 中
-    memcpy(obj_slot, buf, file_hdr_.record_size);
+    page_handle.set_record(rid.slot_no, buf);
     // 更新页面的 bitmap
     Bitmap::set(page_handle.bitmap, rid.slot_no);
     // 增加记录计数
     page_handle.page_hdr->num_records++;
-    // 如果该页的记录已满，更新文件头中的 first_free_page_no
-    if (page_handle.page_hdr->num_records >= file_hdr_.num_records_per_page) {
+    // 如果该页的记录已满，更新文件头中的 first_free_page_no，旧格式的页面不在空闲页面链表中
+    if (page_handle.is_current() && page_handle.page_hdr->num_records >= file_hdr_.num_records_per_page) {
         file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
     }
     return; // 无返回值
@@ -94,7 +91,7 @@ void RmFileHandle::delete_record(const Rid& rid, Context* context) {
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
     Bitmap::reset(page_handle.bitmap, rid.slot_no);
     // 2. 更新page_handle.page_hdr中的数据结构
-    if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page) {
+    if (page_handle.is_current() && page_handle.page_hdr->num_records == file_hdr_.num_records_per_page) {
         release_page_handle(page_handle);
     }
     page_handle.page_hdr->num_records--;
@@ -115,8 +112,7 @@ void RmFileHandle::update_record(const Rid& rid, char* buf, Context* context) {
     // 1. 获取指定记录所在的page handle
     RmPageHandle page_handle = fetch_page_handle(rid.page_no);
     // 2. 更新记录
-    char* obj_slot = page_handle.get_slot(rid.slot_no);
-    memcpy(obj_slot, buf, file_hdr_.record_size);
+    page_handle.set_record(rid.slot_no, buf);
 }
 
 /**
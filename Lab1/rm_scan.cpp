@@ -22,7 +22,7 @@ RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
         // 存了记录
         RmPageHandle first_page_handle = file_handle_->fetch_page_handle(1);
         rid_.page_no = 1;
-        rid_.slot_no = Bitmap::first_bit(1,first_page_handle.bitmap,file_handle->file_hdr_.num_records_per_page);
+        rid_.slot_no = Bitmap::first_bit(1,first_page_handle.bitmap,first_page_handle.layout.num_records_per_page);
     }
     else{
         // 没有记录
@@ -37,9 +37,10 @@ RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
 void RmScan::next() {
     // Todo:
     // 找到文件中下一个存放了记录的非空闲位置，用rid_来指向这个位置
-    int max_records = file_handle_->file_hdr_.num_records_per_page;
     int page_max = file_handle_->file_hdr_.num_pages;
     RmPageHandle page_handle = file_handle_->fetch_page_handle(rid_.page_no);
+    // 增加字段之前分配的页面使用旧的记录格式，每个页面的容量不同
+    int max_records = page_handle.layout.num_records_per_page;
     rid_.slot_no = Bitmap::next_bit(1,page_handle.bitmap,max_records,rid_.slot_no);
     
     while(rid_.slot_no == max_records){
@@ -48,6 +49,7 @@ void RmScan::next() {
             return;
         }
         page_handle = file_handle_->fetch_page_handle(rid_.page_no);
+        max_records = page_handle.layout.num_records_per_page;
         rid_.slot_no = Bitmap::first_bit(1,page_handle.bitmap,max_records);
     }
     // 考虑store page_handle，省去fetch开销
@@ -58,8 +60,7 @@ void RmScan::next() {
  */
 bool RmScan::is_end() const {
     // Todo: 修改返回值
-    if(rid_.slot_no == file_handle_->file_hdr_.num_records_per_page \
-        && (rid_.page_no >= (file_handle_->file_hdr_.num_pages))){
+    if(rid_.page_no >= (file_handle_->file_hdr_.num_pages)){
             return true;
         }
     return false;
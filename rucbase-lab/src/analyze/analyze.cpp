@@ -2,16 +2,26 @@
 
 /**
  * @description: 分析器，进行语义分析和查询重写，需要检查不符合语义规定的部分
+ * 语法树可能是缓存的存储过程语句，分析过程中不能修改语法树
  * @param {shared_ptr<ast::TreeNode>} parse parser生成的结果集
+ * @param {vector<Value>*} params 分析存储过程中的语句时为实参列表，参数引用在分析时绑定为常量
  * @return {shared_ptr<Query>} Query 
  */
-std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
+std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse, const std::vector<Value> *params)
 {
+    params_ = params;
     std::shared_ptr<Query> query = std::make_shared<Query>();
     if (auto x = std::dynamic_pointer_cast<ast::SelectStmt>(parse))
     {
+        // 聚集函数目前只能出现在物化视图的定义中
+        bool has_agg = std::any_of(x->cols.begin(), x->cols.end(), [](const std::shared_ptr<ast::Col> &col) {
+            return std::dynamic_pointer_cast<ast::AggCol>(col) != nullptr;
+        });
+        if (has_agg || !x->group_cols.empty()) {
+            throw AggregateNotSupportedError();
+        }
         // 处理表名
-        query->tables = std::move(x->tabs);
+        query->tables = x->tabs;
         // 检查表是否存在
         for (auto tbl : query->tables) {
             if(!sm_manager_->db_.is_table(tbl)) {
@@ -42,11 +52,27 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
         //处理where条件
         get_clause(x->conds, query->conds);
         check_clause(query->tables, query->conds);
+    } else if (auto x = std::dynamic_pointer_cast<ast::CreateMatView>(parse)) {
+        analyze_view(x, query->view);
     } else if (auto x = std::dynamic_pointer_cast<ast::UpdateStmt>(parse)) {
-        // 处理 update 的set 值
+        check_writable(x->tab_name);
+        std::vector<ColMeta> all_cols;
+        get_all_cols({x->tab_name}, all_cols);
+        // 处理 update 的set 值，引用字段的表达式编译后由执行器对每条记录求值，不引用字段的表达式直接求值为常量
         for (auto &sv_set_clause : x->set_clauses) {
-            SetClause set_clause = {.lhs = {.tab_name = "", .col_name = sv_set_clause->col_name},
-                                    .rhs = convert_sv_value(sv_set_clause->val)};
+            SetClause set_clause = {.lhs = {.tab_name = "", .col_name = sv_set_clause->col_name}};
+            if (auto sv_val = std::dynamic_pointer_cast<ast::Value>(sv_set_clause->val)) {
+                set_clause.rhs = convert_sv_value(sv_val);
+            } else {
+                auto prog = std::make_shared<ExprProgram>();
+                compile_expr(sv_set_clause->val, all_cols, *prog);
+                if (prog->is_const()) {
+                    set_clause.rhs = eval_const(*prog);
+                } else {
+                    set_clause.rhs.type = prog->type();
+                    set_clause.rhs_expr = std::move(prog);
+                }
+            }
             query->set_clauses.push_back(set_clause);
         }
         TabMeta &tab = sm_manager_->db_.get_table(x->tab_name);
@@ -55,16 +81,46 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
             if (lhs_col->type != set_clause.rhs.type) {
                 throw IncompatibleTypeError(coltype2str(lhs_col->type), coltype2str(set_clause.rhs.type));
             }
-            set_clause.rhs.init_raw(lhs_col->len);
+            // 元组不会在分区之间移动，因此分区键不能被修改
+            if (tab.part.is_partitioned() && lhs_col->name == tab.part.col_name) {
+                throw PartitionKeyUpdateError(lhs_col->name);
+            }
+            if (set_clause.rhs_expr == nullptr) {
+                set_clause.rhs.init_raw(lhs_col->len);
+            }
         }
         //处理where条件
-        get_clause(x->conds, query->conds);
+        std::vector<std::shared_ptr<ast::BinaryExpr>> sv_expr_conds;
+        get_clause(x->conds, query->conds, &sv_expr_conds);
         check_clause({x->tab_name}, query->conds);
+        get_expr_clause(sv_expr_conds, all_cols, query->expr_conds);
     } else if (auto x = std::dynamic_pointer_cast<ast::DeleteStmt>(parse)) {
+        check_writable(x->tab_name);
         //处理where条件
         get_clause(x->conds, query->conds);
         check_clause({x->tab_name}, query->conds);        
+    } else if (auto x = std::dynamic_pointer_cast<ast::CreateProcedure>(parse)) {
+        analyze_procedure(x, query->proc);
+    } else if (auto x = std::dynamic_pointer_cast<ast::CallStmt>(parse)) {
+        auto &proc = sm_manager_->db_.get_proc(x->proc_name);
+        if (x->args.size() != proc.params.size()) {
+            throw InvalidProcedureError(proc.name + " expects " + std::to_string(proc.params.size()) + " arguments");
+        }
+        for (size_t i = 0; i < x->args.size(); i++) {
+            query->values.push_back(bind_arg(proc.params[i], convert_sv_value(x->args[i])));
+        }
+        query->proc_stmts = get_proc_stmts(proc);
+    } else if (auto x = std::dynamic_pointer_cast<ast::DropProcedure>(parse)) {
+        // 同名过程重新创建前不能再用到旧的过程体
+        std::lock_guard<std::mutex> lock(proc_latch_);
+        proc_cache_.erase(x->proc_name);
+    } else if (auto x = std::dynamic_pointer_cast<ast::AddColumn>(parse)) {
+        // 默认值的类型在增加字段时按字段类型检查
+        if (x->default_val != nullptr) {
+            query->values.push_back(convert_sv_value(x->default_val));
+        }
     } else if (auto x = std::dynamic_pointer_cast<ast::InsertStmt>(parse)) {
+        check_writable(x->tab_name);
         // 处理insert 的values值
         for (auto &sv_val : x->vals) {
             query->values.push_back(convert_sv_value(sv_val));
@@ -77,6 +133,207 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
 }
 
 
+/**
+ * @description: 物化视图定义的语义检查，视图的基表必须是互不相同的普通表，
+ * 包含聚集列时必须包含COUNT(*)，且非聚集列即为分组列
+ * @param {shared_ptr<ast::CreateMatView>} stmt 创建视图语句
+ * @param {ViewMeta&} view 检查通过后生成的视图定义
+ */
+void Analyze::analyze_view(const std::shared_ptr<ast::CreateMatView> &stmt, ViewMeta &view) {
+    auto &sel = stmt->query;
+    view.name = stmt->view_name;
+    view.tabs = sel->tabs;
+    for (auto &tab_name : view.tabs) {
+        if (!sm_manager_->db_.is_table(tab_name)) {
+            throw TableNotFoundError(tab_name);
+        }
+        if (sm_manager_->db_.is_view(tab_name)) {
+            throw InvalidViewDefinitionError("base table " + tab_name + " is a materialized view");
+        }
+        if (std::count(view.tabs.begin(), view.tabs.end(), tab_name) > 1) {
+            throw InvalidViewDefinitionError("self join on " + tab_name);
+        }
+    }
+    if (sel->has_sort) {
+        throw InvalidViewDefinitionError("ORDER BY is not allowed");
+    }
+
+    std::vector<ColMeta> all_cols;
+    get_all_cols(view.tabs, all_cols);
+    if (sel->cols.empty()) {
+        for (auto &col : all_cols) {
+            view.cols.push_back({.agg = VIEW_AGG_NONE, .src = {.tab_name = col.tab_name, .col_name = col.name}});
+        }
+    }
+    for (auto &sv_col : sel->cols) {
+        auto agg_col = std::dynamic_pointer_cast<ast::AggCol>(sv_col);
+        if (agg_col != nullptr && agg_col->agg == ast::SV_AGG_COUNT) {
+            view.cols.push_back({.agg = VIEW_AGG_COUNT, .src = {.tab_name = "*", .col_name = "*"}});
+            continue;
+        }
+        TabCol col = check_column(all_cols, {.tab_name = sv_col->tab_name, .col_name = sv_col->col_name});
+        if (agg_col == nullptr) {
+            view.cols.push_back({.agg = VIEW_AGG_NONE, .src = col});
+            continue;
+        }
+        auto type = sm_manager_->db_.get_table(col.tab_name).get_col(col.col_name)->type;
+        if (type == TYPE_STRING) {
+            throw IncompatibleTypeError("INT or FLOAT", coltype2str(type));
+        }
+        view.cols.push_back({.agg = VIEW_AGG_SUM, .src = col});
+    }
+
+    bool has_count = std::any_of(view.cols.begin(), view.cols.end(),
+                                 [](const ViewCol &col) { return col.agg == VIEW_AGG_COUNT; });
+    if (view.has_agg() && !has_count) {
+        // 删除增量需要知道分组中剩余的元组个数
+        throw InvalidViewDefinitionError("aggregate view must include COUNT(*)");
+    }
+    if (!sel->group_cols.empty()) {
+        if (!view.has_agg()) {
+            throw InvalidViewDefinitionError("GROUP BY without aggregates");
+        }
+        std::vector<TabCol> group_cols;
+        for (auto &sv_col : sel->group_cols) {
+            if (std::dynamic_pointer_cast<ast::AggCol>(sv_col) != nullptr) {
+                throw InvalidViewDefinitionError("aggregate in GROUP BY");
+            }
+            group_cols.push_back(check_column(all_cols, {.tab_name = sv_col->tab_name, .col_name = sv_col->col_name}));
+        }
+        for (auto &col : view.cols) {
+            if (col.agg == VIEW_AGG_NONE &&
+                std::find_if(group_cols.begin(), group_cols.end(), [&](const TabCol &group_col) {
+                    return group_col.tab_name == col.src.tab_name && group_col.col_name == col.src.col_name;
+                }) == group_cols.end()) {
+                throw InvalidViewDefinitionError("column " + col.src.col_name + " must appear in GROUP BY");
+            }
+        }
+    }
+
+    get_clause(sel->conds, view.conds);
+    check_clause(view.tabs, view.conds);
+}
+
+/**
+ * @description: 存储过程定义的语义检查，解析过程体并用占位实参分析其中的每条语句，
+ * 提前发现表、字段不存在和类型不匹配等错误，解析结果放入缓存
+ * @param {shared_ptr<ast::CreateProcedure>} stmt 创建存储过程语句
+ * @param {ProcMeta&} proc 检查通过后生成的存储过程定义
+ */
+void Analyze::analyze_procedure(const std::shared_ptr<ast::CreateProcedure> &stmt, ProcMeta &proc) {
+    static const std::map<ast::SvType, ColType> types = {
+        {ast::SV_TYPE_INT, TYPE_INT}, {ast::SV_TYPE_FLOAT, TYPE_FLOAT}, {ast::SV_TYPE_STRING, TYPE_STRING}};
+    if (sm_manager_->db_.is_proc(stmt->proc_name)) {
+        throw ProcedureExistsError(stmt->proc_name);
+    }
+    proc.name = stmt->proc_name;
+    proc.body = stmt->body;
+    std::vector<Value> dummy_args;
+    for (auto &field : stmt->params) {
+        auto col_def = std::dynamic_pointer_cast<ast::ColDef>(field);
+        ProcParam param = {.name = col_def->col_name,
+                           .type = types.at(col_def->type_len->type),
+                           .len = col_def->type_len->len};
+        Value arg;
+        if (param.type == TYPE_INT) {
+            arg.set_int(1);
+        } else if (param.type == TYPE_FLOAT) {
+            arg.set_float(1);
+        } else {
+            arg.set_str("");
+        }
+        proc.params.push_back(param);
+        dummy_args.push_back(arg);
+    }
+
+    auto stmts = parse_proc_body(proc.body);
+    Analyze checker(sm_manager_);
+    for (auto &sub_stmt : stmts) {
+        checker.do_analyze(sub_stmt, &dummy_args);
+    }
+    std::lock_guard<std::mutex> lock(proc_latch_);
+    proc_cache_[proc.name] = {proc.body, std::move(stmts)};
+}
+
+/* 获取存储过程解析后的语句，缓存中没有或已过期时重新解析过程体 */
+std::vector<std::shared_ptr<ast::TreeNode>> Analyze::get_proc_stmts(const ProcMeta &proc) {
+    std::lock_guard<std::mutex> lock(proc_latch_);
+    auto &entry = proc_cache_[proc.name];
+    if (entry.stmts.empty() || entry.body != proc.body) {
+        entry.stmts = parse_proc_body(proc.body);
+        entry.body = proc.body;
+    }
+    return entry.stmts;
+}
+
+/**
+ * @description: 把过程体按字符串常量之外的分号切分为语句并逐条解析，过程体只能包含DML语句
+ * 调用者需要保证此时没有其他线程在使用解析器
+ * @param {string&} body 过程体文本
+ * @return {vector<shared_ptr<ast::TreeNode>>} 各条语句的语法树
+ */
+std::vector<std::shared_ptr<ast::TreeNode>> Analyze::parse_proc_body(const std::string &body) {
+    std::vector<std::string> sqls;
+    std::string sql;
+    bool in_str = false;
+    for (char c : body) {
+        sql += c;
+        if (c == '\'') {
+            in_str = !in_str;
+        } else if (c == ';' && !in_str) {
+            sqls.push_back(std::move(sql));
+            sql.clear();
+        }
+    }
+    if (sql.find_first_not_of(" \t\r\n") != std::string::npos) {
+        throw InvalidProcedureError("statement must end with ';'");
+    }
+
+    std::vector<std::shared_ptr<ast::TreeNode>> stmts;
+    for (auto &stmt_sql : sqls) {
+        if (stmt_sql.find_first_not_of(" \t\r\n;") == std::string::npos) {
+            continue;
+        }
+        YY_BUFFER_STATE buf = yy_scan_string(stmt_sql.c_str());
+        int res = yyparse();
+        yy_delete_buffer(buf);
+        auto stmt = ast::parse_tree;
+        if (res != 0 || stmt == nullptr) {
+            throw InvalidProcedureError("syntax error in statement " + std::to_string(stmts.size() + 1));
+        }
+        if (!std::dynamic_pointer_cast<ast::InsertStmt>(stmt) && !std::dynamic_pointer_cast<ast::DeleteStmt>(stmt) &&
+            !std::dynamic_pointer_cast<ast::UpdateStmt>(stmt) && !std::dynamic_pointer_cast<ast::SelectStmt>(stmt)) {
+            throw InvalidProcedureError("only INSERT, DELETE, UPDATE and SELECT are allowed in a procedure");
+        }
+        stmts.push_back(stmt);
+    }
+    if (stmts.empty()) {
+        throw InvalidProcedureError("procedure body is empty");
+    }
+    return stmts;
+}
+
+/* 按形参的类型检查实参，INT实参可以传给FLOAT形参 */
+Value Analyze::bind_arg(const ProcParam &param, Value arg) {
+    if (param.type == TYPE_FLOAT && arg.type == TYPE_INT) {
+        arg.set_float((float)arg.int_val);
+    }
+    if (param.type != arg.type) {
+        throw IncompatibleTypeError(coltype2str(param.type), coltype2str(arg.type));
+    }
+    if (arg.type == TYPE_STRING && (int)arg.str_val.size() > param.len) {
+        throw StringOverflowError();
+    }
+    return arg;
+}
+
+/* 物化视图由系统维护，不能直接修改 */
+void Analyze::check_writable(const std::string &tab_name) {
+    if (sm_manager_->db_.is_view(tab_name)) {
+        throw ViewReadOnlyError(tab_name);
+    }
+}
+
 TabCol Analyze::check_column(const std::vector<ColMeta> &all_cols, TabCol target) {
     if (target.tab_name.empty()) {
         // Table name not specified, infer table name from column name
@@ -111,7 +368,27 @@ void Analyze::get_all_cols(const std::vector<std::string> &tab_names, std::vecto
     }
 }
 
-void Analyze::get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_conds, std::vector<Condition> &conds) {
+/* 判断表达式是否引用了字段 */
+static bool refers_col(const std::shared_ptr<ast::Expr> &sv_expr) {
+    if (std::dynamic_pointer_cast<ast::Col>(sv_expr)) {
+        return true;
+    }
+    if (auto neg = std::dynamic_pointer_cast<ast::NegExpr>(sv_expr)) {
+        return refers_col(neg->expr);
+    }
+    if (auto arith = std::dynamic_pointer_cast<ast::ArithExpr>(sv_expr)) {
+        return refers_col(arith->lhs) || refers_col(arith->rhs);
+    }
+    return false;
+}
+
+/**
+ * @description: 收集where条件，右侧不引用字段的算术表达式直接求值为常量
+ * @param {vector<shared_ptr<ast::BinaryExpr>>*} sv_expr_conds 右侧为引用字段的算术表达式的条件放入这里，
+ * 为nullptr时说明语句不支持这种条件
+ */
+void Analyze::get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_conds, std::vector<Condition> &conds,
+                         std::vector<std::shared_ptr<ast::BinaryExpr>> *sv_expr_conds) {
     conds.clear();
     for (auto &expr : sv_conds) {
         Condition cond;
@@ -123,6 +400,17 @@ void Analyze::get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv
         } else if (auto rhs_col = std::dynamic_pointer_cast<ast::Col>(expr->rhs)) {
             cond.is_rhs_val = false;
             cond.rhs_col = {.tab_name = rhs_col->tab_name, .col_name = rhs_col->col_name};
+        } else if (refers_col(expr->rhs)) {
+            if (sv_expr_conds == nullptr) {
+                throw ExpressionNotSupportedError();
+            }
+            sv_expr_conds->push_back(expr);
+            continue;
+        } else {
+            ExprProgram prog;
+            compile_expr(expr->rhs, {}, prog);
+            cond.is_rhs_val = true;
+            cond.rhs_val = eval_const(prog);
         }
         conds.push_back(cond);
     }
@@ -157,6 +445,78 @@ void Analyze::check_clause(const std::vector<std::string> &tab_names, std::vecto
     }
 }
 
+/* 把右侧为引用字段的算术表达式的条件编译为ExprCondition，两侧的类型必须相同 */
+void Analyze::get_expr_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_expr_conds,
+                              const std::vector<ColMeta> &all_cols, std::vector<ExprCondition> &expr_conds) {
+    for (auto &sv_cond : sv_expr_conds) {
+        ExprCondition cond = {.lhs = std::make_shared<ExprProgram>(),
+                              .op = convert_sv_comp_op(sv_cond->op),
+                              .rhs = std::make_shared<ExprProgram>()};
+        ColType lhs_type = compile_expr(sv_cond->lhs, all_cols, *cond.lhs);
+        ColType rhs_type = compile_expr(sv_cond->rhs, all_cols, *cond.rhs);
+        if (lhs_type != rhs_type) {
+            throw IncompatibleTypeError(coltype2str(lhs_type), coltype2str(rhs_type));
+        }
+        expr_conds.push_back(std::move(cond));
+    }
+}
+
+/**
+ * @description: 把算术表达式编译为字节码，INT和FLOAT混合运算时INT操作数转换为FLOAT
+ * @param {vector<ColMeta>&} all_cols 表达式可以引用的字段
+ * @param {ExprProgram&} prog 生成的字节码追加到这里
+ * @return {ColType} 表达式的类型
+ */
+ColType Analyze::compile_expr(const std::shared_ptr<ast::Expr> &sv_expr, const std::vector<ColMeta> &all_cols,
+                              ExprProgram &prog) {
+    if (auto sv_val = std::dynamic_pointer_cast<ast::Value>(sv_expr)) {
+        Value val = convert_sv_value(sv_val);
+        if (val.type == TYPE_INT) {
+            prog.push_int(val.int_val);
+        } else if (val.type == TYPE_FLOAT) {
+            prog.push_float(val.float_val);
+        } else {
+            throw IncompatibleTypeError("INT or FLOAT", coltype2str(TYPE_STRING));
+        }
+    } else if (auto sv_col = std::dynamic_pointer_cast<ast::Col>(sv_expr)) {
+        TabCol col = check_column(all_cols, {.tab_name = sv_col->tab_name, .col_name = sv_col->col_name});
+        auto col_meta = sm_manager_->db_.get_table(col.tab_name).get_col(col.col_name);
+        if (col_meta->type == TYPE_STRING) {
+            throw IncompatibleTypeError("INT or FLOAT", coltype2str(TYPE_STRING));
+        }
+        prog.load(col_meta->type, col_meta->offset);
+    } else if (auto neg = std::dynamic_pointer_cast<ast::NegExpr>(sv_expr)) {
+        compile_expr(neg->expr, all_cols, prog);
+        prog.negate();
+    } else if (auto arith = std::dynamic_pointer_cast<ast::ArithExpr>(sv_expr)) {
+        static const std::map<ast::SvArithOp, ExprOpCode> codes = {
+            {ast::SV_OP_ADD, EXPR_ADD_INT}, {ast::SV_OP_SUB, EXPR_SUB_INT},
+            {ast::SV_OP_MUL, EXPR_MUL_INT}, {ast::SV_OP_DIV, EXPR_DIV_INT},
+        };
+        ColType lhs_type = compile_expr(arith->lhs, all_cols, prog);
+        ColType rhs_type = compile_expr(arith->rhs, all_cols, prog);
+        if (lhs_type != rhs_type) {
+            // 左操作数在次栈顶，右操作数在栈顶
+            prog.to_float(lhs_type == TYPE_INT ? 1 : 0);
+        }
+        prog.binary(codes.at(arith->op), lhs_type == rhs_type ? lhs_type : TYPE_FLOAT);
+    } else {
+        throw InternalError("Unexpected sv expr type");
+    }
+    return prog.type();
+}
+
+/* 对不引用字段的表达式求值 */
+Value Analyze::eval_const(const ExprProgram &prog) {
+    Value val;
+    ExprCell res = prog.eval(nullptr);
+    if (prog.type() == TYPE_INT) {
+        val.set_int(res.int_val);
+    } else {
+        val.set_float(res.float_val);
+    }
+    return val;
+}
 
 Value Analyze::convert_sv_value(const std::shared_ptr<ast::Value> &sv_val) {
     Value val;
@@ -166,6 +526,12 @@ Value Analyze::convert_sv_value(const std::shared_ptr<ast::Value> &sv_val) {
         val.set_float(float_lit->val);
     } else if (auto str_lit = std::dynamic_pointer_cast<ast::StringLit>(sv_val)) {
         val.set_str(str_lit->val);
+    } else if (auto param = std::dynamic_pointer_cast<ast::ParamRef>(sv_val)) {
+        // 参数引用只能出现在存储过程中
+        if (params_ == nullptr || param->idx < 1 || param->idx > (int)params_->size()) {
+            throw InvalidProcedureError("parameter $" + std::to_string(param->idx) + " is not declared");
+        }
+        val = (*params_)[param->idx - 1];
     } else {
         throw InternalError("Unexpected sv value type");
     }
@@ -10,10 +10,13 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "parser/parser.h"
@@ -26,14 +29,24 @@ class Query{
     // TODO jointree
     // where条件
     std::vector<Condition> conds;
+    // where条件恒为假，查询结果为空，不需要扫描
+    bool always_false = false;
     // 投影列
     std::vector<TabCol> cols;
     // 表名
     std::vector<std::string> tables;
     // update 的set 值
     std::vector<SetClause> set_clauses;
+    // update 中右侧引用字段的算术表达式where条件，由UpdateExecutor逐条记录求值
+    std::vector<ExprCondition> expr_conds;
     //insert 的values值
     std::vector<Value> values;
+    // create materialized view 的视图定义
+    ViewMeta view;
+    // create procedure 的存储过程定义
+    ProcMeta proc;
+    // call 的存储过程中的语句，实参在values中
+    std::vector<std::shared_ptr<ast::TreeNode>> proc_stmts;
 
     Query(){}
 
@@ -42,19 +55,40 @@ class Query{
 class Analyze
 {
 private:
+    /* 解析后的存储过程体，过程体文本变化时重新解析 */
+    struct ProcCache {
+        std::string body;
+        std::vector<std::shared_ptr<ast::TreeNode>> stmts;
+    };
+
     SmManager *sm_manager_;
+    const std::vector<Value> *params_ = nullptr;    // 分析存储过程中的语句时为实参列表
+    std::mutex proc_latch_;
+    std::unordered_map<std::string, ProcCache> proc_cache_;    // 存储过程名 -> 解析后的过程体
 public:
     Analyze(SmManager *sm_manager) : sm_manager_(sm_manager){}
     ~Analyze(){}
 
-    std::shared_ptr<Query> do_analyze(std::shared_ptr<ast::TreeNode> root);
+    std::shared_ptr<Query> do_analyze(std::shared_ptr<ast::TreeNode> root, const std::vector<Value> *params = nullptr);
 
 private:
     TabCol check_column(const std::vector<ColMeta> &all_cols, TabCol target);
     void get_all_cols(const std::vector<std::string> &tab_names, std::vector<ColMeta> &all_cols);
-    void get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_conds, std::vector<Condition> &conds);
+    void get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_conds, std::vector<Condition> &conds,
+                    std::vector<std::shared_ptr<ast::BinaryExpr>> *sv_expr_conds = nullptr);
     void check_clause(const std::vector<std::string> &tab_names, std::vector<Condition> &conds);
+    void get_expr_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv_expr_conds,
+                         const std::vector<ColMeta> &all_cols, std::vector<ExprCondition> &expr_conds);
+    ColType compile_expr(const std::shared_ptr<ast::Expr> &sv_expr, const std::vector<ColMeta> &all_cols,
+                         ExprProgram &prog);
+    Value eval_const(const ExprProgram &prog);
     Value convert_sv_value(const std::shared_ptr<ast::Value> &sv_val);
     CompOp convert_sv_comp_op(ast::SvCompOp op);
+    void analyze_view(const std::shared_ptr<ast::CreateMatView> &stmt, ViewMeta &view);
+    void check_writable(const std::string &tab_name);
+    void analyze_procedure(const std::shared_ptr<ast::CreateProcedure> &stmt, ProcMeta &proc);
+    std::vector<std::shared_ptr<ast::TreeNode>> get_proc_stmts(const ProcMeta &proc);
+    std::vector<std::shared_ptr<ast::TreeNode>> parse_proc_body(const std::string &body);
+    Value bind_arg(const ProcParam &param, Value arg);
 };
 
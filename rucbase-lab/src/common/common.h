@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include <memory>
 #include <string>
 #include <vector>
+#include "common/expr.h"
 #include "defs.h"
 #include "record/rm_defs.h"
 
@@ -82,7 +83,35 @@ struct Condition {
     Value rhs_val;    // right-hand side value
 };
 
+/* 右侧为引用字段的算术表达式的条件，由执行器对每条记录求值，两侧表达式已编译为相同的类型 */
+struct ExprCondition {
+    std::shared_ptr<ExprProgram> lhs;
+    CompOp op;
+    std::shared_ptr<ExprProgram> rhs;
+
+    bool eval(const char *rec) const {
+        ExprCell lhs_val = lhs->eval(rec);
+        ExprCell rhs_val = rhs->eval(rec);
+        int res;
+        if (lhs->type() == TYPE_INT) {
+            res = (lhs_val.int_val > rhs_val.int_val) - (lhs_val.int_val < rhs_val.int_val);
+        } else {
+            res = (lhs_val.float_val > rhs_val.float_val) - (lhs_val.float_val < rhs_val.float_val);
+        }
+        switch (op) {
+            case OP_EQ: return res == 0;
+            case OP_NE: return res != 0;
+            case OP_LT: return res < 0;
+            case OP_GT: return res > 0;
+            case OP_LE: return res <= 0;
+            case OP_GE: return res >= 0;
+        }
+        return false;
+    }
+};
+
 struct SetClause {
     TabCol lhs;
     Value rhs;
+    std::shared_ptr<ExprProgram> rhs_expr;  // 非空时对每条记录求值，rhs无效
 };
\ No newline at end of file
@@ -23,7 +23,7 @@ extern std::chrono::milliseconds cycle_detection_interval;
 extern std::atomic<bool> enable_logging;
 
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
-extern std::chrono::duration<int64_t> log_timeout;
+extern std::chrono::milliseconds log_timeout;
 
 static constexpr int INVALID_FRAME_ID = -1;                                   // invalid frame id
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
@@ -36,6 +36,21 @@ static constexpr int BUFFER_POOL_SIZE = 65536;                                //
 // static constexpr int BUFFER_POOL_SIZE = 262144;                                // size of buffer pool 1GB
 static constexpr int LOG_BUFFER_SIZE = (1024 * PAGE_SIZE);                    // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int INDEX_BUILD_BATCH = 1024;                                // online index build yields every N records
+static constexpr double REOPT_THRESHOLD = 4.0;                                // re-plan joins when actual/estimated rows exceed this ratio
+static constexpr size_t REOPT_MATERIALIZE_ROWS = 100000;                      // max rows of one join input buffered for re-optimization
+static constexpr int TXN_RETRY_LIMIT = 3;                                     // server-side retries of an aborted implicit transaction
+static constexpr int TXN_RETRY_BACKOFF_US = 1000;                             // base backoff before a retry, doubled per attempt
+static constexpr int LOCK_FAST_PATH_SLOTS = 4096;                             // tables with fd below this take IS/IX locks via counters
+static constexpr int LOCK_FAST_PATH_WAIT_MS = 50;                             // max wait of S/X/SIX table locks for fast-path holders
+static constexpr int LOG_SEGMENT_SIZE = (4096 * PAGE_SIZE);                   // size of a preallocated log segment file 16MB
+static constexpr int LOG_BLOCK_SIZE = PAGE_SIZE;                              // log writes start and end on this boundary
+static constexpr int LOG_RECYCLE_SEGMENTS = 4;                                // spare log segments kept for reuse after checkpoints
+static constexpr int LOG_CHECKPOINT_SEGMENTS = 4;                             // checkpoint once the log grows by this many segments
+static constexpr int BACKUP_RATE_KB = 16384;                                  // default page copy rate of an online backup in KB/s
+static constexpr int WARM_SAVE_INTERVAL_S = 60;                               // how often the resident page list is saved
+static constexpr int WARM_BATCH_PAGES = 4096;                                 // warm-up loads the hottest pages first, in batches of this size
+static constexpr int WARM_READ_PAGES = 64;                                    // max pages in one sequential read during warm-up
 
 using frame_id_t = int32_t;  // frame id type, 帧页ID, 页在BufferPool中的存储单元称为帧,一帧对应一页
 using page_id_t = int32_t;   // page id type , 页ID
@@ -45,10 +60,17 @@ using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
 using timestamp_t = int32_t;  // timestamp type, used for transaction concurrency
 
-// log file
+// log file，日志段文件名为LOG_FILE_NAME.<段号>
 static const std::string LOG_FILE_NAME = "db.log";
+static const std::string LOG_CONTROL_FILE_NAME = "db.log.ctl";
 
 // replacer
 static const std::string REPLACER_TYPE = "LRU";
 
 static const std::string DB_META_NAME = "db.meta";
+
+// 缓冲池中的页面列表，按热度排序，重启后据此预热缓冲池
+static const std::string WARM_FILE_NAME = "db.warm";
+
+// 被删除或被TRUNCATE替换的表和索引文件先改名为"<文件名>.dropped.<序号>"，由后台线程删除，启动时清理残留的此类文件
+static const std::string DROPPED_FILE_SUFFIX = ".dropped.";
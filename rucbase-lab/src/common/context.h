@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <string>
+
 #include "transaction/transaction.h"
 #include "transaction/concurrency/lock_manager.h"
 #include "recovery/log_manager.h"
@@ -35,4 +37,5 @@ public:
     char *data_send_;
     int *offset_;
     bool ellipsis_;
+    std::string output_;    // 语句要写入output.txt的内容，语句执行成功后才追加到文件，重试时丢弃
 };
\ No newline at end of file
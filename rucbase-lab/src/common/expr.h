@@ -0,0 +1,194 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "defs.h"
+#include "errors.h"
+
+/* 表达式求值栈的最大深度，超过时拒绝编译 */
+constexpr int EXPR_MAX_DEPTH = 32;
+
+/* 表达式字节码的操作码，INT和FLOAT的运算使用不同的操作码，类型检查在编译时完成 */
+enum ExprOpCode {
+    EXPR_LOAD_INT,      // 把记录中offset处的INT字段压栈
+    EXPR_LOAD_FLOAT,    // 把记录中offset处的FLOAT字段压栈
+    EXPR_PUSH_INT,      // 把常量压栈
+    EXPR_PUSH_FLOAT,
+    EXPR_TO_FLOAT,      // 把距栈顶offset个位置的INT转换为FLOAT
+    EXPR_ADD_INT,
+    EXPR_SUB_INT,
+    EXPR_MUL_INT,
+    EXPR_DIV_INT,
+    EXPR_NEG_INT,
+    EXPR_ADD_FLOAT,
+    EXPR_SUB_FLOAT,
+    EXPR_MUL_FLOAT,
+    EXPR_DIV_FLOAT,
+    EXPR_NEG_FLOAT,
+};
+
+union ExprCell {
+    int int_val;
+    float float_val;
+};
+
+struct ExprInstr {
+    ExprOpCode code;
+    int offset;     // LOAD的字段偏移，或TO_FLOAT距栈顶的位置
+    ExprCell imm;   // PUSH的常量
+};
+
+/**
+ * @description: 编译后的算术表达式，在一条记录上按逆波兰序求值
+ * 由分析器从语法树生成，执行器对每条记录调用eval，求值过程不再访问元数据
+ */
+class ExprProgram {
+   public:
+    ColType type() const { return type_; }
+
+    /* 表达式不引用字段时可以在分析阶段求值 */
+    bool is_const() const { return !has_load_; }
+
+    void load(ColType type, int offset) {
+        emit({type == TYPE_INT ? EXPR_LOAD_INT : EXPR_LOAD_FLOAT, offset, {}}, 1);
+        has_load_ = true;
+        type_ = type;
+    }
+
+    void push_int(int val) {
+        ExprCell imm;
+        imm.int_val = val;
+        emit({EXPR_PUSH_INT, 0, imm}, 1);
+        type_ = TYPE_INT;
+    }
+
+    void push_float(float val) {
+        ExprCell imm;
+        imm.float_val = val;
+        emit({EXPR_PUSH_FLOAT, 0, imm}, 1);
+        type_ = TYPE_FLOAT;
+    }
+
+    /* 把距栈顶depth个位置的INT操作数转换为FLOAT，depth为0时同时改变表达式的类型 */
+    void to_float(int depth = 0) {
+        emit({EXPR_TO_FLOAT, depth, {}}, 0);
+        if (depth == 0) {
+            type_ = TYPE_FLOAT;
+        }
+    }
+
+    /* 弹出两个同类型的操作数，压入运算结果，int_code为该运算INT版本的操作码 */
+    void binary(ExprOpCode int_code, ColType type) {
+        emit({type == TYPE_INT ? int_code : float_code(int_code), 0, {}}, -1);
+        type_ = type;
+    }
+
+    void negate() { emit({type_ == TYPE_INT ? EXPR_NEG_INT : EXPR_NEG_FLOAT, 0, {}}, 0); }
+
+    ExprCell eval(const char *rec) const {
+        ExprCell stack[EXPR_MAX_DEPTH];
+        int top = -1;
+        for (auto &instr : code_) {
+            switch (instr.code) {
+                case EXPR_LOAD_INT:
+                case EXPR_LOAD_FLOAT:
+                    memcpy(&stack[++top], rec + instr.offset, sizeof(ExprCell));
+                    break;
+                case EXPR_PUSH_INT:
+                case EXPR_PUSH_FLOAT:
+                    stack[++top] = instr.imm;
+                    break;
+                case EXPR_TO_FLOAT:
+                    stack[top - instr.offset].float_val = (float)stack[top - instr.offset].int_val;
+                    break;
+                case EXPR_ADD_INT:
+                    if (__builtin_add_overflow(stack[top - 1].int_val, stack[top].int_val, &stack[top - 1].int_val)) {
+                        throw ArithmeticError("integer overflow");
+                    }
+                    top--;
+                    break;
+                case EXPR_SUB_INT:
+                    if (__builtin_sub_overflow(stack[top - 1].int_val, stack[top].int_val, &stack[top - 1].int_val)) {
+                        throw ArithmeticError("integer overflow");
+                    }
+                    top--;
+                    break;
+                case EXPR_MUL_INT:
+                    if (__builtin_mul_overflow(stack[top - 1].int_val, stack[top].int_val, &stack[top - 1].int_val)) {
+                        throw ArithmeticError("integer overflow");
+                    }
+                    top--;
+                    break;
+                case EXPR_DIV_INT:
+                    if (stack[top].int_val == 0) {
+                        throw ArithmeticError("division by zero");
+                    }
+                    if (stack[top].int_val == -1 && stack[top - 1].int_val == INT32_MIN) {
+                        throw ArithmeticError("integer overflow");
+                    }
+                    stack[top - 1].int_val /= stack[top].int_val;
+                    top--;
+                    break;
+                case EXPR_NEG_INT:
+                    if (stack[top].int_val == INT32_MIN) {
+                        throw ArithmeticError("integer overflow");
+                    }
+                    stack[top].int_val = -stack[top].int_val;
+                    break;
+                case EXPR_ADD_FLOAT:
+                    stack[top - 1].float_val += stack[top].float_val;
+                    top--;
+                    break;
+                case EXPR_SUB_FLOAT:
+                    stack[top - 1].float_val -= stack[top].float_val;
+                    top--;
+                    break;
+                case EXPR_MUL_FLOAT:
+                    stack[top - 1].float_val *= stack[top].float_val;
+                    top--;
+                    break;
+                case EXPR_DIV_FLOAT:
+                    if (stack[top].float_val == 0) {
+                        throw ArithmeticError("division by zero");
+                    }
+                    stack[top - 1].float_val /= stack[top].float_val;
+                    top--;
+                    break;
+                case EXPR_NEG_FLOAT:
+                    stack[top].float_val = -stack[top].float_val;
+                    break;
+            }
+        }
+        return stack[0];
+    }
+
+   private:
+    static ExprOpCode float_code(ExprOpCode int_code) {
+        return (ExprOpCode)(int_code - EXPR_ADD_INT + EXPR_ADD_FLOAT);
+    }
+
+    void emit(ExprInstr instr, int delta) {
+        depth_ += delta;
+        if (depth_ > EXPR_MAX_DEPTH) {
+            throw ArithmeticError("expression is too complex");
+        }
+        code_.push_back(instr);
+    }
+
+    std::vector<ExprInstr> code_;
+    ColType type_ = TYPE_INT;   // 表达式结果的类型
+    int depth_ = 0;             // 编译时模拟的栈深度
+    bool has_load_ = false;
+};
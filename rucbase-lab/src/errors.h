@@ -108,6 +108,16 @@ class ColumnNotFoundError : public RMDBError {
     ColumnNotFoundError(const std::string &col_name) : RMDBError("Column not found: " + col_name) {}
 };
 
+class ColumnExistsError : public RMDBError {
+   public:
+    ColumnExistsError(const std::string &col_name) : RMDBError("Column already exists: " + col_name) {}
+};
+
+class InvalidAlterColumnError : public RMDBError {
+   public:
+    InvalidAlterColumnError(const std::string &msg) : RMDBError("Invalid column change: " + msg) {}
+};
+
 class IndexNotFoundError : public RMDBError {
    public:
     IndexNotFoundError(const std::string &tab_name, const std::vector<std::string> &col_names) {
@@ -132,6 +142,81 @@ class IndexExistsError : public RMDBError {
     }
 };
 
+class IndexDuplicateKeyError : public RMDBError {
+   public:
+    IndexDuplicateKeyError(const std::string &tab_name, const std::vector<std::string> &col_names) {
+        _msg += "Duplicate key in table " + tab_name + " for unique index (";
+        for(size_t i = 0; i < col_names.size(); ++i) {
+            if(i > 0) _msg += ", ";
+            _msg += col_names[i];
+        }
+        _msg += ")";
+    }
+};
+
+class IndexBuildInProgressError : public RMDBError {
+   public:
+    IndexBuildInProgressError(const std::string &tab_name)
+        : RMDBError("An index is being built on table " + tab_name) {}
+};
+
+class DdlInTransactionError : public RMDBError {
+   public:
+    DdlInTransactionError(const std::string &stmt) : RMDBError(stmt + " cannot run inside a transaction block") {}
+};
+
+class ViewNotFoundError : public RMDBError {
+   public:
+    ViewNotFoundError(const std::string &view_name) : RMDBError("Materialized view not found: " + view_name) {}
+};
+
+class ProcedureNotFoundError : public RMDBError {
+   public:
+    ProcedureNotFoundError(const std::string &proc_name) : RMDBError("Procedure not found: " + proc_name) {}
+};
+
+class ProcedureExistsError : public RMDBError {
+   public:
+    ProcedureExistsError(const std::string &proc_name) : RMDBError("Procedure already exists: " + proc_name) {}
+};
+
+class InvalidProcedureError : public RMDBError {
+   public:
+    InvalidProcedureError(const std::string &msg) : RMDBError("Invalid procedure: " + msg) {}
+};
+
+class ViewReadOnlyError : public RMDBError {
+   public:
+    ViewReadOnlyError(const std::string &view_name) : RMDBError("Materialized view is read-only: " + view_name) {}
+};
+
+class ViewDependencyError : public RMDBError {
+   public:
+    ViewDependencyError(const std::string &tab_name, const std::string &view_name)
+        : RMDBError("Table " + tab_name + " is referenced by materialized view " + view_name) {}
+};
+
+class InvalidViewDefinitionError : public RMDBError {
+   public:
+    InvalidViewDefinitionError(const std::string &msg) : RMDBError("Invalid materialized view definition: " + msg) {}
+};
+
+class PartitionNotFoundError : public RMDBError {
+   public:
+    PartitionNotFoundError(const std::string &part) : RMDBError("Partition not found: " + part) {}
+};
+
+class PartitionExistsError : public RMDBError {
+   public:
+    PartitionExistsError(const std::string &tab_name, const std::string &part_name)
+        : RMDBError("Partition already exists: " + tab_name + "." + part_name) {}
+};
+
+class InvalidPartitionError : public RMDBError {
+   public:
+    InvalidPartitionError(const std::string &msg) : RMDBError("Invalid partition definition: " + msg) {}
+};
+
 // QL errors
 class InvalidValueCountError : public RMDBError {
    public:
@@ -149,11 +234,63 @@ class IncompatibleTypeError : public RMDBError {
         : RMDBError("Incompatible type error: lhs " + lhs + ", rhs " + rhs) {}
 };
 
+class ArithmeticError : public RMDBError {
+   public:
+    ArithmeticError(const std::string &msg) : RMDBError("Arithmetic error: " + msg) {}
+};
+
+class ExpressionNotSupportedError : public RMDBError {
+   public:
+    ExpressionNotSupportedError() : RMDBError("Column expressions in WHERE are only supported in UPDATE") {}
+};
+
+class PartitionKeyUpdateError : public RMDBError {
+   public:
+    PartitionKeyUpdateError(const std::string &col_name)
+        : RMDBError("Partition key column cannot be updated: " + col_name) {}
+};
+
+class AggregateNotSupportedError : public RMDBError {
+   public:
+    AggregateNotSupportedError() : RMDBError("Aggregates are only supported in materialized view definitions") {}
+};
+
 class AmbiguousColumnError : public RMDBError {
    public:
     AmbiguousColumnError(const std::string &col_name) : RMDBError("Ambiguous column: " + col_name) {}
 };
 
+class ReadOnlyTransactionError : public RMDBError {
+   public:
+    ReadOnlyTransactionError() : RMDBError("Cannot modify data in a read-only transaction") {}
+};
+
+class UnknownVariableError : public RMDBError {
+   public:
+    UnknownVariableError(const std::string &name) : RMDBError("Unknown variable: " + name) {}
+};
+
+class InvalidVariableValueError : public RMDBError {
+   public:
+    InvalidVariableValueError(const std::string &name, const std::string &value)
+        : RMDBError("Invalid value for variable " + name + ": " + value) {}
+};
+
+class SavepointNotFoundError : public RMDBError {
+   public:
+    SavepointNotFoundError(const std::string &name) : RMDBError("Savepoint not found: " + name) {}
+};
+
+class ReadOnlyReplicaError : public RMDBError {
+   public:
+    ReadOnlyReplicaError() : RMDBError("Cannot execute this statement on a read-only replica") {}
+};
+
+class BackupInProgressError : public RMDBError {
+   public:
+    BackupInProgressError() : RMDBError("Another backup is in progress") {}
+};
+
 class PageNotExistError : public RMDBError {
    public:
     PageNotExistError(const std::string &table_name, int page_no)
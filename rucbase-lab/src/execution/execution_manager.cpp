@@ -10,6 +10,10 @@ See the Mulan PSL v2 for more details. */
 
 #include "execution_manager.h"
 
+#include <algorithm>
+#include <map>
+#include <sstream>
+
 #include "executor_delete.h"
 #include "executor_index_scan.h"
 #include "executor_insert.h"
@@ -23,14 +27,36 @@ See the Mulan PSL v2 for more details. */
 const char *help_info = "Supported SQL syntax:\n"
                    "  command ;\n"
                    "command:\n"
-                   "  CREATE TABLE table_name (column_name type [, column_name type ...])\n"
+                   "  CREATE TABLE table_name (column_name type [, column_name type ...]) [partition_clause]\n"
                    "  DROP TABLE table_name\n"
+                   "  TRUNCATE TABLE table_name\n"
+                   "  ALTER TABLE table_name ADD range_partition\n"
+                   "  ALTER TABLE table_name DROP PARTITION partition_name\n"
+                   "  ALTER TABLE table_name ADD COLUMN column_name type [DEFAULT value]\n"
+                   "  ALTER TABLE table_name DROP COLUMN column_name\n"
                    "  CREATE INDEX table_name (column_name)\n"
                    "  DROP INDEX table_name (column_name)\n"
+                   "  CREATE MATERIALIZED VIEW view_name AS SELECT selector FROM table_name [, table_name ...]"
+                   " [WHERE where_clause] [GROUP BY column [, column ...]]\n"
+                   "  DROP MATERIALIZED VIEW view_name\n"
+                   "  CREATE PROCEDURE proc_name ([param_name type [, param_name type ...]]) AS $$ statement; ... $$\n"
+                   "  DROP PROCEDURE proc_name\n"
+                   "  CALL proc_name ([value [, value ...]])\n"
                    "  INSERT INTO table_name VALUES (value [, value ...])\n"
                    "  DELETE FROM table_name [WHERE where_clause]\n"
                    "  UPDATE table_name SET column_name = value [, column_name = value ...] [WHERE where_clause]\n"
                    "  SELECT selector FROM table_name [WHERE where_clause]\n"
+                   "  SHOW METRICS\n"
+                   "  SET variable = value\n"
+                   "  BACKUP TO 'path'\n"
+                   "  VACUUM table_name\n"
+                   "  BEGIN [READ ONLY]\n"
+                   "  {COMMIT | ABORT | ROLLBACK}\n"
+                   "partition_clause:\n"
+                   "  PARTITION BY RANGE (column_name) (range_partition [, range_partition ...])\n"
+                   "  PARTITION BY HASH (column_name) PARTITIONS n\n"
+                   "range_partition:\n"
+                   "  PARTITION partition_name VALUES LESS THAN ({int_value | MAXVALUE})\n"
                    "type:\n"
                    "  {INT | FLOAT | CHAR(n)}\n"
                    "where_clause:\n"
@@ -42,7 +68,11 @@ const char *help_info = "Supported SQL syntax:\n"
                    "op:\n"
                    "  {= | <> | < | > | <= | >=}\n"
                    "selector:\n"
-                   "  {* | column [, column ...]}\n";
+                   "  {* | column [, column ...]}\n"
+                   "procedure statement:\n"
+                   "  INSERT, DELETE, UPDATE or SELECT, using $n for the n-th parameter\n"
+                   "view selector:\n"
+                   "  {* | {column | COUNT(*) | SUM(column)} [, ...]}\n";
 
 // 主要负责执行DDL语句
 void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
@@ -50,7 +80,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
         switch(x->tag) {
             case T_CreateTable:
             {
-                sm_manager_->create_table(x->tab_name_, x->cols_, context);
+                sm_manager_->create_table(x->tab_name_, x->cols_, context, x->part_);
                 break;
             }
             case T_DropTable:
@@ -58,6 +88,11 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
                 sm_manager_->drop_table(x->tab_name_, context);
                 break;
             }
+            case T_TruncateTable:
+            {
+                sm_manager_->truncate_table(x->tab_name_, context);
+                break;
+            }
             case T_CreateIndex:
             {
                 sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context);
@@ -68,6 +103,47 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
                 sm_manager_->drop_index(x->tab_name_, x->tab_col_names_, context);
                 break;
             }
+            case T_AddPartition:
+            {
+                sm_manager_->add_partition(x->tab_name_, x->part_.names[0], x->part_.bounds[0], context);
+                break;
+            }
+            case T_DropPartition:
+            {
+                sm_manager_->drop_partition(x->tab_name_, x->part_.names[0], context);
+                break;
+            }
+            case T_AddColumn:
+            {
+                sm_manager_->add_column(x->tab_name_, x->cols_[0], x->values_.empty() ? nullptr : &x->values_[0],
+                                        context);
+                break;
+            }
+            case T_DropColumn:
+            {
+                sm_manager_->drop_column(x->tab_name_, x->tab_col_names_[0], context);
+                break;
+            }
+            case T_CreateMatView:
+            {
+                sm_manager_->create_view(x->view_, context);
+                break;
+            }
+            case T_DropMatView:
+            {
+                sm_manager_->drop_view(x->tab_name_, context);
+                break;
+            }
+            case T_CreateProcedure:
+            {
+                sm_manager_->create_procedure(x->proc_, context);
+                break;
+            }
+            case T_DropProcedure:
+            {
+                sm_manager_->drop_procedure(x->tab_name_, context);
+                break;
+            }
             default:
                 throw InternalError("Unexpected field type");
                 break;  
@@ -75,7 +151,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
     }
 }
 
-// 执行help; show tables; desc table; begin; commit; abort;语句
+// 执行help; show tables; show metrics; set; backup; vacuum; desc table; begin; commit; abort;语句
 void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Context *context) {
     if (auto x = std::dynamic_pointer_cast<OtherPlan>(plan)) {
         switch(x->tag) {
@@ -90,17 +166,55 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
                 sm_manager_->show_tables(context);
                 break;
             }
+            case T_ShowMetrics:
+            {
+                auto &metrics = txn_mgr_->get_metrics();
+                RecordPrinter printer(2);
+                printer.print_separator(context);
+                printer.print_record({"Metric", "Value"}, context);
+                printer.print_separator(context);
+                printer.print_record({"committed", std::to_string(metrics.committed)}, context);
+                printer.print_record({"aborted", std::to_string(metrics.aborted)}, context);
+                printer.print_record({"retried", std::to_string(metrics.retried)}, context);
+                printer.print_record({"retry_exhausted", std::to_string(metrics.retry_exhausted)}, context);
+                printer.print_separator(context);
+                break;
+            }
+            case T_SetVar:
+            {
+                auto set = std::static_pointer_cast<SetVarPlan>(plan);
+                set_variable(set->var_name_, set->value_, context);
+                break;
+            }
             case T_DescTable:
             {
                 sm_manager_->desc_table(x->tab_name_, context);
                 break;
             }
+            case T_Backup:
+            {
+                // 备份路径存放在tab_name_中
+                sm_manager_->backup(x->tab_name_, context);
+                break;
+            }
+            case T_Vacuum:
+            {
+                sm_manager_->vacuum(x->tab_name_, context);
+                break;
+            }
             case T_Transaction_begin:
             {
                 // 显示开启一个事务
                 context->txn_->set_txn_mode(true);
                 break;
             }  
+            case T_Transaction_begin_read_only:
+            {
+                // 显式开启一个只读事务，事务中的写操作会被拒绝
+                context->txn_->set_txn_mode(true);
+                context->txn_->set_read_only(true);
+                break;
+            }
             case T_Transaction_commit:
             {
                 context->txn_ = txn_mgr_->get_transaction(*txn_id);
@@ -119,6 +233,24 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
                 txn_mgr_->abort(context->txn_, context->log_mgr_);
                 break;
             }     
+            case T_Savepoint:
+            {
+                auto sp = std::static_pointer_cast<SavepointPlan>(plan);
+                txn_mgr_->savepoint(context->txn_, sp->name_);
+                break;
+            }
+            case T_RollbackToSavepoint:
+            {
+                auto sp = std::static_pointer_cast<SavepointPlan>(plan);
+                txn_mgr_->rollback_to_savepoint(context->txn_, sp->name_, context->log_mgr_);
+                break;
+            }
+            case T_ReleaseSavepoint:
+            {
+                auto sp = std::static_pointer_cast<SavepointPlan>(plan);
+                txn_mgr_->release_savepoint(context->txn_, sp->name_);
+                break;
+            }
             default:
                 throw InternalError("Unexpected field type");
                 break;                        
@@ -141,9 +273,8 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
     rec_printer.print_separator(context);
     rec_printer.print_record(captions, context);
     rec_printer.print_separator(context);
-    // print header into file
-    std::fstream outfile;
-    outfile.open("output.txt", std::ios::out | std::ios::app);
+    // print header into file，先写入context的输出缓冲，语句执行成功后由调用者追加到output.txt
+    std::stringstream outfile;
     outfile << "|";
     for(int i = 0; i < captions.size(); ++i) {
         outfile << " " << captions[i] << " |";
@@ -179,13 +310,55 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
         outfile << "\n";
         num_rec++;
     }
-    outfile.close();
+    context->output_ += outfile.str();
     // Print footer into buffer
     rec_printer.print_separator(context);
     // Print record count into buffer
     RecordPrinter::print_record_count(num_rec, context);
 }
 
+/**
+ * @description: 修改运行时参数，参数名和取值不区分大小写
+ * deadlock_policy: 锁冲突时的处理策略，取值为no_wait、wait_die或wound_wait
+ * async_commit: 当前会话的事务是否异步提交，取值为on或off，从当前事务开始生效
+ * @param {string&} name 参数名
+ * @param {string&} value 参数的取值
+ * @param {Context*} context 执行SET语句的上下文
+ */
+void QlManager::set_variable(const std::string &name, const std::string &value, Context *context) {
+    auto lower = [](std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+        return str;
+    };
+    std::string key = lower(name);
+    std::string val = lower(value);
+    if (key == "deadlock_policy") {
+        static const std::map<std::string, DeadlockPolicy> policies = {
+            {"no_wait", DeadlockPolicy::NO_WAIT}, {"wait_die", DeadlockPolicy::WAIT_DIE},
+            {"wound_wait", DeadlockPolicy::WOUND_WAIT}};
+        auto it = policies.find(val);
+        if (it == policies.end()) {
+            throw InvalidVariableValueError(name, value);
+        }
+        txn_mgr_->get_lock_manager()->set_policy(it->second);
+    } else if (key == "async_commit") {
+        if (val != "on" && val != "off") {
+            throw InvalidVariableValueError(name, value);
+        }
+        context->txn_->set_async_commit(val == "on");
+    } else if (key == "backup_rate") {
+        // 在线备份复制页面的速率上限，单位KB/s，0表示不限速
+        char *end;
+        long rate = strtol(val.c_str(), &end, 10);
+        if (val.empty() || *end != '\0' || rate < 0 || rate > INT32_MAX) {
+            throw InvalidVariableValueError(name, value);
+        }
+        sm_manager_->set_backup_rate(rate);
+    } else {
+        throw UnknownVariableError(name);
+    }
+}
+
 // 执行DML语句
 void QlManager::run_dml(std::unique_ptr<AbstractExecutor> exec){
     exec->Next();
@@ -41,4 +41,6 @@ class QlManager {
                         Context *context);
 
     void run_dml(std::unique_ptr<AbstractExecutor> exec);
+
+    void set_variable(const std::string &name, const std::string &value, Context *context);
 };
@@ -53,4 +53,27 @@ class AbstractExecutor {
         }
         return pos;
     }
+
+    /* 向索引插入key之前对key所在的间隙加插入意向锁，加锁期间其他事务可能插入了更近的索引项，因此重新确认间隙 */
+    void lock_gap_for_insert(IxIndexHandle *ih, const char *key) {
+        if (context_->txn_ == nullptr) {
+            return;
+        }
+        Rid next = ih->next_key_rid(key);
+        while (true) {
+            context_->lock_mgr_->lock_IX_on_gap(context_->txn_, next, ih->get_fd());
+            Rid curr = ih->next_key_rid(key);
+            if (curr == next) {
+                break;
+            }
+            next = curr;
+        }
+    }
+
+    /* 删除指向rid的索引项之前对该索引项之前的间隙加锁，删除后该间隙并入下一个间隙，不能让扫描过它的事务看到变化 */
+    void lock_gap_for_delete(IxIndexHandle *ih, const Rid &rid) {
+        if (context_->txn_ != nullptr) {
+            context_->lock_mgr_->lock_IX_on_gap(context_->txn_, rid, ih->get_fd());
+        }
+    }
 };
\ No newline at end of file
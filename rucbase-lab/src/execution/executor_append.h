@@ -0,0 +1,92 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @description: 依次执行多个子算子，用于分区表
+ * 扫描分区表时每个子算子扫描一个分区，依次输出各个分区中的元组；
+ * 修改分区表时每个子算子修改一个分区，Next()依次执行所有子算子
+ */
+class AppendExecutor : public AbstractExecutor {
+   private:
+    std::vector<std::unique_ptr<AbstractExecutor>> children_;   // 子算子
+    size_t curr_;                                               // 当前正在输出元组的子算子
+    std::vector<ColMeta> cols_;                                 // 输出的字段，所有子算子相同
+    size_t len_;                                                // 输出的每条记录的长度
+    bool is_dml_;                                               // 子算子是否为DML算子
+
+   public:
+    // 扫描算子，所有分区都被裁剪掉时children为空，因此输出字段需要单独给出
+    AppendExecutor(std::vector<std::unique_ptr<AbstractExecutor>> children, std::vector<ColMeta> cols, size_t len) {
+        children_ = std::move(children);
+        cols_ = std::move(cols);
+        len_ = len;
+        curr_ = 0;
+        is_dml_ = false;
+    }
+
+    // DML算子
+    explicit AppendExecutor(std::vector<std::unique_ptr<AbstractExecutor>> children) {
+        children_ = std::move(children);
+        len_ = 0;
+        curr_ = 0;
+        is_dml_ = true;
+    }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "AppendExecutor"; }
+
+    void beginTuple() override {
+        curr_ = 0;
+        if (!children_.empty()) {
+            children_[curr_]->beginTuple();
+        }
+        skip_finished();
+    }
+
+    void nextTuple() override {
+        children_[curr_]->nextTuple();
+        skip_finished();
+    }
+
+    bool is_end() const override { return curr_ == children_.size(); }
+
+    std::unique_ptr<RmRecord> Next() override {
+        if (is_dml_) {
+            for (auto &child : children_) {
+                child->Next();
+            }
+            return nullptr;
+        }
+        return children_[curr_]->Next();
+    }
+
+    Rid &rid() override { return is_end() ? _abstract_rid : children_[curr_]->rid(); }
+
+   private:
+    // 当前子算子输出完毕后切换到下一个仍有元组的子算子
+    void skip_finished() {
+        while (curr_ < children_.size() && children_[curr_]->is_end()) {
+            curr_++;
+            if (curr_ < children_.size()) {
+                children_[curr_]->beginTuple();
+            }
+        }
+    }
+};
@@ -22,21 +22,62 @@ class DeleteExecutor : public AbstractExecutor {
     RmFileHandle *fh_;              // 表的数据文件句柄
     std::vector<Rid> rids_;         // 需要删除的记录的位置
     std::string tab_name_;          // 表名称
+    std::string file_name_;         // 数据文件名，分区表为rids_所在分区的数据文件名
     SmManager *sm_manager_;
 
    public:
-    DeleteExecutor(SmManager *sm_manager, const std::string &tab_name, std::vector<Condition> conds,
-                   std::vector<Rid> rids, Context *context) {
+    DeleteExecutor(SmManager *sm_manager, const std::string &tab_name, const std::string &file_name,
+                   std::vector<Condition> conds, std::vector<Rid> rids, Context *context) {
         sm_manager_ = sm_manager;
         tab_name_ = tab_name;
+        file_name_ = file_name;
         tab_ = sm_manager_->db_.get_table(tab_name);
-        fh_ = sm_manager_->fhs_.at(tab_name).get();
+        fh_ = sm_manager_->get_file_handle(file_name);
         conds_ = conds;
         rids_ = rids;
         context_ = context;
     }
 
     std::unique_ptr<RmRecord> Next() override {
+        // 先加表意向写锁，再持有元数据共享锁，保证删除期间表上的索引集合不变
+        auto meta_lock = sm_manager_->lock_file_for_write(file_name_, context_);
+        fh_ = sm_manager_->get_file_handle(file_name_);
+        auto &indexes = sm_manager_->db_.get_table(tab_name_).indexes;
+        for (auto &rid : rids_) {
+            fh_->lock_record(rid, context_, true);
+            auto rec = fh_->get_record(rid, context_);
+            // 先对要删除的索引项前的间隙加锁，加锁失败时还没有修改任何数据
+            std::vector<std::vector<char>> keys;
+            for (auto &index : indexes) {
+                auto ih = sm_manager_->get_index_handle(file_name_, index.cols);
+                std::vector<char> key(index.col_tot_len);
+                int offset = 0;
+                for (int i = 0; i < index.col_num; ++i) {
+                    memcpy(key.data() + offset, rec->data + index.cols[i].offset, index.cols[i].len);
+                    offset += index.cols[i].len;
+                }
+                lock_gap_for_delete(ih, rid);
+                keys.push_back(std::move(key));
+            }
+            // 页面固定到写完日志并记入page lsn之后，保证页面写盘前日志已经写盘
+            Page *page = fh_->pin_page(rid.page_no);
+            fh_->delete_record(rid, context_);
+            // 记录写操作，用于事务回滚和物化视图的增量维护，加入写集合之后后续步骤出错时语句回滚可以撤销这次删除
+            auto write_rec = std::make_unique<WriteRecord>(WType::DELETE_TUPLE, file_name_, rid, *rec);
+            WriteRecord &write = *write_rec;
+            if (context_->txn_ != nullptr) {
+                context_->log_mgr_->add_write_log(context_->txn_, write_rec.get(), nullptr, fh_);
+                context_->txn_->append_write_record(write_rec.release());
+            }
+            fh_->unpin_page(page);
+            // 删除索引项，索引页面的page lsn取已经分配的最大日志号，因此修改索引在写日志之后
+            for (size_t k = 0; k < indexes.size(); ++k) {
+                auto ih = sm_manager_->get_index_handle(file_name_, indexes[k].cols);
+                ih->delete_entry(keys[k].data(), context_->txn_);
+            }
+            sm_manager_->record_index_change(file_name_, rec->data, rid, false);
+            sm_manager_->get_view_maintainer()->apply(write, context_);
+        }
         return nullptr;
     }
 
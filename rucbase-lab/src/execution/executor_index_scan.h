@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cfloat>
+
 #include "execution_defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -19,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 class IndexScanExecutor : public AbstractExecutor {
    private:
     std::string tab_name_;                      // 表名称
+    std::string file_name_;                     // 扫描的数据文件名，分区表的每个分区有独立的索引
     TabMeta tab_;                               // 表的元数据
     std::vector<Condition> conds_;              // 扫描条件
     RmFileHandle *fh_;                          // 表的数据文件句柄
@@ -29,23 +32,27 @@ class IndexScanExecutor : public AbstractExecutor {
     std::vector<std::string> index_col_names_;  // index scan涉及到的索引包含的字段
     IndexMeta index_meta_;                      // index scan涉及到的索引元数据
 
+    IxIndexHandle *ih_;                         // 扫描的索引
+    Rid end_gap_;                               // 扫描范围之后的第一个间隙
+
     Rid rid_;
     std::unique_ptr<RecScan> scan_;
 
     SmManager *sm_manager_;
 
    public:
-    IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, std::vector<std::string> index_col_names,
-                    Context *context) {
+    IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::string file_name, std::vector<Condition> conds,
+                    std::vector<std::string> index_col_names, Context *context) {
         sm_manager_ = sm_manager;
         context_ = context;
         tab_name_ = std::move(tab_name);
+        file_name_ = std::move(file_name);
         tab_ = sm_manager_->db_.get_table(tab_name_);
         conds_ = std::move(conds);
         // index_no_ = index_no;
         index_col_names_ = index_col_names; 
         index_meta_ = *(tab_.get_index_meta(index_col_names_));
-        fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        fh_ = sm_manager_->get_file_handle(file_name_);
         cols_ = tab_.cols;
         len_ = cols_.back().offset + cols_.back().len;
         std::map<CompOp, CompOp> swap_op = {
@@ -61,20 +68,155 @@ class IndexScanExecutor : public AbstractExecutor {
                 cond.op = swap_op.at(cond.op);
             }
         }
+        // 改写规则推导出的常量条件没有raw，按字段长度初始化
+        for (auto &cond : conds_) {
+            if (cond.is_rhs_val && cond.rhs_val.raw == nullptr) {
+                cond.rhs_val.init_raw(tab_.get_col(cond.lhs_col.col_name)->len);
+            }
+        }
         fed_conds_ = conds_;
     }
 
+    /**
+     * @brief 按扫描条件确定索引上的键范围，构建索引迭代器并停在第一个满足条件的记录上
+     * 在可串行化隔离下只对表加意向读锁，对扫描到的键范围加间隙锁，其他事务仍可以向范围之外插入记录
+     */
     void beginTuple() override {
-        
+        ih_ = sm_manager_->get_index_handle(file_name_, index_meta_.cols);
+        if (context_->txn_ != nullptr) {
+            context_->lock_mgr_->lock_IS_on_table(context_->txn_, fh_->GetFd());
+        }
+        std::vector<char> lower_key(index_meta_.col_tot_len);
+        std::vector<char> upper_key(index_meta_.col_tot_len);
+        bool lower_inc = true;
+        bool upper_inc = true;
+        int offset = 0;
+        size_t i = 0;
+        // 等值条件确定的前缀之后，第一个带范围条件的字段确定上下界，其余字段分别用最小值和最大值填充
+        for (; i < index_meta_.cols.size(); i++) {
+            auto &col = index_meta_.cols[i];
+            const Condition *eq = find_cond(col, {OP_EQ});
+            if (eq == nullptr) {
+                break;
+            }
+            memcpy(lower_key.data() + offset, eq->rhs_val.raw->data, col.len);
+            memcpy(upper_key.data() + offset, eq->rhs_val.raw->data, col.len);
+            offset += col.len;
+        }
+        if (i < index_meta_.cols.size()) {
+            auto &col = index_meta_.cols[i];
+            const Condition *lower = find_cond(col, {OP_GT, OP_GE});
+            const Condition *upper = find_cond(col, {OP_LT, OP_LE});
+            fill_bound(lower_key.data() + offset, col, false);
+            fill_bound(upper_key.data() + offset, col, true);
+            if (lower != nullptr) {
+                memcpy(lower_key.data() + offset, lower->rhs_val.raw->data, col.len);
+                lower_inc = lower->op == OP_GE;
+            }
+            if (upper != nullptr) {
+                memcpy(upper_key.data() + offset, upper->rhs_val.raw->data, col.len);
+                upper_inc = upper->op == OP_LE;
+            }
+            offset += col.len;
+            for (i++; i < index_meta_.cols.size(); i++) {
+                auto &rest = index_meta_.cols[i];
+                // 开区间的下界要跳过与边界相等的全部键，因此其余字段按最大值填充，上界同理
+                fill_bound(lower_key.data() + offset, rest, !lower_inc);
+                fill_bound(upper_key.data() + offset, rest, upper_inc);
+                offset += rest.len;
+            }
+        }
+        Iid lower = lower_inc ? ih_->lower_bound(lower_key.data()) : ih_->upper_bound(lower_key.data());
+        Iid upper = upper_inc ? ih_->upper_bound(upper_key.data()) : ih_->lower_bound(upper_key.data());
+        end_gap_ = ih_->gap_rid(upper);
+        scan_ = std::make_unique<IxScan>(ih_, lower, upper, sm_manager_->get_bpm());
+        find_next();
     }
 
     void nextTuple() override {
-        
+        scan_->next();
+        find_next();
     }
 
-    std::unique_ptr<RmRecord> Next() override {
+    std::unique_ptr<RmRecord> Next() override { return fh_->get_record(rid_, context_); }
+
+    bool is_end() const override { return scan_->is_end(); }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "IndexScanExecutor"; }
+
+    Rid &rid() override { return rid_; }
+
+   private:
+    /* 从当前位置开始找到第一个满足全部条件的记录，扫描过的每个索引项都对其之前的间隙和记录加读锁 */
+    void find_next() {
+        for (; !scan_->is_end(); scan_->next()) {
+            rid_ = scan_->rid();
+            if (context_->txn_ != nullptr) {
+                context_->lock_mgr_->lock_shared_on_gap(context_->txn_, rid_, ih_->get_fd());
+            }
+            fh_->lock_record(rid_, context_, false);
+            auto rec = fh_->get_record(rid_, context_);
+            if (eval_conds(rec->data)) {
+                return;
+            }
+        }
+        // 范围之后的第一个间隙也要加锁，防止其他事务在最后一个键和范围上界之间插入
+        if (context_->txn_ != nullptr) {
+            context_->lock_mgr_->lock_shared_on_gap(context_->txn_, end_gap_, ih_->get_fd());
+        }
+    }
+
+    /* 在索引字段col上找到运算符为ops之一、右侧为常量的条件 */
+    const Condition *find_cond(const ColMeta &col, std::initializer_list<CompOp> ops) const {
+        for (auto &cond : fed_conds_) {
+            if (cond.is_rhs_val && cond.lhs_col.col_name == col.name &&
+                std::find(ops.begin(), ops.end(), cond.op) != ops.end()) {
+                return &cond;
+            }
+        }
         return nullptr;
     }
 
-    Rid &rid() override { return rid_; }
-};
\ No newline at end of file
+    /* 用字段col的最小值或最大值填充键的对应部分 */
+    static void fill_bound(char *dest, const ColMeta &col, bool max) {
+        if (col.type == TYPE_INT) {
+            int val = max ? INT32_MAX : INT32_MIN;
+            memcpy(dest, &val, sizeof(int));
+        } else if (col.type == TYPE_FLOAT) {
+            float val = max ? FLT_MAX : -FLT_MAX;
+            memcpy(dest, &val, sizeof(float));
+        } else {
+            memset(dest, max ? 0xff : 0, col.len);
+        }
+    }
+
+    /* 只检查本表字段上的条件，与其他表字段比较的连接条件由上层的连接算子检查 */
+    bool eval_conds(const char *rec) {
+        for (auto &cond : fed_conds_) {
+            if (!cond.is_rhs_val && cond.rhs_col.tab_name != tab_name_) {
+                continue;
+            }
+            auto lhs_col = tab_.get_col(cond.lhs_col.col_name);
+            const char *rhs = cond.is_rhs_val ? cond.rhs_val.raw->data
+                                              : rec + tab_.get_col(cond.rhs_col.col_name)->offset;
+            int cmp = ix_compare(rec + lhs_col->offset, rhs, lhs_col->type, lhs_col->len);
+            bool ok = false;
+            switch (cond.op) {
+                case OP_EQ: ok = cmp == 0; break;
+                case OP_NE: ok = cmp != 0; break;
+                case OP_LT: ok = cmp < 0; break;
+                case OP_GT: ok = cmp > 0; break;
+                case OP_LE: ok = cmp <= 0; break;
+                case OP_GE: ok = cmp >= 0; break;
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
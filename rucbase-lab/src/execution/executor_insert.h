@@ -33,13 +33,14 @@ class InsertExecutor : public AbstractExecutor {
         if (values.size() != tab_.cols.size()) {
             throw InvalidValueCountError();
         }
-        fh_ = sm_manager_->fhs_.at(tab_name).get();
+        // 分区表的数据文件要根据分区键的取值确定，加锁之后才获取文件句柄
+        fh_ = nullptr;
         context_ = context;
     };
 
     std::unique_ptr<RmRecord> Next() override {
-        // Make record buffer
-        RmRecord rec(fh_->get_file_hdr().record_size);
+        // 先按元数据中的字段生成记录，分区表根据分区键的取值确定要写的数据文件
+        std::vector<char> buf(tab_.get_record_size(), 0);
         for (size_t i = 0; i < values_.size(); i++) {
             auto &col = tab_.cols[i];
             auto &val = values_[i];
@@ -47,23 +48,52 @@ class InsertExecutor : public AbstractExecutor {
                 throw IncompatibleTypeError(coltype2str(col.type), coltype2str(val.type));
             }
             val.init_raw(col.len);
-            memcpy(rec.data + col.offset, val.raw->data, col.len);
+            memcpy(buf.data() + col.offset, val.raw->data, col.len);
         }
-        // Insert into record file
-        rid_ = fh_->insert_record(rec.data, context_);
-        
-        // Insert into index
-        for(size_t i = 0; i < tab_.indexes.size(); ++i) {
-            auto& index = tab_.indexes[i];
-            auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
-            char* key = new char[index.col_tot_len];
+        auto file_name = tab_.locate_file(buf.data());
+        // 先加表意向写锁，再持有元数据共享锁，保证写入期间表上的索引集合不变
+        auto meta_lock = sm_manager_->lock_file_for_write(file_name, context_);
+        fh_ = sm_manager_->get_file_handle(file_name);
+        // 增加字段之后数据文件中的记录可能比元数据中的长，多出的部分不属于任何字段
+        RmRecord rec(fh_->get_file_hdr().record_size);
+        memset(rec.data, 0, rec.size);
+        memcpy(rec.data, buf.data(), std::min<size_t>(rec.size, buf.size()));
+        // 在线创建的索引可能在算子构造之后才发布，因此从元数据中重新读取
+        // 先生成索引键并对插入位置的间隙加锁，加锁失败时还没有修改任何数据
+        auto &indexes = sm_manager_->db_.get_table(tab_name_).indexes;
+        std::vector<std::vector<char>> keys;
+        for (auto &index : indexes) {
+            auto ih = sm_manager_->get_index_handle(file_name, index.cols);
+            std::vector<char> key(index.col_tot_len);
             int offset = 0;
-            for(size_t i = 0; i < index.col_num; ++i) {
-                memcpy(key + offset, rec.data + index.cols[i].offset, index.cols[i].len);
+            for (int i = 0; i < index.col_num; ++i) {
+                memcpy(key.data() + offset, rec.data + index.cols[i].offset, index.cols[i].len);
                 offset += index.cols[i].len;
             }
-            ih->insert_entry(key, rid_, context_->txn_);
+            lock_gap_for_insert(ih, key.data());
+            keys.push_back(std::move(key));
+        }
+
+        // Insert into record file，页面固定到写完日志并记入page lsn之后，保证页面写盘前日志已经写盘
+        Page *page = fh_->pin_insert_page();
+        rid_ = fh_->insert_record(rec.data, context_);
+        // 记录写操作，用于事务回滚和物化视图的增量维护，加入写集合之后后续步骤出错时语句回滚可以撤销这次插入
+        auto write_rec = std::make_unique<WriteRecord>(WType::INSERT_TUPLE, file_name, rid_);
+        WriteRecord &write = *write_rec;
+        if (context_->txn_ != nullptr) {
+            context_->log_mgr_->add_write_log(context_->txn_, write_rec.get(), rec.data, fh_);
+            context_->txn_->append_write_record(write_rec.release());
+        }
+        fh_->unpin_page(page);
+        fh_->lock_record(rid_, context_, true);
+
+        // Insert into index，索引页面的page lsn取已经分配的最大日志号，因此修改索引在写日志之后
+        for (size_t k = 0; k < indexes.size(); ++k) {
+            auto ih = sm_manager_->get_index_handle(file_name, indexes[k].cols);
+            ih->insert_entry(keys[k].data(), rid_, context_->txn_);
         }
+        sm_manager_->record_index_change(file_name, rec.data, rid_, true);
+        sm_manager_->get_view_maintainer()->apply(write, context_);
         return nullptr;
     }
     Rid &rid() override { return rid_; }
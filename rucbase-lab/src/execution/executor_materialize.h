@@ -0,0 +1,53 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @description: 输出已经物化的记录，用于自适应执行中已物化的连接输入
+ * 记录由MaterializePlan持有，嵌套循环连接重复扫描内层输入时不需要重新执行其子计划
+ */
+class MaterializeExecutor : public AbstractExecutor {
+   private:
+    std::vector<ColMeta> cols_;                                     // 输出的字段
+    size_t len_;                                                    // 输出的每条记录的长度
+    std::shared_ptr<std::vector<std::unique_ptr<RmRecord>>> rows_;  // 物化得到的记录
+    size_t curr_;                                                   // 当前输出的记录下标
+
+   public:
+    MaterializeExecutor(std::vector<ColMeta> cols, size_t len,
+                        std::shared_ptr<std::vector<std::unique_ptr<RmRecord>>> rows) {
+        cols_ = std::move(cols);
+        len_ = len;
+        rows_ = std::move(rows);
+        curr_ = 0;
+    }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "MaterializeExecutor"; }
+
+    void beginTuple() override { curr_ = 0; }
+
+    void nextTuple() override { curr_++; }
+
+    bool is_end() const override { return curr_ >= rows_->size(); }
+
+    std::unique_ptr<RmRecord> Next() override { return std::make_unique<RmRecord>(*(*rows_)[curr_]); }
+
+    Rid &rid() override { return _abstract_rid; }
+};
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 class SeqScanExecutor : public AbstractExecutor {
    private:
     std::string tab_name_;              // 表的名称
+    std::string file_name_;             // 扫描的数据文件名，分区表为其中一个分区的数据文件名
     std::vector<Condition> conds_;      // scan的条件
     RmFileHandle *fh_;                  // 表的数据文件句柄
     std::vector<ColMeta> cols_;         // scan后生成的记录的字段
@@ -31,12 +32,14 @@ class SeqScanExecutor : public AbstractExecutor {
     SmManager *sm_manager_;
 
    public:
-    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context) {
+    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::string file_name, std::vector<Condition> conds,
+                    Context *context) {
         sm_manager_ = sm_manager;
         tab_name_ = std::move(tab_name);
+        file_name_ = std::move(file_name);
         conds_ = std::move(conds);
         TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
-        fh_ = sm_manager_->fhs_.at(tab_name_).get();
+        fh_ = sm_manager_->get_file_handle(file_name_);
         cols_ = tab.cols;
         len_ = cols_.back().offset + cols_.back().len;
 
@@ -19,28 +19,170 @@ class UpdateExecutor : public AbstractExecutor {
    private:
     TabMeta tab_;
     std::vector<Condition> conds_;
+    std::vector<ExprCondition> expr_conds_;     // 扫描之后还需要对每条记录求值的where条件
     RmFileHandle *fh_;
     std::vector<Rid> rids_;
     std::string tab_name_;
+    std::string file_name_;     // 数据文件名，分区表为rids_所在分区的数据文件名
     std::vector<SetClause> set_clauses_;
     SmManager *sm_manager_;
 
    public:
-    UpdateExecutor(SmManager *sm_manager, const std::string &tab_name, std::vector<SetClause> set_clauses,
-                   std::vector<Condition> conds, std::vector<Rid> rids, Context *context) {
+    UpdateExecutor(SmManager *sm_manager, const std::string &tab_name, const std::string &file_name,
+                   std::vector<SetClause> set_clauses, std::vector<Condition> conds,
+                   std::vector<ExprCondition> expr_conds, std::vector<Rid> rids, Context *context) {
         sm_manager_ = sm_manager;
         tab_name_ = tab_name;
+        file_name_ = file_name;
         set_clauses_ = set_clauses;
         tab_ = sm_manager_->db_.get_table(tab_name);
-        fh_ = sm_manager_->fhs_.at(tab_name).get();
+        fh_ = sm_manager_->get_file_handle(file_name);
         conds_ = conds;
+        expr_conds_ = std::move(expr_conds);
         rids_ = rids;
         context_ = context;
     }
     std::unique_ptr<RmRecord> Next() override {
-        
+        // 先加表意向写锁，再持有元数据共享锁，保证更新期间表上的索引集合不变
+        auto meta_lock = sm_manager_->lock_file_for_write(file_name_, context_);
+        fh_ = sm_manager_->get_file_handle(file_name_);
+        auto &indexes = sm_manager_->db_.get_table(tab_name_).indexes;
+        // 先在修改前的记录上求出所有新记录，表达式求值出错时语句不修改任何记录
+        std::vector<Rid> rids;
+        std::vector<std::unique_ptr<RmRecord>> old_recs;
+        std::vector<std::unique_ptr<RmRecord>> new_recs;
+        for (auto &rid : rids_) {
+            fh_->lock_record(rid, context_, true);
+            auto rec = fh_->get_record(rid, context_);
+            if (!std::all_of(expr_conds_.begin(), expr_conds_.end(),
+                             [&](const ExprCondition &cond) { return cond.eval(rec->data); })) {
+                continue;
+            }
+            auto new_rec = std::make_unique<RmRecord>(*rec);
+            for (auto &set_clause : set_clauses_) {
+                auto col = tab_.get_col(set_clause.lhs.col_name);
+                if (set_clause.rhs_expr != nullptr) {
+                    ExprCell res = set_clause.rhs_expr->eval(rec->data);
+                    memcpy(new_rec->data + col->offset, &res, col->len);
+                } else {
+                    memcpy(new_rec->data + col->offset, set_clause.rhs.raw->data, col->len);
+                }
+            }
+            rids.push_back(rid);
+            old_recs.push_back(std::move(rec));
+            new_recs.push_back(std::move(new_rec));
+        }
+        for (size_t k = 0; k < rids.size(); k++) {
+            auto &rid = rids[k];
+            auto &rec = old_recs[k];
+            auto &new_rec = *new_recs[k];
+            if (!fh_->fits_in_place(rid, new_rec.data)) {
+                relocate(rid, *rec, new_rec, indexes);
+                continue;
+            }
+            // 只有索引字段发生变化时才需要更新索引项，先对涉及的间隙加锁，加锁失败时还没有修改任何数据
+            std::vector<std::pair<std::vector<char>, std::vector<char>>> keys;
+            for (auto &index : indexes) {
+                auto ih = sm_manager_->get_index_handle(file_name_, index.cols);
+                std::vector<char> old_key(index.col_tot_len);
+                std::vector<char> new_key(index.col_tot_len);
+                int offset = 0;
+                for (int i = 0; i < index.col_num; ++i) {
+                    memcpy(old_key.data() + offset, rec->data + index.cols[i].offset, index.cols[i].len);
+                    memcpy(new_key.data() + offset, new_rec.data + index.cols[i].offset, index.cols[i].len);
+                    offset += index.cols[i].len;
+                }
+                if (old_key != new_key) {
+                    lock_gap_for_delete(ih, rid);
+                    lock_gap_for_insert(ih, new_key.data());
+                }
+                keys.emplace_back(std::move(old_key), std::move(new_key));
+            }
+            // 页面固定到写完日志并记入page lsn之后，保证页面写盘前日志已经写盘
+            Page *page = fh_->pin_page(rid.page_no);
+            fh_->update_record(rid, new_rec.data, context_);
+            // 记录写操作，用于事务回滚和物化视图的增量维护，加入写集合之后后续步骤出错时语句回滚可以撤销这次更新
+            auto write_rec = std::make_unique<WriteRecord>(WType::UPDATE_TUPLE, file_name_, rid, *rec);
+            WriteRecord &write = *write_rec;
+            if (context_->txn_ != nullptr) {
+                context_->log_mgr_->add_write_log(context_->txn_, write_rec.get(), new_rec.data, fh_);
+                context_->txn_->append_write_record(write_rec.release());
+            }
+            fh_->unpin_page(page);
+            // 索引页面的page lsn取已经分配的最大日志号，因此修改索引在写日志之后
+            for (size_t j = 0; j < indexes.size(); ++j) {
+                auto &[old_key, new_key] = keys[j];
+                if (old_key != new_key) {
+                    auto ih = sm_manager_->get_index_handle(file_name_, indexes[j].cols);
+                    ih->delete_entry(old_key.data(), context_->txn_);
+                    ih->insert_entry(new_key.data(), rid, context_->txn_);
+                }
+            }
+            sm_manager_->record_index_change(file_name_, rec->data, rid, false);
+            sm_manager_->record_index_change(file_name_, new_rec.data, rid, true);
+            sm_manager_->get_view_maintainer()->apply(write, context_);
+        }
         return nullptr;
     }
 
     Rid &rid() override { return _abstract_rid; }
+
+   private:
+    /**
+     * @description: 增加字段之前的页面只能保存新增字段为默认值的记录，更新后的记录改为插入到当前格式的页面中，再删除原记录
+     * 写集合和日志中记录为一次删除和一次插入，回滚和重做与普通的删除、插入相同
+     * @param {Rid&} rid 原记录的位置
+     * @param {RmRecord&} rec 原记录
+     * @param {RmRecord&} new_rec 更新后的记录
+     * @param {vector<IndexMeta>&} indexes 表上的索引
+     */
+    void relocate(const Rid &rid, const RmRecord &rec, RmRecord &new_rec, const std::vector<IndexMeta> &indexes) {
+        std::vector<std::pair<std::vector<char>, std::vector<char>>> keys;
+        for (auto &index : indexes) {
+            auto ih = sm_manager_->get_index_handle(file_name_, index.cols);
+            std::vector<char> old_key(index.col_tot_len);
+            std::vector<char> new_key(index.col_tot_len);
+            int offset = 0;
+            for (int i = 0; i < index.col_num; ++i) {
+                memcpy(old_key.data() + offset, rec.data + index.cols[i].offset, index.cols[i].len);
+                memcpy(new_key.data() + offset, new_rec.data + index.cols[i].offset, index.cols[i].len);
+                offset += index.cols[i].len;
+            }
+            lock_gap_for_delete(ih, rid);
+            lock_gap_for_insert(ih, new_key.data());
+            keys.emplace_back(std::move(old_key), std::move(new_key));
+        }
+
+        // 插入和删除各自在固定页面期间写日志，顺序与普通的插入、删除相同
+        Page *page = fh_->pin_insert_page();
+        Rid new_rid = fh_->insert_record(new_rec.data, context_);
+        auto insert_rec = std::make_unique<WriteRecord>(WType::INSERT_TUPLE, file_name_, new_rid);
+        WriteRecord &insert = *insert_rec;
+        if (context_->txn_ != nullptr) {
+            context_->log_mgr_->add_write_log(context_->txn_, insert_rec.get(), new_rec.data, fh_);
+            context_->txn_->append_write_record(insert_rec.release());
+        }
+        fh_->unpin_page(page);
+        fh_->lock_record(new_rid, context_, true);
+
+        page = fh_->pin_page(rid.page_no);
+        fh_->delete_record(rid, context_);
+        auto delete_rec = std::make_unique<WriteRecord>(WType::DELETE_TUPLE, file_name_, rid, rec);
+        WriteRecord &del = *delete_rec;
+        if (context_->txn_ != nullptr) {
+            context_->log_mgr_->add_write_log(context_->txn_, delete_rec.get(), nullptr, fh_);
+            context_->txn_->append_write_record(delete_rec.release());
+        }
+        fh_->unpin_page(page);
+
+        for (size_t j = 0; j < indexes.size(); ++j) {
+            auto ih = sm_manager_->get_index_handle(file_name_, indexes[j].cols);
+            ih->delete_entry(keys[j].first.data(), context_->txn_);
+            ih->insert_entry(keys[j].second.data(), new_rid, context_->txn_);
+        }
+        sm_manager_->record_index_change(file_name_, rec.data, rid, false);
+        sm_manager_->record_index_change(file_name_, new_rec.data, new_rid, true);
+        sm_manager_->get_view_maintainer()->apply(del, context_);
+        sm_manager_->get_view_maintainer()->apply(insert, context_);
+    }
 };
\ No newline at end of file
@@ -21,6 +21,7 @@ constexpr int IX_LEAF_HEADER_PAGE = 1;
 constexpr int IX_INIT_ROOT_PAGE = 2;
 constexpr int IX_INIT_NUM_PAGES = 3;
 constexpr int IX_MAX_COL_LEN = 512;
+constexpr int IX_PAGE_FORMAT = 1;     // 索引结点页面的格式版本，1：页头以page_lsn开始，之前的版本没有page_lsn
 
 class IxFileHdr {
 public: 
@@ -129,7 +130,8 @@ public:
 
 class IxPageHdr {
 public:
-    page_id_t next_free_page_no;    // unused
+    lsn_t page_lsn;                 // 与Page::OFFSET_LSN对齐，页面写盘前日志要刷到该日志号
+    page_id_t next_free_page_no;    // 被删除的结点串成空闲页面链表，指向下一个空闲页面
     page_id_t parent;               // 父亲节点所在页面的叶号
     int num_key;                    // # current keys (always equals to #child - 1) 已插入的keys数量，key_idx∈[0,num_key)
     bool is_leaf;                   // 是否为叶节点
@@ -151,8 +151,7 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
     file_hdr_->deserialize(buf);
     
     // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
-    int now_page_no = disk_manager_->get_fd2pageno(fd);
-    disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+    disk_manager_->set_fd2pageno(fd, file_hdr_->num_pages_);
 }
 
 /**
@@ -249,6 +248,86 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
     return -1;
 }
 
+/**
+ * @brief 将按key递增排序且不含重复key的键值对批量装入空的B+树
+ * 先把键值对平均分配到若干叶子结点中，再以每个结点的第一个key自底向上逐层构建内部结点，
+ * 除根结点外每个结点都不少于get_min_size()个键值对，装载过程不需要查找和分裂结点
+ *
+ * @param keys 连续存放的num_entries个key
+ * @param rids 与keys一一对应的rid
+ * @param num_entries 键值对数量
+ */
+void IxIndexHandle::bulk_load(const char *keys, const Rid *rids, int num_entries) {
+    assert(file_hdr_->root_page_ == IX_INIT_ROOT_PAGE && file_hdr_->first_leaf_ == IX_INIT_ROOT_PAGE);
+    if (num_entries == 0) {
+        return;
+    }
+    int key_len = file_hdr_->col_tot_len_;
+    // 当前层的键值对，叶子层为索引项，内部层为(孩子结点的第一个key, 孩子结点页号)
+    std::vector<char> level_keys(keys, keys + (size_t)num_entries * key_len);
+    std::vector<Rid> level_rids(rids, rids + num_entries);
+    bool is_leaf = true;
+    while (true) {
+        int n = level_rids.size();
+        int num_nodes = (n + file_hdr_->btree_order_ - 1) / file_hdr_->btree_order_;
+        std::vector<char> parent_keys;
+        std::vector<Rid> parent_rids;
+        IxNodeHandle *prev_leaf = nullptr;
+        int offset = 0;
+        for (int i = 0; i < num_nodes; i++) {
+            int size = n / num_nodes + (i < n % num_nodes ? 1 : 0);
+            // 原有的空根结点作为第一个叶子结点
+            IxNodeHandle *node = (is_leaf && i == 0) ? fetch_node(IX_INIT_ROOT_PAGE) : create_node();
+            node->page_hdr->next_free_page_no = IX_NO_PAGE;
+            node->page_hdr->parent = IX_NO_PAGE;
+            node->page_hdr->is_leaf = is_leaf;
+            memcpy(node->get_key(0), level_keys.data() + (size_t)offset * key_len, (size_t)size * key_len);
+            memcpy(node->get_rid(0), level_rids.data() + offset, size * sizeof(Rid));
+            node->set_size(size);
+            if (is_leaf) {
+                node->set_prev_leaf(prev_leaf == nullptr ? IX_LEAF_HEADER_PAGE : prev_leaf->get_page_no());
+                node->set_next_leaf(IX_LEAF_HEADER_PAGE);
+                if (prev_leaf != nullptr) {
+                    prev_leaf->set_next_leaf(node->get_page_no());
+                    buffer_pool_manager_->unpin_page(prev_leaf->get_page_id(), true);
+                    delete prev_leaf;
+                }
+                prev_leaf = node;
+            } else {
+                for (int j = 0; j < size; j++) {
+                    maintain_child(node, j);
+                }
+            }
+            parent_keys.insert(parent_keys.end(), node->get_key(0), node->get_key(0) + key_len);
+            parent_rids.push_back(Rid{.page_no = node->get_page_no(), .slot_no = -1});
+            if (!is_leaf) {
+                buffer_pool_manager_->unpin_page(node->get_page_id(), true);
+                delete node;
+            }
+            offset += size;
+        }
+        if (is_leaf) {
+            file_hdr_->first_leaf_ = parent_rids.front().page_no;
+            file_hdr_->last_leaf_ = prev_leaf->get_page_no();
+            buffer_pool_manager_->unpin_page(prev_leaf->get_page_id(), true);
+            delete prev_leaf;
+            // 叶子链表的头结点
+            IxNodeHandle *header = fetch_node(IX_LEAF_HEADER_PAGE);
+            header->set_next_leaf(file_hdr_->first_leaf_);
+            header->set_prev_leaf(file_hdr_->last_leaf_);
+            buffer_pool_manager_->unpin_page(header->get_page_id(), true);
+            delete header;
+        }
+        if (num_nodes == 1) {
+            update_root_page_no(parent_rids[0].page_no);
+            break;
+        }
+        level_keys = std::move(parent_keys);
+        level_rids = std::move(parent_rids);
+        is_leaf = false;
+    }
+}
+
 /**
  * @brief 用于删除B+树中含有指定key的键值对
  * @param key 要删除的key值
@@ -300,6 +379,7 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
     // 1. 如果old_root_node是内部结点，并且大小为1，则直接把它的孩子更新成新的根结点
     // 2. 如果old_root_node是叶结点，且大小为0，则直接更新root page
     // 3. 除了上述两种情况，不需要进行操作
+    // 提示：被删除的原根结点调用release_node_handle放入空闲页面链表
 
     return false;
 }
@@ -345,7 +425,8 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
     // Todo:
     // 1. 用index判断neighbor_node是否为node的前驱结点，若不是则交换两个结点，让neighbor_node作为左结点，node作为右结点
     // 2. 把node结点的键值对移动到neighbor_node中，并更新node结点孩子结点的父节点信息（调用maintain_child函数）
-    // 3. 释放和删除node结点，并删除parent中node结点的信息，返回parent是否需要被删除
+    // 3. 释放和删除node结点（调用release_node_handle，把它的页面放入空闲页面链表），并删除parent中node结点的信息，
+    //    返回parent是否需要被删除
     // 提示：如果是叶子结点且为最右叶子结点，需要更新file_hdr_.last_leaf
 
     return false;
@@ -417,6 +498,53 @@ Iid IxIndexHandle::leaf_begin() const {
     return iid;
 }
 
+/**
+ * @brief 获取iid指向的索引项之前的间隙的标识，即该索引项指向的记录
+ * iid位于非最后一个叶子的末尾时指向下一个叶子的第一个索引项，位于leaf_end时返回{-1, -1}
+ *
+ * @param iid
+ * @return Rid
+ */
+Rid IxIndexHandle::gap_rid(const Iid &iid) const {
+    Iid pos = iid;
+    while (pos.page_no != file_hdr_->last_leaf_) {
+        IxNodeHandle *node = fetch_node(pos.page_no);
+        bool at_end = pos.slot_no >= node->get_size();
+        page_id_t next_leaf = node->get_next_leaf();
+        buffer_pool_manager_->unpin_page(node->get_page_id(), false);  // unpin it!
+        if (!at_end) {
+            break;
+        }
+        pos = {.page_no = next_leaf, .slot_no = 0};
+    }
+    if (pos == leaf_end()) {
+        return Rid{.page_no = -1, .slot_no = -1};
+    }
+    return get_rid(pos);
+}
+
+/**
+ * @brief 获取插入key时所在的间隙的标识，即第一个大于key的索引项指向的记录
+ *
+ * @param key
+ * @return Rid
+ */
+Rid IxIndexHandle::next_key_rid(const char *key) {
+    return gap_rid(upper_bound(key));
+}
+
+/**
+ * @brief 把结点的page lsn提高到已经分配的最大日志号
+ * 索引的修改不单独写日志，修改索引的操作在写完数据的日志之后获取结点，结点写盘前这条日志一定已经写盘
+ * 并发获取同一结点的线程可能交错，只保留较大的日志号
+ */
+static void stamp_page_lsn(Page *page, lsn_t lsn) {
+    auto page_lsn = reinterpret_cast<std::atomic<lsn_t> *>(page->get_data() + Page::OFFSET_LSN);
+    lsn_t cur = page_lsn->load();
+    while (cur < lsn && !page_lsn->compare_exchange_weak(cur, lsn)) {
+    }
+}
+
 /**
  * @brief 获取一个指定结点
  *
@@ -426,6 +554,10 @@ Iid IxIndexHandle::leaf_begin() const {
  */
 IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const {
     Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, page_no});
+    if (page == nullptr) {
+        throw PageNotExistError(disk_manager_->get_file_name(fd_), page_no);
+    }
+    stamp_page_lsn(page, buffer_pool_manager_->get_last_lsn());
     IxNodeHandle *node = new IxNodeHandle(file_hdr_, page);
     
     return node;
@@ -440,14 +572,22 @@ IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const {
  * 而first_free_page实际上就是最新被删除的页面，初始为IX_NO_PAGE
  * 在最开始插入时，一直是create node，那么first_page_no一直没变，一直是IX_NO_PAGE
  * 与Record的处理不同，Record将未插入满的记录页认为是free_page
+ * 有被删除的页面时优先复用，复用的页面清零后与新分配的页面相同，file_hdr_.num_pages只在分配新页面时增加
  */
 IxNodeHandle *IxIndexHandle::create_node() {
     IxNodeHandle *node;
-    file_hdr_->num_pages_++;
-
-    PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
-    // 从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
-    Page *page = buffer_pool_manager_->new_page(&new_page_id);
+    Page *page;
+    if (file_hdr_->first_free_page_no_ != IX_NO_PAGE) {
+        page = buffer_pool_manager_->fetch_page(PageId{fd_, file_hdr_->first_free_page_no_});
+        file_hdr_->first_free_page_no_ = reinterpret_cast<IxPageHdr *>(page->get_data())->next_free_page_no;
+        memset(page->get_data(), 0, PAGE_SIZE);
+    } else {
+        file_hdr_->num_pages_++;
+        PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
+        // 从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
+        page = buffer_pool_manager_->new_page(&new_page_id);
+    }
+    stamp_page_lsn(page, buffer_pool_manager_->get_last_lsn());
     node = new IxNodeHandle(file_hdr_, page);
     return node;
 }
@@ -494,12 +634,16 @@ void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
 }
 
 /**
- * @brief 删除node时，更新file_hdr_.num_pages
+ * @brief 删除node时，把node所在的页面放入空闲页面链表的表头，之后create_node优先复用它
+ * 页面仍然属于文件，file_hdr_.num_pages不变；调用者需要把node所在的页面作为脏页unpin
+ * 空闲页面链表随文件头在检查点和关闭索引时写盘，不单独写日志：检查点之后索引只随数据文件的修改而修改，
+ * 这些修改都有日志，故障恢复时重做过的数据文件上的索引整体重建，其他索引的文件头和页面都是检查点时的状态
  *
  * @param node
  */
 void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
-    file_hdr_->num_pages_--;
+    node.page_hdr->next_free_page_no = file_hdr_->first_free_page_no_;
+    file_hdr_->first_free_page_no_ = node.get_page_no();
 }
 
 /**
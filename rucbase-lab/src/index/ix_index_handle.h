@@ -185,6 +185,9 @@ class IxIndexHandle {
 
     void insert_into_parent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node, Transaction *transaction);
 
+    // for bulk load
+    void bulk_load(const char *keys, const Rid *rids, int num_entries);
+
     // for delete
     bool delete_entry(const char *key, Transaction *transaction);
 
@@ -205,6 +208,17 @@ class IxIndexHandle {
 
     Iid leaf_begin() const;
 
+    Rid gap_rid(const Iid &iid) const;
+
+    Rid next_key_rid(const char *key);
+
+    int get_fd() const { return fd_; }
+
+    IxFileHdr *get_file_hdr() const { return file_hdr_; }
+
+    /* B+树的写操作从根结点开始加锁，持有root_latch_期间树的结构不会改变 */
+    std::mutex &get_root_latch() { return root_latch_; }
+
    private:
     // 辅助函数
     void update_root_page_no(page_id_t root) { file_hdr_->root_page_ = root; }
@@ -101,6 +101,7 @@ class IxManager {
             memset(page_buf, 0, PAGE_SIZE);
             auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
             *phdr = {
+                .page_lsn = INVALID_LSN,
                 .next_free_page_no = IX_NO_PAGE,
                 .parent = IX_NO_PAGE,
                 .num_key = 0,
@@ -116,6 +117,7 @@ class IxManager {
             memset(page_buf, 0, PAGE_SIZE);
             auto phdr = reinterpret_cast<IxPageHdr *>(page_buf);
             *phdr = {
+                .page_lsn = INVALID_LSN,
                 .next_free_page_no = IX_NO_PAGE,
                 .parent = IX_NO_PAGE,
                 .num_key = 0,
@@ -156,6 +158,16 @@ class IxManager {
         return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
     }
 
+    /**
+     * @description: 把索引的文件头写盘，用于检查点，调用者需要持有索引的root_latch_，保证文件头与已经写盘的结点一致
+     * @param {IxIndexHandle*} ih 索引句柄
+     */
+    void flush_file_hdr(const IxIndexHandle *ih) {
+        std::vector<char> data(ih->file_hdr_->tot_len_);
+        ih->file_hdr_->serialize(data.data());
+        disk_manager_->write_page(ih->fd_, IX_FILE_HDR_PAGE, data.data(), ih->file_hdr_->tot_len_);
+    }
+
     void close_index(const IxIndexHandle *ih) {
         char* data = new char[ih->file_hdr_->tot_len_];
         ih->file_hdr_->serialize(data);
@@ -38,12 +38,25 @@ class Optimizer {
         } else if (auto x = std::dynamic_pointer_cast<ast::ShowTables>(query->parse)) {
             // show tables;
             return std::make_shared<OtherPlan>(T_ShowTable, std::string());
+        } else if (auto x = std::dynamic_pointer_cast<ast::ShowMetrics>(query->parse)) {
+            // show metrics;
+            return std::make_shared<OtherPlan>(T_ShowMetrics, std::string());
+        } else if (auto x = std::dynamic_pointer_cast<ast::SetVar>(query->parse)) {
+            // set name = value;
+            return std::make_shared<SetVarPlan>(x->name, x->value);
+        } else if (auto x = std::dynamic_pointer_cast<ast::Backup>(query->parse)) {
+            // backup to 'path';
+            return std::make_shared<OtherPlan>(T_Backup, x->path);
+        } else if (auto x = std::dynamic_pointer_cast<ast::Vacuum>(query->parse)) {
+            // vacuum table;
+            return std::make_shared<OtherPlan>(T_Vacuum, x->tab_name);
         } else if (auto x = std::dynamic_pointer_cast<ast::DescTable>(query->parse)) {
             // desc table;
             return std::make_shared<OtherPlan>(T_DescTable, x->tab_name);
         } else if (auto x = std::dynamic_pointer_cast<ast::TxnBegin>(query->parse)) {
-            // begin;
-            return std::make_shared<OtherPlan>(T_Transaction_begin, std::string());
+            // begin; begin read only;
+            return std::make_shared<OtherPlan>(x->read_only ? T_Transaction_begin_read_only : T_Transaction_begin,
+                                               std::string());
         } else if (auto x = std::dynamic_pointer_cast<ast::TxnAbort>(query->parse)) {
             // abort;
             return std::make_shared<OtherPlan>(T_Transaction_abort, std::string());
@@ -53,6 +66,15 @@ class Optimizer {
         } else if (auto x = std::dynamic_pointer_cast<ast::TxnRollback>(query->parse)) {
             // rollback;
             return std::make_shared<OtherPlan>(T_Transaction_rollback, std::string());
+        } else if (auto x = std::dynamic_pointer_cast<ast::Savepoint>(query->parse)) {
+            // savepoint name;
+            return std::make_shared<SavepointPlan>(T_Savepoint, x->name);
+        } else if (auto x = std::dynamic_pointer_cast<ast::RollbackToSavepoint>(query->parse)) {
+            // rollback to savepoint name;
+            return std::make_shared<SavepointPlan>(T_RollbackToSavepoint, x->name);
+        } else if (auto x = std::dynamic_pointer_cast<ast::ReleaseSavepoint>(query->parse)) {
+            // release savepoint name;
+            return std::make_shared<SavepointPlan>(T_ReleaseSavepoint, x->name);
         } else {
             return planner_->do_planner(query, context);
         }
@@ -23,23 +23,42 @@ typedef enum PlanTag{
     T_Invalid = 1,
     T_Help,
     T_ShowTable,
+    T_ShowMetrics,
+    T_SetVar,
+    T_Backup,
+    T_Vacuum,
     T_DescTable,
     T_CreateTable,
     T_DropTable,
+    T_TruncateTable,
     T_CreateIndex,
     T_DropIndex,
+    T_CreateMatView,
+    T_DropMatView,
+    T_AddPartition,
+    T_DropPartition,
+    T_AddColumn,
+    T_DropColumn,
+    T_CreateProcedure,
+    T_DropProcedure,
+    T_Call,
     T_Insert,
     T_Update,
     T_Delete,
     T_select,
     T_Transaction_begin,
+    T_Transaction_begin_read_only,
     T_Transaction_commit,
     T_Transaction_abort,
     T_Transaction_rollback,
+    T_Savepoint,
+    T_RollbackToSavepoint,
+    T_ReleaseSavepoint,
     T_SeqScan,
     T_IndexScan,
     T_NestLoop,
     T_Sort,
+    T_Materialize,
     T_Projection
 } PlanTag;
 
@@ -64,6 +83,7 @@ class ScanPlan : public Plan
             len_ = cols_.back().offset + cols_.back().len;
             fed_conds_ = conds_;
             index_col_names_ = index_col_names;
+            files_ = tab.get_files();
         
         }
         ~ScanPlan(){}
@@ -74,6 +94,7 @@ class ScanPlan : public Plan
         size_t len_;                               
         std::vector<Condition> fed_conds_;
         std::vector<std::string> index_col_names_;
+        std::vector<std::string> files_;    // 需要扫描的数据文件，分区表经过分区裁剪后只包含可能满足条件的分区
     
 };
 
@@ -100,6 +121,25 @@ class JoinPlan : public Plan
         
 };
 
+// 执行时已经物化的连接输入，自适应执行用它的实际行数代替估计值重新规划剩余的连接
+class MaterializePlan : public Plan
+{
+    public:
+        MaterializePlan(PlanTag tag, std::shared_ptr<Plan> subplan, std::vector<ColMeta> cols, size_t len)
+        {
+            Plan::tag = tag;
+            subplan_ = std::move(subplan);
+            cols_ = std::move(cols);
+            len_ = len;
+            rows_ = std::make_shared<std::vector<std::unique_ptr<RmRecord>>>();
+        }
+        ~MaterializePlan(){}
+        std::shared_ptr<Plan> subplan_;     // 被物化的计划
+        std::vector<ColMeta> cols_;
+        size_t len_;
+        std::shared_ptr<std::vector<std::unique_ptr<RmRecord>>> rows_;  // 物化得到的记录，与执行算子共享
+};
+
 class ProjectionPlan : public Plan
 {
     public:
@@ -153,9 +193,11 @@ class DMLPlan : public Plan
         std::vector<Value> values_;
         std::vector<Condition> conds_;
         std::vector<SetClause> set_clauses_;
+        std::vector<ExprCondition> expr_conds_;     // update中需要对每条记录求值的where条件
 };
 
-// ddl语句, 包括create/drop table; create/drop index;
+// ddl语句, 包括create/drop table; create/drop index; create/drop materialized view; add/drop partition;
+// create/drop procedure;
 class DDLPlan : public Plan
 {
     public:
@@ -170,6 +212,25 @@ class DDLPlan : public Plan
         std::string tab_name_;
         std::vector<std::string> tab_col_names_;
         std::vector<ColDef> cols_;
+        ViewMeta view_;     // create materialized view 的视图定义
+        PartitionMeta part_;    // create table 的分区定义，add/drop partition 时只包含该分区
+        ProcMeta proc_;         // create procedure 的存储过程定义
+        std::vector<Value> values_;     // add column 的默认值，没有默认值时为空
+};
+
+// call语句对应的plan，存储过程中的语句在执行时逐条分析和优化
+class CallPlan : public Plan
+{
+    public:
+        CallPlan(std::vector<std::shared_ptr<ast::TreeNode>> stmts, std::vector<Value> args)
+        {
+            Plan::tag = T_Call;
+            stmts_ = std::move(stmts);
+            args_ = std::move(args);
+        }
+        ~CallPlan(){}
+        std::vector<std::shared_ptr<ast::TreeNode>> stmts_;
+        std::vector<Value> args_;
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -185,6 +246,26 @@ class OtherPlan : public Plan
         std::string tab_name_;
 };
 
+/* SET语句，修改名为var_name_的运行时参数 */
+class SetVarPlan : public OtherPlan
+{
+    public:
+        SetVarPlan(std::string var_name, std::string value)
+            : OtherPlan(T_SetVar, std::string()), var_name_(std::move(var_name)), value_(std::move(value)) {}
+        ~SetVarPlan(){}
+        std::string var_name_;
+        std::string value_;
+};
+
+/* SAVEPOINT、ROLLBACK TO SAVEPOINT和RELEASE SAVEPOINT语句，name_为保存点名称 */
+class SavepointPlan : public OtherPlan
+{
+    public:
+        SavepointPlan(PlanTag tag, std::string name) : OtherPlan(tag, std::string()), name_(std::move(name)) {}
+        ~SavepointPlan(){}
+        std::string name_;
+};
+
 class plannerInfo{
     public:
     std::shared_ptr<ast::SelectStmt> parse;
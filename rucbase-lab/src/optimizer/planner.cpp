@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #include "planner.h"
 
 #include <memory>
+#include <set>
 
 #include "execution/executor_delete.h"
 #include "execution/executor_index_scan.h"
@@ -21,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include "execution/executor_update.h"
 #include "index/ix.h"
 #include "record_printer.h"
+#include "rewriter.h"
 
 // 目前的索引匹配规则为：完全匹配索引字段，且全部为单点查询，不会自动调整where条件的顺序
 bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_conds, std::vector<std::string>& index_col_names) {
@@ -29,11 +31,70 @@ bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_c
         if(cond.is_rhs_val && cond.op == OP_EQ && cond.lhs_col.tab_name.compare(tab_name) == 0)
             index_col_names.push_back(cond.lhs_col.col_name);
     }
+    // 在线创建的索引在发布时修改表的索引列表，读取时需要持有元数据共享锁
+    std::shared_lock<std::shared_mutex> meta_lock(sm_manager_->meta_latch_);
     TabMeta& tab = sm_manager_->db_.get_table(tab_name);
     if(tab.is_index(index_col_names)) return true;
     return false;
 }
 
+/**
+ * @brief 分区裁剪，根据扫描算子上分区键与常量比较的条件，去掉不可能包含满足条件元组的分区
+ * 范围分区根据条件求出分区键的取值区间，只保留与区间相交的分区；哈希分区只在有等值条件时裁剪到一个分区
+ *
+ * @param plan 扫描算子或连接算子
+ */
+void Planner::prune_partitions(std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        prune_partitions(x->left_);
+        prune_partitions(x->right_);
+        return;
+    }
+    auto scan = std::dynamic_pointer_cast<ScanPlan>(plan);
+    if (scan == nullptr) {
+        return;
+    }
+    TabMeta &tab = sm_manager_->db_.get_table(scan->tab_name_);
+    auto &part = tab.part;
+    if (!part.is_partitioned()) {
+        return;
+    }
+    std::vector<Condition> key_conds;
+    for (auto &cond : scan->conds_) {
+        if (cond.is_rhs_val && cond.lhs_col.tab_name == tab.name && cond.lhs_col.col_name == part.col_name) {
+            key_conds.push_back(cond);
+        }
+    }
+    std::vector<int> part_nos;
+    if (part.type == PART_RANGE) {
+        long long lower = LLONG_MIN, upper = LLONG_MAX;
+        for (auto &cond : key_conds) {
+            long long val = cond.rhs_val.int_val;
+            switch (cond.op) {
+                case OP_EQ: lower = std::max(lower, val); upper = std::min(upper, val); break;
+                case OP_LT: upper = std::min(upper, val - 1); break;
+                case OP_LE: upper = std::min(upper, val); break;
+                case OP_GT: lower = std::max(lower, val + 1); break;
+                case OP_GE: lower = std::max(lower, val); break;
+                default: break;
+            }
+        }
+        if (lower <= upper) {
+            part_nos = part.overlap(lower, upper);
+        }
+    } else {
+        auto eq = std::find_if(key_conds.begin(), key_conds.end(), [](const Condition &cond) { return cond.op == OP_EQ; });
+        if (eq == key_conds.end()) {
+            return;
+        }
+        part_nos.push_back(part.locate(eq->rhs_val.raw->data, eq->rhs_val.raw->size));
+    }
+    scan->files_.clear();
+    for (int part_no : part_nos) {
+        scan->files_.push_back(tab.get_part_file(part_no));
+    }
+}
+
 /**
  * @brief 表算子条件谓词生成
  *
@@ -58,70 +119,73 @@ std::vector<Condition> pop_conds(std::vector<Condition> &conds, std::string tab_
     return solved_conds;
 }
 
-int push_conds(Condition *cond, std::shared_ptr<Plan> plan)
-{
-    if(auto x = std::dynamic_pointer_cast<ScanPlan>(plan))
-    {
-        if(x->tab_name_.compare(cond->lhs_col.tab_name) == 0) {
-            return 1;
-        } else if(x->tab_name_.compare(cond->rhs_col.tab_name) == 0){
-            return 2;
-        } else {
-            return 0;
-        }
-    }
-    else if(auto x = std::dynamic_pointer_cast<JoinPlan>(plan))
-    {
-        int left_res = push_conds(cond, x->left_);
-        // 条件已经下推到左子节点
-        if(left_res == 3){
-            return 3;
-        }
-        int right_res = push_conds(cond, x->right_);
-        // 条件已经下推到右子节点
-        if(right_res == 3){
-            return 3;
-        }
-        // 左子节点或右子节点有一个没有匹配到条件的列
-        if(left_res == 0 || right_res == 0) {
-            return left_res + right_res;
-        }
-        // 左子节点匹配到条件的右边
-        if(left_res == 2) {
-            // 需要将左右两边的条件变换位置
-            std::map<CompOp, CompOp> swap_op = {
-                {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
-            };
-            std::swap(cond->lhs_col, cond->rhs_col);
-            cond->op = swap_op.at(cond->op);
-        }
-        x->conds_.emplace_back(std::move(*cond));
-        return 3;
+/**
+ * @brief 收集计划涉及的所有表
+ *
+ * @param plan 扫描、连接或已物化的计划
+ * @param tables 表名集合
+ */
+static void collect_tables(const std::shared_ptr<Plan> &plan, std::set<std::string> &tables) {
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        tables.insert(x->tab_name_);
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        collect_tables(x->left_, tables);
+        collect_tables(x->right_, tables);
+    } else if (auto x = std::dynamic_pointer_cast<MaterializePlan>(plan)) {
+        collect_tables(x->subplan_, tables);
     }
-    return false;
 }
 
-std::shared_ptr<Plan> pop_scan(int *scantbl, std::string table, std::vector<std::string> &joined_tables, 
-                std::vector<std::shared_ptr<Plan>> plans)
-{
-    for (size_t i = 0; i < plans.size(); i++) {
-        auto x = std::dynamic_pointer_cast<ScanPlan>(plans[i]);
-        if(x->tab_name_.compare(table) == 0)
-        {
-            scantbl[i] = 1;
-            joined_tables.emplace_back(x->tab_name_);
-            return plans[i];
-        }
+/**
+ * @brief 估计连接结果的行数，等值条件按主外键连接估计，其他条件使用默认选择率
+ */
+static double estimate_join_rows(double left_rows, double right_rows, const std::vector<Condition> &conds) {
+    double rows = left_rows * right_rows;
+    for (auto &cond : conds) {
+        rows *= cond.op == OP_EQ ? 1.0 / std::max({left_rows, right_rows, 1.0}) : STATS_RANGE_SELECTIVITY;
     }
-    return nullptr;
+    return rows;
 }
 
 
+/**
+ * @brief 标记查询结果为空：清空所有扫描算子需要扫描的数据文件，执行时不会访问任何数据
+ *
+ * @param plan 扫描算子或连接算子
+ */
+void Planner::mark_empty(std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        mark_empty(x->left_);
+        mark_empty(x->right_);
+    } else if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        x->files_.clear();
+    }
+}
+
 std::shared_ptr<Query> Planner::logical_optimization(std::shared_ptr<Query> query, Context *context)
 {
-    
-    //TODO 实现逻辑优化规则
-
+    // 基于规则改写where条件：常量折叠、矛盾检测、冗余消除和传递推导
+    RewriteEngine rewriter;
+    if (!rewriter.rewrite(query->conds)) {
+        query->always_false = true;
+        return query;
+    }
+    // 传递推导出的常量条件需要按所在字段的长度生成raw，常量比字段长时该等值条件不可能成立
+    auto it = query->conds.begin();
+    while (it != query->conds.end()) {
+        if (it->is_rhs_val && it->rhs_val.raw == nullptr) {
+            auto col = sm_manager_->db_.get_table(it->lhs_col.tab_name).get_col(it->lhs_col.col_name);
+            if (it->rhs_val.type == TYPE_STRING && (int)it->rhs_val.str_val.size() > col->len) {
+                if (it->op == OP_EQ) {
+                    query->always_false = true;
+                }
+                it = query->conds.erase(it);
+                continue;
+            }
+            it->rhs_val.init_raw(col->len);
+        }
+        it++;
+    }
     return query;
 }
 
@@ -130,6 +194,10 @@ std::shared_ptr<Plan> Planner::physical_optimization(std::shared_ptr<Query> quer
     std::shared_ptr<Plan> plan = make_one_rel(query);
     
     // 其他物理优化
+    prune_partitions(plan);
+    if (query->always_false) {
+        mark_empty(plan);
+    }
 
     // 处理orderby
     plan = generate_sort_plan(query, std::move(plan)); 
@@ -164,88 +232,97 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
     {
         return table_scan_executors[0];
     }
-    // 获取where条件
-    auto conds = std::move(query->conds);
-    std::shared_ptr<Plan> table_join_executors;
-    
-    int scantbl[tables.size()];
-    for(size_t i = 0; i < tables.size(); i++)
-    {
-        scantbl[i] = -1;
+    // 根据统计信息确定连接顺序，执行时还会根据实际行数调整
+    return make_join_tree(std::move(table_scan_executors), std::move(query->conds));
+}
+
+/**
+ * @brief 估计计划产生的行数，已物化的输入使用实际行数，扫描使用统计信息
+ *
+ * @param plan 扫描、连接或已物化的计划
+ * @return double 估计行数
+ */
+double Planner::estimate_rows(std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<MaterializePlan>(plan)) {
+        return x->rows_->size();
+    } else if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        return sm_manager_->get_stats()->estimate(x->tab_name_, x->conds_);
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        return estimate_join_rows(estimate_rows(x->left_), estimate_rows(x->right_), x->conds_);
     }
-    // 假设在ast中已经添加了jointree，这里需要修改的逻辑是，先处理jointree，然后再考虑剩下的部分
-    if(conds.size() >= 1)
-    {
-        // 有连接条件
+    return STATS_DEFAULT_ROWS;
+}
 
-        // 根据连接条件，生成第一层join
-        std::vector<std::string> joined_tables(tables.size());
-        auto it = conds.begin();
-        while (it != conds.end()) {
-            std::shared_ptr<Plan> left , right;
-            left = pop_scan(scantbl, it->lhs_col.tab_name, joined_tables, table_scan_executors);
-            right = pop_scan(scantbl, it->rhs_col.tab_name, joined_tables, table_scan_executors);
-            std::vector<Condition> join_conds{*it};
-            //建立join
-            table_join_executors = std::make_shared<JoinPlan>(T_NestLoop, std::move(left), std::move(right), join_conds);
-            it = conds.erase(it);
-            break;
+/**
+ * @brief 贪心地生成左深连接树：从估计行数最少的输入开始，每次加入使连接结果估计行数最少的输入，
+ * 有连接条件的输入优先于需要做笛卡尔积的输入；新加入的输入作为左儿子，连接条件的左侧调整为新加入的输入
+ *
+ * @param rels 参与连接的输入，可以是扫描计划或已物化的计划
+ * @param conds 输入之间的连接条件
+ * @return std::shared_ptr<Plan> 连接树
+ */
+std::shared_ptr<Plan> Planner::make_join_tree(std::vector<std::shared_ptr<Plan>> rels, std::vector<Condition> conds) {
+    std::vector<double> rel_rows;
+    for (auto &rel : rels) {
+        rel_rows.push_back(estimate_rows(rel));
+    }
+    size_t first = std::min_element(rel_rows.begin(), rel_rows.end()) - rel_rows.begin();
+    std::shared_ptr<Plan> tree = rels[first];
+    double tree_rows = rel_rows[first];
+    std::set<std::string> joined;
+    collect_tables(tree, joined);
+    rels.erase(rels.begin() + first);
+    rel_rows.erase(rel_rows.begin() + first);
+
+    while (!rels.empty()) {
+        size_t best = 0;
+        bool best_connected = false;
+        double best_rows = 0;
+        for (size_t i = 0; i < rels.size(); i++) {
+            std::set<std::string> tables;
+            collect_tables(rels[i], tables);
+            std::vector<Condition> join_conds;
+            for (auto &cond : conds) {
+                if ((tables.count(cond.lhs_col.tab_name) && joined.count(cond.rhs_col.tab_name)) ||
+                    (tables.count(cond.rhs_col.tab_name) && joined.count(cond.lhs_col.tab_name))) {
+                    join_conds.push_back(cond);
+                }
+            }
+            bool connected = !join_conds.empty();
+            double rows = estimate_join_rows(rel_rows[i], tree_rows, join_conds);
+            if (i == 0 || connected > best_connected || (connected == best_connected && rows < best_rows)) {
+                best = i;
+                best_connected = connected;
+                best_rows = rows;
+            }
         }
-        // 根据连接条件，生成第2-n层join
-        it = conds.begin();
+
+        std::set<std::string> tables;
+        collect_tables(rels[best], tables);
+        std::vector<Condition> join_conds;
+        auto it = conds.begin();
         while (it != conds.end()) {
-            std::shared_ptr<Plan> left_need_to_join_executors = nullptr;
-            std::shared_ptr<Plan> right_need_to_join_executors = nullptr;
-            bool isneedreverse = false;
-            if (std::find(joined_tables.begin(), joined_tables.end(), it->lhs_col.tab_name) == joined_tables.end()) {
-                left_need_to_join_executors = pop_scan(scantbl, it->lhs_col.tab_name, joined_tables, table_scan_executors);
+            if (tables.count(it->rhs_col.tab_name) && joined.count(it->lhs_col.tab_name)) {
+                std::map<CompOp, CompOp> swap_op = {
+                    {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
+                };
+                std::swap(it->lhs_col, it->rhs_col);
+                it->op = swap_op.at(it->op);
             }
-            if (std::find(joined_tables.begin(), joined_tables.end(), it->rhs_col.tab_name) == joined_tables.end()) {
-                right_need_to_join_executors = pop_scan(scantbl, it->rhs_col.tab_name, joined_tables, table_scan_executors);
-                isneedreverse = true;
-            } 
-
-            if(left_need_to_join_executors != nullptr && right_need_to_join_executors != nullptr) {
-                std::vector<Condition> join_conds{*it};
-                std::shared_ptr<Plan> temp_join_executors = std::make_shared<JoinPlan>(T_NestLoop, 
-                                                                    std::move(left_need_to_join_executors), 
-                                                                    std::move(right_need_to_join_executors), 
-                                                                    join_conds);
-                table_join_executors = std::make_shared<JoinPlan>(T_NestLoop, std::move(temp_join_executors), 
-                                                                    std::move(table_join_executors), 
-                                                                    std::vector<Condition>());
-            } else if(left_need_to_join_executors != nullptr || right_need_to_join_executors != nullptr) {
-                if(isneedreverse) {
-                    std::map<CompOp, CompOp> swap_op = {
-                        {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
-                    };
-                    std::swap(it->lhs_col, it->rhs_col);
-                    it->op = swap_op.at(it->op);
-                    left_need_to_join_executors = std::move(right_need_to_join_executors);
-                }
-                std::vector<Condition> join_conds{*it};
-                table_join_executors = std::make_shared<JoinPlan>(T_NestLoop, std::move(left_need_to_join_executors), 
-                                                                    std::move(table_join_executors), join_conds);
+            if (tables.count(it->lhs_col.tab_name) && joined.count(it->rhs_col.tab_name)) {
+                join_conds.emplace_back(std::move(*it));
+                it = conds.erase(it);
             } else {
-                push_conds(std::move(&(*it)), table_join_executors);
+                it++;
             }
-            it = conds.erase(it);
-        }
-    } else {
-        table_join_executors = table_scan_executors[0];
-        scantbl[0] = 1;
-    }
-
-    //连接剩余表
-    for (size_t i = 0; i < tables.size(); i++) {
-        if(scantbl[i] == -1) {
-            table_join_executors = std::make_shared<JoinPlan>(T_NestLoop, std::move(table_scan_executors[i]), 
-                                                    std::move(table_join_executors), std::vector<Condition>());
         }
+        tree = std::make_shared<JoinPlan>(T_NestLoop, rels[best], std::move(tree), std::move(join_conds));
+        tree_rows = best_rows;
+        joined.insert(tables.begin(), tables.end());
+        rels.erase(rels.begin() + best);
+        rel_rows.erase(rel_rows.begin() + best);
     }
-
-    return table_join_executors;
-
+    return tree;
 }
 
 
@@ -309,22 +386,79 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
                 throw InternalError("Unexpected field type");
             }
         }
-        plannerRoot = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+        auto ddl = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+        if (x->partition != nullptr) {
+            ddl->part_ = interp_partition(x->partition);
+        }
+        plannerRoot = ddl;
     } else if (auto x = std::dynamic_pointer_cast<ast::DropTable>(query->parse)) {
         // drop table;
         plannerRoot = std::make_shared<DDLPlan>(T_DropTable, x->tab_name, std::vector<std::string>(), std::vector<ColDef>());
+    } else if (auto x = std::dynamic_pointer_cast<ast::TruncateTable>(query->parse)) {
+        // truncate table;
+        plannerRoot =
+            std::make_shared<DDLPlan>(T_TruncateTable, x->tab_name, std::vector<std::string>(), std::vector<ColDef>());
     } else if (auto x = std::dynamic_pointer_cast<ast::CreateIndex>(query->parse)) {
         // create index;
         plannerRoot = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
     } else if (auto x = std::dynamic_pointer_cast<ast::DropIndex>(query->parse)) {
         // drop index
         plannerRoot = std::make_shared<DDLPlan>(T_DropIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+    } else if (auto x = std::dynamic_pointer_cast<ast::CreateMatView>(query->parse)) {
+        // create materialized view;
+        auto ddl = std::make_shared<DDLPlan>(T_CreateMatView, x->view_name, std::vector<std::string>(),
+                                             std::vector<ColDef>());
+        ddl->view_ = query->view;
+        plannerRoot = ddl;
+    } else if (auto x = std::dynamic_pointer_cast<ast::CreateProcedure>(query->parse)) {
+        // create procedure;
+        auto ddl = std::make_shared<DDLPlan>(T_CreateProcedure, x->proc_name, std::vector<std::string>(),
+                                             std::vector<ColDef>());
+        ddl->proc_ = query->proc;
+        plannerRoot = ddl;
+    } else if (auto x = std::dynamic_pointer_cast<ast::DropProcedure>(query->parse)) {
+        // drop procedure;
+        plannerRoot = std::make_shared<DDLPlan>(T_DropProcedure, x->proc_name, std::vector<std::string>(),
+                                                std::vector<ColDef>());
+    } else if (auto x = std::dynamic_pointer_cast<ast::CallStmt>(query->parse)) {
+        // call;
+        plannerRoot = std::make_shared<CallPlan>(query->proc_stmts, query->values);
+    } else if (auto x = std::dynamic_pointer_cast<ast::DropMatView>(query->parse)) {
+        // drop materialized view;
+        plannerRoot = std::make_shared<DDLPlan>(T_DropMatView, x->view_name, std::vector<std::string>(),
+                                                std::vector<ColDef>());
+    } else if (auto x = std::dynamic_pointer_cast<ast::AddPartition>(query->parse)) {
+        // alter table add partition;
+        auto ddl = std::make_shared<DDLPlan>(T_AddPartition, x->tab_name, std::vector<std::string>(),
+                                             std::vector<ColDef>());
+        ddl->part_ = interp_range_part(x->part);
+        plannerRoot = ddl;
+    } else if (auto x = std::dynamic_pointer_cast<ast::DropPartition>(query->parse)) {
+        // alter table drop partition;
+        auto ddl = std::make_shared<DDLPlan>(T_DropPartition, x->tab_name, std::vector<std::string>(),
+                                             std::vector<ColDef>());
+        ddl->part_.names.push_back(x->part_name);
+        plannerRoot = ddl;
+    } else if (auto x = std::dynamic_pointer_cast<ast::AddColumn>(query->parse)) {
+        // alter table add column;
+        ColDef col_def = {.name = x->col_def->col_name,
+                          .type = interp_sv_type(x->col_def->type_len->type),
+                          .len = x->col_def->type_len->len};
+        auto ddl = std::make_shared<DDLPlan>(T_AddColumn, x->tab_name, std::vector<std::string>(),
+                                             std::vector<ColDef>{col_def});
+        ddl->values_ = query->values;
+        plannerRoot = ddl;
+    } else if (auto x = std::dynamic_pointer_cast<ast::DropColumn>(query->parse)) {
+        // alter table drop column;
+        plannerRoot = std::make_shared<DDLPlan>(T_DropColumn, x->tab_name, std::vector<std::string>{x->col_name},
+                                                std::vector<ColDef>());
     } else if (auto x = std::dynamic_pointer_cast<ast::InsertStmt>(query->parse)) {
         // insert;
         plannerRoot = std::make_shared<DMLPlan>(T_Insert, std::shared_ptr<Plan>(),  x->tab_name,  
                                                     query->values, std::vector<Condition>(), std::vector<SetClause>());
     } else if (auto x = std::dynamic_pointer_cast<ast::DeleteStmt>(query->parse)) {
         // delete;
+        query = logical_optimization(std::move(query), context);
         // 生成表扫描方式
         std::shared_ptr<Plan> table_scan_executors;
         // 只有一张表，不需要进行物理优化了
@@ -341,10 +475,16 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
                 std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, x->tab_name, query->conds, index_col_names);
         }
 
+        prune_partitions(table_scan_executors);
+        if (query->always_false) {
+            mark_empty(table_scan_executors);
+        }
+
         plannerRoot = std::make_shared<DMLPlan>(T_Delete, table_scan_executors, x->tab_name,  
                                                 std::vector<Value>(), query->conds, std::vector<SetClause>());
     } else if (auto x = std::dynamic_pointer_cast<ast::UpdateStmt>(query->parse)) {
         // update;
+        query = logical_optimization(std::move(query), context);
         // 生成表扫描方式
         std::shared_ptr<Plan> table_scan_executors;
         // 只有一张表，不需要进行物理优化了
@@ -360,9 +500,15 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
             table_scan_executors =
                 std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, x->tab_name, query->conds, index_col_names);
         }
-        plannerRoot = std::make_shared<DMLPlan>(T_Update, table_scan_executors, x->tab_name,
+        prune_partitions(table_scan_executors);
+        if (query->always_false) {
+            mark_empty(table_scan_executors);
+        }
+        auto update_plan = std::make_shared<DMLPlan>(T_Update, table_scan_executors, x->tab_name,
                                                      std::vector<Value>(), query->conds, 
                                                      query->set_clauses);
+        update_plan->expr_conds_ = query->expr_conds;
+        plannerRoot = update_plan;
     } else if (auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse)) {
 
         std::shared_ptr<plannerInfo> root = std::make_shared<plannerInfo>(x);
@@ -374,4 +520,32 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
         throw InternalError("Unexpected AST root");
     }
     return plannerRoot;
-}
\ No newline at end of file
+}
+
+// 将语法树中的分区定义转换为分区元数据，哈希分区的分区依次命名为p0, p1, ...
+PartitionMeta Planner::interp_partition(const std::shared_ptr<ast::PartitionDef> &sv_part) {
+    PartitionMeta part;
+    part.col_name = sv_part->col_name;
+    if (sv_part->type == ast::SV_PART_RANGE) {
+        part.type = PART_RANGE;
+        for (auto &sv_range_part : sv_part->parts) {
+            auto range_part = interp_range_part(sv_range_part);
+            part.names.push_back(range_part.names[0]);
+            part.bounds.push_back(range_part.bounds[0]);
+        }
+    } else {
+        part.type = PART_HASH;
+        for (int i = 0; i < sv_part->num_parts; i++) {
+            part.names.push_back("p" + std::to_string(i));
+        }
+    }
+    return part;
+}
+
+PartitionMeta Planner::interp_range_part(const std::shared_ptr<ast::RangePartDef> &sv_range_part) {
+    PartitionMeta part;
+    part.type = PART_RANGE;
+    part.names.push_back(sv_range_part->part_name);
+    part.bounds.push_back(sv_range_part->is_max ? PART_MAXVALUE : sv_range_part->bound);
+    return part;
+}
@@ -36,6 +36,10 @@ class Planner {
 
     std::shared_ptr<Plan> do_planner(std::shared_ptr<Query> query, Context *context);
 
+    double estimate_rows(std::shared_ptr<Plan> plan);
+
+    std::shared_ptr<Plan> make_join_tree(std::vector<std::shared_ptr<Plan>> rels, std::vector<Condition> conds);
+
    private:
     std::shared_ptr<Query> logical_optimization(std::shared_ptr<Query> query, Context *context);
     std::shared_ptr<Plan> physical_optimization(std::shared_ptr<Query> query, Context *context);
@@ -50,6 +54,14 @@ class Planner {
     // int get_indexNo(std::string tab_name, std::vector<Condition> curr_conds);
     bool get_index_cols(std::string tab_name, std::vector<Condition> curr_conds, std::vector<std::string>& index_col_names);
 
+    void prune_partitions(std::shared_ptr<Plan> plan);
+
+    void mark_empty(std::shared_ptr<Plan> plan);
+
+    PartitionMeta interp_partition(const std::shared_ptr<ast::PartitionDef> &sv_part);
+
+    PartitionMeta interp_range_part(const std::shared_ptr<ast::RangePartDef> &sv_range_part);
+
     ColType interp_sv_type(ast::SvType sv_type) {
         std::map<ast::SvType, ColType> m = {
             {ast::SV_TYPE_INT, TYPE_INT}, {ast::SV_TYPE_FLOAT, TYPE_FLOAT}, {ast::SV_TYPE_STRING, TYPE_STRING}};
@@ -0,0 +1,316 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rewriter.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+static bool same_col(const TabCol &a, const TabCol &b) {
+    return a.tab_name == b.tab_name && a.col_name == b.col_name;
+}
+
+static CompOp swap_op(CompOp op) {
+    switch (op) {
+        case OP_LT: return OP_GT;
+        case OP_GT: return OP_LT;
+        case OP_LE: return OP_GE;
+        case OP_GE: return OP_LE;
+        default: return op;
+    }
+}
+
+/* 比较两个同类型的常量，字符串按字典序比较，与按定长字段memcmp的结果一致 */
+static int compare_value(const Value &a, const Value &b) {
+    switch (a.type) {
+        case TYPE_INT:
+            return (a.int_val > b.int_val) - (a.int_val < b.int_val);
+        case TYPE_FLOAT:
+            return (a.float_val > b.float_val) - (a.float_val < b.float_val);
+        default: {
+            int res = a.str_val.compare(b.str_val);
+            return (res > 0) - (res < 0);
+        }
+    }
+}
+
+/* 判断两个条件是否等价，字段之间的比较允许左右交换 */
+static bool same_cond(const Condition &a, const Condition &b) {
+    if (a.is_rhs_val != b.is_rhs_val) {
+        return false;
+    }
+    if (a.is_rhs_val) {
+        return same_col(a.lhs_col, b.lhs_col) && a.op == b.op && compare_value(a.rhs_val, b.rhs_val) == 0;
+    }
+    if (same_col(a.lhs_col, b.lhs_col) && same_col(a.rhs_col, b.rhs_col) && a.op == b.op) {
+        return true;
+    }
+    return same_col(a.lhs_col, b.rhs_col) && same_col(a.rhs_col, b.lhs_col) && a.op == swap_op(b.op);
+}
+
+static std::string col_key(const TabCol &col) { return col.tab_name + "." + col.col_name; }
+
+/* 一个字段上与常量比较的条件所确定的取值范围：在lower和upper之间，且不等于ne中的常量 */
+struct ColRange {
+    const Value *lower = nullptr;
+    bool lower_inc = false;
+    const Value *upper = nullptr;
+    bool upper_inc = false;
+    std::vector<const Value *> ne;
+
+    void add(CompOp op, const Value &val) {
+        switch (op) {
+            case OP_EQ: add_lower(val, true); add_upper(val, true); break;
+            case OP_GT: add_lower(val, false); break;
+            case OP_GE: add_lower(val, true); break;
+            case OP_LT: add_upper(val, false); break;
+            case OP_LE: add_upper(val, true); break;
+            case OP_NE: ne.push_back(&val); break;
+        }
+    }
+
+    bool contains(const Value &val) const {
+        return in_bounds(val) &&
+               std::none_of(ne.begin(), ne.end(), [&](const Value *v) { return compare_value(val, *v) == 0; });
+    }
+
+    bool in_bounds(const Value &val) const {
+        if (lower != nullptr) {
+            int res = compare_value(val, *lower);
+            if (res < 0 || (res == 0 && !lower_inc)) {
+                return false;
+            }
+        }
+        if (upper != nullptr) {
+            int res = compare_value(val, *upper);
+            if (res > 0 || (res == 0 && !upper_inc)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool empty() const {
+        if (lower == nullptr || upper == nullptr) {
+            return false;
+        }
+        int res = compare_value(*lower, *upper);
+        if (res != 0) {
+            return res > 0;
+        }
+        // 取值范围只有一个点，这个点还不能被NE条件排除
+        return !(lower_inc && upper_inc) || !contains(*lower);
+    }
+
+   private:
+    void add_lower(const Value &val, bool inc) {
+        // 取值相同时开区间更严格
+        int res = lower == nullptr ? 1 : compare_value(val, *lower);
+        if (res > 0 || (res == 0 && !inc)) {
+            lower = &val;
+            lower_inc = inc;
+        }
+    }
+
+    void add_upper(const Value &val, bool inc) {
+        int res = upper == nullptr ? -1 : compare_value(val, *upper);
+        if (res < 0 || (res == 0 && !inc)) {
+            upper = &val;
+            upper_inc = inc;
+        }
+    }
+};
+
+/* 按字段收集与常量比较的条件的下标 */
+static std::map<std::string, std::vector<size_t>> group_value_conds(const std::vector<Condition> &conds) {
+    std::map<std::string, std::vector<size_t>> groups;
+    for (size_t i = 0; i < conds.size(); i++) {
+        if (conds[i].is_rhs_val) {
+            groups[col_key(conds[i].lhs_col)].push_back(i);
+        }
+    }
+    return groups;
+}
+
+bool ConstantFoldRule::apply(std::vector<Condition> &conds, bool &contradiction) {
+    bool changed = false;
+    auto it = conds.begin();
+    while (it != conds.end()) {
+        if (it->is_rhs_val || !same_col(it->lhs_col, it->rhs_col)) {
+            it++;
+            continue;
+        }
+        // a = a、a <= a、a >= a恒为真，a <> a、a < a、a > a恒为假
+        if (it->op == OP_NE || it->op == OP_LT || it->op == OP_GT) {
+            contradiction = true;
+            return changed;
+        }
+        it = conds.erase(it);
+        changed = true;
+    }
+    return changed;
+}
+
+bool ContradictionRule::apply(std::vector<Condition> &conds, bool &contradiction) {
+    for (auto &group : group_value_conds(conds)) {
+        ColRange range;
+        for (size_t i : group.second) {
+            range.add(conds[i].op, conds[i].rhs_val);
+        }
+        if (range.empty()) {
+            contradiction = true;
+            break;
+        }
+    }
+    return false;
+}
+
+bool RedundancyRule::apply(std::vector<Condition> &conds, bool &contradiction) {
+    std::vector<bool> removed(conds.size(), false);
+    for (size_t i = 0; i < conds.size(); i++) {
+        for (size_t j = 0; j < i && !removed[i]; j++) {
+            removed[i] = !removed[j] && same_cond(conds[i], conds[j]);
+        }
+    }
+
+    for (auto &group : group_value_conds(conds)) {
+        ColRange range;
+        for (size_t i : group.second) {
+            if (!removed[i]) {
+                range.add(conds[i].op, conds[i].rhs_val);
+            }
+        }
+        // 有等值条件时只保留等值条件，否则只保留确定上下界的条件和范围内的不等条件
+        auto eq = std::find_if(group.second.begin(), group.second.end(),
+                               [&](size_t i) { return !removed[i] && conds[i].op == OP_EQ; });
+        bool lower_kept = false;
+        bool upper_kept = false;
+        for (size_t i : group.second) {
+            if (removed[i]) {
+                continue;
+            }
+            auto &cond = conds[i];
+            bool keep;
+            if (eq != group.second.end()) {
+                keep = i == *eq;
+            } else if (cond.op == OP_NE) {
+                keep = range.in_bounds(cond.rhs_val);
+            } else if (cond.op == OP_GT || cond.op == OP_GE) {
+                keep = !lower_kept && &cond.rhs_val == range.lower && (cond.op == OP_GE) == range.lower_inc;
+                lower_kept = lower_kept || keep;
+            } else {
+                keep = !upper_kept && &cond.rhs_val == range.upper && (cond.op == OP_LE) == range.upper_inc;
+                upper_kept = upper_kept || keep;
+            }
+            removed[i] = !keep;
+        }
+    }
+
+    bool changed = false;
+    std::vector<Condition> kept;
+    for (size_t i = 0; i < conds.size(); i++) {
+        if (removed[i]) {
+            changed = true;
+        } else {
+            kept.push_back(std::move(conds[i]));
+        }
+    }
+    conds = std::move(kept);
+    return changed;
+}
+
+bool TransitiveRule::apply(std::vector<Condition> &conds, bool &contradiction) {
+    // 用并查集把等值连接的字段划分为等价类
+    std::map<std::string, std::string> parent;
+    std::map<std::string, TabCol> cols;
+    std::function<std::string(const std::string &)> find = [&](const std::string &key) {
+        auto &p = parent[key];
+        if (p.empty() || p == key) {
+            p = key;
+            return key;
+        }
+        p = find(p);
+        return p;
+    };
+    for (auto &cond : conds) {
+        if (!cond.is_rhs_val && cond.op == OP_EQ) {
+            auto lhs = col_key(cond.lhs_col);
+            auto rhs = col_key(cond.rhs_col);
+            cols[lhs] = cond.lhs_col;
+            cols[rhs] = cond.rhs_col;
+            parent[find(lhs)] = find(rhs);
+        }
+    }
+    std::map<std::string, std::vector<TabCol>> classes;
+    for (auto &entry : cols) {
+        classes[find(entry.first)].push_back(entry.second);
+    }
+
+    std::vector<Condition> derived;
+    auto add = [&](Condition cond) {
+        auto exists = [&](const Condition &other) { return same_cond(cond, other); };
+        if (std::none_of(conds.begin(), conds.end(), exists) && std::none_of(derived.begin(), derived.end(), exists)) {
+            derived.push_back(std::move(cond));
+        }
+    };
+    for (auto &entry : classes) {
+        auto &members = entry.second;
+        // 等价类中不同表的字段两两相等
+        for (size_t i = 0; i < members.size(); i++) {
+            for (size_t j = i + 1; j < members.size(); j++) {
+                if (members[i].tab_name != members[j].tab_name) {
+                    add(Condition{.lhs_col = members[i], .op = OP_EQ, .is_rhs_val = false, .rhs_col = members[j]});
+                }
+            }
+        }
+        // 一个字段上与常量比较的条件对等价类中的其他字段同样成立
+        for (size_t i = 0, n = conds.size(); i < n; i++) {
+            if (!conds[i].is_rhs_val || find(col_key(conds[i].lhs_col)) != entry.first) {
+                continue;
+            }
+            for (auto &member : members) {
+                if (!same_col(member, conds[i].lhs_col)) {
+                    Condition cond = conds[i];
+                    cond.lhs_col = member;
+                    // 不同字段的长度可能不同，raw需要按新字段的长度重新生成
+                    cond.rhs_val.raw = nullptr;
+                    add(std::move(cond));
+                }
+            }
+        }
+    }
+    conds.insert(conds.end(), derived.begin(), derived.end());
+    return !derived.empty();
+}
+
+RewriteEngine::RewriteEngine() {
+    add_rule(std::make_unique<ConstantFoldRule>());
+    add_rule(std::make_unique<ContradictionRule>());
+    add_rule(std::make_unique<RedundancyRule>());
+    add_rule(std::make_unique<TransitiveRule>());
+}
+
+bool RewriteEngine::rewrite(std::vector<Condition> &conds) {
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        bool changed = false;
+        for (auto &rule : rules_) {
+            bool contradiction = false;
+            changed = rule->apply(conds, contradiction) || changed;
+            if (contradiction) {
+                return false;
+            }
+        }
+        if (!changed) {
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common.h"
+
+/* where条件的一条改写规则 */
+class RewriteRule {
+   public:
+    virtual ~RewriteRule() = default;
+
+    virtual std::string name() const = 0;
+
+    /**
+     * @description: 改写条件列表
+     * @param {vector<Condition>&} conds 合取的条件列表
+     * @param {bool&} contradiction 发现条件恒为假时置为true
+     * @return {bool} 条件列表是否发生变化
+     */
+    virtual bool apply(std::vector<Condition> &conds, bool &contradiction) = 0;
+};
+
+/* 常量折叠：同一字段与自身比较的条件恒为真或恒为假 */
+class ConstantFoldRule : public RewriteRule {
+   public:
+    std::string name() const override { return "constant_fold"; }
+    bool apply(std::vector<Condition> &conds, bool &contradiction) override;
+};
+
+/* 矛盾检测：同一字段上与常量比较的条件没有公共解，例如a = 1 AND a = 2 */
+class ContradictionRule : public RewriteRule {
+   public:
+    std::string name() const override { return "contradiction"; }
+    bool apply(std::vector<Condition> &conds, bool &contradiction) override;
+};
+
+/* 冗余消除：去掉重复的条件，以及被同一字段上更严格的条件蕴含的条件 */
+class RedundancyRule : public RewriteRule {
+   public:
+    std::string name() const override { return "redundancy"; }
+    bool apply(std::vector<Condition> &conds, bool &contradiction) override;
+};
+
+/* 传递推导：由字段之间的等值条件，把一个字段上与常量比较的条件和等值连接条件传递到与之相等的其他字段 */
+class TransitiveRule : public RewriteRule {
+   public:
+    std::string name() const override { return "transitive"; }
+    bool apply(std::vector<Condition> &conds, bool &contradiction) override;
+};
+
+/**
+ * @description: 基于规则的where条件改写引擎，依次应用各条规则直到条件不再变化
+ * 推导出的常量条件没有raw，需要由调用者按字段长度初始化
+ */
+class RewriteEngine {
+   public:
+    RewriteEngine();
+
+    void add_rule(std::unique_ptr<RewriteRule> rule) { rules_.push_back(std::move(rule)); }
+
+    /* 改写条件列表，返回false表示条件恒为假，此时conds的内容没有意义 */
+    bool rewrite(std::vector<Condition> &conds);
+
+   private:
+    static constexpr int MAX_ROUNDS = 8;    // 规则之间相互触发时最多应用的轮数
+
+    std::vector<std::unique_ptr<RewriteRule>> rules_;
+};
@@ -26,6 +26,14 @@ enum SvCompOp {
     SV_OP_EQ, SV_OP_NE, SV_OP_LT, SV_OP_GT, SV_OP_LE, SV_OP_GE
 };
 
+enum SvArithOp {
+    SV_OP_ADD, SV_OP_SUB, SV_OP_MUL, SV_OP_DIV
+};
+
+enum SvAggType {
+    SV_AGG_COUNT, SV_AGG_SUM
+};
+
 enum OrderByDir {
     OrderBy_DEFAULT,
     OrderBy_ASC,
@@ -43,7 +51,35 @@ struct Help : public TreeNode {
 struct ShowTables : public TreeNode {
 };
 
+struct ShowMetrics : public TreeNode {
+};
+
+/* SET name = value，修改运行时参数 */
+struct SetVar : public TreeNode {
+    std::string name;
+    std::string value;
+
+    SetVar(std::string name_, std::string value_) : name(std::move(name_)), value(std::move(value_)) {}
+};
+
+/* BACKUP TO 'path'，在线备份数据库到path目录 */
+struct Backup : public TreeNode {
+    std::string path;
+
+    Backup(std::string path_) : path(std::move(path_)) {}
+};
+
+/* VACUUM table，整理表的数据文件并截断末尾的空页面 */
+struct Vacuum : public TreeNode {
+    std::string tab_name;
+
+    Vacuum(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
+};
+
 struct TxnBegin : public TreeNode {
+    bool read_only;     // BEGIN READ ONLY声明的只读事务
+
+    TxnBegin(bool read_only_ = false) : read_only(read_only_) {}
 };
 
 struct TxnCommit : public TreeNode {
@@ -55,6 +91,27 @@ struct TxnAbort : public TreeNode {
 struct TxnRollback : public TreeNode {
 };
 
+/* SAVEPOINT name */
+struct Savepoint : public TreeNode {
+    std::string name;
+
+    Savepoint(std::string name_) : name(std::move(name_)) {}
+};
+
+/* ROLLBACK TO [SAVEPOINT] name */
+struct RollbackToSavepoint : public TreeNode {
+    std::string name;
+
+    RollbackToSavepoint(std::string name_) : name(std::move(name_)) {}
+};
+
+/* RELEASE [SAVEPOINT] name */
+struct ReleaseSavepoint : public TreeNode {
+    std::string name;
+
+    ReleaseSavepoint(std::string name_) : name(std::move(name_)) {}
+};
+
 struct TypeLen : public TreeNode {
     SvType type;
     int len;
@@ -73,12 +130,55 @@ struct ColDef : public Field {
             col_name(std::move(col_name_)), type_len(std::move(type_len_)) {}
 };
 
+enum SvPartitionType {
+    SV_PART_RANGE, SV_PART_HASH
+};
+
+// PARTITION part_name VALUES LESS THAN (bound | MAXVALUE)
+struct RangePartDef : public TreeNode {
+    std::string part_name;
+    bool is_max;
+    int bound;
+
+    RangePartDef(std::string part_name_, bool is_max_, int bound_) :
+            part_name(std::move(part_name_)), is_max(is_max_), bound(bound_) {}
+};
+
+struct PartitionDef : public TreeNode {
+    SvPartitionType type;
+    std::string col_name;
+    std::vector<std::shared_ptr<RangePartDef>> parts;   // 范围分区的各个分区
+    int num_parts;                                      // 哈希分区的分区数
+
+    PartitionDef(SvPartitionType type_, std::string col_name_, std::vector<std::shared_ptr<RangePartDef>> parts_,
+                 int num_parts_) :
+            type(type_), col_name(std::move(col_name_)), parts(std::move(parts_)), num_parts(num_parts_) {}
+};
+
 struct CreateTable : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Field>> fields;
+    std::shared_ptr<PartitionDef> partition;    // 非分区表为nullptr
+
+    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_,
+                std::shared_ptr<PartitionDef> partition_ = nullptr) :
+            tab_name(std::move(tab_name_)), fields(std::move(fields_)), partition(std::move(partition_)) {}
+};
+
+struct AddPartition : public TreeNode {
+    std::string tab_name;
+    std::shared_ptr<RangePartDef> part;
 
-    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_) :
-            tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+    AddPartition(std::string tab_name_, std::shared_ptr<RangePartDef> part_) :
+            tab_name(std::move(tab_name_)), part(std::move(part_)) {}
+};
+
+struct DropPartition : public TreeNode {
+    std::string tab_name;
+    std::string part_name;
+
+    DropPartition(std::string tab_name_, std::string part_name_) :
+            tab_name(std::move(tab_name_)), part_name(std::move(part_name_)) {}
 };
 
 struct DropTable : public TreeNode {
@@ -87,6 +187,12 @@ struct DropTable : public TreeNode {
     DropTable(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
 };
 
+struct TruncateTable : public TreeNode {
+    std::string tab_name;
+
+    TruncateTable(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
+};
+
 struct DescTable : public TreeNode {
     std::string tab_name;
 
@@ -115,6 +221,13 @@ struct Expr : public TreeNode {
 struct Value : public Expr {
 };
 
+// 存储过程中的参数引用$n，调用时绑定为实参，n从1开始
+struct ParamRef : public Value {
+    int idx;
+
+    ParamRef(int idx_) : idx(idx_) {}
+};
+
 struct IntLit : public Value {
     int val;
 
@@ -141,11 +254,36 @@ struct Col : public Expr {
             tab_name(std::move(tab_name_)), col_name(std::move(col_name_)) {}
 };
 
+// 聚集函数，COUNT(*)的col_name为"*"
+struct AggCol : public Col {
+    SvAggType agg;
+
+    AggCol(SvAggType agg_, std::string tab_name_, std::string col_name_) :
+            Col(std::move(tab_name_), std::move(col_name_)), agg(agg_) {}
+};
+
+// 算术表达式，操作数为常量、字段或子表达式
+struct ArithExpr : public Expr {
+    std::shared_ptr<Expr> lhs;
+    SvArithOp op;
+    std::shared_ptr<Expr> rhs;
+
+    ArithExpr(std::shared_ptr<Expr> lhs_, SvArithOp op_, std::shared_ptr<Expr> rhs_) :
+            lhs(std::move(lhs_)), op(op_), rhs(std::move(rhs_)) {}
+};
+
+// 取负，常量取负在语法分析时直接折叠为负的常量
+struct NegExpr : public Expr {
+    std::shared_ptr<Expr> expr;
+
+    NegExpr(std::shared_ptr<Expr> expr_) : expr(std::move(expr_)) {}
+};
+
 struct SetClause : public TreeNode {
     std::string col_name;
-    std::shared_ptr<Value> val;
+    std::shared_ptr<Expr> val;
 
-    SetClause(std::string col_name_, std::shared_ptr<Value> val_) :
+    SetClause(std::string col_name_, std::shared_ptr<Expr> val_) :
             col_name(std::move(col_name_)), val(std::move(val_)) {}
 };
 
@@ -166,6 +304,25 @@ struct OrderBy : public TreeNode
        cols(std::move(cols_)), orderby_dir(std::move(orderby_dir_)) {}
 };
 
+// ALTER TABLE tab_name ADD COLUMN col_name type [DEFAULT value]
+struct AddColumn : public TreeNode {
+    std::string tab_name;
+    std::shared_ptr<ColDef> col_def;
+    std::shared_ptr<Value> default_val;     // 没有默认值时为nullptr
+
+    AddColumn(std::string tab_name_, std::shared_ptr<ColDef> col_def_, std::shared_ptr<Value> default_val_) :
+            tab_name(std::move(tab_name_)), col_def(std::move(col_def_)), default_val(std::move(default_val_)) {}
+};
+
+// ALTER TABLE tab_name DROP COLUMN col_name
+struct DropColumn : public TreeNode {
+    std::string tab_name;
+    std::string col_name;
+
+    DropColumn(std::string tab_name_, std::string col_name_) :
+            tab_name(std::move(tab_name_)), col_name(std::move(col_name_)) {}
+};
+
 struct InsertStmt : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Value>> vals;
@@ -209,6 +366,7 @@ struct SelectStmt : public TreeNode {
     std::vector<std::string> tabs;
     std::vector<std::shared_ptr<BinaryExpr>> conds;
     std::vector<std::shared_ptr<JoinExpr>> jointree;
+    std::vector<std::shared_ptr<Col>> group_cols;
 
     
     bool has_sort;
@@ -218,13 +376,52 @@ struct SelectStmt : public TreeNode {
     SelectStmt(std::vector<std::shared_ptr<Col>> cols_,
                std::vector<std::string> tabs_,
                std::vector<std::shared_ptr<BinaryExpr>> conds_,
+               std::vector<std::shared_ptr<Col>> group_cols_,
                std::shared_ptr<OrderBy> order_) :
             cols(std::move(cols_)), tabs(std::move(tabs_)), conds(std::move(conds_)), 
-            order(std::move(order_)) {
+            group_cols(std::move(group_cols_)), order(std::move(order_)) {
                 has_sort = (bool)order;
             }
 };
 
+struct CreateMatView : public TreeNode {
+    std::string view_name;
+    std::shared_ptr<SelectStmt> query;
+
+    CreateMatView(std::string view_name_, std::shared_ptr<SelectStmt> query_) :
+            view_name(std::move(view_name_)), query(std::move(query_)) {}
+};
+
+struct DropMatView : public TreeNode {
+    std::string view_name;
+
+    DropMatView(std::string view_name_) : view_name(std::move(view_name_)) {}
+};
+
+// 存储过程，过程体为$$ $$之间的若干条以分号结尾的DML语句，语句中用$n引用第n个参数
+struct CreateProcedure : public TreeNode {
+    std::string proc_name;
+    std::vector<std::shared_ptr<Field>> params;
+    std::string body;
+
+    CreateProcedure(std::string proc_name_, std::vector<std::shared_ptr<Field>> params_, std::string body_) :
+            proc_name(std::move(proc_name_)), params(std::move(params_)), body(std::move(body_)) {}
+};
+
+struct DropProcedure : public TreeNode {
+    std::string proc_name;
+
+    DropProcedure(std::string proc_name_) : proc_name(std::move(proc_name_)) {}
+};
+
+struct CallStmt : public TreeNode {
+    std::string proc_name;
+    std::vector<std::shared_ptr<Value>> args;
+
+    CallStmt(std::string proc_name_, std::vector<std::shared_ptr<Value>> args_) :
+            proc_name(std::move(proc_name_)), args(std::move(args_)) {}
+};
+
 // Semantic value
 struct SemValue {
     int sv_int;
@@ -257,6 +454,10 @@ struct SemValue {
     std::vector<std::shared_ptr<BinaryExpr>> sv_conds;
 
     std::shared_ptr<OrderBy> sv_orderby;
+
+    std::shared_ptr<PartitionDef> sv_partition;
+    std::shared_ptr<RangePartDef> sv_range_part;
+    std::vector<std::shared_ptr<RangePartDef>> sv_range_parts;
 };
 
 extern std::shared_ptr<ast::TreeNode> parse_tree;
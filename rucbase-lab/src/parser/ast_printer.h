@@ -62,6 +62,24 @@ private:
         return m.at(op);
     }
 
+    static std::string arith_op2str(SvArithOp op) {
+        static std::map<SvArithOp, std::string> m{
+                {SV_OP_ADD, "+"},
+                {SV_OP_SUB, "-"},
+                {SV_OP_MUL, "*"},
+                {SV_OP_DIV, "/"},
+        };
+        return m.at(op);
+    }
+
+    static std::string agg2str(SvAggType agg) {
+        static std::map<SvAggType, std::string> m{
+                {SV_AGG_COUNT, "COUNT"},
+                {SV_AGG_SUM,   "SUM"},
+        };
+        return m.at(agg);
+    }
+
     template<typename T>
     static void print_node_list(std::vector<T> nodes, int offset) {
         std::cout << offset2string(offset);
@@ -79,13 +97,67 @@ private:
             std::cout << "HELP\n";
         } else if (auto x = std::dynamic_pointer_cast<ShowTables>(node)) {
             std::cout << "SHOW_TABLES\n";
+        } else if (auto x = std::dynamic_pointer_cast<ShowMetrics>(node)) {
+            std::cout << "SHOW_METRICS\n";
+        } else if (auto x = std::dynamic_pointer_cast<SetVar>(node)) {
+            std::cout << "SET_VAR\n";
+            print_val(x->name, offset);
+            print_val(x->value, offset);
+        } else if (auto x = std::dynamic_pointer_cast<Backup>(node)) {
+            std::cout << "BACKUP\n";
+            print_val(x->path, offset);
+        } else if (auto x = std::dynamic_pointer_cast<Vacuum>(node)) {
+            std::cout << "VACUUM\n";
+            print_val(x->tab_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<CreateTable>(node)) {
             std::cout << "CREATE_TABLE\n";
             print_val(x->tab_name, offset);
             print_node_list(x->fields, offset);
+            if (x->partition != nullptr) {
+                print_node(x->partition, offset);
+            }
+        } else if (auto x = std::dynamic_pointer_cast<PartitionDef>(node)) {
+            std::cout << "PARTITION_DEF\n";
+            print_val(x->type == SV_PART_RANGE ? "RANGE" : "HASH", offset);
+            print_val(x->col_name, offset);
+            if (x->type == SV_PART_RANGE) {
+                print_node_list(x->parts, offset);
+            } else {
+                print_val(x->num_parts, offset);
+            }
+        } else if (auto x = std::dynamic_pointer_cast<RangePartDef>(node)) {
+            std::cout << "RANGE_PART\n";
+            print_val(x->part_name, offset);
+            if (x->is_max) {
+                print_val("MAXVALUE", offset);
+            } else {
+                print_val(x->bound, offset);
+            }
+        } else if (auto x = std::dynamic_pointer_cast<AddPartition>(node)) {
+            std::cout << "ADD_PARTITION\n";
+            print_val(x->tab_name, offset);
+            print_node(x->part, offset);
+        } else if (auto x = std::dynamic_pointer_cast<DropPartition>(node)) {
+            std::cout << "DROP_PARTITION\n";
+            print_val(x->tab_name, offset);
+            print_val(x->part_name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<AddColumn>(node)) {
+            std::cout << "ADD_COLUMN\n";
+            print_val(x->tab_name, offset);
+            print_node(x->col_def, offset);
+            if (x->default_val != nullptr) {
+                print_node(x->default_val, offset);
+            }
+        } else if (auto x = std::dynamic_pointer_cast<DropColumn>(node)) {
+            std::cout << "DROP_COLUMN\n";
+            print_val(x->tab_name, offset);
+            print_val(x->col_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
             std::cout << "DROP_TABLE\n";
             print_val(x->tab_name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<TruncateTable>(node)) {
+            std::cout << "TRUNCATE_TABLE\n";
+            print_val(x->tab_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<DescTable>(node)) {
             std::cout << "DESC_TABLE\n";
             print_val(x->tab_name, offset);
@@ -105,6 +177,11 @@ private:
             std::cout << "COL_DEF\n";
             print_val(x->col_name, offset);
             print_node(x->type_len, offset);
+        } else if (auto x = std::dynamic_pointer_cast<AggCol>(node)) {
+            std::cout << "AGG_COL\n";
+            print_val(agg2str(x->agg), offset);
+            print_val(x->tab_name, offset);
+            print_val(x->col_name, offset);
         } else if (auto x = std::dynamic_pointer_cast<Col>(node)) {
             std::cout << "COL\n";
             print_val(x->tab_name, offset);
@@ -113,6 +190,9 @@ private:
             std::cout << "TYPE_LEN\n";
             print_val(type2str(x->type), offset);
             print_val(x->len, offset);
+        } else if (auto x = std::dynamic_pointer_cast<ParamRef>(node)) {
+            std::cout << "PARAM_REF\n";
+            print_val(x->idx, offset);
         } else if (auto x = std::dynamic_pointer_cast<IntLit>(node)) {
             std::cout << "INT_LIT\n";
             print_val(x->val, offset);
@@ -122,6 +202,14 @@ private:
         } else if (auto x = std::dynamic_pointer_cast<StringLit>(node)) {
             std::cout << "STRING_LIT\n";
             print_val(x->val, offset);
+        } else if (auto x = std::dynamic_pointer_cast<ArithExpr>(node)) {
+            std::cout << "ARITH_EXPR\n";
+            print_node(x->lhs, offset);
+            print_val(arith_op2str(x->op), offset);
+            print_node(x->rhs, offset);
+        } else if (auto x = std::dynamic_pointer_cast<NegExpr>(node)) {
+            std::cout << "NEG_EXPR\n";
+            print_node(x->expr, offset);
         } else if (auto x = std::dynamic_pointer_cast<SetClause>(node)) {
             std::cout << "SET_CLAUSE\n";
             print_val(x->col_name, offset);
@@ -149,14 +237,43 @@ private:
             print_node_list(x->cols, offset);
             print_val_list(x->tabs, offset);
             print_node_list(x->conds, offset);
+            print_node_list(x->group_cols, offset);
+        } else if (auto x = std::dynamic_pointer_cast<CreateMatView>(node)) {
+            std::cout << "CREATE_MATERIALIZED_VIEW\n";
+            print_val(x->view_name, offset);
+            print_node(x->query, offset);
+        } else if (auto x = std::dynamic_pointer_cast<DropMatView>(node)) {
+            std::cout << "DROP_MATERIALIZED_VIEW\n";
+            print_val(x->view_name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<CreateProcedure>(node)) {
+            std::cout << "CREATE_PROCEDURE\n";
+            print_val(x->proc_name, offset);
+            print_node_list(x->params, offset);
+            print_val(x->body, offset);
+        } else if (auto x = std::dynamic_pointer_cast<DropProcedure>(node)) {
+            std::cout << "DROP_PROCEDURE\n";
+            print_val(x->proc_name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<CallStmt>(node)) {
+            std::cout << "CALL\n";
+            print_val(x->proc_name, offset);
+            print_node_list(x->args, offset);
         } else if (auto x = std::dynamic_pointer_cast<TxnBegin>(node)) {
-            std::cout << "BEGIN\n";
+            std::cout << (x->read_only ? "BEGIN_READ_ONLY\n" : "BEGIN\n");
         } else if (auto x = std::dynamic_pointer_cast<TxnCommit>(node)) {
             std::cout << "COMMIT\n";
         } else if (auto x = std::dynamic_pointer_cast<TxnAbort>(node)) {
             std::cout << "ABORT\n";
         } else if (auto x = std::dynamic_pointer_cast<TxnRollback>(node)) {
             std::cout << "ROLLBACK\n";
+        } else if (auto x = std::dynamic_pointer_cast<Savepoint>(node)) {
+            std::cout << "SAVEPOINT\n";
+            print_val(x->name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<RollbackToSavepoint>(node)) {
+            std::cout << "ROLLBACK_TO_SAVEPOINT\n";
+            print_val(x->name, offset);
+        } else if (auto x = std::dynamic_pointer_cast<ReleaseSavepoint>(node)) {
+            std::cout << "RELEASE_SAVEPOINT\n";
+            print_val(x->name, offset);
         } else {
             assert(0);
         }
@@ -379,8 +379,8 @@ static void yynoreturn yy_fatal_error ( const char* msg  );
 	(yy_hold_char) = *yy_cp; \
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
-#define YY_NUM_RULES 47
-#define YY_END_OF_BUFFER 48
+#define YY_NUM_RULES 77
+#define YY_END_OF_BUFFER 78
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -388,25 +388,39 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static const flex_int16_t yy_accept[154] =
+static const flex_int16_t yy_accept[282] =
     {   0,
-        0,    0,    0,    0,   48,   46,    6,    7,    7,   46,
-       41,   46,   46,   46,   43,   41,   41,   42,   42,   42,
-       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
-       42,   42,   42,   42,    3,    4,    6,    7,    0,   45,
-       43,    5,    1,   44,   39,   40,   38,   42,   42,   42,
-       42,   42,   36,   42,   42,   42,   42,   42,   42,   42,
-       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
-       42,   42,    2,    5,   44,   42,   31,   37,   42,   42,
-       42,   42,   42,   42,   42,   42,   42,   42,   42,   42,
-       42,   27,   42,   42,   42,   42,   25,   42,   42,   42,
-
-       42,   42,   42,   42,   28,   42,   42,   42,   17,   16,
-       33,   42,   22,   34,   42,   42,   19,   32,   42,   42,
-       42,    8,   42,   42,   42,   42,   11,    9,   42,   42,
-       42,   29,   30,   42,   35,   42,   42,   15,   42,   42,
-       23,   10,   14,   21,   18,   42,   26,   13,   24,   20,
-       42,   12,    0
+        0,    0,    0,    0,   78,   76,    6,    7,    7,   76,
+       76,   69,   69,   69,   71,   69,   69,   70,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,    3,    4,
+        6,    7,    0,   74,    0,   73,    5,    1,   72,   71,
+       67,   68,   66,   70,   70,   70,   70,   70,   41,   70,
+       70,   37,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   60,   70,   70,   70,   70,   70,    2,    0,
+
+        0,    5,   72,   70,   53,   70,   32,   38,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   28,   70,
+       70,   70,   70,   70,   70,   70,   70,   70,   70,   70,
+       70,   70,   70,   70,   26,   70,   43,   70,   70,   70,
+       70,   70,   70,   70,   70,   75,   70,   70,   70,   70,
+       55,   29,   70,   70,   70,   70,   70,   70,   18,   17,
+       34,   70,   23,   70,   48,   35,   70,   70,   20,   33,
+       49,   70,   70,   70,   57,   70,   70,   70,   70,   56,
+       70,   70,   70,   70,    8,   70,   50,   70,   70,   70,
+
+       70,   40,   70,   11,   52,   70,    9,   70,   70,   42,
+       70,   70,   70,   30,   44,   31,   70,   70,   70,   70,
+       36,   70,   70,   47,   70,   70,   70,   70,   16,   70,
+       70,   70,   70,   24,   61,   64,   10,   15,   70,   22,
+       19,   70,   70,   70,   70,   70,   70,   70,   70,   27,
+       13,   70,   25,   62,   21,   65,   70,   70,   14,   70,
+       70,   59,   70,   70,   70,   70,   51,   70,   70,   12,
+       70,   63,   70,   45,   54,   58,   70,   46,   70,   39,
+        0
     } ;
 
 static const YY_CHAR yy_ec[256] =
@@ -414,17 +428,17 @@ static const YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1,    1,    1,    1,    2,    3,
         1,    1,    4,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    2,    1,    1,    1,    1,    1,    1,    5,    6,
-        7,    8,    9,   10,   11,   12,   13,   14,   14,   14,
-       14,   14,   14,   14,   14,   14,   14,    1,   15,   16,
-       17,   18,    1,    1,   19,   20,   21,   22,   23,   24,
-       25,   26,   27,   28,   29,   30,   31,   32,   33,   34,
-       35,   36,   37,   38,   39,   40,   41,   42,   43,   35,
-        1,    1,    1,    1,   44,    1,   45,   46,   47,   48,
-
-       49,   50,   51,   52,   53,   54,   55,   56,   57,   58,
-       59,   60,   35,   61,   62,   63,   64,   65,   66,   67,
-       68,   35,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    2,    1,    1,    1,    5,    1,    1,    6,    7,
+        8,    9,   10,   11,   12,   13,   14,   15,   15,   15,
+       15,   15,   15,   15,   15,   15,   15,    1,   16,   17,
+       18,   19,    1,    1,   20,   21,   22,   23,   24,   25,
+       26,   27,   28,   29,   30,   31,   32,   33,   34,   35,
+       36,   37,   38,   39,   40,   41,   42,   43,   44,   45,
+        1,    1,    1,    1,   46,    1,   47,   48,   49,   50,
+
+       51,   52,   53,   54,   55,   56,   57,   58,   59,   60,
+       61,   62,   36,   63,   64,   65,   66,   67,   68,   69,
+       70,   71,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -441,105 +455,162 @@ static const YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static const YY_CHAR yy_meta[69] =
+static const YY_CHAR yy_meta[72] =
     {   0,
         1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    3,    1,    1,    1,    1,    3,    3,
+        1,    1,    1,    1,    3,    1,    1,    1,    1,    3,
         3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
         3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
         3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
         3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3
     } ;
 
-static const flex_int16_t yy_base[158] =
+static const flex_int16_t yy_base[287] =
     {   0,
-        0,    0,  281,  280,  287,  306,  284,  306,  279,  274,
-      306,  261,   58,  265,   59,   57,  238,   50,   54,   50,
-       55,   38,   54,    0,   58,   56,   59,   58,   62,   75,
-       80,   66,   87,   87,  306,  176,  139,  306,   88,  306,
-      116,    0,  306,   75,  306,  306,  306,    0,   84,   98,
-      102,  104,    0,  112,  102,  111,  105,  103,  110,  105,
-      107,  114,  131,  118,  125,  118,  120,  118,  132,  132,
-      126,  142,  306,    0,   71,  136,    0,    0,  148,  145,
-      153,  166,  163,  166,  154,  152,  173,  164,  162,  175,
-      176,  167,  170,  180,  174,  182,    0,  166,  178,  190,
-
-      177,  181,  181,  188,    0,  196,  189,  195,    0,    0,
-        0,  198,    0,    0,  195,  202,    0,    0,  203,  220,
-      222,    0,  222,  209,  225,  227,    0,    0,  215,  228,
-      231,    0,    0,  218,    0,  238,  221,  223,  242,  230,
-        0,    0,    0,    0,    0,  247,    0,    0,    0,    0,
-      241,    0,  306,  296,  299,   76,  302
+        0,    0,  523,  521,  528,  554,  525,  554,  520,   67,
+      515,  554,  508,  509,   60,   58,  499,   57,   59,   64,
+       57,   31,   56,   49,   89,   56,   62,    0,   73,  102,
+       95,  110,  114,  132,  117,   69,  113,  108,  554,  502,
+      472,  554,  409,  330,  186,  554,    0,  554,  131,  130,
+      554,  554,  554,    0,  105,  119,  111,  140,  145,  148,
+      148,    0,  146,  161,  153,  158,  164,  153,  160,  157,
+      162,  165,  165,  169,  182,  178,  172,  174,  185,  176,
+      202,  193,  197,  202,  217,  207,  199,  214,  207,  210,
+      223,  229,    0,  211,  231,  239,  231,  233,  554,   97,
+
+       94,    0,   77,  222,    0,  236,    0,    0,  233,  239,
+      242,  241,  240,  242,  250,  266,  269,  267,  270,  258,
+      256,  276,  266,  262,  272,  268,  281,  283,  274,  276,
+      273,  288,  273,  278,  273,  298,  285,  305,  303,  308,
+      309,  307,  318,  320,    0,  304,    0,  316,  315,  318,
+      332,  315,  317,  317,  324,  554,  323,  326,  324,  320,
+        0,    0,  334,  339,  331,  334,  336,  338,    0,    0,
+        0,  343,    0,  333,    0,    0,  341,  349,    0,    0,
+        0,  354,  372,  369,    0,  363,  370,  377,  380,    0,
+      385,  385,  372,  387,    0,  387,    0,  391,  376,  376,
+
+      394,    0,  396,    0,    0,  386,    0,  389,  388,    0,
+      399,  398,  406,    0,    0,    0,  396,  409,  408,  421,
+        0,  407,  421,    0,  413,  432,  420,  419,  421,  435,
+      436,  430,  427,    0,    0,    0,    0,    0,  428,    0,
+        0,  443,  428,  431,  445,  435,  452,  456,  452,    0,
+        0,  444,    0,    0,    0,    0,  455,  464,    0,  458,
+      459,    0,  467,  465,  475,  474,    0,  471,  482,    0,
+      469,    0,  465,  473,    0,    0,  488,    0,  491,    0,
+      554,  541,  544,   82,  547,  550
     } ;
 
-static const flex_int16_t yy_def[158] =
+static const flex_int16_t yy_def[287] =
     {   0,
-      153,    1,  154,  154,  153,  153,  153,  153,  153,  155,
-      153,  153,  153,  153,  153,  153,  153,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  153,  153,  153,  153,  155,  153,
-      153,  157,  153,  153,  153,  153,  153,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  153,  157,  153,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,  156,  156,  156,  156,  156,  156,  156,  156,
-      156,  156,    0,  153,  153,  153,  153
+      281,    1,  282,  282,  281,  281,  281,  281,  281,  281,
+      283,  281,  281,  281,  281,  281,  281,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  281,  281,
+      281,  281,  285,  281,  283,  281,  286,  281,  281,  281,
+      281,  281,  281,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  281,  285,
+
+      285,  286,  281,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  281,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+      284,  284,  284,  284,  284,  284,  284,  284,  284,  284,
+        0,  281,  281,  281,  281,  281
     } ;
 
-static const flex_int16_t yy_nxt[375] =
+static const flex_int16_t yy_nxt[626] =
     {   0,
-        6,    7,    8,    9,   10,   11,   11,   11,   12,   11,
-       13,   11,   14,   15,   11,   16,   11,   17,   18,   19,
-       20,   21,   22,   23,   24,   25,   26,   27,   24,   24,
-       24,   24,   28,   24,   24,   29,   30,   31,   32,   33,
-       34,   24,   24,    6,   18,   19,   20,   21,   22,   23,
-       24,   25,   26,   27,   24,   24,   24,   24,   28,   24,
-       29,   30,   31,   32,   33,   34,   24,   24,   42,   49,
-       44,   41,   41,   45,   46,   54,   52,   57,   48,   59,
-       62,   50,   55,   60,   75,   56,   51,   63,   75,   61,
-       58,   64,   40,   65,   66,   49,   53,   67,   69,   70,
-
-       68,   54,   52,   57,   59,   71,   62,   50,   55,   60,
-       56,   51,   72,   63,   61,   58,   76,   64,   65,   77,
-       66,   53,   78,   67,   69,   70,   68,   44,   79,   41,
-       80,   71,   81,   82,   83,   85,   86,   87,   72,   88,
-       37,   84,   76,   89,   93,   77,   94,   95,   78,   96,
-       98,   99,   90,  100,   79,  101,   80,   97,   81,   82,
-       83,   85,   86,   87,  102,   88,   84,   91,   92,   89,
-       93,  103,   94,   95,  104,   96,   98,   99,   90,  100,
-      105,  101,   97,  106,  107,  108,  109,  110,   73,  111,
-      102,  112,   91,   92,  113,  114,  103,  115,  116,  117,
-
-      104,  118,  119,  120,  121,  105,  122,  123,  124,  106,
-      107,  108,  109,  110,  111,  125,  126,  112,  127,  128,
-      113,  114,  129,  115,  116,  117,  130,  118,  119,  120,
-      121,  122,  131,  123,  124,  132,  133,  134,  135,  136,
-      125,  126,  137,  127,  138,  128,  139,  140,  129,  141,
-      143,  130,  142,  144,   47,  145,  146,  131,  147,  148,
-      132,  133,  134,  135,  149,  136,  150,  151,  137,  152,
-      138,  139,   43,  140,   41,  141,  143,  142,   40,  144,
-      145,   38,  146,  147,  148,   37,  153,   36,   36,  153,
-      149,  150,  153,  151,  153,  152,   35,   35,   35,   39,
-
-       39,   39,   74,  153,   74,    5,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153
+        6,    7,    8,    9,   10,   11,   12,   12,   12,   12,
+       12,   13,   12,   14,   15,   12,   16,   12,   17,   18,
+       19,   20,   21,   22,   23,   24,   25,   26,   27,   28,
+       29,   30,   28,   31,   32,   28,   33,   34,   35,   36,
+       37,   38,   28,   28,   28,    6,   18,   19,   20,   21,
+       22,   23,   24,   25,   26,   27,   28,   29,   30,   28,
+       31,   32,   33,   34,   35,   36,   37,   38,   28,   28,
+       28,   43,   49,   69,   50,   51,   52,   55,   60,   56,
+       67,   44,   61,   63,   54,   72,   70,   57,   75,   58,
+       64,  103,   71,   68,   59,   76,   77,   65,  156,   69,
+
+       66,  101,   62,   95,   55,   60,   56,   67,   73,   61,
+       63,   72,   74,   70,   57,   75,   58,   64,   71,   68,
+       59,   78,   76,   77,   65,   79,   66,   80,   62,   82,
+       95,   81,   96,   84,   98,   73,   91,   85,  104,   74,
+       97,  105,   49,   92,   50,  103,   83,   86,   78,  106,
+       93,   87,   79,   94,   80,   88,   82,   81,   89,   96,
+       84,   98,  107,   91,   85,  104,  108,   97,  105,  109,
+       92,   90,   83,  110,   86,  106,  111,   93,   87,   94,
+      112,  116,   88,  113,  114,   89,  120,  121,  117,  107,
+      122,   46,  115,  108,  118,  123,  109,   90,  124,  126,
+
+      110,  119,  125,  111,  127,  130,  135,  112,  116,  131,
+      113,  114,  132,  120,  121,  117,  133,  122,  115,  128,
+      129,  118,  123,  134,  136,  124,  126,  119,  125,  137,
+      138,  127,  130,  135,  139,  131,  140,  142,  132,  143,
+      146,  147,  133,  148,  144,  128,  129,  141,  149,  134,
+      150,  136,  145,  151,  154,  137,  155,  138,  157,  158,
+      152,  139,  159,  140,  142,  143,  160,  146,  147,  153,
+      148,  144,  161,  164,  141,  149,  150,  162,  145,  163,
+      151,  154,  165,  155,  157,  166,  158,  152,  167,  159,
+      168,  169,  170,  160,  171,  172,  153,  173,  175,  161,
+
+      164,  174,  176,  162,  177,  163,  178,  179,  180,  165,
+      181,  182,  166,  183,  184,  167,  185,  168,  169,  170,
+      171,  186,  172,  187,  173,  175,  188,  174,  189,  176,
+      190,  177,  191,  178,  179,  180,  181,  192,  182,  183,
+      184,  193,  185,  194,   44,  195,  196,  197,  186,  187,
+      198,  199,  207,  188,  200,  189,  201,  190,  202,  191,
+      203,  204,  205,  206,  192,  208,  209,  215,  193,  210,
+      194,  195,  211,  196,  197,  212,  213,  198,  199,  207,
+      200,  214,  201,  216,  202,  217,  203,  204,  205,  206,
+      218,  219,  208,  209,  215,  210,  220,  222,  211,  221,
+
+      223,  212,  213,  224,  225,  226,  227,  214,  228,  216,
+      229,  217,  230,  101,  231,  232,  218,  233,  219,  234,
+      235,  236,  238,  220,  222,  221,  237,  223,  239,  240,
+      224,  225,  226,  227,  241,  228,  242,  229,  243,  230,
+      231,  232,  244,  246,  233,  245,  234,  235,  236,  238,
+      247,  248,  237,  249,  252,  239,  240,  250,  251,  253,
+      241,  254,  257,  242,  255,  243,  256,  258,  259,  244,
+      246,  245,  260,   41,  261,  262,  247,  263,  248,  264,
+      249,  252,  265,  250,  251,  266,  253,  267,  254,  257,
+      255,  268,  256,  258,  259,  269,  270,  271,  272,  260,
+
+      261,  273,  262,  274,  263,  275,  264,  276,  265,  277,
+      278,  279,  266,  280,  267,   99,   53,   48,  268,   47,
+       46,  269,   42,  270,  271,  272,   41,  281,  273,   40,
+      274,   40,  275,  276,  281,  277,  278,  281,  279,  281,
+      280,   39,   39,   39,   45,   45,   45,  100,  100,  100,
+      102,  281,  102,    5,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281
     } ;
 
-static const flex_int16_t yy_chk[375] =
+static const flex_int16_t yy_chk[626] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -547,41 +618,69 @@ static const flex_int16_t yy_chk[375] =
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,   13,   18,
-       15,   13,   15,   16,   16,   20,   19,   21,  156,   22,
-       25,   18,   20,   23,   75,   20,   18,   26,   44,   23,
-       21,   27,   39,   28,   29,   18,   19,   30,   31,   32,
-
-       30,   20,   19,   21,   22,   33,   25,   18,   20,   23,
-       20,   18,   34,   26,   23,   21,   49,   27,   28,   50,
-       29,   19,   51,   30,   31,   32,   30,   41,   52,   41,
-       54,   33,   55,   56,   57,   58,   59,   60,   34,   61,
-       37,   57,   49,   62,   64,   50,   65,   66,   51,   67,
-       68,   69,   63,   70,   52,   71,   54,   67,   55,   56,
-       57,   58,   59,   60,   72,   61,   57,   63,   63,   62,
-       64,   76,   65,   66,   79,   67,   68,   69,   63,   70,
-       80,   71,   67,   81,   82,   83,   84,   85,   36,   86,
-       72,   87,   63,   63,   88,   89,   76,   90,   91,   92,
-
-       79,   93,   94,   95,   96,   80,   98,   99,  100,   81,
-       82,   83,   84,   85,   86,  101,  102,   87,  103,  104,
-       88,   89,  106,   90,   91,   92,  107,   93,   94,   95,
-       96,   98,  108,   99,  100,  112,  115,  116,  119,  120,
-      101,  102,  121,  103,  123,  104,  124,  125,  106,  126,
-      130,  107,  129,  131,   17,  134,  136,  108,  137,  138,
-      112,  115,  116,  119,  139,  120,  140,  146,  121,  151,
-      123,  124,   14,  125,   12,  126,  130,  129,   10,  131,
-      134,    9,  136,  137,  138,    7,    5,    4,    3,    0,
-      139,  140,    0,  146,    0,  151,  154,  154,  154,  155,
-
-      155,  155,  157,    0,  157,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153,  153,  153,  153,  153,  153,  153,
-      153,  153,  153,  153
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,   10,   15,   22,   15,   16,   16,   18,   19,   18,
+       21,   10,   19,   20,  284,   24,   23,   18,   26,   18,
+       20,  103,   23,   21,   18,   27,   29,   20,  101,   22,
+
+       20,  100,   19,   36,   18,   19,   18,   21,   25,   19,
+       20,   24,   25,   23,   18,   26,   18,   20,   23,   21,
+       18,   30,   27,   29,   20,   30,   20,   31,   19,   32,
+       36,   31,   37,   33,   38,   25,   35,   33,   55,   25,
+       37,   56,   50,   35,   50,   49,   32,   33,   30,   57,
+       35,   34,   30,   35,   31,   34,   32,   31,   34,   37,
+       33,   38,   58,   35,   33,   55,   59,   37,   56,   60,
+       35,   34,   32,   61,   33,   57,   63,   35,   34,   35,
+       64,   66,   34,   65,   65,   34,   68,   69,   67,   58,
+       70,   45,   65,   59,   67,   71,   60,   34,   72,   74,
+
+       61,   67,   73,   63,   75,   76,   80,   64,   66,   77,
+       65,   65,   78,   68,   69,   67,   78,   70,   65,   75,
+       75,   67,   71,   79,   81,   72,   74,   67,   73,   82,
+       83,   75,   76,   80,   84,   77,   85,   86,   78,   87,
+       89,   90,   78,   91,   88,   75,   75,   85,   92,   79,
+       94,   81,   88,   95,   97,   82,   98,   83,  104,  106,
+       96,   84,  109,   85,   86,   87,  110,   89,   90,   96,
+       91,   88,  111,  114,   85,   92,   94,  112,   88,  113,
+       95,   97,  115,   98,  104,  116,  106,   96,  117,  109,
+      118,  119,  120,  110,  121,  122,   96,  123,  125,  111,
+
+      114,  124,  126,  112,  127,  113,  128,  129,  130,  115,
+      131,  132,  116,  133,  134,  117,  135,  118,  119,  120,
+      121,  136,  122,  137,  123,  125,  138,  124,  139,  126,
+      140,  127,  141,  128,  129,  130,  131,  142,  132,  133,
+      134,  143,  135,  144,   44,  146,  148,  149,  136,  137,
+      150,  151,  160,  138,  152,  139,  153,  140,  154,  141,
+      155,  157,  158,  159,  142,  163,  164,  174,  143,  165,
+      144,  146,  166,  148,  149,  167,  168,  150,  151,  160,
+      152,  172,  153,  177,  154,  178,  155,  157,  158,  159,
+      182,  183,  163,  164,  174,  165,  184,  187,  166,  186,
+
+      188,  167,  168,  189,  191,  192,  193,  172,  194,  177,
+      196,  178,  198,   43,  199,  200,  182,  201,  183,  203,
+      206,  208,  211,  184,  187,  186,  209,  188,  212,  213,
+      189,  191,  192,  193,  217,  194,  218,  196,  219,  198,
+      199,  200,  220,  223,  201,  222,  203,  206,  208,  211,
+      225,  226,  209,  227,  230,  212,  213,  228,  229,  231,
+      217,  232,  242,  218,  233,  219,  239,  243,  244,  220,
+      223,  222,  245,   41,  246,  247,  225,  248,  226,  249,
+      227,  230,  252,  228,  229,  257,  231,  258,  232,  242,
+      233,  260,  239,  243,  244,  261,  263,  264,  265,  245,
+
+      246,  266,  247,  268,  248,  269,  249,  271,  252,  273,
+      274,  277,  257,  279,  258,   40,   17,   14,  260,   13,
+       11,  261,    9,  263,  264,  265,    7,    5,  266,    4,
+      268,    3,  269,  271,    0,  273,  274,    0,  277,    0,
+      279,  282,  282,  282,  283,  283,  283,  285,  285,  285,
+      286,    0,  286,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281,  281,  281,  281,  281,  281,
+      281,  281,  281,  281,  281
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -623,9 +722,9 @@ char *yytext;
         } \
     }
 
-#line 626 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 725 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
-#line 628 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 727 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
 #define INITIAL 0
 #define STATE_COMMENT 1
@@ -859,11 +958,11 @@ YY_DECL
 		}
 
 	{
-#line 46 "lex.l"
+#line 47 "lex.l"
 
-#line 48 "lex.l"
+#line 49 "lex.l"
     /* block comment */
-#line 866 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 965 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -890,13 +989,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 154 )
+				if ( yy_current_state >= 282 )
 					yy_c = yy_meta[yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 306 );
+		while ( yy_base[yy_current_state] != 554 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -922,268 +1021,425 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 49 "lex.l"
+#line 50 "lex.l"
 { BEGIN(STATE_COMMENT); }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 50 "lex.l"
+#line 51 "lex.l"
 { BEGIN(INITIAL); }
 	YY_BREAK
 case 3:
 /* rule 3 can match eol */
 YY_RULE_SETUP
-#line 51 "lex.l"
+#line 52 "lex.l"
 { /* ignore the text of the comment */ }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 52 "lex.l"
+#line 53 "lex.l"
 { /* ignore *'s that aren't part of */ }
 	YY_BREAK
 /* single line comment */
 case 5:
 YY_RULE_SETUP
-#line 54 "lex.l"
+#line 55 "lex.l"
 { /* ignore single line comment */ }
 	YY_BREAK
 /* white space and new line */
 case 6:
 YY_RULE_SETUP
-#line 56 "lex.l"
+#line 57 "lex.l"
 { /* ignore white space */ }
 	YY_BREAK
 case 7:
 /* rule 7 can match eol */
 YY_RULE_SETUP
-#line 57 "lex.l"
+#line 58 "lex.l"
 { /* ignore new line */ }
 	YY_BREAK
 /* keywords */
 case 8:
 YY_RULE_SETUP
-#line 59 "lex.l"
+#line 60 "lex.l"
 { return SHOW; }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 60 "lex.l"
+#line 61 "lex.l"
 { return TXN_BEGIN; }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 61 "lex.l"
+#line 62 "lex.l"
 { return TXN_COMMIT; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 62 "lex.l"
+#line 63 "lex.l"
 { return TXN_ABORT; }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 63 "lex.l"
+#line 64 "lex.l"
 { return TXN_ROLLBACK; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 64 "lex.l"
+#line 65 "lex.l"
 { return TABLES; }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 65 "lex.l"
-{ return CREATE; }
+#line 66 "lex.l"
+{ return METRICS; }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 66 "lex.l"
-{ return TABLE; }
+#line 67 "lex.l"
+{ return CREATE; }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 67 "lex.l"
-{ return DROP; }
+#line 68 "lex.l"
+{ return TABLE; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 68 "lex.l"
-{ return DESC; }
+#line 69 "lex.l"
+{ return DROP; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 69 "lex.l"
-{ return INSERT; }
+#line 70 "lex.l"
+{ return DESC; }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 70 "lex.l"
-{ return INTO; }
+#line 71 "lex.l"
+{ return INSERT; }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 71 "lex.l"
-{ return VALUES; }
+#line 72 "lex.l"
+{ return INTO; }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 72 "lex.l"
-{ return DELETE; }
+#line 73 "lex.l"
+{ return VALUES; }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 73 "lex.l"
-{ return FROM; }
+#line 74 "lex.l"
+{ return DELETE; }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 74 "lex.l"
-{ return WHERE; }
+#line 75 "lex.l"
+{ return FROM; }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 75 "lex.l"
-{ return UPDATE; }
+#line 76 "lex.l"
+{ return WHERE; }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 76 "lex.l"
-{ return SET; }
+#line 77 "lex.l"
+{ return UPDATE; }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 77 "lex.l"
-{ return SELECT; }
+#line 78 "lex.l"
+{ return SET; }
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 78 "lex.l"
-{ return INT; }
+#line 79 "lex.l"
+{ return SELECT; }
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 79 "lex.l"
-{ return CHAR; }
+#line 80 "lex.l"
+{ return INT; }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 80 "lex.l"
-{ return FLOAT; }
+#line 81 "lex.l"
+{ return CHAR; }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 81 "lex.l"
-{ return INDEX; }
+#line 82 "lex.l"
+{ return FLOAT; }
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 82 "lex.l"
-{ return AND; }
+#line 83 "lex.l"
+{ return INDEX; }
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 83 "lex.l"
-{return JOIN;}
+#line 84 "lex.l"
+{ return AND; }
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 84 "lex.l"
-{ return EXIT; }
+#line 85 "lex.l"
+{return JOIN;}
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 85 "lex.l"
-{ return HELP; }
+#line 86 "lex.l"
+{ return EXIT; }
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 86 "lex.l"
-{ return ORDER; }
+#line 87 "lex.l"
+{ return HELP; }
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 87 "lex.l"
-{  return BY;  }
+#line 88 "lex.l"
+{ return ORDER; }
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 88 "lex.l"
-{ return ASC; }
+#line 89 "lex.l"
+{  return BY;  }
 	YY_BREAK
-/* operators */
 case 38:
 YY_RULE_SETUP
 #line 90 "lex.l"
-{ return GEQ; }
+{ return ASC; }
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
 #line 91 "lex.l"
-{ return LEQ; }
+{ return MATERIALIZED; }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
 #line 92 "lex.l"
-{ return NEQ; }
+{ return VIEW; }
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
 #line 93 "lex.l"
-{ return yytext[0]; }
+{ return AS; }
 	YY_BREAK
-/* id */
 case 42:
 YY_RULE_SETUP
+#line 94 "lex.l"
+{ return COUNT; }
+	YY_BREAK
+case 43:
+YY_RULE_SETUP
 #line 95 "lex.l"
+{ return SUM; }
+	YY_BREAK
+case 44:
+YY_RULE_SETUP
+#line 96 "lex.l"
+{ return GROUP; }
+	YY_BREAK
+case 45:
+YY_RULE_SETUP
+#line 97 "lex.l"
+{ return PARTITION; }
+	YY_BREAK
+case 46:
+YY_RULE_SETUP
+#line 98 "lex.l"
+{ return PARTITIONS; }
+	YY_BREAK
+case 47:
+YY_RULE_SETUP
+#line 99 "lex.l"
+{ return RANGE; }
+	YY_BREAK
+case 48:
+YY_RULE_SETUP
+#line 100 "lex.l"
+{ return HASH; }
+	YY_BREAK
+case 49:
+YY_RULE_SETUP
+#line 101 "lex.l"
+{ return LESS; }
+	YY_BREAK
+case 50:
+YY_RULE_SETUP
+#line 102 "lex.l"
+{ return THAN; }
+	YY_BREAK
+case 51:
+YY_RULE_SETUP
+#line 103 "lex.l"
+{ return MAXVALUE; }
+	YY_BREAK
+case 52:
+YY_RULE_SETUP
+#line 104 "lex.l"
+{ return ALTER; }
+	YY_BREAK
+case 53:
+YY_RULE_SETUP
+#line 105 "lex.l"
+{ return ADD; }
+	YY_BREAK
+case 54:
+YY_RULE_SETUP
+#line 106 "lex.l"
+{ return PROCEDURE; }
+	YY_BREAK
+case 55:
+YY_RULE_SETUP
+#line 107 "lex.l"
+{ return CALL; }
+	YY_BREAK
+case 56:
+YY_RULE_SETUP
+#line 108 "lex.l"
+{ return READ; }
+	YY_BREAK
+case 57:
+YY_RULE_SETUP
+#line 109 "lex.l"
+{ return ONLY; }
+	YY_BREAK
+case 58:
+YY_RULE_SETUP
+#line 110 "lex.l"
+{ return SAVEPOINT; }
+	YY_BREAK
+case 59:
+YY_RULE_SETUP
+#line 111 "lex.l"
+{ return RELEASE; }
+	YY_BREAK
+case 60:
+YY_RULE_SETUP
+#line 112 "lex.l"
+{ return TO; }
+	YY_BREAK
+case 61:
+YY_RULE_SETUP
+#line 113 "lex.l"
+{ return BACKUP; }
+	YY_BREAK
+case 62:
+YY_RULE_SETUP
+#line 114 "lex.l"
+{ return VACUUM; }
+	YY_BREAK
+case 63:
+YY_RULE_SETUP
+#line 115 "lex.l"
+{ return TRUNCATE; }
+	YY_BREAK
+case 64:
+YY_RULE_SETUP
+#line 116 "lex.l"
+{ return COLUMN; }
+	YY_BREAK
+case 65:
+YY_RULE_SETUP
+#line 117 "lex.l"
+{ return DEFAULT; }
+	YY_BREAK
+/* operators */
+case 66:
+YY_RULE_SETUP
+#line 119 "lex.l"
+{ return GEQ; }
+	YY_BREAK
+case 67:
+YY_RULE_SETUP
+#line 120 "lex.l"
+{ return LEQ; }
+	YY_BREAK
+case 68:
+YY_RULE_SETUP
+#line 121 "lex.l"
+{ return NEQ; }
+	YY_BREAK
+case 69:
+YY_RULE_SETUP
+#line 122 "lex.l"
+{ return yytext[0]; }
+	YY_BREAK
+/* id */
+case 70:
+YY_RULE_SETUP
+#line 124 "lex.l"
 {
     yylval->sv_str = yytext;
     return IDENTIFIER;
 }
 	YY_BREAK
 /* literals */
-case 43:
+case 71:
 YY_RULE_SETUP
-#line 100 "lex.l"
+#line 129 "lex.l"
 {
     yylval->sv_int = atoi(yytext);
     return VALUE_INT;
 }
 	YY_BREAK
-case 44:
+case 72:
 YY_RULE_SETUP
-#line 104 "lex.l"
+#line 133 "lex.l"
 {
     yylval->sv_float = atof(yytext);
     return VALUE_FLOAT;
 }
 	YY_BREAK
-case 45:
-/* rule 45 can match eol */
+case 73:
+/* rule 73 can match eol */
 YY_RULE_SETUP
-#line 108 "lex.l"
+#line 137 "lex.l"
 {
     yylval->sv_str = std::string(yytext + 1, strlen(yytext) - 2);
     return VALUE_STRING;
 }
 	YY_BREAK
+case 74:
+YY_RULE_SETUP
+#line 141 "lex.l"
+{
+    yylval->sv_int = atoi(yytext + 1);
+    return VALUE_PARAM;
+}
+	YY_BREAK
+case 75:
+/* rule 75 can match eol */
+YY_RULE_SETUP
+#line 145 "lex.l"
+{
+    yylval->sv_str = std::string(yytext + 2, strlen(yytext) - 4);
+    return VALUE_PROC_BODY;
+}
+	YY_BREAK
 /* EOF */
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STATE_COMMENT):
-#line 113 "lex.l"
+#line 150 "lex.l"
 { return T_EOF; }
 	YY_BREAK
 /* unexpected char */
-case 46:
+case 76:
 YY_RULE_SETUP
-#line 115 "lex.l"
+#line 152 "lex.l"
 { std::cerr << "Lexer Error: unexpected character " << yytext[0] << std::endl; }
 	YY_BREAK
-case 47:
+case 77:
 YY_RULE_SETUP
-#line 116 "lex.l"
+#line 153 "lex.l"
 ECHO;
 	YY_BREAK
-#line 1186 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
+#line 1442 "/Users/sxy/Documents/projects/rucbase/src/parser/lex.yy.cpp"
 
 	case YY_END_OF_BUFFER:
 		{
@@ -1478,7 +1734,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 154 )
+			if ( yy_current_state >= 282 )
 				yy_c = yy_meta[yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
@@ -1506,11 +1762,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 154 )
+		if ( yy_current_state >= 282 )
 			yy_c = yy_meta[yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-	yy_is_jam = (yy_current_state == 153);
+	yy_is_jam = (yy_current_state == 281);
 
 		return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2149,6 +2405,6 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 116 "lex.l"
+#line 153 "lex.l"
 
 
@@ -67,7 +67,7 @@
 
 
 /* First part of user prologue.  */
-#line 1 "/content/rucbase-lab/src/parser/yacc.y"
+#line 1 "/root/repo/rucbase-lab/src/parser/yacc.y"
 
 #include "ast.h"
 #include "yacc.tab.h"
@@ -82,7 +82,7 @@ void yyerror(YYLTYPE *locp, const char* s) {
 
 using namespace ast;
 
-#line 86 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 86 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -144,52 +144,94 @@ enum yysymbol_kind_t
   YYSYMBOL_TXN_ABORT = 31,                 /* TXN_ABORT  */
   YYSYMBOL_TXN_ROLLBACK = 32,              /* TXN_ROLLBACK  */
   YYSYMBOL_ORDER_BY = 33,                  /* ORDER_BY  */
-  YYSYMBOL_LEQ = 34,                       /* LEQ  */
-  YYSYMBOL_NEQ = 35,                       /* NEQ  */
-  YYSYMBOL_GEQ = 36,                       /* GEQ  */
-  YYSYMBOL_T_EOF = 37,                     /* T_EOF  */
-  YYSYMBOL_IDENTIFIER = 38,                /* IDENTIFIER  */
-  YYSYMBOL_VALUE_STRING = 39,              /* VALUE_STRING  */
-  YYSYMBOL_VALUE_INT = 40,                 /* VALUE_INT  */
-  YYSYMBOL_VALUE_FLOAT = 41,               /* VALUE_FLOAT  */
-  YYSYMBOL_42_ = 42,                       /* ';'  */
-  YYSYMBOL_43_ = 43,                       /* '('  */
-  YYSYMBOL_44_ = 44,                       /* ')'  */
-  YYSYMBOL_45_ = 45,                       /* ','  */
-  YYSYMBOL_46_ = 46,                       /* '.'  */
-  YYSYMBOL_47_ = 47,                       /* '='  */
-  YYSYMBOL_48_ = 48,                       /* '<'  */
-  YYSYMBOL_49_ = 49,                       /* '>'  */
-  YYSYMBOL_50_ = 50,                       /* '*'  */
-  YYSYMBOL_YYACCEPT = 51,                  /* $accept  */
-  YYSYMBOL_start = 52,                     /* start  */
-  YYSYMBOL_stmt = 53,                      /* stmt  */
-  YYSYMBOL_txnStmt = 54,                   /* txnStmt  */
-  YYSYMBOL_dbStmt = 55,                    /* dbStmt  */
-  YYSYMBOL_ddl = 56,                       /* ddl  */
-  YYSYMBOL_dml = 57,                       /* dml  */
-  YYSYMBOL_fieldList = 58,                 /* fieldList  */
-  YYSYMBOL_colNameList = 59,               /* colNameList  */
-  YYSYMBOL_field = 60,                     /* field  */
-  YYSYMBOL_type = 61,                      /* type  */
-  YYSYMBOL_valueList = 62,                 /* valueList  */
-  YYSYMBOL_value = 63,                     /* value  */
-  YYSYMBOL_condition = 64,                 /* condition  */
-  YYSYMBOL_optWhereClause = 65,            /* optWhereClause  */
-  YYSYMBOL_whereClause = 66,               /* whereClause  */
-  YYSYMBOL_col = 67,                       /* col  */
-  YYSYMBOL_colList = 68,                   /* colList  */
-  YYSYMBOL_op = 69,                        /* op  */
-  YYSYMBOL_expr = 70,                      /* expr  */
-  YYSYMBOL_setClauses = 71,                /* setClauses  */
-  YYSYMBOL_setClause = 72,                 /* setClause  */
-  YYSYMBOL_selector = 73,                  /* selector  */
-  YYSYMBOL_tableList = 74,                 /* tableList  */
-  YYSYMBOL_opt_order_clause = 75,          /* opt_order_clause  */
-  YYSYMBOL_order_clause = 76,              /* order_clause  */
-  YYSYMBOL_opt_asc_desc = 77,              /* opt_asc_desc  */
-  YYSYMBOL_tbName = 78,                    /* tbName  */
-  YYSYMBOL_colName = 79                    /* colName  */
+  YYSYMBOL_MATERIALIZED = 34,              /* MATERIALIZED  */
+  YYSYMBOL_VIEW = 35,                      /* VIEW  */
+  YYSYMBOL_AS = 36,                        /* AS  */
+  YYSYMBOL_COUNT = 37,                     /* COUNT  */
+  YYSYMBOL_SUM = 38,                       /* SUM  */
+  YYSYMBOL_GROUP = 39,                     /* GROUP  */
+  YYSYMBOL_PARTITION = 40,                 /* PARTITION  */
+  YYSYMBOL_PARTITIONS = 41,                /* PARTITIONS  */
+  YYSYMBOL_RANGE = 42,                     /* RANGE  */
+  YYSYMBOL_HASH = 43,                      /* HASH  */
+  YYSYMBOL_LESS = 44,                      /* LESS  */
+  YYSYMBOL_THAN = 45,                      /* THAN  */
+  YYSYMBOL_MAXVALUE = 46,                  /* MAXVALUE  */
+  YYSYMBOL_ALTER = 47,                     /* ALTER  */
+  YYSYMBOL_ADD = 48,                       /* ADD  */
+  YYSYMBOL_PROCEDURE = 49,                 /* PROCEDURE  */
+  YYSYMBOL_CALL = 50,                      /* CALL  */
+  YYSYMBOL_READ = 51,                      /* READ  */
+  YYSYMBOL_ONLY = 52,                      /* ONLY  */
+  YYSYMBOL_METRICS = 53,                   /* METRICS  */
+  YYSYMBOL_SAVEPOINT = 54,                 /* SAVEPOINT  */
+  YYSYMBOL_RELEASE = 55,                   /* RELEASE  */
+  YYSYMBOL_TO = 56,                        /* TO  */
+  YYSYMBOL_BACKUP = 57,                    /* BACKUP  */
+  YYSYMBOL_VACUUM = 58,                    /* VACUUM  */
+  YYSYMBOL_TRUNCATE = 59,                  /* TRUNCATE  */
+  YYSYMBOL_COLUMN = 60,                    /* COLUMN  */
+  YYSYMBOL_DEFAULT = 61,                   /* DEFAULT  */
+  YYSYMBOL_LEQ = 62,                       /* LEQ  */
+  YYSYMBOL_NEQ = 63,                       /* NEQ  */
+  YYSYMBOL_GEQ = 64,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 65,                     /* T_EOF  */
+  YYSYMBOL_IDENTIFIER = 66,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_STRING = 67,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_PROC_BODY = 68,           /* VALUE_PROC_BODY  */
+  YYSYMBOL_VALUE_INT = 69,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_PARAM = 70,               /* VALUE_PARAM  */
+  YYSYMBOL_VALUE_FLOAT = 71,               /* VALUE_FLOAT  */
+  YYSYMBOL_72_ = 72,                       /* ';'  */
+  YYSYMBOL_73_ = 73,                       /* '='  */
+  YYSYMBOL_74_ = 74,                       /* '('  */
+  YYSYMBOL_75_ = 75,                       /* ')'  */
+  YYSYMBOL_76_ = 76,                       /* ','  */
+  YYSYMBOL_77_ = 77,                       /* '-'  */
+  YYSYMBOL_78_ = 78,                       /* '.'  */
+  YYSYMBOL_79_ = 79,                       /* '*'  */
+  YYSYMBOL_80_ = 80,                       /* '<'  */
+  YYSYMBOL_81_ = 81,                       /* '>'  */
+  YYSYMBOL_82_ = 82,                       /* '+'  */
+  YYSYMBOL_83_ = 83,                       /* '/'  */
+  YYSYMBOL_YYACCEPT = 84,                  /* $accept  */
+  YYSYMBOL_start = 85,                     /* start  */
+  YYSYMBOL_stmt = 86,                      /* stmt  */
+  YYSYMBOL_txnStmt = 87,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 88,                    /* dbStmt  */
+  YYSYMBOL_ddl = 89,                       /* ddl  */
+  YYSYMBOL_optPartitionClause = 90,        /* optPartitionClause  */
+  YYSYMBOL_rangePartList = 91,             /* rangePartList  */
+  YYSYMBOL_rangePart = 92,                 /* rangePart  */
+  YYSYMBOL_dml = 93,                       /* dml  */
+  YYSYMBOL_selectStmt = 94,                /* selectStmt  */
+  YYSYMBOL_fieldList = 95,                 /* fieldList  */
+  YYSYMBOL_colNameList = 96,               /* colNameList  */
+  YYSYMBOL_field = 97,                     /* field  */
+  YYSYMBOL_type = 98,                      /* type  */
+  YYSYMBOL_valueList = 99,                 /* valueList  */
+  YYSYMBOL_value = 100,                    /* value  */
+  YYSYMBOL_literal = 101,                  /* literal  */
+  YYSYMBOL_condition = 102,                /* condition  */
+  YYSYMBOL_optWhereClause = 103,           /* optWhereClause  */
+  YYSYMBOL_whereClause = 104,              /* whereClause  */
+  YYSYMBOL_col = 105,                      /* col  */
+  YYSYMBOL_aggCol = 106,                   /* aggCol  */
+  YYSYMBOL_colList = 107,                  /* colList  */
+  YYSYMBOL_op = 108,                       /* op  */
+  YYSYMBOL_expr = 109,                     /* expr  */
+  YYSYMBOL_term = 110,                     /* term  */
+  YYSYMBOL_factor = 111,                   /* factor  */
+  YYSYMBOL_setClauses = 112,               /* setClauses  */
+  YYSYMBOL_setClause = 113,                /* setClause  */
+  YYSYMBOL_selector = 114,                 /* selector  */
+  YYSYMBOL_tableList = 115,                /* tableList  */
+  YYSYMBOL_opt_group_clause = 116,         /* opt_group_clause  */
+  YYSYMBOL_opt_order_clause = 117,         /* opt_order_clause  */
+  YYSYMBOL_order_clause = 118,             /* order_clause  */
+  YYSYMBOL_opt_asc_desc = 119,             /* opt_asc_desc  */
+  YYSYMBOL_tbName = 120,                   /* tbName  */
+  YYSYMBOL_colName = 121                   /* colName  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -306,7 +348,7 @@ typedef int yytype_uint16;
 
 
 /* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
+typedef yytype_int16 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -518,21 +560,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  39
+#define YYFINAL  67
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   112
+#define YYLAST   262
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  51
+#define YYNTOKENS  84
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  29
+#define YYNNTS  38
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  69
+#define YYNRULES  121
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  127
+#define YYNSTATES  262
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   296
+#define YYMAXUTOK   326
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -550,9 +592,9 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      43,    44,    50,     2,    45,     2,    46,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    42,
-      48,    47,    49,     2,     2,     2,     2,     2,     2,     2,
+      74,    75,    79,    82,    76,    77,    78,    83,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    72,
+      80,    73,    81,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -575,20 +617,29 @@ static const yytype_int8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    56,    56,    61,    66,    71,    79,    80,    81,    82,
-      86,    90,    94,    98,   105,   112,   116,   120,   124,   128,
-     135,   139,   143,   147,   154,   158,   165,   169,   176,   183,
-     187,   191,   198,   202,   209,   213,   217,   224,   231,   232,
-     239,   243,   250,   254,   261,   265,   272,   276,   280,   284,
-     288,   292,   299,   303,   310,   314,   321,   328,   332,   336,
-     340,   344,   351,   355,   359,   366,   367,   368,   371,   373
+       0,    61,    61,    66,    71,    76,    84,    85,    86,    87,
+      91,    95,    99,   103,   107,   111,   115,   119,   123,   127,
+     134,   138,   142,   146,   150,   154,   158,   165,   169,   173,
+     177,   181,   185,   189,   193,   197,   201,   205,   209,   213,
+     217,   221,   225,   232,   236,   241,   247,   251,   258,   262,
+     266,   273,   277,   281,   285,   289,   293,   297,   304,   308,
+     315,   319,   326,   333,   337,   341,   348,   352,   359,   360,
+     364,   371,   375,   379,   383,   390,   397,   398,   405,   409,
+     416,   420,   427,   431,   438,   442,   446,   450,   457,   461,
+     465,   469,   473,   477,   484,   485,   489,   496,   497,   501,
+     508,   512,   516,   520,   533,   537,   544,   551,   555,   559,
+     563,   567,   574,   578,   582,   586,   590,   597,   598,   599,
+     602,   604
 };
 #endif
 
@@ -608,14 +659,21 @@ static const char *const yytname[] =
   "CREATE", "TABLE", "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE",
   "FROM", "ASC", "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT",
   "CHAR", "FLOAT", "INDEX", "AND", "JOIN", "EXIT", "HELP", "TXN_BEGIN",
-  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "LEQ", "NEQ",
-  "GEQ", "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT",
-  "';'", "'('", "')'", "','", "'.'", "'='", "'<'", "'>'", "'*'", "$accept",
-  "start", "stmt", "txnStmt", "dbStmt", "ddl", "dml", "fieldList",
-  "colNameList", "field", "type", "valueList", "value", "condition",
-  "optWhereClause", "whereClause", "col", "colList", "op", "expr",
-  "setClauses", "setClause", "selector", "tableList", "opt_order_clause",
-  "order_clause", "opt_asc_desc", "tbName", "colName", YY_NULLPTR
+  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "MATERIALIZED",
+  "VIEW", "AS", "COUNT", "SUM", "GROUP", "PARTITION", "PARTITIONS",
+  "RANGE", "HASH", "LESS", "THAN", "MAXVALUE", "ALTER", "ADD", "PROCEDURE",
+  "CALL", "READ", "ONLY", "METRICS", "SAVEPOINT", "RELEASE", "TO",
+  "BACKUP", "VACUUM", "TRUNCATE", "COLUMN", "DEFAULT", "LEQ", "NEQ", "GEQ",
+  "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_PROC_BODY", "VALUE_INT",
+  "VALUE_PARAM", "VALUE_FLOAT", "';'", "'='", "'('", "')'", "','", "'-'",
+  "'.'", "'*'", "'<'", "'>'", "'+'", "'/'", "$accept", "start", "stmt",
+  "txnStmt", "dbStmt", "ddl", "optPartitionClause", "rangePartList",
+  "rangePart", "dml", "selectStmt", "fieldList", "colNameList", "field",
+  "type", "valueList", "value", "literal", "condition", "optWhereClause",
+  "whereClause", "col", "aggCol", "colList", "op", "expr", "term",
+  "factor", "setClauses", "setClause", "selector", "tableList",
+  "opt_group_clause", "opt_order_clause", "order_clause", "opt_asc_desc",
+  "tbName", "colName", YY_NULLPTR
 };
 
 static const char *
@@ -625,33 +683,47 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-75)
+#define YYPACT_NINF (-224)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-69)
+#define YYTABLE_NINF (-121)
 
 #define yytable_value_is_error(Yyn) \
   0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-static const yytype_int8 yypact[] =
+static const yytype_int16 yypact[] =
 {
-      42,    21,     5,     8,    -2,    32,    31,    -2,   -26,   -75,
-     -75,   -75,   -75,   -75,   -75,   -75,    52,     6,   -75,   -75,
-     -75,   -75,   -75,    -2,    -2,    -2,    -2,   -75,   -75,    -2,
-      -2,    34,    13,   -75,   -75,    16,    55,    39,   -75,   -75,
-     -75,    43,    44,   -75,    45,    78,    73,    53,    54,    -2,
-      53,    53,    53,    53,    50,    54,   -75,   -75,    -4,   -75,
-      51,   -75,    -7,   -75,   -75,   -11,   -75,    -5,    22,   -75,
-      33,    24,   -75,    74,    48,    53,   -75,    24,    -2,    -2,
-      85,   -75,    53,   -75,    58,   -75,   -75,   -75,    53,   -75,
-     -75,   -75,   -75,    36,   -75,    54,   -75,   -75,   -75,   -75,
-     -75,   -75,    17,   -75,   -75,   -75,   -75,    86,   -75,   -75,
-      63,   -75,   -75,    24,   -75,   -75,   -75,   -75,    54,    60,
-     -75,     1,   -75,   -75,   -75,   -75,   -75
+      90,     2,    33,    34,   -32,    46,    52,   -32,    47,    25,
+    -224,  -224,    76,  -224,  -224,    75,   129,   -32,    72,   -43,
+      95,   -32,   140,  -224,   156,    87,  -224,  -224,  -224,  -224,
+    -224,  -224,  -224,   -32,   -32,   130,   -32,   -32,   -32,   147,
+     -32,  -224,  -224,   -32,   -32,   166,   113,   114,   115,   109,
+    -224,  -224,  -224,   116,   177,   117,  -224,   139,   -34,   -32,
+     119,  -224,   128,  -224,   131,  -224,   -32,  -224,  -224,   122,
+     123,   -32,   125,  -224,   126,   -32,  -224,   190,   185,   137,
+      45,   127,   141,    49,   -32,   137,  -224,   142,  -224,     1,
+      97,  -224,  -224,  -224,   137,   137,   169,   -37,   137,  -224,
+     135,   141,  -224,  -224,   -15,  -224,   138,  -224,  -224,  -224,
+     144,   145,  -224,  -224,   -16,  -224,  -224,  -224,   -27,   -25,
+    -224,  -224,  -224,  -224,  -224,    32,   -51,  -224,  -224,    -5,
+    -224,   148,     4,  -224,   192,   174,    13,    66,    83,  -224,
+     188,    43,   137,  -224,    59,  -224,  -224,   -32,   -32,   175,
+     149,   137,   150,   137,  -224,  -224,  -224,  -224,    83,   181,
+     137,  -224,   143,  -224,  -224,  -224,   137,  -224,   154,   187,
+    -224,   101,   141,  -224,  -224,  -224,  -224,  -224,  -224,    59,
+    -224,    59,    59,  -224,  -224,   -18,    17,  -224,  -224,  -224,
+     208,   210,  -224,  -224,   215,   148,  -224,   211,  -224,  -224,
+     159,  -224,  -224,   161,  -224,  -224,   -18,    57,  -224,    59,
+      59,    59,    59,    49,   214,  -224,   189,   170,   136,   157,
+    -224,  -224,    17,    17,  -224,  -224,   116,   141,   191,    83,
+     160,   163,  -224,    37,  -224,   164,  -224,   137,   137,  -224,
+    -224,  -224,   -41,   165,   167,   168,   171,   172,   173,   194,
+    -224,  -224,   176,   199,   179,  -224,   105,  -224,  -224,  -224,
+     199,  -224
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -659,113 +731,185 @@ static const yytype_int8 yypact[] =
    means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     4,
-       3,    10,    11,    12,    13,     5,     0,     0,     9,     6,
-       7,     8,    14,     0,     0,     0,     0,    68,    17,     0,
-       0,     0,    69,    57,    44,    58,     0,     0,    43,     1,
-       2,     0,     0,    16,     0,     0,    38,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    21,    69,    38,    54,
-       0,    45,    38,    59,    42,     0,    24,     0,     0,    26,
-       0,     0,    40,    39,     0,     0,    22,     0,     0,     0,
-      63,    15,     0,    29,     0,    31,    28,    18,     0,    19,
-      36,    34,    35,     0,    32,     0,    50,    49,    51,    46,
-      47,    48,     0,    55,    56,    61,    60,     0,    23,    25,
-       0,    27,    20,     0,    41,    52,    53,    37,     0,     0,
-      33,    67,    62,    30,    66,    65,    64
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       4,     3,    10,    12,    13,    14,     0,     0,     0,     0,
+       0,     0,     0,     5,     0,     0,     9,     6,     7,     8,
+      56,    20,    21,     0,     0,     0,     0,     0,     0,     0,
+       0,   120,    30,     0,     0,     0,     0,     0,     0,   121,
+     107,    84,    85,   108,     0,     0,    81,     0,     0,     0,
+       0,    15,     0,    18,     0,    26,     0,     1,     2,     0,
+       0,     0,     0,    28,     0,     0,    37,     0,    76,     0,
+       0,     0,     0,     0,     0,     0,    11,     0,    16,     0,
+       0,    19,    25,    29,     0,     0,     0,     0,     0,    34,
+       0,     0,    52,   121,    76,   104,     0,    22,    23,    24,
+       0,     0,    86,    87,    76,   109,    80,    17,     0,     0,
+      73,    71,    74,    72,    55,     0,     0,    66,    68,     0,
+      58,     0,     0,    60,     0,     0,     0,     0,     0,    78,
+      77,     0,     0,    53,     0,    82,    83,     0,     0,   113,
+       0,     0,     0,     0,    38,    69,    70,    54,     0,    45,
+       0,    63,     0,    65,    62,    31,     0,    33,     0,     0,
+      32,     0,     0,    92,    91,    93,    88,    89,    90,     0,
+     105,     0,     0,   100,   101,   106,    94,    97,   111,   110,
+       0,   115,    39,    42,     0,     0,    67,     0,    27,    59,
+       0,    61,    36,     0,    51,    79,    75,     0,   103,     0,
+       0,     0,     0,     0,     0,    57,     0,    40,     0,     0,
+      35,   102,    96,    95,    98,    99,   112,     0,     0,     0,
+       0,     0,    64,   119,   114,     0,    41,     0,     0,   118,
+     117,   116,     0,     0,     0,     0,     0,     0,     0,     0,
+      50,    48,     0,     0,     0,    49,     0,    46,    44,    43,
+       0,    47
 };
 
 /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int16 yypgoto[] =
 {
-     -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,    56,    23,
-     -75,   -75,   -74,    11,   -27,   -75,    -8,   -75,   -75,   -75,
-     -75,    37,   -75,   -75,   -75,   -75,   -75,    -3,   -45
+    -224,  -224,  -224,  -224,  -224,  -224,  -224,  -224,  -223,  -224,
+     110,   152,   155,    85,    55,   118,  -151,   -86,    80,   -88,
+    -224,    -9,   178,    41,  -224,    -6,   -26,  -170,  -224,   120,
+    -224,  -224,  -224,  -224,  -224,  -224,    10,   -76
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+static const yytype_int16 yydefgoto[] =
 {
-       0,    16,    17,    18,    19,    20,    21,    65,    68,    66,
-      86,    93,    94,    72,    56,    73,    74,    35,   102,   117,
-      58,    59,    36,    62,   108,   122,   126,    37,    38
+       0,    24,    25,    26,    27,    28,   198,   256,   154,    29,
+      30,   129,   132,   130,   164,   126,   127,   183,   139,   102,
+     140,   184,    52,    53,   179,   185,   186,   187,   104,   105,
+      54,   114,   191,   215,   234,   241,    55,    56
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
    positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
+static const yytype_int16 yytable[] =
 {
-      34,    28,    60,   104,    31,    64,    67,    69,    69,   124,
-      55,    23,    32,    55,    25,   125,    83,    84,    85,    78,
-      41,    42,    43,    44,    33,    22,    45,    46,   115,    24,
-      60,    76,    26,    81,    82,    80,    27,    67,    79,   120,
-      61,    75,    29,   111,    30,     1,    63,     2,    40,     3,
-       4,     5,    39,    47,     6,    32,    90,    91,    92,   -68,
-       7,    48,     8,    90,    91,    92,    87,    88,    49,     9,
-      10,    11,    12,    13,    14,   105,   106,    89,    88,    15,
-     112,   113,    96,    97,    98,    50,    51,    52,    53,    54,
-      55,    57,    32,    71,   116,    99,   100,   101,    77,    95,
-     107,   110,   118,   119,   123,   109,   114,     0,     0,    70,
-     121,     0,   103
+      51,   101,   101,   106,   128,   245,    31,   196,   118,   116,
+     147,    62,   208,   150,    42,   152,   143,    45,   131,   133,
+      87,   131,   133,    63,   157,   158,   149,    60,   246,   103,
+     257,    65,    88,   151,    41,   153,   247,   261,   135,    33,
+      37,   224,   225,    69,    70,   239,    72,    73,    74,   119,
+      76,   240,   128,    77,    78,    32,    43,    34,    38,   209,
+     148,   142,    47,    48,   210,    44,   106,    35,    39,    89,
+     159,   160,   128,   111,   112,   193,    93,   195,   236,   165,
+     166,    96,    36,    40,   131,    99,    47,    48,   169,   160,
+     201,    49,   141,     1,   115,     2,   211,     3,     4,     5,
+     212,   155,     6,   156,    50,   173,   174,   175,     7,     8,
+       9,   107,   108,    46,   109,    49,   176,    10,    11,    12,
+      13,    14,    15,   177,   178,    49,   120,    57,   121,   122,
+     123,    58,   221,   181,   209,    59,   182,    16,    61,   210,
+      17,   170,   166,   128,    18,    19,    66,    20,    21,    22,
+     120,    64,   121,   122,   123,    23,    67,   188,   189,    68,
+     125,   243,   244,   141,   120,    71,   121,   122,   123,   161,
+     162,   163,   124,   206,   125,   207,   204,   158,   230,   231,
+     259,   260,    75,   222,   223,    79,    80,  -120,    81,    82,
+      84,    86,    83,    90,    91,    85,    94,    95,    92,    97,
+      98,   100,   101,   103,    51,   134,   110,    49,   117,   138,
+     168,   144,     9,   172,   190,   192,   194,   200,   233,   145,
+     146,   197,   202,   203,   213,   214,   216,   218,   219,   220,
+     227,   229,   232,   228,   237,   254,   235,   238,   242,   152,
+     248,   252,   249,   250,   167,   199,   251,   253,   258,   136,
+     217,   255,   205,   137,   226,     0,   171,     0,     0,     0,
+       0,   113,   180
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       8,     4,    47,    77,     7,    50,    51,    52,    53,     8,
-      17,     6,    38,    17,     6,    14,    21,    22,    23,    26,
-      23,    24,    25,    26,    50,     4,    29,    30,   102,    24,
-      75,    58,    24,    44,    45,    62,    38,    82,    45,   113,
-      48,    45,    10,    88,    13,     3,    49,     5,    42,     7,
-       8,     9,     0,    19,    12,    38,    39,    40,    41,    46,
-      18,    45,    20,    39,    40,    41,    44,    45,    13,    27,
-      28,    29,    30,    31,    32,    78,    79,    44,    45,    37,
-      44,    45,    34,    35,    36,    46,    43,    43,    43,    11,
-      17,    38,    38,    43,   102,    47,    48,    49,    47,    25,
-      15,    43,    16,    40,    44,    82,    95,    -1,    -1,    53,
-     118,    -1,    75
+       9,    17,    17,    79,    90,    46,     4,   158,     7,    85,
+      26,    54,   182,    40,     4,    40,   104,     7,    94,    95,
+      54,    97,    98,    66,    75,    76,   114,    17,    69,    66,
+     253,    21,    66,    60,    66,    60,    77,   260,    75,     6,
+       6,   211,   212,    33,    34,     8,    36,    37,    38,    48,
+      40,    14,   138,    43,    44,    53,    10,    24,    24,    77,
+      76,    76,    37,    38,    82,    13,   142,    34,    34,    59,
+      75,    76,   158,    82,    83,   151,    66,   153,   229,    75,
+      76,    71,    49,    49,   160,    75,    37,    38,    75,    76,
+     166,    66,   101,     3,    84,     5,    79,     7,     8,     9,
+      83,    69,    12,    71,    79,    62,    63,    64,    18,    19,
+      20,    66,    67,    66,    69,    66,    73,    27,    28,    29,
+      30,    31,    32,    80,    81,    66,    67,    51,    69,    70,
+      71,    56,    75,    74,    77,     6,    77,    47,    66,    82,
+      50,    75,    76,   229,    54,    55,     6,    57,    58,    59,
+      67,    56,    69,    70,    71,    65,     0,   147,   148,    72,
+      77,   237,   238,   172,    67,    35,    69,    70,    71,    21,
+      22,    23,    75,   179,    77,   181,    75,    76,    42,    43,
+      75,    76,    35,   209,   210,    19,    73,    78,    74,    74,
+      13,    52,    76,    74,    66,    78,    74,    74,    67,    74,
+      74,    11,    17,    66,   213,    36,    79,    66,    66,    74,
+      36,    73,    20,    25,    39,    66,    66,    74,   227,    75,
+      75,    40,    68,    36,    16,    15,    11,    16,    69,    68,
+      16,    61,    75,    44,    74,    41,    45,    74,    74,    40,
+      75,    69,    75,    75,   134,   160,    75,    74,    69,    97,
+     195,    75,   172,    98,   213,    -1,   138,    -1,    -1,    -1,
+      -1,    83,   142
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,     3,     5,     7,     8,     9,    12,    18,    20,    27,
-      28,    29,    30,    31,    32,    37,    52,    53,    54,    55,
-      56,    57,     4,     6,    24,     6,    24,    38,    78,    10,
-      13,    78,    38,    50,    67,    68,    73,    78,    79,     0,
-      42,    78,    78,    78,    78,    78,    78,    19,    45,    13,
-      46,    43,    43,    43,    11,    17,    65,    38,    71,    72,
-      79,    67,    74,    78,    79,    58,    60,    79,    59,    79,
-      59,    43,    64,    66,    67,    45,    65,    47,    26,    45,
-      65,    44,    45,    21,    22,    23,    61,    44,    45,    44,
-      39,    40,    41,    62,    63,    25,    34,    35,    36,    47,
-      48,    49,    69,    72,    63,    78,    78,    15,    75,    60,
-      43,    79,    44,    45,    64,    63,    67,    70,    16,    40,
-      63,    67,    76,    44,     8,    14,    77
+       0,     3,     5,     7,     8,     9,    12,    18,    19,    20,
+      27,    28,    29,    30,    31,    32,    47,    50,    54,    55,
+      57,    58,    59,    65,    85,    86,    87,    88,    89,    93,
+      94,     4,    53,     6,    24,    34,    49,     6,    24,    34,
+      49,    66,   120,    10,    13,   120,    66,    37,    38,    66,
+      79,   105,   106,   107,   114,   120,   121,    51,    56,     6,
+     120,    66,    54,    66,    56,   120,     6,     0,    72,   120,
+     120,    35,   120,   120,   120,    35,   120,   120,   120,    19,
+      73,    74,    74,    76,    13,    78,    52,    54,    66,   120,
+      74,    66,    67,   120,    74,    74,   120,    74,    74,   120,
+      11,    17,   103,    66,   112,   113,   121,    66,    67,    69,
+      79,   105,   105,   106,   115,   120,   121,    66,     7,    48,
+      67,    69,    70,    71,    75,    77,    99,   100,   101,    95,
+      97,   121,    96,   121,    36,    75,    95,    96,    74,   102,
+     104,   105,    76,   103,    73,    75,    75,    26,    76,   103,
+      40,    60,    40,    60,    92,    69,    71,    75,    76,    75,
+      76,    21,    22,    23,    98,    75,    76,    94,    36,    75,
+      75,    99,    25,    62,    63,    64,    73,    80,    81,   108,
+     113,    74,    77,   101,   105,   109,   110,   111,   120,   120,
+      39,   116,    66,   121,    66,   121,   100,    40,    90,    97,
+      74,   121,    68,    36,    75,   102,   109,   109,   111,    77,
+      82,    79,    83,    16,    15,   117,    11,    98,    16,    69,
+      68,    75,   110,   110,   111,   111,   107,    16,    44,    61,
+      42,    43,    75,   105,   118,    45,   100,    74,    74,     8,
+      14,   119,    74,   121,   121,    46,    69,    77,    75,    75,
+      75,    75,    69,    74,    41,    75,    91,    92,    69,    75,
+      76,    92
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    51,    52,    52,    52,    52,    53,    53,    53,    53,
-      54,    54,    54,    54,    55,    56,    56,    56,    56,    56,
-      57,    57,    57,    57,    58,    58,    59,    59,    60,    61,
-      61,    61,    62,    62,    63,    63,    63,    64,    65,    65,
-      66,    66,    67,    67,    68,    68,    69,    69,    69,    69,
-      69,    69,    70,    70,    71,    71,    72,    73,    73,    74,
-      74,    74,    75,    75,    76,    77,    77,    77,    78,    79
+       0,    84,    85,    85,    85,    85,    86,    86,    86,    86,
+      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
+      88,    88,    88,    88,    88,    88,    88,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    90,    90,    90,    91,    91,    92,    92,
+      92,    93,    93,    93,    93,    93,    93,    94,    95,    95,
+      96,    96,    97,    98,    98,    98,    99,    99,   100,   100,
+     100,   101,   101,   101,   101,   102,   103,   103,   104,   104,
+     105,   105,   106,   106,   107,   107,   107,   107,   108,   108,
+     108,   108,   108,   108,   109,   109,   109,   110,   110,   110,
+     111,   111,   111,   111,   112,   112,   113,   114,   114,   115,
+     115,   115,   116,   116,   117,   117,   118,   119,   119,   119,
+     120,   121
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     6,     3,     2,     6,     6,
-       7,     4,     5,     6,     1,     3,     1,     3,     2,     1,
-       4,     1,     1,     3,     1,     1,     1,     3,     0,     2,
-       1,     3,     3,     1,     1,     3,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     3,     3,     1,     1,     1,
-       3,     3,     3,     0,     2,     1,     1,     0,     1,     1
+       1,     3,     1,     1,     1,     2,     3,     4,     2,     3,
+       2,     2,     4,     4,     4,     3,     2,     7,     3,     3,
+       2,     6,     6,     6,     4,     8,     7,     3,     5,     6,
+       7,     9,     6,     9,     8,     0,     1,     3,     8,     9,
+       8,     7,     4,     5,     5,     4,     1,     7,     1,     3,
+       1,     3,     2,     1,     4,     1,     1,     3,     1,     2,
+       2,     1,     1,     1,     1,     3,     0,     2,     1,     3,
+       3,     1,     4,     4,     1,     1,     3,     3,     1,     1,
+       1,     1,     1,     1,     1,     3,     3,     1,     3,     3,
+       1,     1,     3,     2,     1,     3,     3,     1,     1,     1,
+       3,     3,     3,     0,     3,     0,     2,     1,     1,     0,
+       1,     1
 };
 
 
@@ -1621,489 +1765,877 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* start: stmt ';'  */
-#line 57 "/content/rucbase-lab/src/parser/yacc.y"
+#line 62 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1630 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1774 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 3: /* start: HELP  */
-#line 62 "/content/rucbase-lab/src/parser/yacc.y"
+#line 67 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1639 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1783 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 4: /* start: EXIT  */
-#line 67 "/content/rucbase-lab/src/parser/yacc.y"
+#line 72 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1648 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1792 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 5: /* start: T_EOF  */
-#line 72 "/content/rucbase-lab/src/parser/yacc.y"
+#line 77 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1657 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1801 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
   case 10: /* txnStmt: TXN_BEGIN  */
-#line 87 "/content/rucbase-lab/src/parser/yacc.y"
+#line 92 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1665 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1809 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 11: /* txnStmt: TXN_COMMIT  */
-#line 91 "/content/rucbase-lab/src/parser/yacc.y"
+  case 11: /* txnStmt: TXN_BEGIN READ ONLY  */
+#line 96 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<TxnBegin>(true);
+    }
+#line 1817 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 12: /* txnStmt: TXN_COMMIT  */
+#line 100 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1673 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1825 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 12: /* txnStmt: TXN_ABORT  */
-#line 95 "/content/rucbase-lab/src/parser/yacc.y"
+  case 13: /* txnStmt: TXN_ABORT  */
+#line 104 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1681 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1833 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 13: /* txnStmt: TXN_ROLLBACK  */
-#line 99 "/content/rucbase-lab/src/parser/yacc.y"
+  case 14: /* txnStmt: TXN_ROLLBACK  */
+#line 108 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1689 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1841 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 14: /* dbStmt: SHOW TABLES  */
-#line 106 "/content/rucbase-lab/src/parser/yacc.y"
+  case 15: /* txnStmt: SAVEPOINT IDENTIFIER  */
+#line 112 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<Savepoint>((yyvsp[0].sv_str));
+    }
+#line 1849 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 16: /* txnStmt: TXN_ROLLBACK TO IDENTIFIER  */
+#line 116 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<RollbackToSavepoint>((yyvsp[0].sv_str));
+    }
+#line 1857 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 17: /* txnStmt: TXN_ROLLBACK TO SAVEPOINT IDENTIFIER  */
+#line 120 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<RollbackToSavepoint>((yyvsp[0].sv_str));
+    }
+#line 1865 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 18: /* txnStmt: RELEASE IDENTIFIER  */
+#line 124 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<ReleaseSavepoint>((yyvsp[0].sv_str));
+    }
+#line 1873 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 19: /* txnStmt: RELEASE SAVEPOINT IDENTIFIER  */
+#line 128 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<ReleaseSavepoint>((yyvsp[0].sv_str));
+    }
+#line 1881 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 20: /* dbStmt: SHOW TABLES  */
+#line 135 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1697 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1889 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 15: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
-#line 113 "/content/rucbase-lab/src/parser/yacc.y"
+  case 21: /* dbStmt: SHOW METRICS  */
+#line 139 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
+        (yyval.sv_node) = std::make_shared<ShowMetrics>();
     }
-#line 1705 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1897 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 16: /* ddl: DROP TABLE tbName  */
-#line 117 "/content/rucbase-lab/src/parser/yacc.y"
+  case 22: /* dbStmt: SET IDENTIFIER '=' IDENTIFIER  */
+#line 143 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<SetVar>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
+    }
+#line 1905 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 23: /* dbStmt: SET IDENTIFIER '=' VALUE_STRING  */
+#line 147 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<SetVar>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
+    }
+#line 1913 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 24: /* dbStmt: SET IDENTIFIER '=' VALUE_INT  */
+#line 151 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<SetVar>((yyvsp[-2].sv_str), std::to_string((yyvsp[0].sv_int)));
+    }
+#line 1921 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 25: /* dbStmt: BACKUP TO VALUE_STRING  */
+#line 155 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<Backup>((yyvsp[0].sv_str));
+    }
+#line 1929 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 26: /* dbStmt: VACUUM tbName  */
+#line 159 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<Vacuum>((yyvsp[0].sv_str));
+    }
+#line 1937 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 27: /* ddl: CREATE TABLE tbName '(' fieldList ')' optPartitionClause  */
+#line 166 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-4].sv_str), (yyvsp[-2].sv_fields), (yyvsp[0].sv_partition));
+    }
+#line 1945 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 28: /* ddl: DROP TABLE tbName  */
+#line 170 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1713 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1953 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 17: /* ddl: DESC tbName  */
-#line 121 "/content/rucbase-lab/src/parser/yacc.y"
+  case 29: /* ddl: TRUNCATE TABLE tbName  */
+#line 174 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<TruncateTable>((yyvsp[0].sv_str));
+    }
+#line 1961 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 30: /* ddl: DESC tbName  */
+#line 178 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1721 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1969 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 18: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
-#line 125 "/content/rucbase-lab/src/parser/yacc.y"
+  case 31: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
+#line 182 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1729 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1977 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 19: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
-#line 129 "/content/rucbase-lab/src/parser/yacc.y"
+  case 32: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 186 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1737 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1985 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 33: /* ddl: CREATE MATERIALIZED VIEW tbName AS selectStmt  */
+#line 190 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateMatView>((yyvsp[-2].sv_str), std::static_pointer_cast<SelectStmt>((yyvsp[0].sv_node)));
+    }
+#line 1993 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 34: /* ddl: DROP MATERIALIZED VIEW tbName  */
+#line 194 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<DropMatView>((yyvsp[0].sv_str));
+    }
+#line 2001 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 35: /* ddl: CREATE PROCEDURE tbName '(' fieldList ')' AS VALUE_PROC_BODY  */
+#line 198 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateProcedure>((yyvsp[-5].sv_str), (yyvsp[-3].sv_fields), (yyvsp[0].sv_str));
+    }
+#line 2009 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 36: /* ddl: CREATE PROCEDURE tbName '(' ')' AS VALUE_PROC_BODY  */
+#line 202 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateProcedure>((yyvsp[-4].sv_str), std::vector<std::shared_ptr<Field>>(), (yyvsp[0].sv_str));
+    }
+#line 2017 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 37: /* ddl: DROP PROCEDURE tbName  */
+#line 206 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<DropProcedure>((yyvsp[0].sv_str));
+    }
+#line 2025 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 38: /* ddl: ALTER TABLE tbName ADD rangePart  */
+#line 210 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<AddPartition>((yyvsp[-2].sv_str), (yyvsp[0].sv_range_part));
+    }
+#line 2033 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 39: /* ddl: ALTER TABLE tbName DROP PARTITION IDENTIFIER  */
+#line 214 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<DropPartition>((yyvsp[-3].sv_str), (yyvsp[0].sv_str));
+    }
+#line 2041 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 40: /* ddl: ALTER TABLE tbName ADD COLUMN colName type  */
+#line 218 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<AddColumn>((yyvsp[-4].sv_str), std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len)), nullptr);
+    }
+#line 2049 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 41: /* ddl: ALTER TABLE tbName ADD COLUMN colName type DEFAULT value  */
+#line 222 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<AddColumn>((yyvsp[-6].sv_str), std::make_shared<ColDef>((yyvsp[-3].sv_str), (yyvsp[-2].sv_type_len)), (yyvsp[0].sv_val));
+    }
+#line 2057 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 42: /* ddl: ALTER TABLE tbName DROP COLUMN colName  */
+#line 226 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<DropColumn>((yyvsp[-3].sv_str), (yyvsp[0].sv_str));
+    }
+#line 2065 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 43: /* optPartitionClause: PARTITION BY RANGE '(' colName ')' '(' rangePartList ')'  */
+#line 233 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_partition) = std::make_shared<PartitionDef>(SV_PART_RANGE, (yyvsp[-4].sv_str), (yyvsp[-1].sv_range_parts), 0);
+    }
+#line 2073 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 44: /* optPartitionClause: PARTITION BY HASH '(' colName ')' PARTITIONS VALUE_INT  */
+#line 237 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_partition) = std::make_shared<PartitionDef>(SV_PART_HASH, (yyvsp[-3].sv_str), std::vector<std::shared_ptr<RangePartDef>>(), (yyvsp[0].sv_int));
+    }
+#line 2081 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 45: /* optPartitionClause: %empty  */
+#line 241 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_partition) = nullptr;
+    }
+#line 2089 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 20: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
-#line 136 "/content/rucbase-lab/src/parser/yacc.y"
+  case 46: /* rangePartList: rangePart  */
+#line 248 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_range_parts) = std::vector<std::shared_ptr<RangePartDef>>{(yyvsp[0].sv_range_part)};
+    }
+#line 2097 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 47: /* rangePartList: rangePartList ',' rangePart  */
+#line 252 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_range_parts).push_back((yyvsp[0].sv_range_part));
+    }
+#line 2105 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 48: /* rangePart: PARTITION IDENTIFIER VALUES LESS THAN '(' VALUE_INT ')'  */
+#line 259 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_range_part) = std::make_shared<RangePartDef>((yyvsp[-6].sv_str), false, (yyvsp[-1].sv_int));
+    }
+#line 2113 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 49: /* rangePart: PARTITION IDENTIFIER VALUES LESS THAN '(' '-' VALUE_INT ')'  */
+#line 263 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_range_part) = std::make_shared<RangePartDef>((yyvsp[-7].sv_str), false, -(yyvsp[-1].sv_int));
+    }
+#line 2121 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 50: /* rangePart: PARTITION IDENTIFIER VALUES LESS THAN '(' MAXVALUE ')'  */
+#line 267 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_range_part) = std::make_shared<RangePartDef>((yyvsp[-6].sv_str), true, 0);
+    }
+#line 2129 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 51: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 274 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
     }
-#line 1745 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2137 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 21: /* dml: DELETE FROM tbName optWhereClause  */
-#line 140 "/content/rucbase-lab/src/parser/yacc.y"
+  case 52: /* dml: DELETE FROM tbName optWhereClause  */
+#line 278 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1753 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2145 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 22: /* dml: UPDATE tbName SET setClauses optWhereClause  */
-#line 144 "/content/rucbase-lab/src/parser/yacc.y"
+  case 53: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 282 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1761 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2153 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 54: /* dml: CALL tbName '(' valueList ')'  */
+#line 286 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CallStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_vals));
+    }
+#line 2161 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 23: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause  */
-#line 148 "/content/rucbase-lab/src/parser/yacc.y"
+  case 55: /* dml: CALL tbName '(' ')'  */
+#line 290 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-4].sv_cols), (yyvsp[-2].sv_strs), (yyvsp[-1].sv_conds), (yyvsp[0].sv_orderby));
+        (yyval.sv_node) = std::make_shared<CallStmt>((yyvsp[-2].sv_str), std::vector<std::shared_ptr<Value>>());
     }
-#line 1769 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2169 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 24: /* fieldList: field  */
-#line 155 "/content/rucbase-lab/src/parser/yacc.y"
+  case 57: /* selectStmt: SELECT selector FROM tableList optWhereClause opt_group_clause opt_order_clause  */
+#line 298 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-5].sv_cols), (yyvsp[-3].sv_strs), (yyvsp[-2].sv_conds), (yyvsp[-1].sv_cols), (yyvsp[0].sv_orderby));
+    }
+#line 2177 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 58: /* fieldList: field  */
+#line 305 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1777 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2185 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 25: /* fieldList: fieldList ',' field  */
-#line 159 "/content/rucbase-lab/src/parser/yacc.y"
+  case 59: /* fieldList: fieldList ',' field  */
+#line 309 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1785 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2193 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 26: /* colNameList: colName  */
-#line 166 "/content/rucbase-lab/src/parser/yacc.y"
+  case 60: /* colNameList: colName  */
+#line 316 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1793 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2201 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 27: /* colNameList: colNameList ',' colName  */
-#line 170 "/content/rucbase-lab/src/parser/yacc.y"
+  case 61: /* colNameList: colNameList ',' colName  */
+#line 320 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1801 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2209 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 28: /* field: colName type  */
-#line 177 "/content/rucbase-lab/src/parser/yacc.y"
+  case 62: /* field: colName type  */
+#line 327 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1809 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2217 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 29: /* type: INT  */
-#line 184 "/content/rucbase-lab/src/parser/yacc.y"
+  case 63: /* type: INT  */
+#line 334 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 1817 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2225 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 30: /* type: CHAR '(' VALUE_INT ')'  */
-#line 188 "/content/rucbase-lab/src/parser/yacc.y"
+  case 64: /* type: CHAR '(' VALUE_INT ')'  */
+#line 338 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 1825 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2233 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 31: /* type: FLOAT  */
-#line 192 "/content/rucbase-lab/src/parser/yacc.y"
+  case 65: /* type: FLOAT  */
+#line 342 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1833 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2241 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 32: /* valueList: value  */
-#line 199 "/content/rucbase-lab/src/parser/yacc.y"
+  case 66: /* valueList: value  */
+#line 349 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1841 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2249 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 33: /* valueList: valueList ',' value  */
-#line 203 "/content/rucbase-lab/src/parser/yacc.y"
+  case 67: /* valueList: valueList ',' value  */
+#line 353 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1849 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2257 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 69: /* value: '-' VALUE_INT  */
+#line 361 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_val) = std::make_shared<IntLit>(-(yyvsp[0].sv_int));
+    }
+#line 2265 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 70: /* value: '-' VALUE_FLOAT  */
+#line 365 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_val) = std::make_shared<FloatLit>(-(yyvsp[0].sv_float));
+    }
+#line 2273 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 34: /* value: VALUE_INT  */
-#line 210 "/content/rucbase-lab/src/parser/yacc.y"
+  case 71: /* literal: VALUE_INT  */
+#line 372 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 1857 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2281 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 35: /* value: VALUE_FLOAT  */
-#line 214 "/content/rucbase-lab/src/parser/yacc.y"
+  case 72: /* literal: VALUE_FLOAT  */
+#line 376 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 1865 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2289 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 36: /* value: VALUE_STRING  */
-#line 218 "/content/rucbase-lab/src/parser/yacc.y"
+  case 73: /* literal: VALUE_STRING  */
+#line 380 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 1873 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2297 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 37: /* condition: col op expr  */
-#line 225 "/content/rucbase-lab/src/parser/yacc.y"
+  case 74: /* literal: VALUE_PARAM  */
+#line 384 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_val) = std::make_shared<ParamRef>((yyvsp[0].sv_int));
+    }
+#line 2305 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 75: /* condition: col op expr  */
+#line 391 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 1881 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2313 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 38: /* optWhereClause: %empty  */
-#line 231 "/content/rucbase-lab/src/parser/yacc.y"
+  case 76: /* optWhereClause: %empty  */
+#line 397 "/root/repo/rucbase-lab/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 1887 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2319 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 39: /* optWhereClause: WHERE whereClause  */
-#line 233 "/content/rucbase-lab/src/parser/yacc.y"
+  case 77: /* optWhereClause: WHERE whereClause  */
+#line 399 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 1895 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2327 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 40: /* whereClause: condition  */
-#line 240 "/content/rucbase-lab/src/parser/yacc.y"
+  case 78: /* whereClause: condition  */
+#line 406 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 1903 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2335 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 41: /* whereClause: whereClause AND condition  */
-#line 244 "/content/rucbase-lab/src/parser/yacc.y"
+  case 79: /* whereClause: whereClause AND condition  */
+#line 410 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 1911 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2343 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 42: /* col: tbName '.' colName  */
-#line 251 "/content/rucbase-lab/src/parser/yacc.y"
+  case 80: /* col: tbName '.' colName  */
+#line 417 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 1919 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2351 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 43: /* col: colName  */
-#line 255 "/content/rucbase-lab/src/parser/yacc.y"
+  case 81: /* col: colName  */
+#line 421 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 1927 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2359 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 44: /* colList: col  */
-#line 262 "/content/rucbase-lab/src/parser/yacc.y"
+  case 82: /* aggCol: COUNT '(' '*' ')'  */
+#line 428 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_col) = std::make_shared<AggCol>(SV_AGG_COUNT, "", "*");
+    }
+#line 2367 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 83: /* aggCol: SUM '(' col ')'  */
+#line 432 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_col) = std::make_shared<AggCol>(SV_AGG_SUM, (yyvsp[-1].sv_col)->tab_name, (yyvsp[-1].sv_col)->col_name);
+    }
+#line 2375 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 84: /* colList: col  */
+#line 439 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 1935 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2383 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 85: /* colList: aggCol  */
+#line 443 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
+    }
+#line 2391 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 86: /* colList: colList ',' col  */
+#line 447 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_cols).push_back((yyvsp[0].sv_col));
+    }
+#line 2399 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 45: /* colList: colList ',' col  */
-#line 266 "/content/rucbase-lab/src/parser/yacc.y"
+  case 87: /* colList: colList ',' aggCol  */
+#line 451 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 1943 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2407 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 46: /* op: '='  */
-#line 273 "/content/rucbase-lab/src/parser/yacc.y"
+  case 88: /* op: '='  */
+#line 458 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 1951 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2415 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 47: /* op: '<'  */
-#line 277 "/content/rucbase-lab/src/parser/yacc.y"
+  case 89: /* op: '<'  */
+#line 462 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 1959 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2423 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 48: /* op: '>'  */
-#line 281 "/content/rucbase-lab/src/parser/yacc.y"
+  case 90: /* op: '>'  */
+#line 466 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 1967 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2431 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 49: /* op: NEQ  */
-#line 285 "/content/rucbase-lab/src/parser/yacc.y"
+  case 91: /* op: NEQ  */
+#line 470 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 1975 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2439 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 50: /* op: LEQ  */
-#line 289 "/content/rucbase-lab/src/parser/yacc.y"
+  case 92: /* op: LEQ  */
+#line 474 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 1983 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2447 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 51: /* op: GEQ  */
-#line 293 "/content/rucbase-lab/src/parser/yacc.y"
+  case 93: /* op: GEQ  */
+#line 478 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 1991 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2455 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 95: /* expr: expr '+' term  */
+#line 486 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_expr) = std::make_shared<ArithExpr>((yyvsp[-2].sv_expr), SV_OP_ADD, (yyvsp[0].sv_expr));
+    }
+#line 2463 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 96: /* expr: expr '-' term  */
+#line 490 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_expr) = std::make_shared<ArithExpr>((yyvsp[-2].sv_expr), SV_OP_SUB, (yyvsp[0].sv_expr));
+    }
+#line 2471 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 52: /* expr: value  */
-#line 300 "/content/rucbase-lab/src/parser/yacc.y"
+  case 98: /* term: term '*' factor  */
+#line 498 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_expr) = std::make_shared<ArithExpr>((yyvsp[-2].sv_expr), SV_OP_MUL, (yyvsp[0].sv_expr));
+    }
+#line 2479 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 99: /* term: term '/' factor  */
+#line 502 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_expr) = std::make_shared<ArithExpr>((yyvsp[-2].sv_expr), SV_OP_DIV, (yyvsp[0].sv_expr));
+    }
+#line 2487 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 100: /* factor: literal  */
+#line 509 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 1999 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2495 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 53: /* expr: col  */
-#line 304 "/content/rucbase-lab/src/parser/yacc.y"
+  case 101: /* factor: col  */
+#line 513 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2007 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2503 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 102: /* factor: '(' expr ')'  */
+#line 517 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_expr) = (yyvsp[-1].sv_expr);
+    }
+#line 2511 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 54: /* setClauses: setClause  */
-#line 311 "/content/rucbase-lab/src/parser/yacc.y"
+  case 103: /* factor: '-' factor  */
+#line 521 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        if (auto int_lit = std::dynamic_pointer_cast<IntLit>((yyvsp[0].sv_expr))) {
+            (yyval.sv_expr) = std::make_shared<IntLit>(-int_lit->val);
+        } else if (auto float_lit = std::dynamic_pointer_cast<FloatLit>((yyvsp[0].sv_expr))) {
+            (yyval.sv_expr) = std::make_shared<FloatLit>(-float_lit->val);
+        } else {
+            (yyval.sv_expr) = std::make_shared<NegExpr>((yyvsp[0].sv_expr));
+        }
+    }
+#line 2525 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 104: /* setClauses: setClause  */
+#line 534 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 2015 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2533 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 55: /* setClauses: setClauses ',' setClause  */
-#line 315 "/content/rucbase-lab/src/parser/yacc.y"
+  case 105: /* setClauses: setClauses ',' setClause  */
+#line 538 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 2023 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2541 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 56: /* setClause: colName '=' value  */
-#line 322 "/content/rucbase-lab/src/parser/yacc.y"
+  case 106: /* setClause: colName '=' expr  */
+#line 545 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
-        (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val));
+        (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_expr));
     }
-#line 2031 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2549 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 57: /* selector: '*'  */
-#line 329 "/content/rucbase-lab/src/parser/yacc.y"
+  case 107: /* selector: '*'  */
+#line 552 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 2039 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2557 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 59: /* tableList: tbName  */
-#line 337 "/content/rucbase-lab/src/parser/yacc.y"
+  case 109: /* tableList: tbName  */
+#line 560 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 2047 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2565 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 60: /* tableList: tableList ',' tbName  */
-#line 341 "/content/rucbase-lab/src/parser/yacc.y"
+  case 110: /* tableList: tableList ',' tbName  */
+#line 564 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2055 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2573 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 61: /* tableList: tableList JOIN tbName  */
-#line 345 "/content/rucbase-lab/src/parser/yacc.y"
+  case 111: /* tableList: tableList JOIN tbName  */
+#line 568 "/root/repo/rucbase-lab/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2063 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2581 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 112: /* opt_group_clause: GROUP BY colList  */
+#line 575 "/root/repo/rucbase-lab/src/parser/yacc.y"
+    {
+        (yyval.sv_cols) = (yyvsp[0].sv_cols);
+    }
+#line 2589 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
+    break;
+
+  case 113: /* opt_group_clause: %empty  */
+#line 578 "/root/repo/rucbase-lab/src/parser/yacc.y"
+                      { /* ignore*/ }
+#line 2595 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 62: /* opt_order_clause: ORDER BY order_clause  */
-#line 352 "/content/rucbase-lab/src/parser/yacc.y"
+  case 114: /* opt_order_clause: ORDER BY order_clause  */
+#line 583 "/root/repo/rucbase-lab/src/parser/yacc.y"
     { 
         (yyval.sv_orderby) = (yyvsp[0].sv_orderby); 
     }
-#line 2071 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2603 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 63: /* opt_order_clause: %empty  */
-#line 355 "/content/rucbase-lab/src/parser/yacc.y"
+  case 115: /* opt_order_clause: %empty  */
+#line 586 "/root/repo/rucbase-lab/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2077 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2609 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 64: /* order_clause: col opt_asc_desc  */
-#line 360 "/content/rucbase-lab/src/parser/yacc.y"
+  case 116: /* order_clause: col opt_asc_desc  */
+#line 591 "/root/repo/rucbase-lab/src/parser/yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2085 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2617 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 65: /* opt_asc_desc: ASC  */
-#line 366 "/content/rucbase-lab/src/parser/yacc.y"
+  case 117: /* opt_asc_desc: ASC  */
+#line 597 "/root/repo/rucbase-lab/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2091 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2623 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 66: /* opt_asc_desc: DESC  */
-#line 367 "/content/rucbase-lab/src/parser/yacc.y"
+  case 118: /* opt_asc_desc: DESC  */
+#line 598 "/root/repo/rucbase-lab/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2097 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2629 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
-  case 67: /* opt_asc_desc: %empty  */
-#line 368 "/content/rucbase-lab/src/parser/yacc.y"
+  case 119: /* opt_asc_desc: %empty  */
+#line 599 "/root/repo/rucbase-lab/src/parser/yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2103 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2635 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
     break;
 
 
-#line 2107 "/content/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2639 "/root/repo/rucbase-lab/src/parser/yacc.tab.cpp"
 
       default: break;
     }
@@ -2332,5 +2864,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 374 "/content/rucbase-lab/src/parser/yacc.y"
+#line 605 "/root/repo/rucbase-lab/src/parser/yacc.y"
 
@@ -35,8 +35,8 @@
    especially those whose name start with YY_ or yy_.  They are
    private implementation details that can be changed or removed.  */
 
-#ifndef YY_YY_CONTENT_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED
-# define YY_YY_CONTENT_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED
+#ifndef YY_YY_ROOT_REPO_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED
+# define YY_YY_ROOT_REPO_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED
 /* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
@@ -85,14 +85,44 @@ extern int yydebug;
     TXN_ABORT = 286,               /* TXN_ABORT  */
     TXN_ROLLBACK = 287,            /* TXN_ROLLBACK  */
     ORDER_BY = 288,                /* ORDER_BY  */
-    LEQ = 289,                     /* LEQ  */
-    NEQ = 290,                     /* NEQ  */
-    GEQ = 291,                     /* GEQ  */
-    T_EOF = 292,                   /* T_EOF  */
-    IDENTIFIER = 293,              /* IDENTIFIER  */
-    VALUE_STRING = 294,            /* VALUE_STRING  */
-    VALUE_INT = 295,               /* VALUE_INT  */
-    VALUE_FLOAT = 296              /* VALUE_FLOAT  */
+    MATERIALIZED = 289,            /* MATERIALIZED  */
+    VIEW = 290,                    /* VIEW  */
+    AS = 291,                      /* AS  */
+    COUNT = 292,                   /* COUNT  */
+    SUM = 293,                     /* SUM  */
+    GROUP = 294,                   /* GROUP  */
+    PARTITION = 295,               /* PARTITION  */
+    PARTITIONS = 296,              /* PARTITIONS  */
+    RANGE = 297,                   /* RANGE  */
+    HASH = 298,                    /* HASH  */
+    LESS = 299,                    /* LESS  */
+    THAN = 300,                    /* THAN  */
+    MAXVALUE = 301,                /* MAXVALUE  */
+    ALTER = 302,                   /* ALTER  */
+    ADD = 303,                     /* ADD  */
+    PROCEDURE = 304,               /* PROCEDURE  */
+    CALL = 305,                    /* CALL  */
+    READ = 306,                    /* READ  */
+    ONLY = 307,                    /* ONLY  */
+    METRICS = 308,                 /* METRICS  */
+    SAVEPOINT = 309,               /* SAVEPOINT  */
+    RELEASE = 310,                 /* RELEASE  */
+    TO = 311,                      /* TO  */
+    BACKUP = 312,                  /* BACKUP  */
+    VACUUM = 313,                  /* VACUUM  */
+    TRUNCATE = 314,                /* TRUNCATE  */
+    COLUMN = 315,                  /* COLUMN  */
+    DEFAULT = 316,                 /* DEFAULT  */
+    LEQ = 317,                     /* LEQ  */
+    NEQ = 318,                     /* NEQ  */
+    GEQ = 319,                     /* GEQ  */
+    T_EOF = 320,                   /* T_EOF  */
+    IDENTIFIER = 321,              /* IDENTIFIER  */
+    VALUE_STRING = 322,            /* VALUE_STRING  */
+    VALUE_PROC_BODY = 323,         /* VALUE_PROC_BODY  */
+    VALUE_INT = 324,               /* VALUE_INT  */
+    VALUE_PARAM = 325,             /* VALUE_PARAM  */
+    VALUE_FLOAT = 326              /* VALUE_FLOAT  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -119,4 +149,4 @@ struct YYLTYPE
 int yyparse (void);
 
 
-#endif /* !YY_YY_CONTENT_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED  */
+#endif /* !YY_YY_ROOT_REPO_RUCBASE_LAB_SRC_PARSER_YACC_TAB_H_INCLUDED  */
@@ -23,33 +23,38 @@ using namespace ast;
 // keywords
 %token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY
 WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY
+MATERIALIZED VIEW AS COUNT SUM GROUP PARTITION PARTITIONS RANGE HASH LESS THAN MAXVALUE ALTER ADD
+PROCEDURE CALL READ ONLY METRICS SAVEPOINT RELEASE TO BACKUP VACUUM TRUNCATE COLUMN DEFAULT
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 
 // type-specific tokens
-%token <sv_str> IDENTIFIER VALUE_STRING
-%token <sv_int> VALUE_INT
+%token <sv_str> IDENTIFIER VALUE_STRING VALUE_PROC_BODY
+%token <sv_int> VALUE_INT VALUE_PARAM
 %token <sv_float> VALUE_FLOAT
 
 // specify types for non-terminal symbol
-%type <sv_node> stmt dbStmt ddl dml txnStmt
+%type <sv_node> stmt dbStmt ddl dml txnStmt selectStmt
 %type <sv_field> field
 %type <sv_fields> fieldList
 %type <sv_type_len> type
 %type <sv_comp_op> op
-%type <sv_expr> expr
-%type <sv_val> value
+%type <sv_expr> expr term factor
+%type <sv_val> value literal
 %type <sv_vals> valueList
 %type <sv_str> tbName colName
 %type <sv_strs> tableList colNameList
-%type <sv_col> col
-%type <sv_cols> colList selector
+%type <sv_col> col aggCol
+%type <sv_cols> colList selector opt_group_clause
 %type <sv_set_clause> setClause
 %type <sv_set_clauses> setClauses
 %type <sv_cond> condition
 %type <sv_conds> whereClause optWhereClause
 %type <sv_orderby>  order_clause opt_order_clause
 %type <sv_orderby_dir> opt_asc_desc
+%type <sv_partition> optPartitionClause
+%type <sv_range_part> rangePart
+%type <sv_range_parts> rangePartList
 
 %%
 start:
@@ -87,6 +92,10 @@ txnStmt:
     {
         $$ = std::make_shared<TxnBegin>();
     }
+    |   TXN_BEGIN READ ONLY
+    {
+        $$ = std::make_shared<TxnBegin>(true);
+    }
     |   TXN_COMMIT
     {
         $$ = std::make_shared<TxnCommit>();
@@ -99,6 +108,26 @@ txnStmt:
     {
         $$ = std::make_shared<TxnRollback>();
     }
+    |   SAVEPOINT IDENTIFIER
+    {
+        $$ = std::make_shared<Savepoint>($2);
+    }
+    |   TXN_ROLLBACK TO IDENTIFIER
+    {
+        $$ = std::make_shared<RollbackToSavepoint>($3);
+    }
+    |   TXN_ROLLBACK TO SAVEPOINT IDENTIFIER
+    {
+        $$ = std::make_shared<RollbackToSavepoint>($4);
+    }
+    |   RELEASE IDENTIFIER
+    {
+        $$ = std::make_shared<ReleaseSavepoint>($2);
+    }
+    |   RELEASE SAVEPOINT IDENTIFIER
+    {
+        $$ = std::make_shared<ReleaseSavepoint>($3);
+    }
     ;
 
 dbStmt:
@@ -106,17 +135,45 @@ dbStmt:
     {
         $$ = std::make_shared<ShowTables>();
     }
+    |   SHOW METRICS
+    {
+        $$ = std::make_shared<ShowMetrics>();
+    }
+    |   SET IDENTIFIER '=' IDENTIFIER
+    {
+        $$ = std::make_shared<SetVar>($2, $4);
+    }
+    |   SET IDENTIFIER '=' VALUE_STRING
+    {
+        $$ = std::make_shared<SetVar>($2, $4);
+    }
+    |   SET IDENTIFIER '=' VALUE_INT
+    {
+        $$ = std::make_shared<SetVar>($2, std::to_string($4));
+    }
+    |   BACKUP TO VALUE_STRING
+    {
+        $$ = std::make_shared<Backup>($3);
+    }
+    |   VACUUM tbName
+    {
+        $$ = std::make_shared<Vacuum>($2);
+    }
     ;
 
 ddl:
-        CREATE TABLE tbName '(' fieldList ')'
+        CREATE TABLE tbName '(' fieldList ')' optPartitionClause
     {
-        $$ = std::make_shared<CreateTable>($3, $5);
+        $$ = std::make_shared<CreateTable>($3, $5, $7);
     }
     |   DROP TABLE tbName
     {
         $$ = std::make_shared<DropTable>($3);
     }
+    |   TRUNCATE TABLE tbName
+    {
+        $$ = std::make_shared<TruncateTable>($3);
+    }
     |   DESC tbName
     {
         $$ = std::make_shared<DescTable>($2);
@@ -129,6 +186,87 @@ ddl:
     {
         $$ = std::make_shared<DropIndex>($3, $5);
     }
+    |   CREATE MATERIALIZED VIEW tbName AS selectStmt
+    {
+        $$ = std::make_shared<CreateMatView>($4, std::static_pointer_cast<SelectStmt>($6));
+    }
+    |   DROP MATERIALIZED VIEW tbName
+    {
+        $$ = std::make_shared<DropMatView>($4);
+    }
+    |   CREATE PROCEDURE tbName '(' fieldList ')' AS VALUE_PROC_BODY
+    {
+        $$ = std::make_shared<CreateProcedure>($3, $5, $8);
+    }
+    |   CREATE PROCEDURE tbName '(' ')' AS VALUE_PROC_BODY
+    {
+        $$ = std::make_shared<CreateProcedure>($3, std::vector<std::shared_ptr<Field>>(), $7);
+    }
+    |   DROP PROCEDURE tbName
+    {
+        $$ = std::make_shared<DropProcedure>($3);
+    }
+    |   ALTER TABLE tbName ADD rangePart
+    {
+        $$ = std::make_shared<AddPartition>($3, $5);
+    }
+    |   ALTER TABLE tbName DROP PARTITION IDENTIFIER
+    {
+        $$ = std::make_shared<DropPartition>($3, $6);
+    }
+    |   ALTER TABLE tbName ADD COLUMN colName type
+    {
+        $$ = std::make_shared<AddColumn>($3, std::make_shared<ColDef>($6, $7), nullptr);
+    }
+    |   ALTER TABLE tbName ADD COLUMN colName type DEFAULT value
+    {
+        $$ = std::make_shared<AddColumn>($3, std::make_shared<ColDef>($6, $7), $9);
+    }
+    |   ALTER TABLE tbName DROP COLUMN colName
+    {
+        $$ = std::make_shared<DropColumn>($3, $6);
+    }
+    ;
+
+optPartitionClause:
+        PARTITION BY RANGE '(' colName ')' '(' rangePartList ')'
+    {
+        $$ = std::make_shared<PartitionDef>(SV_PART_RANGE, $5, $8, 0);
+    }
+    |   PARTITION BY HASH '(' colName ')' PARTITIONS VALUE_INT
+    {
+        $$ = std::make_shared<PartitionDef>(SV_PART_HASH, $5, std::vector<std::shared_ptr<RangePartDef>>(), $8);
+    }
+    |   /* epsilon */
+    {
+        $$ = nullptr;
+    }
+    ;
+
+rangePartList:
+        rangePart
+    {
+        $$ = std::vector<std::shared_ptr<RangePartDef>>{$1};
+    }
+    |   rangePartList ',' rangePart
+    {
+        $$.push_back($3);
+    }
+    ;
+
+rangePart:
+        PARTITION IDENTIFIER VALUES LESS THAN '(' VALUE_INT ')'
+    {
+        $$ = std::make_shared<RangePartDef>($2, false, $7);
+    }
+    |   PARTITION IDENTIFIER VALUES LESS THAN '(' '-' VALUE_INT ')'
+    {
+        $$ = std::make_shared<RangePartDef>($2, false, -$8);
+    }
+    |   PARTITION IDENTIFIER VALUES LESS THAN '(' MAXVALUE ')'
+    {
+        $$ = std::make_shared<RangePartDef>($2, true, 0);
+    }
     ;
 
 dml:
@@ -144,9 +282,21 @@ dml:
     {
         $$ = std::make_shared<UpdateStmt>($2, $4, $5);
     }
-    |   SELECT selector FROM tableList optWhereClause opt_order_clause
+    |   CALL tbName '(' valueList ')'
+    {
+        $$ = std::make_shared<CallStmt>($2, $4);
+    }
+    |   CALL tbName '(' ')'
+    {
+        $$ = std::make_shared<CallStmt>($2, std::vector<std::shared_ptr<Value>>());
+    }
+    |   selectStmt
+    ;
+
+selectStmt:
+        SELECT selector FROM tableList optWhereClause opt_group_clause opt_order_clause
     {
-        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6);
+        $$ = std::make_shared<SelectStmt>($2, $4, $5, $6, $7);
     }
     ;
 
@@ -206,6 +356,18 @@ valueList:
     ;
 
 value:
+        literal
+    |   '-' VALUE_INT
+    {
+        $$ = std::make_shared<IntLit>(-$2);
+    }
+    |   '-' VALUE_FLOAT
+    {
+        $$ = std::make_shared<FloatLit>(-$2);
+    }
+    ;
+
+literal:
         VALUE_INT
     {
         $$ = std::make_shared<IntLit>($1);
@@ -218,6 +380,10 @@ value:
     {
         $$ = std::make_shared<StringLit>($1);
     }
+    |   VALUE_PARAM
+    {
+        $$ = std::make_shared<ParamRef>($1);
+    }
     ;
 
 condition:
@@ -257,15 +423,34 @@ col:
     }
     ;
 
+aggCol:
+        COUNT '(' '*' ')'
+    {
+        $$ = std::make_shared<AggCol>(SV_AGG_COUNT, "", "*");
+    }
+    |   SUM '(' col ')'
+    {
+        $$ = std::make_shared<AggCol>(SV_AGG_SUM, $3->tab_name, $3->col_name);
+    }
+    ;
+
 colList:
         col
     {
         $$ = std::vector<std::shared_ptr<Col>>{$1};
     }
+    |   aggCol
+    {
+        $$ = std::vector<std::shared_ptr<Col>>{$1};
+    }
     |   colList ',' col
     {
         $$.push_back($3);
     }
+    |   colList ',' aggCol
+    {
+        $$.push_back($3);
+    }
     ;
 
 op:
@@ -296,7 +481,31 @@ op:
     ;
 
 expr:
-        value
+        term
+    |   expr '+' term
+    {
+        $$ = std::make_shared<ArithExpr>($1, SV_OP_ADD, $3);
+    }
+    |   expr '-' term
+    {
+        $$ = std::make_shared<ArithExpr>($1, SV_OP_SUB, $3);
+    }
+    ;
+
+term:
+        factor
+    |   term '*' factor
+    {
+        $$ = std::make_shared<ArithExpr>($1, SV_OP_MUL, $3);
+    }
+    |   term '/' factor
+    {
+        $$ = std::make_shared<ArithExpr>($1, SV_OP_DIV, $3);
+    }
+    ;
+
+factor:
+        literal
     {
         $$ = std::static_pointer_cast<Expr>($1);
     }
@@ -304,6 +513,20 @@ expr:
     {
         $$ = std::static_pointer_cast<Expr>($1);
     }
+    |   '(' expr ')'
+    {
+        $$ = $2;
+    }
+    |   '-' factor
+    {
+        if (auto int_lit = std::dynamic_pointer_cast<IntLit>($2)) {
+            $$ = std::make_shared<IntLit>(-int_lit->val);
+        } else if (auto float_lit = std::dynamic_pointer_cast<FloatLit>($2)) {
+            $$ = std::make_shared<FloatLit>(-float_lit->val);
+        } else {
+            $$ = std::make_shared<NegExpr>($2);
+        }
+    }
     ;
 
 setClauses:
@@ -318,7 +541,7 @@ setClauses:
     ;
 
 setClause:
-        colName '=' value
+        colName '=' expr
     {
         $$ = std::make_shared<SetClause>($1, $3);
     }
@@ -347,6 +570,14 @@ tableList:
     }
     ;
 
+opt_group_clause:
+        GROUP BY colList
+    {
+        $$ = $3;
+    }
+    |   /* epsilon */ { /* ignore*/ }
+    ;
+
 opt_order_clause:
     ORDER BY order_clause      
     { 
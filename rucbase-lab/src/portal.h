@@ -23,6 +23,11 @@ See the Mulan PSL v2 for more details. */
 #include "execution/executor_insert.h"
 #include "execution/executor_delete.h"
 #include "execution/execution_sort.h"
+#include "execution/executor_append.h"
+#include "execution/executor_materialize.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/planner.h"
+#include "analyze/analyze.h"
 #include "common/common.h"
 
 typedef enum portalTag{
@@ -30,7 +35,8 @@ typedef enum portalTag{
     PORTAL_ONE_SELECT,
     PORTAL_DML_WITHOUT_SELECT,
     PORTAL_MULTI_QUERY,
-    PORTAL_CMD_UTILITY
+    PORTAL_CMD_UTILITY,
+    PORTAL_CALL
 } portalTag;
 
 
@@ -49,50 +55,70 @@ class Portal
 {
    private:
     SmManager *sm_manager_;
-    
+    Planner planner_;   // 自适应执行时用于重新规划连接顺序
 
    public:
-    Portal(SmManager *sm_manager) : sm_manager_(sm_manager){}
+    Portal(SmManager *sm_manager) : sm_manager_(sm_manager), planner_(sm_manager){}
     ~Portal(){}
 
     // 将查询执行计划转换成对应的算子树
     std::shared_ptr<PortalStmt> start(std::shared_ptr<Plan> plan, Context *context)
     {
         // 这里可以将select进行拆分，例如：一个select，带有return的select等
+        // 只读事务中只能执行查询
+        if (context->txn_ != nullptr && context->txn_->is_read_only() &&
+            (std::dynamic_pointer_cast<DDLPlan>(plan) != nullptr ||
+             (std::dynamic_pointer_cast<DMLPlan>(plan) != nullptr && plan->tag != T_select))) {
+            throw ReadOnlyTransactionError();
+        }
         if (auto x = std::dynamic_pointer_cast<OtherPlan>(plan)) {
             return std::make_shared<PortalStmt>(PORTAL_CMD_UTILITY, std::vector<TabCol>(), std::unique_ptr<AbstractExecutor>(),plan);
         } else if (auto x = std::dynamic_pointer_cast<DDLPlan>(plan)) {
             return std::make_shared<PortalStmt>(PORTAL_MULTI_QUERY, std::vector<TabCol>(), std::unique_ptr<AbstractExecutor>(),plan);
+        } else if (auto x = std::dynamic_pointer_cast<CallPlan>(plan)) {
+            return std::make_shared<PortalStmt>(PORTAL_CALL, std::vector<TabCol>(), std::unique_ptr<AbstractExecutor>(), plan);
         } else if (auto x = std::dynamic_pointer_cast<DMLPlan>(plan)) {
             switch(x->tag) {
                 case T_select:
                 {
                     std::shared_ptr<ProjectionPlan> p = std::dynamic_pointer_cast<ProjectionPlan>(x->subplan_);
+                    reoptimize_joins(p->subplan_, context);
                     std::unique_ptr<AbstractExecutor> root= convert_plan_executor(p, context);
                     return std::make_shared<PortalStmt>(PORTAL_ONE_SELECT, std::move(p->sel_cols_), std::move(root), plan);
                 }
                     
                 case T_Update:
                 {
-                    std::unique_ptr<AbstractExecutor> scan= convert_plan_executor(x->subplan_, context);
-                    std::vector<Rid> rids;
-                    for (scan->beginTuple(); !scan->is_end(); scan->nextTuple()) {
-                        rids.push_back(scan->rid());
+                    // 分区表的每个分区单独扫描，并生成修改该分区的算子
+                    auto scan_plan = std::dynamic_pointer_cast<ScanPlan>(x->subplan_);
+                    std::vector<std::unique_ptr<AbstractExecutor>> children;
+                    for (auto &file : scan_plan->files_) {
+                        std::unique_ptr<AbstractExecutor> scan = convert_scan_executor(scan_plan, file, context);
+                        std::vector<Rid> rids;
+                        for (scan->beginTuple(); !scan->is_end(); scan->nextTuple()) {
+                            rids.push_back(scan->rid());
+                        }
+                        children.push_back(std::make_unique<UpdateExecutor>(sm_manager_, x->tab_name_, file,
+                                                                            x->set_clauses_, x->conds_, x->expr_conds_,
+                                                                            rids, context));
                     }
-                    std::unique_ptr<AbstractExecutor> root =std::make_unique<UpdateExecutor>(sm_manager_, 
-                                                            x->tab_name_, x->set_clauses_, x->conds_, rids, context);
+                    std::unique_ptr<AbstractExecutor> root = make_append_executor(std::move(children));
                     return std::make_shared<PortalStmt>(PORTAL_DML_WITHOUT_SELECT, std::vector<TabCol>(), std::move(root), plan);
                 }
                 case T_Delete:
                 {
-                    std::unique_ptr<AbstractExecutor> scan= convert_plan_executor(x->subplan_, context);
-                    std::vector<Rid> rids;
-                    for (scan->beginTuple(); !scan->is_end(); scan->nextTuple()) {
-                        rids.push_back(scan->rid());
+                    auto scan_plan = std::dynamic_pointer_cast<ScanPlan>(x->subplan_);
+                    std::vector<std::unique_ptr<AbstractExecutor>> children;
+                    for (auto &file : scan_plan->files_) {
+                        std::unique_ptr<AbstractExecutor> scan = convert_scan_executor(scan_plan, file, context);
+                        std::vector<Rid> rids;
+                        for (scan->beginTuple(); !scan->is_end(); scan->nextTuple()) {
+                            rids.push_back(scan->rid());
+                        }
+                        children.push_back(
+                            std::make_unique<DeleteExecutor>(sm_manager_, x->tab_name_, file, x->conds_, rids, context));
                     }
-
-                    std::unique_ptr<AbstractExecutor> root =
-                        std::make_unique<DeleteExecutor>(sm_manager_, x->tab_name_, x->conds_, rids, context);
+                    std::unique_ptr<AbstractExecutor> root = make_append_executor(std::move(children));
 
                     return std::make_shared<PortalStmt>(PORTAL_DML_WITHOUT_SELECT, std::vector<TabCol>(), std::move(root), plan);
                 }
@@ -140,6 +166,11 @@ class Portal
                 ql->run_cmd_utility(portal->plan, txn_id, context);
                 break;
             }
+            case PORTAL_CALL:
+            {
+                run_procedure(std::dynamic_pointer_cast<CallPlan>(portal->plan), ql, txn_id, context);
+                break;
+            }
             default:
             {
                 throw InternalError("Unexpected field type");
@@ -150,6 +181,20 @@ class Portal
     // 清空资源
     void drop(){}
 
+    /**
+     * @description: 在同一个请求和事务中依次执行存储过程中的语句，语法树来自缓存，不再经过解析器
+     * 实参在分析时绑定为常量，优化器可以按实际参数选择索引和裁剪分区
+     */
+    void run_procedure(std::shared_ptr<CallPlan> plan, QlManager *ql, txn_id_t *txn_id, Context *context) {
+        Analyze analyze(sm_manager_);
+        Optimizer optimizer(sm_manager_, &planner_);
+        for (auto &stmt : plan->stmts_) {
+            std::shared_ptr<Query> query = analyze.do_analyze(stmt, &plan->args_);
+            std::shared_ptr<Plan> stmt_plan = optimizer.plan_query(query, context);
+            run(start(stmt_plan, context), ql, txn_id, context);
+        }
+    }
+
 
     std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context)
     {
@@ -157,12 +202,15 @@ class Portal
             return std::make_unique<ProjectionExecutor>(convert_plan_executor(x->subplan_, context), 
                                                         x->sel_cols_);
         } else if(auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
-            if(x->tag == T_SeqScan) {
-                return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context);
+            // 非分区表只有一个数据文件，直接返回扫描算子
+            if (x->files_.size() == 1 && x->files_[0] == x->tab_name_) {
+                return convert_scan_executor(x, x->tab_name_, context);
             }
-            else {
-                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context);
-            } 
+            std::vector<std::unique_ptr<AbstractExecutor>> children;
+            for (auto &file : x->files_) {
+                children.push_back(convert_scan_executor(x, file, context));
+            }
+            return std::make_unique<AppendExecutor>(std::move(children), x->cols_, x->len_);
         } else if(auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
             std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
             std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
@@ -173,8 +221,107 @@ class Portal
         } else if(auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
             return std::make_unique<SortExecutor>(convert_plan_executor(x->subplan_, context), 
                                             x->sel_col_, x->is_desc_);
+        } else if(auto x = std::dynamic_pointer_cast<MaterializePlan>(plan)) {
+            return std::make_unique<MaterializeExecutor>(x->cols_, x->len_, x->rows_);
         }
         return nullptr;
     }
 
+    /**
+     * @description: 自适应执行连接：按连接顺序从内到外依次物化各个连接输入（最外层的输入只扫描一次，不物化），
+     * 并把实际行数反馈到统计信息中；实际行数与估计值相差超过REOPT_THRESHOLD倍时，
+     * 用已物化输入的实际行数重新规划剩余的连接顺序。输入超过REOPT_MATERIALIZE_ROWS行时不再物化，
+     * 该输入和剩余的连接按当前的连接树直接执行，避免把大表全部读入内存
+     * @param {shared_ptr<Plan>&} plan 投影算子的子计划，其中的连接树会被替换为调整后的连接树
+     * @param {Context*} context
+     */
+    void reoptimize_joins(std::shared_ptr<Plan> &plan, Context *context) {
+        if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+            reoptimize_joins(x->subplan_, context);
+            return;
+        }
+        if (std::dynamic_pointer_cast<JoinPlan>(plan) == nullptr) {
+            return;
+        }
+        while (true) {
+            std::vector<std::shared_ptr<Plan>> rels;
+            std::vector<Condition> conds;
+            flatten_joins(plan, rels, conds);
+            auto next = std::find_if(rels.begin(), rels.end() - 1, [](const std::shared_ptr<Plan> &rel) {
+                return std::dynamic_pointer_cast<ScanPlan>(rel) != nullptr;
+            });
+            if (next == rels.end() - 1) {
+                break;
+            }
+            auto scan = std::dynamic_pointer_cast<ScanPlan>(*next);
+            double estimate = std::max(planner_.estimate_rows(scan), 1.0);
+            auto materialized = std::make_shared<MaterializePlan>(T_Materialize, scan, scan->cols_, scan->len_);
+            auto executor = convert_plan_executor(scan, context);
+            for (executor->beginTuple(); !executor->is_end(); executor->nextTuple()) {
+                if (materialized->rows_->size() == REOPT_MATERIALIZE_ROWS) {
+                    break;
+                }
+                materialized->rows_->push_back(executor->Next());
+            }
+            if (!executor->is_end()) {
+                // 实际行数至少为REOPT_MATERIALIZE_ROWS，记下这个下界后放弃物化
+                sm_manager_->get_stats()->feedback(scan->tab_name_, scan->conds_, REOPT_MATERIALIZE_ROWS);
+                break;
+            }
+            sm_manager_->get_stats()->feedback(scan->tab_name_, scan->conds_, materialized->rows_->size());
+
+            *next = materialized;
+            double actual = std::max((double)materialized->rows_->size(), 1.0);
+            if (actual > estimate * REOPT_THRESHOLD || estimate > actual * REOPT_THRESHOLD) {
+                plan = planner_.make_join_tree(std::move(rels), std::move(conds));
+            } else {
+                replace_join_input(plan, scan, materialized);
+            }
+        }
+    }
+
+    // 按从内到外的顺序展开左深连接树，得到各个连接输入和所有连接条件
+    void flatten_joins(const std::shared_ptr<Plan> &plan, std::vector<std::shared_ptr<Plan>> &rels,
+                       std::vector<Condition> &conds) {
+        if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+            flatten_joins(x->right_, rels, conds);
+            flatten_joins(x->left_, rels, conds);
+            conds.insert(conds.end(), x->conds_.begin(), x->conds_.end());
+        } else {
+            rels.push_back(plan);
+        }
+    }
+
+    // 把连接树中的输入from替换为to，连接顺序不变
+    void replace_join_input(const std::shared_ptr<Plan> &plan, const std::shared_ptr<Plan> &from,
+                            const std::shared_ptr<Plan> &to) {
+        if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+            for (auto child : {&x->left_, &x->right_}) {
+                if (*child == from) {
+                    *child = to;
+                } else {
+                    replace_join_input(*child, from, to);
+                }
+            }
+        }
+    }
+
+    // 生成扫描一个数据文件的算子，分区表的每个分区各生成一个
+    std::unique_ptr<AbstractExecutor> convert_scan_executor(std::shared_ptr<ScanPlan> plan, const std::string &file,
+                                                            Context *context) {
+        if (plan->tag == T_SeqScan) {
+            return std::make_unique<SeqScanExecutor>(sm_manager_, plan->tab_name_, file, plan->conds_, context);
+        }
+        return std::make_unique<IndexScanExecutor>(sm_manager_, plan->tab_name_, file, plan->conds_,
+                                                   plan->index_col_names_, context);
+    }
+
+    // 非分区表只有一个DML算子，不需要额外的Append算子
+    std::unique_ptr<AbstractExecutor> make_append_executor(std::vector<std::unique_ptr<AbstractExecutor>> children) {
+        if (children.size() == 1) {
+            return std::move(children[0]);
+        }
+        return std::make_unique<AppendExecutor>(std::move(children));
+    }
+
 };
\ No newline at end of file
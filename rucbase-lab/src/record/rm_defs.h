@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+
+#include "bitmap.h"
 #include "defs.h"
 #include "storage/buffer_pool_manager.h"
 
@@ -17,6 +20,16 @@ constexpr int RM_NO_PAGE = -1;
 constexpr int RM_FILE_HDR_PAGE = 0;
 constexpr int RM_FIRST_RECORD_PAGE = 1;
 constexpr int RM_MAX_RECORD_SIZE = 512;
+constexpr int RM_LOCK_WORD_SIZE = 8;
+constexpr int RM_MAX_OLD_LAYOUTS = 8;
+
+/* 记录格式，增加字段之后新分配的页面使用新的格式，之前分配的页面保留原来的格式 */
+struct RmLayout {
+    int end_page_no;            // 使用该格式的页面号上界（不含），当前格式为RM_NO_PAGE
+    int record_size;            // 该格式下每条记录的大小
+    int num_records_per_page;   // 该格式下每个页面最多能存储的元组个数
+    int bitmap_size;            // 该格式下每个页面bitmap大小
+};
 
 /* 文件头，记录表数据文件的元信息，写入磁盘中文件的第0号页面 */
 struct RmFileHdr {
@@ -25,6 +38,25 @@ struct RmFileHdr {
     int num_records_per_page;   // 每个页面最多能存储的元组个数
     int first_free_page_no;     // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
     int bitmap_size;            // 每个页面bitmap大小
+    int lock_words;             // 页面末尾是否为每个slot保留行锁字，没有这一字段的旧文件读出为0
+    int num_old_layouts;        // 仍在使用旧记录格式的页面区间个数，没有这一字段的旧文件读出为0
+    RmLayout old_layouts[RM_MAX_OLD_LAYOUTS];   // 旧记录格式，按页面区间递增排列，之后的页面使用当前格式
+    char defaults[RM_MAX_RECORD_SIZE];          // 新增字段的默认值，按字段在记录中的偏移存放
+
+    /* 获取页面使用的记录格式，record_size等字段描述的是当前格式 */
+    RmLayout layout_of(int page_no) const {
+        for (int i = 0; i < num_old_layouts; i++) {
+            if (page_no < old_layouts[i].end_page_no) {
+                return old_layouts[i];
+            }
+        }
+        return RmLayout{RM_NO_PAGE, record_size, num_records_per_page, bitmap_size};
+    }
+
+    /* 第一个使用当前格式的页面号 */
+    int first_current_page() const {
+        return num_old_layouts == 0 ? RM_FIRST_RECORD_PAGE : old_layouts[num_old_layouts - 1].end_page_no;
+    }
 };
 
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
@@ -33,6 +65,21 @@ struct RmPageHdr {
     int num_records;        // 当前页面中当前已经存储的记录个数（初始化为0）
 };
 
+/**
+ * @description: 按记录大小计算每个页面最多能存储的元组个数
+ * We have: OFFSET_PAGE_HDR + sizeof(RmPageHdr) + (n + 7) / 8 + n * (record_size + lock_word_size) <= PAGE_SIZE
+ * @param {int} record_size 记录的大小
+ */
+inline int rm_records_per_page(int record_size) {
+    int hdr_size = Page::OFFSET_PAGE_HDR + sizeof(RmPageHdr);
+    return (BITMAP_WIDTH * (PAGE_SIZE - 1 - hdr_size) + 1) / (1 + (record_size + RM_LOCK_WORD_SIZE) * BITMAP_WIDTH);
+}
+
+/* 页面末尾为每个slot保留的行锁字，第i个slot的锁字是从页面末尾向前的第i+1个字 */
+inline std::atomic<uint64_t> *rm_lock_word(Page *page, int slot_no) {
+    return reinterpret_cast<std::atomic<uint64_t> *>(page->get_data() + PAGE_SIZE - (slot_no + 1) * RM_LOCK_WORD_SIZE);
+}
+
 /* 表中的记录 */
 struct RmRecord {
     char* data;  // 记录的数据
@@ -80,6 +127,7 @@ struct RmRecord {
         }
         data = new char[size];
         memcpy(data, data_ + sizeof(int), size);
+        allocated_ = true;
     }
 
     ~RmRecord() {
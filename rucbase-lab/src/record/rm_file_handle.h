@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <assert.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "bitmap.h"
@@ -24,20 +25,37 @@ class RmManager;
 struct RmPageHandle {
     const RmFileHdr *file_hdr;  // 当前页面所在文件的文件头指针
     Page *page;                 // 页面的实际数据，包括页面存储的数据、元信息等
+    RmLayout layout;            // 页面使用的记录格式，增加字段之前分配的页面使用旧格式
     RmPageHdr *page_hdr;        // page->data的第一部分，存储页面元信息，指针指向首地址，长度为sizeof(RmPageHdr)
-    char *bitmap;               // page->data的第二部分，存储页面的bitmap，指针指向首地址，长度为file_hdr->bitmap_size
-    char *slots;                // page->data的第三部分，存储表的记录，指针指向首地址，每个slot的长度为file_hdr->record_size
+    char *bitmap;               // page->data的第二部分，存储页面的bitmap，指针指向首地址，长度为layout.bitmap_size
+    char *slots;                // page->data的第三部分，存储表的记录，指针指向首地址，每个slot的长度为layout.record_size
 
     RmPageHandle(const RmFileHdr *fhdr_, Page *page_) : file_hdr(fhdr_), page(page_) {
+        layout = file_hdr->layout_of(page->get_page_id().page_no);
         page_hdr = reinterpret_cast<RmPageHdr *>(page->get_data() + page->OFFSET_PAGE_HDR);
         bitmap = page->get_data() + sizeof(RmPageHdr) + page->OFFSET_PAGE_HDR;
-        slots = bitmap + file_hdr->bitmap_size;
+        slots = bitmap + layout.bitmap_size;
     }
 
     // 返回指定slot_no的slot存储收地址
     char* get_slot(int slot_no) const {
-        return slots + slot_no * file_hdr->record_size;  // slots的首地址 + slot个数 * 每个slot的大小(每个record的大小)
+        return slots + slot_no * layout.record_size;  // slots的首地址 + slot个数 * 每个slot的大小(每个record的大小)
     }
+
+    /* 页面是否使用当前的记录格式，只有当前格式的页面接收新插入的记录 */
+    bool is_current() const { return layout.end_page_no == RM_NO_PAGE; }
+
+    /* 读出slot中的记录，旧格式的记录缺少之后新增的字段，用文件头中的默认值补齐 */
+    std::unique_ptr<RmRecord> get_record(int slot_no) const {
+        auto rec = std::make_unique<RmRecord>(file_hdr->record_size);
+        memcpy(rec->data, get_slot(slot_no), layout.record_size);
+        memcpy(rec->data + layout.record_size, file_hdr->defaults + layout.record_size,
+               file_hdr->record_size - layout.record_size);
+        return rec;
+    }
+
+    /* 把记录写入slot，旧格式的页面只保存记录中属于该格式的部分，调用者保证新增字段为默认值 */
+    void set_record(int slot_no, const char *buf) const { memcpy(get_slot(slot_no), buf, layout.record_size); }
 };
 
 /* 每个RmFileHandle对应一个表的数据文件，里面有多个page，每个page的数据封装在RmPageHandle中 */
@@ -65,6 +83,18 @@ class RmFileHandle {
     RmFileHdr get_file_hdr() { return file_hdr_; }
     int GetFd() { return fd_; }
 
+    /**
+     * @description: 判断更新后的记录能否写回原来的位置，旧格式的页面只能保存新增字段为默认值的记录
+     * @param {Rid&} rid 记录的位置
+     * @param {char*} buf 更新后的记录
+     */
+    bool fits_in_place(const Rid &rid, const char *buf) const {
+        RmLayout layout = file_hdr_.layout_of(rid.page_no);
+        return layout.end_page_no == RM_NO_PAGE ||
+               memcmp(buf + layout.record_size, file_hdr_.defaults + layout.record_size,
+                      file_hdr_.record_size - layout.record_size) == 0;
+    }
+
     /* 判断指定位置上是否已经存在一条记录，通过Bitmap来判断 */
     bool is_record(const Rid &rid) const {
         RmPageHandle page_handle = fetch_page_handle(rid.page_no);
@@ -81,6 +111,219 @@ class RmFileHandle {
 
     void update_record(const Rid &rid, char *buf, Context *context);
 
+    /**
+     * @description: 固定记录所在的页面，修改记录之后要写完日志并记入page lsn才能释放，否则页面可能先于日志写盘
+     * @param {int} page_no 要修改的页面
+     * @return {Page*} 固定的页面，修改完成后用unpin_page释放
+     */
+    Page *pin_page(int page_no) const { return fetch_page_handle(page_no).page; }
+
+    /* 固定下一条插入的记录将要写入的页面，没有未满的页面时先分配新页面，插入时直接使用该页面 */
+    Page *pin_insert_page() {
+        if (file_hdr_.first_free_page_no == RM_NO_PAGE) {
+            return create_new_page_handle().page;
+        }
+        return fetch_page_handle(file_hdr_.first_free_page_no).page;
+    }
+
+    /* 释放pin_page或pin_insert_page固定的页面，页面在固定期间已经被修改 */
+    void unpin_page(Page *page) { buffer_pool_manager_->unpin_page(page->get_page_id(), true); }
+
+    /**
+     * @description: 对记录加行锁，文件有行锁字时在记录所在页面的锁字上加锁，否则使用锁表
+     * 锁字的修改需要随页面保留到事务结束，因此锁字被修改时把页面标记为脏页
+     * @param {Rid&} rid 加锁的记录
+     * @param {Context*} context 执行上下文，不在事务中时不加锁
+     * @param {bool} exclusive 是否加排他锁
+     */
+    void lock_record(const Rid &rid, Context *context, bool exclusive) {
+        if (context->txn_ == nullptr) {
+            return;
+        }
+        if (!file_hdr_.lock_words) {
+            if (exclusive) {
+                context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_);
+            } else {
+                context->lock_mgr_->lock_shared_on_record(context->txn_, rid, fd_);
+            }
+            return;
+        }
+        Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, rid.page_no});
+        if (page == nullptr) {
+            throw PageNotExistError(disk_manager_->get_file_name(fd_), rid.page_no);
+        }
+        auto word = rm_lock_word(page, rid.slot_no);
+        uint64_t old_word = word->load();
+        try {
+            if (exclusive) {
+                context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_, word);
+            } else {
+                context->lock_mgr_->lock_shared_on_record(context->txn_, rid, fd_, word);
+            }
+        } catch (...) {
+            buffer_pool_manager_->unpin_page(page->get_page_id(), word->load() != old_word);
+            throw;
+        }
+        // 已经持有锁或者锁已经膨胀到锁表时锁字不变，不必让页面变脏
+        buffer_pool_manager_->unpin_page(page->get_page_id(), word->load() != old_word);
+    }
+
+    /**
+     * @description: 把修改记录的日志号记入页面的page lsn，并发修改同一页面的事务写日志与记入page lsn的顺序可能交错，只保留较大的日志号
+     * @param {int} page_no 被修改的页面
+     * @param {lsn_t} lsn 修改操作的日志号
+     */
+    void set_page_lsn(int page_no, lsn_t lsn) {
+        Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, page_no});
+        if (page == nullptr) {
+            throw PageNotExistError(disk_manager_->get_file_name(fd_), page_no);
+        }
+        auto page_lsn = reinterpret_cast<std::atomic<lsn_t> *>(page->get_data() + Page::OFFSET_LSN);
+        lsn_t cur = page_lsn->load();
+        while (cur < lsn && !page_lsn->compare_exchange_weak(cur, lsn)) {
+        }
+        buffer_pool_manager_->unpin_page(page->get_page_id(), true);
+    }
+
+    /**
+     * @description: 恢复时重做一条记录的修改，重做把记录槽设置为修改后的内容，重复重做同一条日志的结果不变
+     * 副本按事务提交的顺序重放日志，页面的page lsn不能说明更早的修改已经在页面中，因此不根据page lsn跳过重做
+     * 文件头只在检查点和关闭文件时写盘，故障前新分配的页面不在文件头的页面数之内，这些页面的修改都在日志中，重新分配后从空页面重做
+     * @param {Rid&} rid 被修改的记录
+     * 页面改为新的记录格式之前写的日志按槽位重放，槽位号超出新格式页面容量的修改直接跳过，这些记录在改格式之前都已经被移走
+     * @param {char*} buf 修改后的记录，删除时为nullptr
+     * @param {int} size 修改后的记录的大小
+     * @param {lsn_t} lsn 修改操作的日志号
+     */
+    void redo_record(const Rid &rid, char *buf, int size, lsn_t lsn) {
+        while (rid.page_no >= file_hdr_.num_pages) {
+            RmPageHandle page_handle = create_new_page_handle();
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+        }
+        RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+        if (rid.slot_no >= page_handle.layout.num_records_per_page) {
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+            return;
+        }
+        bool exists = Bitmap::is_set(page_handle.bitmap, rid.slot_no);
+        if (buf != nullptr) {
+            memcpy(page_handle.get_slot(rid.slot_no), buf, std::min(size, page_handle.layout.record_size));
+            if (!exists) {
+                Bitmap::set(page_handle.bitmap, rid.slot_no);
+                page_handle.page_hdr->num_records++;
+            }
+        } else if (exists) {
+            Bitmap::reset(page_handle.bitmap, rid.slot_no);
+            page_handle.page_hdr->num_records--;
+        }
+        if (page_handle.page->get_page_lsn() < lsn) {
+            page_handle.page->set_page_lsn(lsn);
+        }
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+    }
+
+    /* 重做之后页面的记录数可能与空闲页面链表不一致，按页面的实际记录数重新串起未满的页面，旧格式的页面不接收插入 */
+    void rebuild_free_list() {
+        file_hdr_.first_free_page_no = RM_NO_PAGE;
+        for (int page_no = file_hdr_.num_pages - 1; page_no >= file_hdr_.first_current_page(); page_no--) {
+            RmPageHandle page_handle = fetch_page_handle(page_no);
+            if (page_handle.page_hdr->num_records < file_hdr_.num_records_per_page) {
+                page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
+                file_hdr_.first_free_page_no = page_no;
+            }
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+        }
+    }
+
+    /**
+     * @description: 截断文件末尾没有记录的页面，释放它们在缓冲池中的帧，并按剩下的页面重建空闲页面链表
+     * 调用者保证被截断的页面中没有记录，并且没有其他线程在访问它们，截断的日志已经写盘
+     * 先写文件头再截断文件，磁盘上的文件头记录的页面数不会超过文件实际的页面数
+     * @param {int} num_pages 截断后文件中的页面个数，不少于当前页面数时不做任何操作
+     */
+    void truncate(int num_pages) {
+        if (num_pages >= file_hdr_.num_pages) {
+            return;
+        }
+        for (int page_no = num_pages; page_no < file_hdr_.num_pages; page_no++) {
+            if (!buffer_pool_manager_->delete_page(PageId{fd_, page_no})) {
+                throw InternalError("RmFileHandle::truncate page is pinned");
+            }
+        }
+        file_hdr_.num_pages = num_pages;
+        rebuild_free_list();
+        disk_manager_->write_page(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+        disk_manager_->truncate_file(fd_, num_pages);
+    }
+
+    /**
+     * @description: 记录被移动到另一个槽位时，把原槽位的行锁字一起移过去，原槽位的锁字清零
+     * 提前释放锁的事务在锁字中留下了COMMIT日志号，之后对该记录加锁的事务依赖它提交，移动后依赖关系保持不变
+     * @param {Rid&} src 记录原来的位置
+     * @param {Rid&} dst 记录移动到的位置
+     */
+    void move_lock_word(const Rid &src, const Rid &dst) {
+        if (!file_hdr_.lock_words) {
+            return;
+        }
+        Page *src_page = buffer_pool_manager_->fetch_page(PageId{fd_, src.page_no});
+        if (src_page == nullptr) {
+            throw PageNotExistError(disk_manager_->get_file_name(fd_), src.page_no);
+        }
+        Page *dst_page = buffer_pool_manager_->fetch_page(PageId{fd_, dst.page_no});
+        if (dst_page == nullptr) {
+            buffer_pool_manager_->unpin_page(src_page->get_page_id(), false);
+            throw PageNotExistError(disk_manager_->get_file_name(fd_), dst.page_no);
+        }
+        rm_lock_word(dst_page, dst.slot_no)->store(rm_lock_word(src_page, src.slot_no)->exchange(0));
+        buffer_pool_manager_->unpin_page(dst_page->get_page_id(), true);
+        buffer_pool_manager_->unpin_page(src_page->get_page_id(), true);
+    }
+
+    /**
+     * @description: 增加字段后切换到新的记录格式，文件中已有的页面保留原来的格式，之后新分配的页面使用新格式
+     * 已有页面中的记录读出时用默认值补齐新增字段，这些页面不再接收插入，由VACUUM移走其中的记录后再改为新格式
+     * @param {int} record_size 新格式的记录大小
+     * @param {char*} defaults 新增字段的默认值，即新格式记录中原记录之后的部分
+     */
+    void add_layout(int record_size, const char *defaults) {
+        if (file_hdr_.num_pages > file_hdr_.first_current_page()) {
+            RmLayout layout = file_hdr_.layout_of(file_hdr_.num_pages);
+            layout.end_page_no = file_hdr_.num_pages;
+            file_hdr_.old_layouts[file_hdr_.num_old_layouts++] = layout;
+        }
+        memcpy(file_hdr_.defaults + file_hdr_.record_size, defaults, record_size - file_hdr_.record_size);
+        file_hdr_.record_size = record_size;
+        file_hdr_.num_records_per_page = rm_records_per_page(record_size);
+        file_hdr_.bitmap_size = (file_hdr_.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        file_hdr_.first_free_page_no = RM_NO_PAGE;
+    }
+
+    /**
+     * @description: 旧格式的页面都已经没有记录时，把它们清零改为当前格式的空页面，调用者保证没有其他线程在访问文件
+     * 改格式不写日志，清零的页面在任何格式下都是空页面，调用者需要在文件头写盘之前把这些页面写盘
+     * @return {bool} 是否改了格式，旧格式的页面中还有记录时不做任何修改
+     */
+    bool reformat_old_pages() {
+        int end = file_hdr_.first_current_page();
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < end; page_no++) {
+            RmPageHandle page_handle = fetch_page_handle(page_no);
+            int num_records = page_handle.page_hdr->num_records;
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+            if (num_records > 0) {
+                return false;
+            }
+        }
+        file_hdr_.num_old_layouts = 0;
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < end; page_no++) {
+            RmPageHandle page_handle = fetch_page_handle(page_no);
+            memset(page_handle.page->get_data() + Page::OFFSET_PAGE_HDR, 0, PAGE_SIZE - Page::OFFSET_PAGE_HDR);
+            buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+        }
+        rebuild_free_list();
+        return true;
+    }
+
     RmPageHandle create_new_page_handle();
 
     RmPageHandle fetch_page_handle(int page_no) const;
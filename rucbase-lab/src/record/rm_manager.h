@@ -43,10 +43,9 @@ class RmManager {
         file_hdr.record_size = record_size;
         file_hdr.num_pages = 1;
         file_hdr.first_free_page_no = RM_NO_PAGE;
-        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
-        file_hdr.num_records_per_page =
-            (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) / (1 + record_size * BITMAP_WIDTH);
+        file_hdr.num_records_per_page = rm_records_per_page(record_size);
         file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        file_hdr.lock_words = 1;
 
         // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
         // head page直接写入磁盘，没有经过缓冲区的NewPage，那么也就不需要FlushPage
@@ -70,6 +69,15 @@ class RmManager {
         int fd = disk_manager_->open_file(filename);
         return std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd);
     }
+    /**
+     * @description: 把表数据文件的文件头写盘，检查点时调用，使恢复时能够找到检查点之前分配的页面
+     * @param {RmFileHandle*} file_handle 文件句柄
+     */
+    void flush_file_hdr(const RmFileHandle* file_handle) {
+        disk_manager_->write_page(file_handle->fd_, RM_FILE_HDR_PAGE, (char *)&file_handle->file_hdr_,
+                                  sizeof(file_handle->file_hdr_));
+    }
+
     /**
      * @description: 关闭表的数据文件
      * @param {RmFileHandle*} file_handle 要关闭文件的句柄
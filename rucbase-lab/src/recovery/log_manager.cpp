@@ -8,8 +8,25 @@ EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
 MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
+#include <algorithm>
 #include <cstring>
 #include "log_manager.h"
+#include "errors.h"
+#include "record/rm_file_handle.h"
+#include "transaction/transaction.h"
+
+std::chrono::milliseconds log_timeout = std::chrono::milliseconds(200);
+
+LogManager::~LogManager() {
+    if (flusher_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            stop_flusher_ = true;
+        }
+        flusher_cv_.notify_all();
+        flusher_.join();
+    }
+}
 
 /**
  * @description: 添加日志记录到日志缓冲区中，并返回日志记录号
@@ -17,12 +34,244 @@ See the Mulan PSL v2 for more details. */
  * @return {lsn_t} 返回该日志的日志记录号
  */
 lsn_t LogManager::add_log_to_buffer(LogRecord* log_record) {
-  
+    std::unique_lock<std::mutex> lock(latch_);
+    while (log_buffer_->is_full(log_record->log_tot_len_)) {
+        if (flushing_) {
+            flush_cv_.wait(lock);
+        } else {
+            flush_buffer(lock);
+        }
+    }
+    log_record->lsn_ = global_lsn_++;
+    log_record->serialize(log_buffer_->buffer_ + log_buffer_->offset_);
+    log_buffer_->offset_ += log_record->log_tot_len_;
+    // 检查点不能回收仍在进行的事务的日志
+    if (log_record->log_type_ == LogType::begin) {
+        active_begin_[log_record->log_tid_] = next_offset_;
+    } else if (log_record->log_type_ == LogType::commit || log_record->log_type_ == LogType::ABORT) {
+        active_begin_.erase(log_record->log_tid_);
+    }
+    next_offset_ += log_record->log_tot_len_;
+    return log_record->lsn_;
+}
+
+/**
+ * @description: 把日志刷到磁盘中，直到日志号不超过lsn的日志全部持久化
+ * 已经有线程在写盘时等待其完成，再由某一个等待者把这期间积累的日志一次写盘，多个事务的提交共用一次写盘
+ * @param {lsn_t} lsn 需要持久化的日志号，INVALID_LSN表示当前缓冲区中的全部日志
+ */
+void LogManager::flush_log_to_disk(lsn_t lsn) {
+    std::unique_lock<std::mutex> lock(latch_);
+    // 页面写盘前按page lsn刷日志，旧版本的索引文件没有page lsn，页面开头的内容可能超过已经分配的日志号
+    if (lsn == INVALID_LSN || lsn > global_lsn_ - 1) {
+        lsn = global_lsn_ - 1;
+    }
+    while (persist_lsn_ < lsn) {
+        if (flushing_) {
+            flush_cv_.wait(lock);
+        } else {
+            flush_buffer(lock);
+        }
+    }
+}
+
+/**
+ * @description: 为事务添加一条日志记录，并维护事务的prev_lsn
+ * 事务的BEGIN日志推迟到事务的第一条日志之前写入，从不写日志的只读事务因此不会产生任何日志
+ * @param {Transaction*} txn 日志所属的事务
+ * @param {LogRecord*} log_record 要写入缓冲区的日志记录
+ * @return {lsn_t} 返回该日志的日志记录号
+ */
+lsn_t LogManager::add_txn_log(Transaction* txn, LogRecord* log_record) {
+    if (txn->get_prev_lsn() == INVALID_LSN) {
+        BeginLogRecord begin_log(txn->get_transaction_id());
+        txn->set_prev_lsn(add_log_to_buffer(&begin_log));
+    }
+    log_record->prev_lsn_ = txn->get_prev_lsn();
+    txn->set_prev_lsn(add_log_to_buffer(log_record));
+    return txn->get_prev_lsn();
 }
 
 /**
- * @description: 把日志缓冲区的内容刷到磁盘中，由于目前只设置了一个缓冲区，因此需要阻塞其他日志操作
+ * @description: 为事务对一条记录的修改写日志，并把日志号记入记录所在页面的page lsn
+ * 调用者在把写操作加入写集合时写日志，事务的日志与写集合中的写操作顺序一致，撤销写操作同样写日志
+ * @param {Transaction*} txn 修改记录的事务
+ * @param {WriteRecord*} write_rec 写操作，删除和更新时带有修改前的记录
+ * @param {char*} new_data 插入或更新后的记录，删除时为nullptr
+ * @param {RmFileHandle*} fh 记录所在的数据文件
+ * @return {lsn_t} 返回该日志的日志记录号
  */
-void LogManager::flush_log_to_disk() {
+lsn_t LogManager::add_write_log(Transaction* txn, WriteRecord* write_rec, char* new_data, RmFileHandle* fh) {
+    auto &rid = write_rec->GetRid();
+    auto &file = write_rec->GetTableName();
+    int record_size = fh->get_file_hdr().record_size;
+    std::unique_ptr<LogRecord> log_record;
+    switch (write_rec->GetWriteType()) {
+        case WType::INSERT_TUPLE:
+            log_record = std::make_unique<InsertLogRecord>(txn->get_transaction_id(), RmRecord(record_size, new_data),
+                                                           rid, file);
+            break;
+        case WType::DELETE_TUPLE:
+            log_record = std::make_unique<DeleteLogRecord>(txn->get_transaction_id(), write_rec->GetRecord(), rid, file);
+            break;
+        case WType::UPDATE_TUPLE:
+            log_record = std::make_unique<UpdateLogRecord>(txn->get_transaction_id(), write_rec->GetRecord(),
+                                                           RmRecord(record_size, new_data), rid, file);
+            break;
+    }
+    lsn_t lsn = add_txn_log(txn, log_record.get());
+    fh->set_page_lsn(rid.page_no, lsn);
+    return lsn;
+}
 
+/**
+ * @description: 把当前缓冲区写盘，调用者需要持有latch_且没有其他线程在写盘
+ * 写盘前切换到另一个缓冲区并释放latch_，写盘期间其他事务可以继续添加日志
+ * @param {unique_lock<mutex>&} lock 调用者持有的latch_
+ */
+void LogManager::flush_buffer(std::unique_lock<std::mutex>& lock) {
+    LogBuffer *buffer = log_buffer_;
+    log_buffer_ = buffer == &buffers_[0] ? &buffers_[1] : &buffers_[0];
+    lsn_t last_lsn = global_lsn_ - 1;
+    flushing_ = true;
+    lock.unlock();
+    try {
+        if (buffer->offset_ > 0) {
+            disk_manager_->write_log(buffer->buffer_, buffer->offset_);
+        }
+    } catch (...) {
+        // 写盘失败时唤醒等待者，由它们重新尝试或报错
+        lock.lock();
+        flushing_ = false;
+        flush_cv_.notify_all();
+        throw;
+    }
+    if (flush_listener_) {
+        flush_listener_();
+    }
+    lock.lock();
+    buffer->offset_ = 0;
+    persist_lsn_ = last_lsn;
+    flushing_ = false;
+    flush_cv_.notify_all();
+}
+
+/**
+ * @description: 打开数据库后从日志起始位置扫描日志，找到日志末尾并接着最后一条日志的日志号继续分配
+ * 日志段是预先填零或回收的旧段，遇到长度为0、长度不合法或日志号不连续的记录时说明已经越过日志末尾
+ * 第一条记录的日志号要等于控制文件中记录的日志号，否则起始位置上是回收的段中残留的旧日志，日志为空
+ */
+void LogManager::open() {
+    std::unique_lock<std::mutex> lock(latch_);
+    int64_t offset = disk_manager_->get_log_begin();
+    lsn_t begin_lsn = disk_manager_->get_log_begin_lsn();
+    lsn_t last_lsn = begin_lsn == INVALID_LSN ? INVALID_LSN : begin_lsn - 1;
+    char header[LOG_HEADER_SIZE];
+    LogRecord log_record;
+    while (disk_manager_->read_log(header, LOG_HEADER_SIZE, offset) == LOG_HEADER_SIZE) {
+        log_record.deserialize(header);
+        if (log_record.log_tot_len_ < (uint32_t)LOG_HEADER_SIZE || log_record.log_tot_len_ > LOG_BUFFER_SIZE ||
+            log_record.lsn_ < 0 || (last_lsn != INVALID_LSN && log_record.lsn_ != last_lsn + 1)) {
+            break;
+        }
+        last_lsn = log_record.lsn_;
+        offset += log_record.log_tot_len_;
+    }
+    disk_manager_->set_log_end(offset);
+    next_offset_ = offset;
+    global_lsn_ = last_lsn + 1;
+    persist_lsn_ = last_lsn;
+}
+
+/**
+ * @description: 从当前时刻恢复需要的日志起点，即最老的活跃事务的BEGIN日志位置，没有活跃事务时为下一条日志的位置
+ * 调用者需要持有latch_
+ */
+int64_t LogManager::redo_begin() {
+    int64_t begin = next_offset_;
+    for (auto &entry : active_begin_) {
+        begin = std::min(begin, entry.second);
+    }
+    return begin;
+}
+
+/**
+ * @description: 开始在线备份，备份结束之前检查点不会回收备份需要的日志
+ * 此后复制的页面包含了起点之前所有已经写入缓冲池的修改，起点之后的修改由备份中的日志重做
+ * @return {int64_t} 备份需要的日志起点
+ */
+int64_t LogManager::begin_backup() {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (backup_begin_ != INT64_MAX) {
+        throw BackupInProgressError();
+    }
+    backup_begin_ = redo_begin();
+    return backup_begin_;
+}
+
+void LogManager::end_backup() {
+    std::lock_guard<std::mutex> lock(latch_);
+    backup_begin_ = INT64_MAX;
+}
+
+/**
+ * @description: 检查点，先确定最老的活跃事务的BEGIN日志位置，再把脏页刷盘，之后回收该位置之前的日志段
+ * @param {function<void()>&} flush_pages 把所有脏页刷盘
+ * @param {int64_t} retain_offset 还需要保留的最早的日志位置，副本尚未接收的日志不能回收
+ */
+void LogManager::checkpoint(const std::function<void()>& flush_pages, int64_t retain_offset) {
+    std::unique_lock<std::mutex> lock(latch_);
+    int64_t begin = std::min({redo_begin(), retain_offset, backup_begin_});
+    lock.unlock();
+    flush_pages();
+    // 日志的起始位置不能越过已经写盘的部分
+    flush_log_to_disk();
+    disk_manager_->recycle_log(begin, get_lsn_at(begin));
+}
+
+/**
+ * @description: 日志中一条记录的日志号，位置上还没有写入日志时为下一个要分配的日志号
+ * 检查点和备份把它与起始位置一起写入控制文件，打开日志时据此识别起始位置上残留的旧日志
+ * @return {lsn_t} 日志号
+ * @param {int64_t} offset 一条日志记录的开始位置，不超过下一条日志的位置
+ */
+lsn_t LogManager::get_lsn_at(int64_t offset) {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            if (offset == next_offset_) {
+                return global_lsn_;
+            }
+        }
+        // 写盘以整条记录为单位，位置在日志末尾之前时整条记录都已经写盘
+        if (offset < disk_manager_->get_log_end()) {
+            char header[LOG_HEADER_SIZE];
+            disk_manager_->read_log(header, LOG_HEADER_SIZE, offset);
+            LogRecord log_record;
+            log_record.deserialize(header);
+            return log_record.lsn_;
+        }
+        flush_log_to_disk();
+    }
+}
+
+/**
+ * @description: 启动后台写盘线程，每隔log_timeout把缓冲区中还没有写盘的日志写盘
+ * 异步提交的事务不等待写盘，故障时最多丢失最近log_timeout内提交的事务
+ */
+void LogManager::start_flusher() {
+    flusher_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (!stop_flusher_) {
+            flusher_cv_.wait_for(lock, log_timeout);
+            if (stop_flusher_ || flushing_ || persist_lsn_ >= global_lsn_ - 1) {
+                continue;
+            }
+            try {
+                flush_buffer(lock);
+            } catch (RMDBError &e) {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+    });
 }
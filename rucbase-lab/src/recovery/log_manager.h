@@ -10,13 +10,21 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 #include "log_defs.h"
 #include "common/config.h"
 #include "record/rm_defs.h"
 
+class Transaction;
+class WriteRecord;
+class RmFileHandle;
+
 /* 日志记录对应操作的类型 */
 enum LogType: int {
     UPDATE = 0,
@@ -24,7 +32,10 @@ enum LogType: int {
     DELETE,
     begin,
     commit,
-    ABORT
+    ABORT,
+    TRUNCATE,
+    MOVE,
+    SHRINK
 };
 static std::string LogTypeStr[] = {
     "UPDATE",
@@ -32,7 +43,10 @@ static std::string LogTypeStr[] = {
     "DELETE",
     "BEGIN",
     "COMMIT",
-    "ABORT"
+    "ABORT",
+    "TRUNCATE",
+    "MOVE",
+    "SHRINK"
 };
 
 class LogRecord {
@@ -98,17 +112,61 @@ public:
 };
 
 /**
- * TODO: commit操作的日志记录
+ * commit操作的日志记录
 */
 class CommitLogRecord: public LogRecord {
-
+public:
+    CommitLogRecord() {
+        log_type_ = LogType::commit;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+    }
+    CommitLogRecord(txn_id_t txn_id) : CommitLogRecord() {
+        log_tid_ = txn_id;
+    }
+    // 序列化Commit日志记录到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+    }
+    // 从src中反序列化出一条Commit日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+    }
+    virtual void format_print() override {
+        std::cout << "log type in son_function: " << LogTypeStr[log_type_] << "\n";
+        LogRecord::format_print();
+    }
 };
 
 /**
- * TODO: abort操作的日志记录
+ * abort操作的日志记录
 */
 class AbortLogRecord: public LogRecord {
-
+public:
+    AbortLogRecord() {
+        log_type_ = LogType::ABORT;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+    }
+    AbortLogRecord(txn_id_t txn_id) : AbortLogRecord() {
+        log_tid_ = txn_id;
+    }
+    // 序列化Abort日志记录到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+    }
+    // 从src中反序列化出一条Abort日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+    }
+    virtual void format_print() override {
+        std::cout << "log type in son_function: " << LogTypeStr[log_type_] << "\n";
+        LogRecord::format_print();
+    }
 };
 
 class InsertLogRecord: public LogRecord {
@@ -121,7 +179,7 @@ public:
         prev_lsn_ = INVALID_LSN;
         table_name_ = nullptr;
     }
-    InsertLogRecord(txn_id_t txn_id, RmRecord& insert_value, Rid& rid, std::string table_name) 
+    InsertLogRecord(txn_id_t txn_id, const RmRecord& insert_value, const Rid& rid, const std::string& table_name)
         : InsertLogRecord() {
         log_tid_ = txn_id;
         insert_value_ = insert_value;
@@ -134,6 +192,7 @@ public:
         memcpy(table_name_, table_name.c_str(), table_name_size_);
         log_tot_len_ += sizeof(size_t) + table_name_size_;
     }
+    ~InsertLogRecord() { delete[] table_name_; }
 
     // 把insert日志记录序列化到dest中
     void serialize(char* dest) const override {
@@ -176,20 +235,332 @@ public:
 };
 
 /**
- * TODO: delete操作的日志记录
+ * delete操作的日志记录，记录被删除的记录，用于redo删除和undo时恢复记录
 */
 class DeleteLogRecord: public LogRecord {
+public:
+    DeleteLogRecord() {
+        log_type_ = LogType::DELETE;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        table_name_ = nullptr;
+    }
+    DeleteLogRecord(txn_id_t txn_id, const RmRecord& delete_value, const Rid& rid, const std::string& table_name)
+        : DeleteLogRecord() {
+        log_tid_ = txn_id;
+        delete_value_ = delete_value;
+        rid_ = rid;
+        log_tot_len_ += sizeof(int);
+        log_tot_len_ += delete_value_.size;
+        log_tot_len_ += sizeof(Rid);
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        log_tot_len_ += sizeof(size_t) + table_name_size_;
+    }
+    ~DeleteLogRecord() { delete[] table_name_; }
+
+    // 把delete日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &delete_value_.size, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, delete_value_.data, delete_value_.size);
+        offset += delete_value_.size;
+        memcpy(dest + offset, &rid_, sizeof(Rid));
+        offset += sizeof(Rid);
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+    }
+    // 从src中反序列化出一条Delete日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        delete_value_.Deserialize(src + OFFSET_LOG_DATA);
+        int offset = OFFSET_LOG_DATA + delete_value_.size + sizeof(int);
+        rid_ = *reinterpret_cast<const Rid*>(src + offset);
+        offset += sizeof(Rid);
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+    }
+    void format_print() override {
+        printf("delete record\n");
+        LogRecord::format_print();
+        printf("delete rid: %d, %d\n", rid_.page_no, rid_.slot_no);
+        printf("table name: %.*s\n", (int)table_name_size_, table_name_);
+    }
 
+    RmRecord delete_value_;     // 被删除的记录
+    Rid rid_;                   // 被删除记录的位置
+    char* table_name_;          // 记录所在的表名称
+    size_t table_name_size_;    // 表名称的大小
 };
 
 /**
- * TODO: update操作的日志记录
+ * update操作的日志记录，同时记录更新前后的记录，redo使用更新后的记录，undo使用更新前的记录
 */
 class UpdateLogRecord: public LogRecord {
+public:
+    UpdateLogRecord() {
+        log_type_ = LogType::UPDATE;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        table_name_ = nullptr;
+    }
+    UpdateLogRecord(txn_id_t txn_id, const RmRecord& old_value, const RmRecord& new_value, const Rid& rid,
+                    const std::string& table_name)
+        : UpdateLogRecord() {
+        log_tid_ = txn_id;
+        old_value_ = old_value;
+        new_value_ = new_value;
+        rid_ = rid;
+        log_tot_len_ += sizeof(int) + old_value_.size;
+        log_tot_len_ += sizeof(int) + new_value_.size;
+        log_tot_len_ += sizeof(Rid);
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        log_tot_len_ += sizeof(size_t) + table_name_size_;
+    }
+    ~UpdateLogRecord() { delete[] table_name_; }
 
+    // 把update日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &old_value_.size, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, old_value_.data, old_value_.size);
+        offset += old_value_.size;
+        memcpy(dest + offset, &new_value_.size, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, new_value_.data, new_value_.size);
+        offset += new_value_.size;
+        memcpy(dest + offset, &rid_, sizeof(Rid));
+        offset += sizeof(Rid);
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+    }
+    // 从src中反序列化出一条Update日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        int offset = OFFSET_LOG_DATA;
+        old_value_.Deserialize(src + offset);
+        offset += sizeof(int) + old_value_.size;
+        new_value_.Deserialize(src + offset);
+        offset += sizeof(int) + new_value_.size;
+        rid_ = *reinterpret_cast<const Rid*>(src + offset);
+        offset += sizeof(Rid);
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+    }
+    void format_print() override {
+        printf("update record\n");
+        LogRecord::format_print();
+        printf("update rid: %d, %d\n", rid_.page_no, rid_.slot_no);
+        printf("table name: %.*s\n", (int)table_name_size_, table_name_);
+    }
+
+    RmRecord old_value_;        // 更新前的记录
+    RmRecord new_value_;        // 更新后的记录
+    Rid rid_;                   // 被更新记录的位置
+    char* table_name_;          // 记录所在的表名称
+    size_t table_name_size_;    // 表名称的大小
 };
 
-/* 日志缓冲区，只有一个buffer，因此需要阻塞地去把日志写入缓冲区中 */
+/**
+ * truncate操作的日志记录，只记录被清空的数据文件名，重做时把数据文件及其上的索引替换为空文件
+ * 之前对该文件的修改按日志顺序先于它重做，之后被它清除；清空不能撤销，所在事务回滚时也不撤销
+*/
+class TruncateLogRecord: public LogRecord {
+public:
+    TruncateLogRecord() {
+        log_type_ = LogType::TRUNCATE;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        table_name_ = nullptr;
+    }
+    TruncateLogRecord(txn_id_t txn_id, const std::string& table_name) : TruncateLogRecord() {
+        log_tid_ = txn_id;
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        log_tot_len_ += sizeof(size_t) + table_name_size_;
+    }
+    ~TruncateLogRecord() { delete[] table_name_; }
+
+    // 把truncate日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+    }
+    // 从src中反序列化出一条Truncate日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        int offset = OFFSET_LOG_DATA;
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+    }
+    void format_print() override {
+        printf("truncate file\n");
+        LogRecord::format_print();
+        printf("table name: %.*s\n", (int)table_name_size_, table_name_);
+    }
+
+    char* table_name_;          // 被清空的数据文件名
+    size_t table_name_size_;    // 文件名的大小
+};
+
+/**
+ * VACUUM移动一条记录的日志记录，插入目标槽位和删除原槽位在同一条日志中，重做时两者一起完成
+ * 移动不改变记录的内容，不需要撤销，所在事务回滚时也不撤销
+*/
+class MoveLogRecord: public LogRecord {
+public:
+    MoveLogRecord() {
+        log_type_ = LogType::MOVE;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        table_name_ = nullptr;
+    }
+    MoveLogRecord(txn_id_t txn_id, const RmRecord& value, const Rid& src, const Rid& dst, const std::string& table_name)
+        : MoveLogRecord() {
+        log_tid_ = txn_id;
+        value_ = value;
+        src_ = src;
+        dst_ = dst;
+        log_tot_len_ += sizeof(int);
+        log_tot_len_ += value_.size;
+        log_tot_len_ += sizeof(Rid) * 2;
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        log_tot_len_ += sizeof(size_t) + table_name_size_;
+    }
+    ~MoveLogRecord() { delete[] table_name_; }
+
+    // 把move日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &value_.size, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, value_.data, value_.size);
+        offset += value_.size;
+        memcpy(dest + offset, &src_, sizeof(Rid));
+        offset += sizeof(Rid);
+        memcpy(dest + offset, &dst_, sizeof(Rid));
+        offset += sizeof(Rid);
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+    }
+    // 从src中反序列化出一条Move日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        value_.Deserialize(src + OFFSET_LOG_DATA);
+        int offset = OFFSET_LOG_DATA + value_.size + sizeof(int);
+        src_ = *reinterpret_cast<const Rid*>(src + offset);
+        offset += sizeof(Rid);
+        dst_ = *reinterpret_cast<const Rid*>(src + offset);
+        offset += sizeof(Rid);
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+    }
+    void format_print() override {
+        printf("move record\n");
+        LogRecord::format_print();
+        printf("move rid: %d, %d -> %d, %d\n", src_.page_no, src_.slot_no, dst_.page_no, dst_.slot_no);
+        printf("table name: %.*s\n", (int)table_name_size_, table_name_);
+    }
+
+    RmRecord value_;            // 被移动的记录
+    Rid src_;                   // 记录原来的位置
+    Rid dst_;                   // 记录移动到的位置
+    char* table_name_;          // 记录所在的数据文件名
+    size_t table_name_size_;    // 文件名的大小
+};
+
+/**
+ * VACUUM截断数据文件末尾页面的日志记录，截断前写盘，重做时把文件截断为num_pages个页面
+ * 被截断的页面中的记录已经由之前的move日志移走，截断不能撤销
+*/
+class ShrinkLogRecord: public LogRecord {
+public:
+    ShrinkLogRecord() {
+        log_type_ = LogType::SHRINK;
+        lsn_ = INVALID_LSN;
+        log_tot_len_ = LOG_HEADER_SIZE;
+        log_tid_ = INVALID_TXN_ID;
+        prev_lsn_ = INVALID_LSN;
+        table_name_ = nullptr;
+    }
+    ShrinkLogRecord(txn_id_t txn_id, const std::string& table_name, int num_pages) : ShrinkLogRecord() {
+        log_tid_ = txn_id;
+        num_pages_ = num_pages;
+        log_tot_len_ += sizeof(int);
+        table_name_size_ = table_name.length();
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, table_name.c_str(), table_name_size_);
+        log_tot_len_ += sizeof(size_t) + table_name_size_;
+    }
+    ~ShrinkLogRecord() { delete[] table_name_; }
+
+    // 把shrink日志记录序列化到dest中
+    void serialize(char* dest) const override {
+        LogRecord::serialize(dest);
+        int offset = OFFSET_LOG_DATA;
+        memcpy(dest + offset, &num_pages_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &table_name_size_, sizeof(size_t));
+        offset += sizeof(size_t);
+        memcpy(dest + offset, table_name_, table_name_size_);
+    }
+    // 从src中反序列化出一条Shrink日志记录
+    void deserialize(const char* src) override {
+        LogRecord::deserialize(src);
+        int offset = OFFSET_LOG_DATA;
+        num_pages_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        table_name_size_ = *reinterpret_cast<const size_t*>(src + offset);
+        offset += sizeof(size_t);
+        table_name_ = new char[table_name_size_];
+        memcpy(table_name_, src + offset, table_name_size_);
+    }
+    void format_print() override {
+        printf("shrink file\n");
+        LogRecord::format_print();
+        printf("num pages: %d\n", num_pages_);
+        printf("table name: %.*s\n", (int)table_name_size_, table_name_);
+    }
+
+    int num_pages_;             // 截断后文件中的页面个数
+    char* table_name_;          // 被截断的数据文件名
+    size_t table_name_size_;    // 文件名的大小
+};
+
+/* 日志缓冲区，日志管理器使用两个buffer，写盘期间新的日志写入另一个buffer */
 
 class LogBuffer {
 public:
@@ -212,16 +583,71 @@ public:
 class LogManager {
 public:
     LogManager(DiskManager* disk_manager) { disk_manager_ = disk_manager; }
+
+    ~LogManager();
     
     lsn_t add_log_to_buffer(LogRecord* log_record);
-    void flush_log_to_disk();
+    void flush_log_to_disk(lsn_t lsn = INVALID_LSN);
+
+    lsn_t add_txn_log(Transaction* txn, LogRecord* log_record);
+
+    lsn_t add_write_log(Transaction* txn, WriteRecord* write_rec, char* new_data, RmFileHandle* fh);
+
+    void open();
 
-    LogBuffer* get_log_buffer() { return &log_buffer_; }
+    void start_flusher();
+
+    void checkpoint(const std::function<void()>& flush_pages, int64_t retain_offset = INT64_MAX);
+
+    int64_t begin_backup();
+
+    lsn_t get_lsn_at(int64_t offset);
+
+    void end_backup();
+
+    /* 设置日志写盘之后的通知，日志发送端由此得知有新的日志可以发给副本 */
+    void set_flush_listener(std::function<void()> listener) { flush_listener_ = std::move(listener); }
+
+    /* 检查点之后积累的日志量 */
+    int64_t get_log_size() {
+        std::lock_guard<std::mutex> lock(latch_);
+        return next_offset_ - disk_manager_->get_log_begin();
+    }
+
+    /* 恢复出的未完成事务在回滚完成之前，检查点不能回收它的BEGIN日志之后的日志 */
+    void add_active_txn(txn_id_t txn_id, int64_t begin_offset) {
+        std::lock_guard<std::mutex> lock(latch_);
+        active_begin_[txn_id] = begin_offset;
+    }
+
+    LogBuffer* get_log_buffer() { return log_buffer_; }
+
+    lsn_t get_persist_lsn() {
+        std::lock_guard<std::mutex> lock(latch_);
+        return persist_lsn_;
+    }
+
+    /* 已经分配的最大日志号，日志可能还在缓冲区中 */
+    lsn_t get_last_lsn() { return global_lsn_ - 1; }
 
 private:    
+    void flush_buffer(std::unique_lock<std::mutex>& lock);
+
+    int64_t redo_begin();
+
     std::atomic<lsn_t> global_lsn_{0};  // 全局lsn，递增，用于为每条记录分发lsn
     std::mutex latch_;                  // 用于对log_buffer_的互斥访问
-    LogBuffer log_buffer_;              // 日志缓冲区
-    lsn_t persist_lsn_;                 // 记录已经持久化到磁盘中的最后一条日志的日志号
+    LogBuffer buffers_[2];              // 两个日志缓冲区轮流使用，一个写盘时另一个继续接收日志
+    LogBuffer* log_buffer_ = &buffers_[0];  // 当前接收日志的缓冲区
+    bool flushing_ = false;             // 是否有线程正在把另一个缓冲区写盘
+    std::condition_variable flush_cv_;  // 等待正在进行的写盘完成
+    lsn_t persist_lsn_ = INVALID_LSN;   // 记录已经持久化到磁盘中的最后一条日志的日志号
+    int64_t next_offset_ = 0;           // 下一条日志记录在日志中的位置
+    std::unordered_map<txn_id_t, int64_t> active_begin_;   // 写过BEGIN日志且尚未结束的事务 -> BEGIN日志的位置
+    int64_t backup_begin_ = INT64_MAX;  // 正在进行的在线备份需要的日志起点，没有备份时为INT64_MAX
+    std::thread flusher_;               // 后台写盘线程，异步提交的事务依赖它在log_timeout内把日志写盘
+    bool stop_flusher_ = false;
+    std::condition_variable flusher_cv_;
+    std::function<void()> flush_listener_;
     DiskManager* disk_manager_;
 }; 
@@ -10,23 +10,366 @@ See the Mulan PSL v2 for more details. */
 
 #include "log_recovery.h"
 
+#include <algorithm>
+
+RecoveryManager::~RecoveryManager() {
+    if (undo_thread_.joinable()) {
+        undo_thread_.join();
+    }
+}
+
+/* 按日志类型反序列化修改记录的日志 */
+static std::shared_ptr<LogRecord> make_write_log(LogType log_type) {
+    switch (log_type) {
+        case LogType::INSERT:
+            return std::make_shared<InsertLogRecord>();
+        case LogType::DELETE:
+            return std::make_shared<DeleteLogRecord>();
+        case LogType::UPDATE:
+            return std::make_shared<UpdateLogRecord>();
+        case LogType::TRUNCATE:
+            return std::make_shared<TruncateLogRecord>();
+        case LogType::MOVE:
+            return std::make_shared<MoveLogRecord>();
+        case LogType::SHRINK:
+            return std::make_shared<ShrinkLogRecord>();
+        default:
+            return nullptr;
+    }
+}
+
+/* 插入、删除和更新记录的日志可以撤销，清空、VACUUM移动记录和截断文件的日志只重做 */
+static bool is_undoable(LogType log_type) {
+    return log_type == LogType::INSERT || log_type == LogType::DELETE || log_type == LogType::UPDATE;
+}
+
+/* 修改记录的日志涉及的数据文件、记录位置以及修改前后的记录，插入没有修改前的记录，删除没有修改后的记录 */
+struct WriteLogInfo {
+    std::string file;
+    Rid rid;
+    char *old_data = nullptr;
+    char *new_data = nullptr;
+    int old_size = 0;   // 修改前的记录的大小
+    int new_size = 0;   // 修改后的记录的大小，增加字段之前写的日志中记录较短
+};
+
+static WriteLogInfo parse_write_log(LogRecord* log_record) {
+    WriteLogInfo info;
+    switch (log_record->log_type_) {
+        case LogType::INSERT: {
+            auto insert_log = static_cast<InsertLogRecord*>(log_record);
+            info.file.assign(insert_log->table_name_, insert_log->table_name_size_);
+            info.rid = insert_log->rid_;
+            info.new_data = insert_log->insert_value_.data;
+            info.new_size = insert_log->insert_value_.size;
+            break;
+        }
+        case LogType::DELETE: {
+            auto delete_log = static_cast<DeleteLogRecord*>(log_record);
+            info.file.assign(delete_log->table_name_, delete_log->table_name_size_);
+            info.rid = delete_log->rid_;
+            info.old_data = delete_log->delete_value_.data;
+            info.old_size = delete_log->delete_value_.size;
+            break;
+        }
+        default: {
+            auto update_log = static_cast<UpdateLogRecord*>(log_record);
+            info.file.assign(update_log->table_name_, update_log->table_name_size_);
+            info.rid = update_log->rid_;
+            info.old_data = update_log->old_value_.data;
+            info.old_size = update_log->old_value_.size;
+            info.new_data = update_log->new_value_.data;
+            info.new_size = update_log->new_value_.size;
+            break;
+        }
+    }
+    return info;
+}
+
+/* 由记录生成索引键 */
+static std::vector<char> make_index_key(const IndexMeta &index, const char *rec) {
+    std::vector<char> key(index.col_tot_len);
+    int offset = 0;
+    for (auto &col : index.cols) {
+        memcpy(key.data() + offset, rec + col.offset, col.len);
+        offset += col.len;
+    }
+    return key;
+}
+
 /**
- * @description: analyze阶段，需要获得脏页表（DPT）和未完成的事务列表（ATT）
+ * @description: analyze阶段，从日志起始位置扫描到日志末尾，收集修改记录的日志，得到未完成的事务列表（ATT）
+ * 检查点只回收所有活跃事务的BEGIN日志之前的日志，日志起始位置之后包含了未完成事务的全部日志
+ * 重做是幂等的，从日志起始位置开始全部重做，不需要脏页表
  */
 void RecoveryManager::analyze() {
- 
+    int64_t offset = disk_manager_->get_log_begin();
+    int64_t log_end = disk_manager_->get_log_end();
+    txn_id_t max_txn_id = INVALID_TXN_ID;
+    while (offset < log_end) {
+        LogRecord header;
+        disk_manager_->read_log(buffer_.buffer_, LOG_HEADER_SIZE, offset);
+        header.deserialize(buffer_.buffer_);
+        disk_manager_->read_log(buffer_.buffer_, header.log_tot_len_, offset);
+        max_txn_id = std::max(max_txn_id, header.log_tid_);
+        switch (header.log_type_) {
+            case LogType::begin:
+                losers_[header.log_tid_] = LoserTxn{offset, header.lsn_, {}};
+                break;
+            case LogType::commit:
+            case LogType::ABORT:
+                losers_.erase(header.log_tid_);
+                break;
+            default: {
+                auto log_record = make_write_log(header.log_type_);
+                log_record->deserialize(buffer_.buffer_);
+                auto it = losers_.find(header.log_tid_);
+                if (it != losers_.end()) {
+                    it->second.last_lsn = header.lsn_;
+                    // 只重做的日志不加入未完成事务需要撤销的日志
+                    if (is_undoable(header.log_type_)) {
+                        it->second.write_logs.push_back(log_record);
+                    }
+                }
+                write_logs_.push_back(log_record);
+                break;
+            }
+        }
+        offset += header.log_tot_len_;
+    }
+    // 事务ID不持久化，之后的事务ID从日志中出现过的最大事务ID之后分配
+    txn_manager_->advance_txn_id(max_txn_id);
 }
 
 /**
- * @description: 重做所有未落盘的操作
+ * @description: 重做日志中所有修改记录的操作（repeating history），包括已经提交、已经回滚和未完成的事务
+ * 回滚操作本身也作为修改写了日志，重做之后数据处于故障发生时的状态
+ * 索引的修改不单独写日志，故障时写盘的结点可能不构成完整的B+树，重做过的数据文件上的索引按重做后的记录重建
  */
 void RecoveryManager::redo() {
+    for (auto &log_record : write_logs_) {
+        redo_write(log_record.get(), false);
+    }
+    for (auto &file : redo_files_) {
+        sm_manager_->get_file_handle(file)->rebuild_free_list();
+        sm_manager_->rebuild_indexes(file);
+    }
+}
 
+/**
+ * @description: 重做一条修改记录的日志
+ * 数据页和索引项的修改都是幂等的，按日志顺序重做一遍得到日志末尾时的状态
+ * 清空文件的日志把文件替换为空文件，之前重做到该文件中的修改随之清除
+ * 截断文件的日志之前已经重做了移走末尾页面中记录的日志，重做截断时末尾页面都已经为空
+ * @param {LogRecord*} log_record 修改记录的日志
+ * @param {bool} redo_index 是否同时修改索引项，故障恢复时索引在重做之后整体重建，副本重放时索引是完整的
+ */
+void RecoveryManager::redo_write(LogRecord* log_record, bool redo_index) {
+    if (log_record->log_type_ == LogType::TRUNCATE) {
+        auto truncate_log = static_cast<TruncateLogRecord*>(log_record);
+        std::unique_lock<std::shared_mutex> lock(sm_manager_->meta_latch_);
+        sm_manager_->reset_file(std::string(truncate_log->table_name_, truncate_log->table_name_size_));
+        return;
+    }
+    if (log_record->log_type_ == LogType::MOVE) {
+        redo_move(static_cast<MoveLogRecord*>(log_record), redo_index);
+        return;
+    }
+    if (log_record->log_type_ == LogType::SHRINK) {
+        auto shrink_log = static_cast<ShrinkLogRecord*>(log_record);
+        auto fh = sm_manager_->get_file_handle(std::string(shrink_log->table_name_, shrink_log->table_name_size_));
+        if (fh != nullptr) {
+            fh->truncate(shrink_log->num_pages_);
+        }
+        return;
+    }
+    auto info = parse_write_log(log_record);
+    auto fh = sm_manager_->get_file_handle(info.file);
+    if (fh == nullptr) {
+        // 表在故障前已经被删除
+        return;
+    }
+    fh->redo_record(info.rid, info.new_data, info.new_size, log_record->lsn_);
+    redo_files_.insert(info.file);
+    if (!redo_index) {
+        return;
+    }
+    for (auto &index : sm_manager_->db_.get_table(file_tab_name(info.file)).indexes) {
+        auto ih = sm_manager_->get_index_handle(info.file, index.cols);
+        if (info.old_data != nullptr) {
+            ih->delete_entry(make_index_key(index, info.old_data).data(), nullptr);
+        }
+        if (info.new_data != nullptr) {
+            auto key = make_index_key(index, info.new_data);
+            ih->delete_entry(key.data(), nullptr);
+            ih->insert_entry(key.data(), info.rid, nullptr);
+        }
+    }
+}
+
+/**
+ * @description: 重做VACUUM移动一条记录的日志，在目标槽位写入记录并清除原槽位，索引项改为指向目标槽位
+ * @param {MoveLogRecord*} move_log 移动记录的日志
+ * @param {bool} redo_index 是否同时修改索引项
+ */
+void RecoveryManager::redo_move(MoveLogRecord* move_log, bool redo_index) {
+    std::string file(move_log->table_name_, move_log->table_name_size_);
+    auto fh = sm_manager_->get_file_handle(file);
+    if (fh == nullptr) {
+        return;
+    }
+    fh->redo_record(move_log->dst_, move_log->value_.data, move_log->value_.size, move_log->lsn_);
+    fh->redo_record(move_log->src_, nullptr, 0, move_log->lsn_);
+    redo_files_.insert(file);
+    if (!redo_index) {
+        return;
+    }
+    for (auto &index : sm_manager_->db_.get_table(file_tab_name(file)).indexes) {
+        auto ih = sm_manager_->get_index_handle(file, index.cols);
+        auto key = make_index_key(index, move_log->value_.data);
+        ih->delete_entry(key.data(), nullptr);
+        ih->insert_entry(key.data(), move_log->dst_, nullptr);
+    }
 }
 
 /**
  * @description: 回滚未完成的事务
+ * 先为每个未完成的事务重建事务对象和写集合，并锁住它修改过的记录，之后立即返回开始接受连接，由后台线程逐个回滚这些事务
+ * 回滚复用事务的abort，撤销操作写日志，回滚期间再次故障时重做这些撤销操作，再连同它们一起撤销
  */
 void RecoveryManager::undo() {
+    auto lock_manager = txn_manager_->get_lock_manager();
+    std::vector<Transaction*> txns;
+    for (auto &entry : losers_) {
+        auto &loser = entry.second;
+        auto txn = txn_manager_->resume(entry.first);
+        txn->set_prev_lsn(loser.last_lsn);
+        Context context(lock_manager, log_manager_, txn);
+        for (auto &log_record : loser.write_logs) {
+            auto info = parse_write_log(log_record.get());
+            auto fh = sm_manager_->get_file_handle(info.file);
+            if (fh == nullptr) {
+                continue;
+            }
+            lock_manager->lock_IX_on_table(txn, fh->GetFd());
+            fh->lock_record(info.rid, &context, true);
+            int record_size = fh->get_file_hdr().record_size;
+            if (log_record->log_type_ == LogType::INSERT) {
+                txn->append_write_record(new WriteRecord(WType::INSERT_TUPLE, info.file, info.rid));
+            } else if (log_record->log_type_ == LogType::DELETE) {
+                txn->append_write_record(
+                    new WriteRecord(WType::DELETE_TUPLE, info.file, info.rid, RmRecord(record_size, info.old_data)));
+            } else {
+                txn->append_write_record(
+                    new WriteRecord(WType::UPDATE_TUPLE, info.file, info.rid, RmRecord(record_size, info.old_data)));
+            }
+        }
+        if (!txn->has_writes()) {
+            // 只写了BEGIN日志的事务没有需要撤销的修改
+            txn_manager_->abort(txn, log_manager_);
+            txn_manager_->release(txn);
+            continue;
+        }
+        log_manager_->add_active_txn(entry.first, loser.begin_offset);
+        txns.push_back(txn);
+    }
+    losers_.clear();
+    write_logs_.clear();
+    if (txns.empty()) {
+        return;
+    }
+    undo_thread_ = std::thread([this, txns] {
+        for (auto txn : txns) {
+            try {
+                txn_manager_->abort(txn, log_manager_);
+            } catch (RMDBError &e) {
+                std::cerr << e.what() << std::endl;
+            }
+            txn_manager_->release(txn);
+        }
+    });
+}
+
+/**
+ * @description: 副本在启动时的分析和重做之后开始重放
+ * 重做把未完成事务的修改也写入了页面，开始提供查询之前按日志的逆序撤销这些修改，撤销不写日志，副本的日志与主库保持一致
+ * 这些修改仍保留在事务的日志列表中，收到事务的COMMIT或ABORT日志时与之后的修改一起按日志顺序重做
+ */
+void RecoveryManager::start_replay() {
+    std::vector<LogRecord*> loser_logs;
+    for (auto &entry : losers_) {
+        for (auto &log_record : entry.second.write_logs) {
+            loser_logs.push_back(log_record.get());
+        }
+    }
+    std::sort(loser_logs.begin(), loser_logs.end(),
+              [](LogRecord* a, LogRecord* b) { return a->lsn_ > b->lsn_; });
+    for (auto log_record : loser_logs) {
+        undo_write(log_record);
+    }
+    write_logs_.clear();
+}
 
-}
\ No newline at end of file
+/**
+ * @description: 把一条修改记录的日志涉及的记录槽恢复为修改前的内容，并同步修改索引项，用于副本启动时隐藏未完成事务的修改
+ * @param {LogRecord*} log_record 修改记录的日志，已经重做过
+ */
+void RecoveryManager::undo_write(LogRecord* log_record) {
+    auto info = parse_write_log(log_record);
+    auto fh = sm_manager_->get_file_handle(info.file);
+    if (fh == nullptr) {
+        return;
+    }
+    fh->redo_record(info.rid, info.old_data, info.old_size, log_record->lsn_);
+    for (auto &index : sm_manager_->db_.get_table(file_tab_name(info.file)).indexes) {
+        auto ih = sm_manager_->get_index_handle(info.file, index.cols);
+        if (info.new_data != nullptr) {
+            ih->delete_entry(make_index_key(index, info.new_data).data(), nullptr);
+        }
+        if (info.old_data != nullptr) {
+            auto key = make_index_key(index, info.old_data);
+            ih->delete_entry(key.data(), nullptr);
+            ih->insert_entry(key.data(), info.rid, nullptr);
+        }
+    }
+}
+
+/**
+ * @description: 副本重放从主库收到的日志，事务的修改缓存到事务结束时再按日志顺序重做，副本上的查询只能看到已经结束的事务
+ * 主库的事务持有写锁直到COMMIT日志写入缓冲区，冲突的修改在日志中一定位于先结束的事务的结束日志之后，按结束顺序重做与按日志顺序重做结果相同
+ * 回滚的事务同样重做，它的撤销操作在日志中，重做之后抵消原来的修改
+ * @param {char*} log_data 若干条完整的日志记录
+ * @param {int} size 日志记录的总长度
+ * @param {int64_t} offset 第一条日志记录在日志中的位置
+ */
+void RecoveryManager::replay(const char* log_data, int size, int64_t offset) {
+    for (int pos = 0; pos < size;) {
+        LogRecord header;
+        header.deserialize(log_data + pos);
+        switch (header.log_type_) {
+            case LogType::begin:
+                losers_[header.log_tid_] = LoserTxn{offset + pos, header.lsn_, {}};
+                break;
+            case LogType::commit:
+            case LogType::ABORT: {
+                auto it = losers_.find(header.log_tid_);
+                if (it != losers_.end()) {
+                    for (auto &log_record : it->second.write_logs) {
+                        redo_write(log_record.get(), true);
+                    }
+                    losers_.erase(it);
+                }
+                break;
+            }
+            default: {
+                auto log_record = make_write_log(header.log_type_);
+                log_record->deserialize(log_data + pos);
+                auto it = losers_.emplace(header.log_tid_, LoserTxn{offset + pos, header.lsn_, {}}).first;
+                it->second.last_lsn = header.lsn_;
+                it->second.write_logs.push_back(log_record);
+                break;
+            }
+        }
+        pos += header.log_tot_len_;
+    }
+}
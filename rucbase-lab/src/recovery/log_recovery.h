@@ -10,11 +10,16 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <set>
+#include <thread>
 #include <unordered_map>
 #include "log_manager.h"
 #include "storage/disk_manager.h"
 #include "system/sm_manager.h"
+#include "transaction/transaction_manager.h"
 
 class RedoLogsInPage {
 public:
@@ -23,20 +28,61 @@ public:
     std::vector<lsn_t> redo_logs_;   // 在该page上需要redo的操作的lsn
 };
 
+/* 分析阶段发现的未完成事务 */
+struct LoserTxn {
+    int64_t begin_offset;                       // BEGIN日志在日志中的位置，回滚完成前检查点不能回收之后的日志
+    lsn_t last_lsn;                             // 事务的最后一条日志的日志号
+    std::vector<std::shared_ptr<LogRecord>> write_logs;    // 事务修改记录的日志，按日志号顺序
+};
+
+/**
+ * @description: 故障恢复，分析和重做在启动时完成，之后立即开始接受连接
+ * 未完成的事务在后台回滚，回滚完成之前它们修改过的记录一直被锁住，其他事务访问这些记录时按死锁策略等待或回滚
+ */
 class RecoveryManager {
 public:
-    RecoveryManager(DiskManager* disk_manager, BufferPoolManager* buffer_pool_manager, SmManager* sm_manager) {
+    RecoveryManager(DiskManager* disk_manager, BufferPoolManager* buffer_pool_manager, SmManager* sm_manager,
+                    LogManager* log_manager, TransactionManager* txn_manager) {
         disk_manager_ = disk_manager;
         buffer_pool_manager_ = buffer_pool_manager;
         sm_manager_ = sm_manager;
+        log_manager_ = log_manager;
+        txn_manager_ = txn_manager;
     }
 
+    ~RecoveryManager();
+
     void analyze();
     void redo();
     void undo();
+
+    void start_replay();
+    void replay(const char* log_data, int size, int64_t offset);
+
+    /* 副本上尚未结束的事务中最早的BEGIN日志位置，副本做检查点时不回收它之后的日志 */
+    int64_t get_replay_begin() {
+        int64_t begin = INT64_MAX;
+        for (auto &entry : losers_) {
+            begin = std::min(begin, entry.second.begin_offset);
+        }
+        return begin;
+    }
+
 private:
+    void redo_write(LogRecord* log_record, bool redo_index);
+
+    void redo_move(MoveLogRecord* move_log, bool redo_index);
+
+    void undo_write(LogRecord* log_record);
+
     LogBuffer buffer_;                                              // 读入日志
     DiskManager* disk_manager_;                                     // 用来读写文件
     BufferPoolManager* buffer_pool_manager_;                        // 对页面进行读写
     SmManager* sm_manager_;                                         // 访问数据库元数据
-};
\ No newline at end of file
+    LogManager* log_manager_;                                       // 后台回滚时写日志
+    TransactionManager* txn_manager_;                               // 重建未完成的事务并回滚
+    std::vector<std::shared_ptr<LogRecord>> write_logs_;            // 日志中所有修改记录的日志，按日志号顺序
+    std::map<txn_id_t, LoserTxn> losers_;                           // 未完成的事务（ATT），副本上为尚未重放的事务
+    std::set<std::string> redo_files_;                              // 重做过修改的数据文件
+    std::thread undo_thread_;                                       // 后台回滚线程
+};
@@ -0,0 +1,206 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#include "log_replication.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+static sockaddr_un make_sock_addr(const std::string& sock_path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (sock_path.size() >= sizeof(addr.sun_path)) {
+        throw InternalError("Replication socket path is too long: " + sock_path);
+    }
+    strncpy(addr.sun_path, sock_path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+/* 发送全部数据，连接断开时返回false，不因对端关闭而收到SIGPIPE */
+static bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool recv_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(fd, data, size, 0);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * @description: 在数据库目录中创建unix socket并开始等待副本连接，每个副本由一个发送线程服务
+ * @param {string&} sock_path socket文件的路径，上次运行遗留的socket文件会被删除
+ */
+void LogSender::start(const std::string& sock_path) {
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw UnixError();
+    }
+    sockaddr_un addr = make_sock_addr(sock_path);
+    unlink(sock_path.c_str());
+    if (bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 4) < 0) {
+        close(listen_fd);
+        throw UnixError();
+    }
+    std::thread([this, listen_fd] {
+        while (true) {
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd >= 0) {
+                std::thread(&LogSender::send_loop, this, fd).detach();
+            }
+        }
+    }).detach();
+}
+
+/**
+ * @description: 服务一个副本：读出副本的日志末尾位置并确认主库还保留着该位置之后的日志，之后持续发送已经写盘的日志
+ * 副本的位置在检查之前登记，登记之后的检查点不会回收它需要的日志
+ * @param {int} fd 副本的连接
+ */
+void LogSender::send_loop(int fd) {
+    int64_t offset;
+    if (!recv_all(fd, (char *)&offset, sizeof(offset))) {
+        close(fd);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(latch_);
+        replicas_[fd] = offset;
+    }
+    // 副本的日志落后于主库已经回收的日志，或者超过了主库的日志末尾，说明副本不是由该主库复制而来
+    int64_t status = offset >= disk_manager_->get_log_begin() && offset <= disk_manager_->get_log_end() ? 0 : -1;
+    std::vector<char> buf(LOG_BUFFER_SIZE);
+    if (send_all(fd, (char *)&status, sizeof(status)) && status == 0) {
+        try {
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(latch_);
+                    cv_.wait_for(lock, log_timeout, [&] { return disk_manager_->get_log_end() > offset; });
+                }
+                int64_t log_end = disk_manager_->get_log_end();
+                if (log_end <= offset) {
+                    continue;
+                }
+                int size = disk_manager_->read_log(buf.data(), std::min<int64_t>(log_end - offset, buf.size()), offset);
+                if (size <= 0 || !send_all(fd, buf.data(), size)) {
+                    break;
+                }
+                offset += size;
+                std::lock_guard<std::mutex> lock(latch_);
+                replicas_[fd] = offset;
+            }
+        } catch (RMDBError &e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    std::lock_guard<std::mutex> lock(latch_);
+    replicas_.erase(fd);
+    close(fd);
+}
+
+/**
+ * @description: 连接主库并发送本地日志的末尾位置，主库确认后在后台接收和重放日志
+ * @param {string&} sock_path 主库数据库目录中的socket文件
+ */
+void LogReceiver::start(const std::string& sock_path) {
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        throw UnixError();
+    }
+    sockaddr_un addr = make_sock_addr(sock_path);
+    if (connect(fd_, (sockaddr *)&addr, sizeof(addr)) < 0) {
+        throw UnixError();
+    }
+    int64_t offset = disk_manager_->get_log_end();
+    int64_t status;
+    if (!send_all(fd_, (char *)&offset, sizeof(offset)) || !recv_all(fd_, (char *)&status, sizeof(status))) {
+        throw InternalError("Lost connection to primary");
+    }
+    if (status != 0) {
+        throw InternalError("Primary no longer has the log from offset " + std::to_string(offset));
+    }
+    std::thread(&LogReceiver::receive_loop, this).detach();
+}
+
+/**
+ * @description: 接收日志，凑齐完整的日志记录后先追加到本地日志再重放
+ * 本地日志积累到检查点的阈值时把重放的结果刷盘，回收尚未结束的事务之前的日志
+ */
+void LogReceiver::receive_loop() {
+    std::vector<char> pending;
+    std::vector<char> buf(LOG_BUFFER_SIZE);
+    int64_t offset = disk_manager_->get_log_end();
+    lsn_t next_lsn = INVALID_LSN;  // 本地日志末尾的下一条日志的日志号
+    while (true) {
+        ssize_t n = recv(fd_, buf.data(), buf.size(), 0);
+        if (n <= 0) {
+            break;
+        }
+        pending.insert(pending.end(), buf.data(), buf.data() + n);
+        size_t complete = 0;
+        while (pending.size() - complete >= (size_t)LOG_HEADER_SIZE) {
+            uint32_t len = *reinterpret_cast<uint32_t *>(pending.data() + complete + OFFSET_LOG_TOT_LEN);
+            if (pending.size() - complete < len) {
+                break;
+            }
+            next_lsn = *reinterpret_cast<lsn_t *>(pending.data() + complete + OFFSET_LSN) + 1;
+            complete += len;
+        }
+        if (complete == 0) {
+            continue;
+        }
+        try {
+            disk_manager_->write_log(pending.data(), complete);
+            {
+                std::unique_lock<std::shared_mutex> lock(replay_latch_);
+                recovery_->replay(pending.data(), complete, offset);
+            }
+            offset += complete;
+            pending.erase(pending.begin(), pending.begin() + complete);
+            if (offset - disk_manager_->get_log_begin() >= (int64_t)LOG_CHECKPOINT_SEGMENTS * LOG_SEGMENT_SIZE) {
+                sm_manager_->flush_all_pages();
+                int64_t begin = std::min(offset, recovery_->get_replay_begin());
+                lsn_t begin_lsn = next_lsn;
+                if (begin < offset) {
+                    char header[LOG_HEADER_SIZE];
+                    disk_manager_->read_log(header, LOG_HEADER_SIZE, begin);
+                    LogRecord log_record;
+                    log_record.deserialize(header);
+                    begin_lsn = log_record.lsn_;
+                }
+                disk_manager_->recycle_log(begin, begin_lsn);
+            }
+        } catch (RMDBError &e) {
+            std::cerr << e.what() << std::endl;
+            break;
+        }
+    }
+    std::cerr << "Lost connection to primary at log offset " << offset << std::endl;
+    close(fd_);
+}
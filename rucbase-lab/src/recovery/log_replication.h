@@ -0,0 +1,76 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include "log_recovery.h"
+
+/**
+ * @description: 主库的日志发送端，在本地unix socket上等待副本连接
+ * 副本连接后发送自己的日志末尾位置，发送端从该位置开始读出已经写盘的日志发给副本，之后每次日志写盘后继续发送
+ * 副本的日志与主库的日志逐字节相同，副本尚未接收的日志在主库上不会被检查点回收
+ */
+class LogSender {
+   public:
+    explicit LogSender(DiskManager* disk_manager) : disk_manager_(disk_manager) {}
+
+    void start(const std::string& sock_path);
+
+    /* 日志写盘之后唤醒发送线程 */
+    void notify() { cv_.notify_all(); }
+
+    /* 所有副本中最早的尚未发送的日志位置，没有副本时为INT64_MAX */
+    int64_t get_retain_offset() {
+        std::lock_guard<std::mutex> lock(latch_);
+        int64_t offset = INT64_MAX;
+        for (auto &entry : replicas_) {
+            offset = std::min(offset, entry.second);
+        }
+        return offset;
+    }
+
+   private:
+    void send_loop(int fd);
+
+    DiskManager* disk_manager_;
+    std::mutex latch_;
+    std::condition_variable cv_;
+    std::map<int, int64_t> replicas_;   // 副本连接 -> 下一次发送的日志位置
+};
+
+/**
+ * @description: 副本的日志接收端，连接主库后把收到的日志追加到本地日志，再交给RecoveryManager重放
+ * 副本上的查询在执行期间持有重放锁的共享锁，重放一批日志时持有排他锁，每条查询看到的是某一时刻已经结束的事务的结果
+ */
+class LogReceiver {
+   public:
+    LogReceiver(DiskManager* disk_manager, SmManager* sm_manager, RecoveryManager* recovery)
+        : disk_manager_(disk_manager), sm_manager_(sm_manager), recovery_(recovery) {}
+
+    void start(const std::string& sock_path);
+
+    std::shared_mutex& get_replay_latch() { return replay_latch_; }
+
+   private:
+    void receive_loop();
+
+    DiskManager* disk_manager_;
+    SmManager* sm_manager_;
+    RecoveryManager* recovery_;
+    int fd_ = -1;                   // 与主库的连接
+    std::shared_mutex replay_latch_;
+};
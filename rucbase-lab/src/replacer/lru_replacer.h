@@ -39,6 +39,12 @@ class LRUReplacer : public Replacer {
 
     size_t Size();
 
+    /* 首部最近被访问，最后被淘汰 */
+    std::vector<frame_id_t> get_victim_order() override {
+        std::scoped_lock lock{latch_};
+        return std::vector<frame_id_t>(LRUlist_.begin(), LRUlist_.end());
+    }
+
    private:
     std::mutex latch_;                  // 互斥锁
     std::list<frame_id_t> LRUlist_;     // 按加入的时间顺序存放unpinned pages的frame id，首部表示最近被访问
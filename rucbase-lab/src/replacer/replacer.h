@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 /**
@@ -41,4 +43,7 @@ class Replacer {
 
     /** @return the number of elements in the replacer that can be victimized */
     virtual size_t Size() = 0;
+
+    /** @return the frames that can be victimized, from the last to be victimized to the first */
+    virtual std::vector<frame_id_t> get_victim_order() = 0;
 };
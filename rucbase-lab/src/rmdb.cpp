@@ -15,17 +15,23 @@ See the Mulan PSL v2 for more details. */
 #include <signal.h>
 #include <unistd.h>
 #include <atomic>
+#include <climits>
+#include <random>
+#include <thread>
 
 #include "errors.h"
 #include "optimizer/optimizer.h"
 #include "recovery/log_recovery.h"
+#include "recovery/log_replication.h"
 #include "optimizer/plan.h"
 #include "optimizer/planner.h"
 #include "portal.h"
 #include "analyze/analyze.h"
 
-#define SOCK_PORT 8765
 #define MAX_CONN_LIMIT 8
+#define REPLICATION_SOCK "replication.sock"
+
+static int sock_port = 8765;
 
 static bool should_exit = false;
 
@@ -39,11 +45,16 @@ auto lock_manager = std::make_unique<LockManager>();
 auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), sm_manager.get());
 auto ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get());
 auto log_manager = std::make_unique<LogManager>(disk_manager.get());
-auto recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get());
+auto recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(),
+                                                  log_manager.get(), txn_manager.get());
 auto planner = std::make_unique<Planner>(sm_manager.get());
 auto optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
 auto portal = std::make_unique<Portal>(sm_manager.get());
 auto analyze = std::make_unique<Analyze>(sm_manager.get());
+// 主库向副本发送日志，副本模式下为空
+std::unique_ptr<LogSender> log_sender;
+// 副本从主库接收日志，主库模式下为空
+std::unique_ptr<LogReceiver> log_receiver;
 pthread_mutex_t *buffer_mutex;
 pthread_mutex_t *sockfd_mutex;
 
@@ -60,12 +71,118 @@ void SetTransaction(txn_id_t *txn_id, Context *context) {
     context->txn_ = txn_manager->get_transaction(*txn_id);
     if(context->txn_ == nullptr || context->txn_->get_state() == TransactionState::COMMITTED ||
         context->txn_->get_state() == TransactionState::ABORTED) {
+        // 上一个事务已经结束，不会再被访问，会话级的设置由新事务沿用
+        bool async_commit = false;
+        if (context->txn_ != nullptr) {
+            async_commit = context->txn_->is_async_commit();
+            txn_manager->release(context->txn_);
+        }
         context->txn_ = txn_manager->begin(nullptr, context->log_mgr_);
         *txn_id = context->txn_->get_transaction_id();
         context->txn_->set_txn_mode(false);
+        context->txn_->set_async_commit(async_commit);
     }
 }
 
+/* 第retry次重试前的退避时间，按重试次数指数增长并加入随机抖动，避免冲突的事务同时重试 */
+std::chrono::microseconds retry_backoff(int retry) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    int backoff = TXN_RETRY_BACKOFF_US << retry;
+    return std::chrono::microseconds(std::uniform_int_distribution<int>(backoff / 2, backoff)(rng));
+}
+
+/**
+ * @description: 执行一条语句，单条语句的隐式事务因锁冲突回滚时，在服务器端退避后自动重试
+ * 语句属于显式事务或者重试次数用尽时，把回滚异常交给调用者处理
+ * @param {shared_ptr<Query>} query 分析后的语句
+ * @param {txn_id_t*} txn_id 客户端当前的事务ID
+ * @param {Context*} context
+ */
+void run_query(std::shared_ptr<Query> query, txn_id_t *txn_id, Context *context) {
+    for (int retry = 0;; retry++) {
+        try {
+            // 优化器
+            std::shared_ptr<Plan> plan = optimizer->plan_query(query, context);
+            // portal
+            std::shared_ptr<PortalStmt> portalStmt = portal->start(plan, context);
+            portal->run(portalStmt, ql_manager.get(), txn_id, context);
+            portal->drop();
+            // 只有执行成功的那次尝试的结果写入output.txt，失败的尝试不会重复写入
+            if (!context->output_.empty()) {
+                std::fstream outfile;
+                outfile.open("output.txt", std::ios::out | std::ios::app);
+                outfile << context->output_;
+                outfile.close();
+            }
+            return;
+        } catch (TransactionAbortException &e) {
+            if (context->txn_->get_txn_mode()) {
+                throw;
+            }
+            if (retry >= TXN_RETRY_LIMIT) {
+                txn_manager->get_metrics().retry_exhausted++;
+                throw;
+            }
+            timestamp_t start_ts = context->txn_->get_start_ts();
+            txn_manager->abort(context->txn_, context->log_mgr_);
+            txn_manager->get_metrics().retried++;
+            std::this_thread::sleep_for(retry_backoff(retry));
+
+            // 丢弃失败的尝试已经生成的结果，在新的事务中重新执行
+            memset(context->data_send_, 0, *context->offset_);
+            *context->offset_ = 0;
+            context->output_.clear();
+            SetTransaction(txn_id, context);
+            // 重试的事务沿用原来的时间戳，基于时间戳的死锁预防不会因为重试而让它一直处于劣势
+            context->txn_->set_start_ts(start_ts);
+            // 优化器会修改query，需要从语法树重新分析
+            pthread_mutex_lock(buffer_mutex);
+            try {
+                query = analyze->do_analyze(query->parse);
+            } catch (...) {
+                pthread_mutex_unlock(buffer_mutex);
+                throw;
+            }
+            pthread_mutex_unlock(buffer_mutex);
+        }
+    }
+}
+
+/* 后台检查点线程，检查点之后的日志超过LOG_CHECKPOINT_SEGMENTS个段时做检查点，回收不再需要的日志段 */
+void checkpoint_loop() {
+    while (!should_exit) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (log_manager->get_log_size() >= (int64_t)LOG_CHECKPOINT_SEGMENTS * LOG_SEGMENT_SIZE) {
+            // 副本尚未接收的日志不能回收
+            int64_t retain_offset = log_sender != nullptr ? log_sender->get_retain_offset() : INT64_MAX;
+            log_manager->checkpoint([] { sm_manager->flush_all_pages(); }, retain_offset);
+        }
+    }
+}
+
+/* 后台线程，定期保存缓冲池中的页面列表，重启后据此预热缓冲池 */
+void warm_list_loop() {
+    while (!should_exit) {
+        std::this_thread::sleep_for(std::chrono::seconds(WARM_SAVE_INTERVAL_S));
+        try {
+            sm_manager->save_warm_list();
+        } catch (RMDBError &e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+}
+
+/* 副本上允许执行的语句：查询、事务控制和不修改数据的辅助语句 */
+bool is_replica_stmt(const std::shared_ptr<ast::TreeNode> &stmt) {
+    return std::dynamic_pointer_cast<ast::SelectStmt>(stmt) || std::dynamic_pointer_cast<ast::Help>(stmt) ||
+           std::dynamic_pointer_cast<ast::ShowTables>(stmt) || std::dynamic_pointer_cast<ast::ShowMetrics>(stmt) ||
+           std::dynamic_pointer_cast<ast::DescTable>(stmt) || std::dynamic_pointer_cast<ast::SetVar>(stmt) ||
+           std::dynamic_pointer_cast<ast::TxnBegin>(stmt) || std::dynamic_pointer_cast<ast::TxnCommit>(stmt) ||
+           std::dynamic_pointer_cast<ast::TxnAbort>(stmt) || std::dynamic_pointer_cast<ast::TxnRollback>(stmt) ||
+           std::dynamic_pointer_cast<ast::Savepoint>(stmt) || std::dynamic_pointer_cast<ast::RollbackToSavepoint>(stmt) ||
+           std::dynamic_pointer_cast<ast::ReleaseSavepoint>(stmt);
+}
+
 void *client_handler(void *sock_fd) {
     int fd = *((int *)sock_fd);
     pthread_mutex_unlock(sockfd_mutex);
@@ -116,9 +233,8 @@ void *client_handler(void *sock_fd) {
 
         // 开启事务，初始化系统所需的上下文信息（包括事务对象指针、锁管理器指针、日志管理器指针、存放结果的buffer、记录结果长度的变量）
         Context *context = new Context(lock_manager.get(), log_manager.get(), nullptr, data_send, &offset);
-        // Lab 3 need to remove transaction part
-        // Lab 4 need to restart transaction
-        // SetTransaction(&txn_id, context);
+        SetTransaction(&txn_id, context);
+        context->txn_->begin_statement();
 
         // 用于判断是否已经调用了yy_delete_buffer来删除buf
         bool finish_analyze = false;
@@ -127,17 +243,20 @@ void *client_handler(void *sock_fd) {
         if (yyparse() == 0) {
             if (ast::parse_tree != nullptr) {
                 try {
+                    if (log_receiver != nullptr && !is_replica_stmt(ast::parse_tree)) {
+                        throw ReadOnlyReplicaError();
+                    }
                     // analyze and rewrite
                     std::shared_ptr<Query> query = analyze->do_analyze(ast::parse_tree);
                     yy_delete_buffer(buf);
                     finish_analyze = true;
                     pthread_mutex_unlock(buffer_mutex);
-                    // 优化器
-                    std::shared_ptr<Plan> plan = optimizer->plan_query(query, context);
-                    // portal
-                    std::shared_ptr<PortalStmt> portalStmt = portal->start(plan, context);
-                    portal->run(portalStmt, ql_manager.get(), &txn_id, context);
-                    portal->drop();
+                    // 副本上的语句执行期间不重放日志，语句看到的是某一时刻已经结束的事务的结果
+                    std::shared_lock<std::shared_mutex> replay_lock;
+                    if (log_receiver != nullptr) {
+                        replay_lock = std::shared_lock<std::shared_mutex>(log_receiver->get_replay_latch());
+                    }
+                    run_query(query, &txn_id, context);
                 } catch (TransactionAbortException &e) {
                     // 事务需要回滚，需要把abort信息返回给客户端并写入output.txt文件中
                     std::string str = "abort\n";
@@ -156,6 +275,8 @@ void *client_handler(void *sock_fd) {
                 } catch (RMDBError &e) {
                     // 遇到异常，需要打印failure到output.txt文件中，并发异常信息返回给客户端
                     std::cerr << e.what() << std::endl;
+                    // 只撤销失败的语句，显式事务中之前的语句保留
+                    txn_manager->rollback_statement(context->txn_, log_manager.get());
 
                     memcpy(data_send, e.what(), e.get_msg_len());
                     data_send[e.get_msg_len()] = '\n';
@@ -174,16 +295,25 @@ void *client_handler(void *sock_fd) {
             yy_delete_buffer(buf);
             pthread_mutex_unlock(buffer_mutex);
         }
+        // 如果是单条语句，需要按照一个完整的事务来执行，所以执行完当前语句后，自动提交事务
+        // 提交完成后才返回结果，只读的语句提交时不写日志也不刷盘
+        if (context->txn_->get_txn_mode() == false && context->txn_->get_state() == TransactionState::GROWING) {
+            txn_manager->commit(context->txn_, context->log_mgr_);
+        }
         // future TODO: 格式化 sql_handler.result, 传给客户端
         // send result with fixed format, use protobuf in the future
         if (write(fd, data_send, offset + 1) == -1) {
             break;
         }
-        // 如果是单条语句，需要按照一个完整的事务来执行，所以执行完当前语句后，自动提交事务
-        // if(context->txn_->get_txn_mode() == false)
-        // {
-        //     txn_manager->commit(context->txn_, context->log_mgr_);
-        // }
+    }
+
+    // 客户端断开连接时回滚还没有结束的显式事务
+    if (txn_id != INVALID_TXN_ID) {
+        Transaction *txn = txn_manager->get_transaction(txn_id);
+        if (txn->get_state() == TransactionState::GROWING || txn->get_state() == TransactionState::SHRINKING) {
+            txn_manager->abort(txn, log_manager.get());
+        }
+        txn_manager->release(txn);
     }
 
     // Clear
@@ -213,7 +343,7 @@ void start_server() {
     memset(&s_addr_in, 0, sizeof(s_addr_in));
     s_addr_in.sin_family = AF_INET;
     s_addr_in.sin_addr.s_addr = htonl(INADDR_ANY);
-    s_addr_in.sin_port = htons(SOCK_PORT);
+    s_addr_in.sin_port = htons(sock_port);
     fd_temp = bind(sockfd_server, (struct sockaddr *)(&s_addr_in), sizeof(s_addr_in));
     if (fd_temp == -1) {
         std::cout << "Bind error!" << std::endl;
@@ -264,9 +394,29 @@ void start_server() {
 }
 
 int main(int argc, char **argv) {
-    if (argc != 2) {
+    // 副本模式下指定主库的数据库目录，主库通过该目录中的unix socket发送日志
+    std::string primary_sock;
+    bool bad_args = argc < 2;
+    for (int i = 2; i + 1 < argc && !bad_args; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--port") {
+            sock_port = atoi(argv[i + 1]);
+        } else if (opt == "--replica-of") {
+            // 打开数据库后工作目录会改变，先把主库目录转换为绝对路径
+            char primary_dir[PATH_MAX];
+            if (realpath(argv[i + 1], primary_dir) == nullptr) {
+                std::cerr << "Primary database not found: " << argv[i + 1] << std::endl;
+                exit(1);
+            }
+            primary_sock = std::string(primary_dir) + "/" + REPLICATION_SOCK;
+        } else {
+            bad_args = true;
+        }
+    }
+    if (bad_args || argc % 2 != 0) {
         // 需要指定数据库名称
-        std::cerr << "Usage: " << argv[0] << " <database>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <database> [--port <port>] [--replica-of <primary database>]"
+                  << std::endl;
         exit(1);
     }
 
@@ -291,12 +441,47 @@ int main(int argc, char **argv) {
         }
         // Open database
         sm_manager->open_db(db_name);
+        log_manager->open();
+        if (!primary_sock.empty()) {
+            // 副本只重放主库的日志，本地的日志与主库的日志逐字节相同，日志在重放之前已经写盘
+            // 副本上未结束的事务等待主库后续的日志决定提交还是回滚，不回滚它们，只在开始重放前撤销已经重做的修改
+            recovery->analyze();
+            recovery->redo();
+            recovery->start_replay();
+            log_receiver = std::make_unique<LogReceiver>(disk_manager.get(), sm_manager.get(), recovery.get());
+            log_receiver->start(primary_sock);
+        } else {
+            log_manager->start_flusher();
+            // 页面写盘前先把它的日志写盘
+            buffer_pool_manager->set_flush_log(
+                [](lsn_t page_lsn) {
+                    if (page_lsn != INVALID_LSN) {
+                        log_manager->flush_log_to_disk(page_lsn);
+                    }
+                },
+                [] { return log_manager->get_last_lsn(); });
+
+            // recovery database，未完成的事务在后台回滚，不等待回滚完成就开始接受连接
+            recovery->analyze();
+            recovery->redo();
+            recovery->undo();
+            std::thread(checkpoint_loop).detach();
+
+            // 日志写盘后通知发送线程把新的日志发给副本
+            log_sender = std::make_unique<LogSender>(disk_manager.get());
+            log_sender->start(REPLICATION_SOCK);
+            log_manager->set_flush_listener([] { log_sender->notify(); });
+        }
+        // 恢复完成后在后台预热缓冲池，不等待预热完成就开始接受连接
+        std::thread([] {
+            try {
+                sm_manager->warm_up();
+            } catch (RMDBError &e) {
+                std::cerr << e.what() << std::endl;
+            }
+        }).detach();
+        std::thread(warm_list_loop).detach();
 
-        // recovery database
-        recovery->analyze();
-        recovery->redo();
-        recovery->undo();
-        
         // 开启服务端，开始接受客户端连接
         start_server();
     } catch (RMDBError &e) {
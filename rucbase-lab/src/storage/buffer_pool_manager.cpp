@@ -32,7 +32,7 @@ bool BufferPoolManager::find_victim_page(frame_id_t* frame_id) {
  */
 void BufferPoolManager::update_page(Page *page, PageId new_page_id, frame_id_t new_frame_id) {
     // Todo:
-    // 1 如果是脏页，写回磁盘，并且把dirty置为false
+    // 1 如果是脏页，调用write_page_back写回磁盘，并且把dirty置为false
     // 2 更新page table
     // 3 重置page的data，更新page id
 
@@ -86,7 +86,7 @@ bool BufferPoolManager::flush_page(PageId page_id) {
     // 0. lock latch
     // 1. 查找页表,尝试获取目标页P
     // 1.1 目标页P没有被page_table_记录 ，返回false
-    // 2. 无论P是否为脏都将其写回磁盘。
+    // 2. 无论P是否为脏都调用write_page_back将其写回磁盘。
     // 3. 更新P的is_dirty_
    
     return true;
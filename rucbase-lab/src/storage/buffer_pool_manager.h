@@ -1,83 +1,206 @@
-/* Copyright (c) 2023 Renmin University of China
-RMDB is licensed under Mulan PSL v2.
-You can use this software according to the terms and conditions of the Mulan PSL v2.
-You may obtain a copy of Mulan PSL v2 at:
-        http://license.coscl.org.cn/MulanPSL2
-THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
-EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
-MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
-See the Mulan PSL v2 for more details. */
-
-#pragma once
-#include <fcntl.h>
-#include <unistd.h>
-
-#include <cassert>
-#include <list>
-#include <unordered_map>
-#include <vector>
-
-#include "disk_manager.h"
-#include "errors.h"
-#include "page.h"
-#include "replacer/lru_replacer.h"
-#include "replacer/replacer.h"
-
-class BufferPoolManager {
-   private:
-    size_t pool_size_;      // buffer_pool中可容纳页面的个数，即帧的个数
-    Page *pages_;           // buffer_pool中的Page对象数组，在构造空间中申请内存空间，在析构函数中释放，大小为BUFFER_POOL_SIZE
-    std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_; // 帧号和页面号的映射哈希表，用于根据页面的PageId定位该页面的帧编号
-    std::list<frame_id_t> free_list_;   // 空闲帧编号的链表
-    DiskManager *disk_manager_;
-    Replacer *replacer_;    // buffer_pool的置换策略，当前赛题中为LRU置换策略
-    std::mutex latch_;      // 用于共享数据结构的并发控制
-
-   public:
-    BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-        : pool_size_(pool_size), disk_manager_(disk_manager) {
-        // 为buffer pool分配一块连续的内存空间
-        pages_ = new Page[pool_size_];
-        // 可以被Replacer改变
-        if (REPLACER_TYPE.compare("LRU"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else if (REPLACER_TYPE.compare("CLOCK"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else {
-            replacer_ = new LRUReplacer(pool_size_);
-        }
-        // 初始化时，所有的page都在free_list_中
-        for (size_t i = 0; i < pool_size_; ++i) {
-            free_list_.emplace_back(static_cast<frame_id_t>(i));  // static_cast转换数据类型
-        }
-    }
-
-    ~BufferPoolManager() {
-        delete[] pages_;
-        delete replacer_;
-    }
-
-    /**
-     * @description: 将目标页面标记为脏页
-     * @param {Page*} page 脏页
-     */
-    static void mark_dirty(Page* page) { page->is_dirty_ = true; }
-
-   public: 
-    Page* fetch_page(PageId page_id);
-
-    bool unpin_page(PageId page_id, bool is_dirty);
-
-    bool flush_page(PageId page_id);
-
-    Page* new_page(PageId* page_id);
-
-    bool delete_page(PageId page_id);
-
-    void flush_all_pages(int fd);
-
-   private:
-    bool find_victim_page(frame_id_t* frame_id);
-
-    void update_page(Page* page, PageId new_page_id, frame_id_t new_frame_id);
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "disk_manager.h"
+#include "errors.h"
+#include "page.h"
+#include "replacer/lru_replacer.h"
+#include "replacer/replacer.h"
+
+class BufferPoolManager {
+   private:
+    size_t pool_size_;      // buffer_pool中可容纳页面的个数，即帧的个数
+    Page *pages_;           // buffer_pool中的Page对象数组，在构造空间中申请内存空间，在析构函数中释放，大小为BUFFER_POOL_SIZE
+    std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_; // 帧号和页面号的映射哈希表，用于根据页面的PageId定位该页面的帧编号
+    std::list<frame_id_t> free_list_;   // 空闲帧编号的链表
+    DiskManager *disk_manager_;
+    Replacer *replacer_;    // buffer_pool的置换策略，当前赛题中为LRU置换策略
+    std::mutex latch_;      // 用于共享数据结构的并发控制
+    std::function<void(lsn_t)> flush_log_;  // 页面写盘前把日志刷到page lsn，未设置时直接写盘
+    std::function<lsn_t()> last_lsn_;       // 已经分配的最大日志号，索引结点用它作为page lsn
+    std::atomic<uint64_t> write_backs_{0};  // 页面写回磁盘的累计次数
+
+   public:
+    BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
+        : pool_size_(pool_size), disk_manager_(disk_manager) {
+        // 为buffer pool分配一块连续的内存空间
+        pages_ = new Page[pool_size_];
+        // 可以被Replacer改变
+        if (REPLACER_TYPE.compare("LRU"))
+            replacer_ = new LRUReplacer(pool_size_);
+        else if (REPLACER_TYPE.compare("CLOCK"))
+            replacer_ = new LRUReplacer(pool_size_);
+        else {
+            replacer_ = new LRUReplacer(pool_size_);
+        }
+        // 初始化时，所有的page都在free_list_中
+        for (size_t i = 0; i < pool_size_; ++i) {
+            free_list_.emplace_back(static_cast<frame_id_t>(i));  // static_cast转换数据类型
+        }
+    }
+
+    ~BufferPoolManager() {
+        delete[] pages_;
+        delete replacer_;
+    }
+
+    /**
+     * @description: 将目标页面标记为脏页
+     * @param {Page*} page 脏页
+     */
+    static void mark_dirty(Page* page) { page->is_dirty_ = true; }
+
+    /**
+     * @description: 设置页面写盘前刷日志的方法，页面中的修改写盘之前它的日志必须已经持久化，否则故障后无法撤销
+     * @param {function<void(lsn_t)>} flush_log 把日志号不超过page lsn的日志刷盘
+     * @param {function<lsn_t()>} last_lsn 返回已经分配的最大日志号
+     */
+    void set_flush_log(std::function<void(lsn_t)> flush_log, std::function<lsn_t()> last_lsn) {
+        flush_log_ = std::move(flush_log);
+        last_lsn_ = std::move(last_lsn);
+    }
+
+    /**
+     * @description: 已经分配的最大日志号，没有设置刷日志的方法时为INVALID_LSN
+     * 索引的修改不单独写日志，修改索引的操作在写完数据的日志之后进行，被修改的结点以此作为page lsn
+     */
+    lsn_t get_last_lsn() const { return last_lsn_ ? last_lsn_() : INVALID_LSN; }
+
+    /**
+     * @description: 按热度从高到低返回缓冲池中的页面，被固定的页面最热，其余按置换策略的淘汰顺序从后往前
+     * @return {vector<PageId>} 缓冲池中的页面
+     */
+    std::vector<PageId> get_hot_pages() {
+        std::scoped_lock lock{latch_};
+        std::vector<PageId> pages;
+        for (auto &entry : page_table_) {
+            if (pages_[entry.second].pin_count_ > 0) {
+                pages.push_back(entry.first);
+            }
+        }
+        for (frame_id_t frame_id : replacer_->get_victim_order()) {
+            pages.push_back(pages_[frame_id].id_);
+        }
+        return pages;
+    }
+
+    size_t get_free_frames() {
+        std::scoped_lock lock{latch_};
+        return free_list_.size();
+    }
+
+    /* 页面写回磁盘的累计次数，预热在读盘之前记下它，用于判断读盘期间是否有页面被写回 */
+    uint64_t get_write_backs() const { return write_backs_.load(); }
+
+    /**
+     * @description: 预热时把从磁盘读出的同一文件中连续的页面放入空闲帧，已经在缓冲池中的页面保留缓冲池中的版本
+     * 读盘不持有latch_，读盘之后可能有页面被读入、修改并写回后又被换出，读到的内容已经过时，
+     * 此时在latch_下重新读盘，页面的写回同样在latch_下进行，重新读到的就是最新的版本
+     * @return {bool} 是否还有空闲帧，没有时预热应当停止
+     * @param {PageId} first 第一个页面
+     * @param {int} count 页面数量
+     * @param {char*} data 从磁盘读出的页面内容，重新读盘时被覆盖
+     * @param {uint64_t} write_backs 读盘之前get_write_backs()的返回值
+     */
+    bool install_pages(PageId first, int count, char *data, uint64_t write_backs) {
+        std::scoped_lock lock{latch_};
+        if (write_backs_.load() != write_backs) {
+            count = disk_manager_->read_pages(first.fd, first.page_no, data, count);
+        }
+        for (int k = 0; k < count; k++) {
+            if (free_list_.empty()) {
+                return false;
+            }
+            PageId page_id = {.fd = first.fd, .page_no = first.page_no + k};
+            if (page_table_.count(page_id)) {
+                continue;
+            }
+            frame_id_t frame_id = free_list_.front();
+            free_list_.pop_front();
+            Page *page = pages_ + frame_id;
+            page->id_ = page_id;
+            memcpy(page->data_, data + (size_t)k * PAGE_SIZE, PAGE_SIZE);
+            page->is_dirty_ = false;
+            page->pin_count_ = 0;
+            page_table_[page_id] = frame_id;
+            replacer_->unpin(frame_id);
+        }
+        return !free_list_.empty();
+    }
+
+    /**
+     * @description: 丢弃缓冲池中属于文件fd的全部页面，脏页也不写回，用于已经被删除的文件
+     * 被固定的页面保留在缓冲池中，调用者等它们被unpin之后再次调用
+     * @return {bool} 文件的页面是否已经全部丢弃
+     * @param {int} fd 被删除的文件
+     */
+    bool discard_pages(int fd) {
+        std::scoped_lock lock{latch_};
+        bool all_discarded = true;
+        for (auto it = page_table_.begin(); it != page_table_.end();) {
+            Page *page = pages_ + it->second;
+            if (it->first.fd != fd) {
+                ++it;
+                continue;
+            }
+            if (page->pin_count_ > 0) {
+                all_discarded = false;
+                ++it;
+                continue;
+            }
+            replacer_->pin(it->second);
+            page->reset_memory();
+            page->is_dirty_ = false;
+            page->id_.page_no = INVALID_PAGE_ID;
+            free_list_.push_back(it->second);
+            it = page_table_.erase(it);
+        }
+        return all_discarded;
+    }
+
+   public: 
+    Page* fetch_page(PageId page_id);
+
+    bool unpin_page(PageId page_id, bool is_dirty);
+
+    bool flush_page(PageId page_id);
+
+    Page* new_page(PageId* page_id);
+
+    bool delete_page(PageId page_id);
+
+    void flush_all_pages(int fd);
+
+   private:
+    bool find_victim_page(frame_id_t* frame_id);
+
+    void update_page(Page* page, PageId new_page_id, frame_id_t new_frame_id);
+
+    /* 把页面写回磁盘，写盘之前先把日志刷到page lsn */
+    void write_page_back(Page* page) {
+        if (flush_log_) {
+            flush_log_(page->get_page_lsn());
+        }
+        disk_manager_->write_page(page->get_page_id().fd, page->get_page_id().page_no, page->get_data(), PAGE_SIZE);
+        // 写盘完成之后才计数，与之并发的预热读盘一定能发现这次写回
+        write_backs_++;
+    }
 };
\ No newline at end of file
@@ -1,221 +1,591 @@
-/* Copyright (c) 2023 Renmin University of China
-RMDB is licensed under Mulan PSL v2.
-You can use this software according to the terms and conditions of the Mulan PSL v2.
-You may obtain a copy of Mulan PSL v2 at:
-        http://license.coscl.org.cn/MulanPSL2
-THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
-EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
-MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
-See the Mulan PSL v2 for more details. */
-
-#include "storage/disk_manager.h"
-
-#include <assert.h>    // for assert
-#include <string.h>    // for memset
-#include <sys/stat.h>  // for stat
-#include <unistd.h>    // for lseek
-
-#include "defs.h"
-
-DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char))); }
-
-/**
- * @description: 将数据写入文件的指定磁盘页面中
- * @param {int} fd 磁盘文件的文件句柄
- * @param {page_id_t} page_no 写入目标页面的page_id
- * @param {char} *offset 要写入磁盘的数据
- * @param {int} num_bytes 要写入磁盘的数据大小
- */
-void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用write()函数
-    // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager::write_page Error");
-
-}
-
-/**
- * @description: 读取文件中指定编号的页面中的部分数据到内存中
- * @param {int} fd 磁盘文件的文件句柄
- * @param {page_id_t} page_no 指定的页面编号
- * @param {char} *offset 读取的内容写入到offset中
- * @param {int} num_bytes 读取的数据量大小
- */
-void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用read()函数
-    // 注意read返回值与num_bytes不等时，throw InternalError("DiskManager::read_page Error");
-
-}
-
-/**
- * @description: 分配一个新的页号
- * @return {page_id_t} 分配的新页号
- * @param {int} fd 指定文件的文件句柄
- */
-page_id_t DiskManager::allocate_page(int fd) {
-    // 简单的自增分配策略，指定文件的页面编号加1
-    assert(fd >= 0 && fd < MAX_FD);
-    return fd2pageno_[fd]++;
-}
-
-void DiskManager::deallocate_page(__attribute__((unused)) page_id_t page_id) {}
-
-bool DiskManager::is_dir(const std::string& path) {
-    struct stat st;
-    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
-}
-
-void DiskManager::create_dir(const std::string &path) {
-    // Create a subdirectory
-    std::string cmd = "mkdir " + path;
-    if (system(cmd.c_str()) < 0) {  // 创建一个名为path的目录
-        throw UnixError();
-    }
-}
-
-void DiskManager::destroy_dir(const std::string &path) {
-    std::string cmd = "rm -r " + path;
-    if (system(cmd.c_str()) < 0) {
-        throw UnixError();
-    }
-}
-
-/**
- * @description: 判断指定路径文件是否存在
- * @return {bool} 若指定路径文件存在则返回true 
- * @param {string} &path 指定路径文件
- */
-bool DiskManager::is_file(const std::string &path) {
-    // 用struct stat获取文件信息
-    struct stat st;
-    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
-}
-
-/**
- * @description: 用于创建指定路径文件
- * @return {*}
- * @param {string} &path
- */
-void DiskManager::create_file(const std::string &path) {
-    // Todo:
-    // 调用open()函数，使用O_CREAT模式
-    // 注意不能重复创建相同文件
-}
-
-/**
- * @description: 删除指定路径的文件
- * @param {string} &path 文件所在路径
- */
-void DiskManager::destroy_file(const std::string &path) {
-    // Todo:
-    // 调用unlink()函数
-    // 注意不能删除未关闭的文件
-    
-}
-
-
-/**
- * @description: 打开指定路径文件 
- * @return {int} 返回打开的文件的文件句柄
- * @param {string} &path 文件所在路径
- */
-int DiskManager::open_file(const std::string &path) {
-    // Todo:
-    // 调用open()函数，使用O_RDWR模式
-    // 注意不能重复打开相同文件，并且需要更新文件打开列表
-
-}
-
-/**
- * @description:用于关闭指定路径文件 
- * @param {int} fd 打开的文件的文件句柄
- */
-void DiskManager::close_file(int fd) {
-    // Todo:
-    // 调用close()函数
-    // 注意不能关闭未打开的文件，并且需要更新文件打开列表
-
-}
-
-
-/**
- * @description: 获得文件的大小
- * @return {int} 文件的大小
- * @param {string} &file_name 文件名
- */
-int DiskManager::get_file_size(const std::string &file_name) {
-    struct stat stat_buf;
-    int rc = stat(file_name.c_str(), &stat_buf);
-    return rc == 0 ? stat_buf.st_size : -1;
-}
-
-/**
- * @description: 根据文件句柄获得文件名
- * @return {string} 文件句柄对应文件的文件名
- * @param {int} fd 文件句柄
- */
-std::string DiskManager::get_file_name(int fd) {
-    if (!fd2path_.count(fd)) {
-        throw FileNotOpenError(fd);
-    }
-    return fd2path_[fd];
-}
-
-/**
- * @description:  获得文件名对应的文件句柄
- * @return {int} 文件句柄
- * @param {string} &file_name 文件名
- */
-int DiskManager::get_file_fd(const std::string &file_name) {
-    if (!path2fd_.count(file_name)) {
-        return open_file(file_name);
-    }
-    return path2fd_[file_name];
-}
-
-
-/**
- * @description:  读取日志文件内容
- * @return {int} 返回读取的数据量，若为-1说明读取数据的起始位置超过了文件大小
- * @param {char} *log_data 读取内容到log_data中
- * @param {int} size 读取的数据量大小
- * @param {int} offset 读取的内容在文件中的位置
- */
-int DiskManager::read_log(char *log_data, int size, int offset) {
-    // read log file from the previous end
-    if (log_fd_ == -1) {
-        log_fd_ = open_file(LOG_FILE_NAME);
-    }
-    int file_size = get_file_size(LOG_FILE_NAME);
-    if (offset > file_size) {
-        return -1;
-    }
-
-    size = std::min(size, file_size - offset);
-    if(size == 0) return 0;
-    lseek(log_fd_, offset, SEEK_SET);
-    ssize_t bytes_read = read(log_fd_, log_data, size);
-    assert(bytes_read == size);
-    return bytes_read;
-}
-
-
-/**
- * @description: 写日志内容
- * @param {char} *log_data 要写入的日志内容
- * @param {int} size 要写入的内容大小
- */
-void DiskManager::write_log(char *log_data, int size) {
-    if (log_fd_ == -1) {
-        log_fd_ = open_file(LOG_FILE_NAME);
-    }
-
-    // write from the file_end
-    lseek(log_fd_, 0, SEEK_END);
-    ssize_t bytes_write = write(log_fd_, log_data, size);
-    if (bytes_write != size) {
-        throw UnixError();
-    }
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/disk_manager.h"
+
+#include <assert.h>    // for assert
+#include <fcntl.h>     // for posix_fallocate
+#include <string.h>    // for memset
+#include <sys/stat.h>  // for stat
+#include <unistd.h>    // for lseek
+
+#include <algorithm>
+#include <iterator>
+
+#include "defs.h"
+
+DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char))); }
+
+/**
+ * @description: 将数据写入文件的指定磁盘页面中
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} page_no 写入目标页面的page_id
+ * @param {char} *offset 要写入磁盘的数据
+ * @param {int} num_bytes 要写入磁盘的数据大小
+ */
+void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
+    // Todo:
+    // 1.pin_file()获得系统文件句柄，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
+    // 2.调用pwrite()函数，写完后unpin_file()
+    // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager::write_page Error");
+
+}
+
+/**
+ * @description: 读取文件中指定编号的页面中的部分数据到内存中
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} page_no 指定的页面编号
+ * @param {char} *offset 读取的内容写入到offset中
+ * @param {int} num_bytes 读取的数据量大小
+ */
+void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
+    // Todo:
+    // 1.pin_file()获得系统文件句柄，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
+    // 2.调用pread()函数，读完后unpin_file()
+    // 注意read返回值与num_bytes不等时，throw InternalError("DiskManager::read_page Error");
+
+}
+
+/**
+ * @description: 分配一个新的页号
+ * @return {page_id_t} 分配的新页号
+ * @param {int} fd 指定文件的文件句柄
+ */
+page_id_t DiskManager::allocate_page(int fd) {
+    // 简单的自增分配策略，指定文件的页面编号加1
+    assert(fd >= 0 && fd < MAX_FD);
+    return fd2pageno_[fd]++;
+}
+
+void DiskManager::deallocate_page(__attribute__((unused)) page_id_t page_id) {}
+
+bool DiskManager::is_dir(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+void DiskManager::create_dir(const std::string &path) {
+    // Create a subdirectory
+    std::string cmd = "mkdir " + path;
+    if (system(cmd.c_str()) < 0) {  // 创建一个名为path的目录
+        throw UnixError();
+    }
+}
+
+void DiskManager::destroy_dir(const std::string &path) {
+    std::string cmd = "rm -r " + path;
+    if (system(cmd.c_str()) < 0) {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 判断指定路径文件是否存在
+ * @return {bool} 若指定路径文件存在则返回true 
+ * @param {string} &path 指定路径文件
+ */
+bool DiskManager::is_file(const std::string &path) {
+    // 用struct stat获取文件信息
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+/**
+ * @description: 用于创建指定路径文件
+ * @return {*}
+ * @param {string} &path
+ */
+void DiskManager::create_file(const std::string &path) {
+    // Todo:
+    // 调用open()函数，使用O_CREAT模式
+    // 注意不能重复创建相同文件
+}
+
+/**
+ * @description: 删除指定路径的文件
+ * @param {string} &path 文件所在路径
+ */
+void DiskManager::destroy_file(const std::string &path) {
+    // Todo:
+    // 调用unlink()函数
+    // 注意不能删除未关闭的文件
+    
+}
+
+
+/**
+ * @description: 打开指定路径文件 
+ * @return {int} 返回打开的文件的文件句柄
+ * @param {string} &path 文件所在路径
+ */
+int DiskManager::open_file(const std::string &path) {
+    // Todo:
+    // 调用register_file()分配文件句柄，系统文件句柄在第一次读写时才由pin_file()打开
+    // 注意不能重复打开相同文件，并且需要更新文件打开列表
+
+}
+
+/**
+ * @description:用于关闭指定路径文件 
+ * @param {int} fd 打开的文件的文件句柄
+ */
+void DiskManager::close_file(int fd) {
+    // Todo:
+    // 调用unregister_file()，关闭已经打开的系统文件句柄
+    // 注意不能关闭未打开的文件，并且需要更新文件打开列表
+
+}
+
+
+/**
+ * @description: 获得文件的大小
+ * @return {int} 文件的大小
+ * @param {string} &file_name 文件名
+ */
+int DiskManager::get_file_size(const std::string &file_name) {
+    struct stat stat_buf;
+    int rc = stat(file_name.c_str(), &stat_buf);
+    return rc == 0 ? stat_buf.st_size : -1;
+}
+
+/**
+ * @description: 根据文件句柄获得文件名
+ * @return {string} 文件句柄对应文件的文件名
+ * @param {int} fd 文件句柄
+ */
+std::string DiskManager::get_file_name(int fd) {
+    std::lock_guard<std::mutex> lock(files_latch_);
+    if (!fd2path_.count(fd)) {
+        throw FileNotOpenError(fd);
+    }
+    return fd2path_[fd];
+}
+
+/**
+ * @description:  获得文件名对应的文件句柄
+ * @return {int} 文件句柄
+ * @param {string} &file_name 文件名
+ */
+int DiskManager::get_file_fd(const std::string &file_name) {
+    {
+        std::lock_guard<std::mutex> lock(files_latch_);
+        auto found = path2fd_.find(file_name);
+        if (found != path2fd_.end()) {
+            return found->second;
+        }
+    }
+    return open_file(file_name);
+}
+
+
+/**
+ * @description: 打开数据库目录中的日志，从控制文件中读出日志的起始位置及该位置上的日志号，日志末尾由日志管理器扫描日志后设置
+ */
+void DiskManager::open_log() {
+    std::lock_guard<std::mutex> lock(log_latch_);
+    int64_t log_begin = 0;
+    lsn_t begin_lsn = INVALID_LSN;
+    std::ifstream ifs(LOG_CONTROL_FILE_NAME);
+    ifs >> log_begin;
+    // 旧的控制文件中只有起始位置，读取失败时begin_lsn会被置为0
+    if (!(ifs >> begin_lsn)) {
+        begin_lsn = INVALID_LSN;
+    }
+    log_begin_ = log_begin;
+    log_begin_lsn_ = begin_lsn;
+    log_end_ = log_begin;
+    log_end_known_ = false;
+    log_max_seg_ = log_begin / LOG_SEGMENT_SIZE - 1;
+    while (is_file(log_segment_name(log_max_seg_ + 1))) {
+        log_max_seg_++;
+    }
+    log_tail_.clear();
+}
+
+/**
+ * @description: 关闭所有打开的日志段
+ */
+void DiskManager::close_log() {
+    std::lock_guard<std::mutex> lock(log_latch_);
+    for (auto &entry : log_fds_) {
+        close(entry.second);
+    }
+    log_fds_.clear();
+}
+
+/**
+ * @description: 获得日志段的文件句柄，段文件不存在时创建
+ * 新的段文件一次性分配空间并填零后再改名生效，之后写日志只覆盖已有的数据块，fdatasync不需要更新文件的元数据
+ * @return {int} 段文件的文件句柄
+ * @param {int64_t} seg_no 段号
+ */
+int DiskManager::log_segment_fd(int64_t seg_no) {
+    std::lock_guard<std::mutex> lock(log_latch_);
+    auto it = log_fds_.find(seg_no);
+    if (it != log_fds_.end()) {
+        return it->second;
+    }
+    auto name = log_segment_name(seg_no);
+    if (!is_file(name)) {
+        auto tmp_name = name + ".tmp";
+        int fd = open(tmp_name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+        if (fd < 0) {
+            throw UnixError();
+        }
+        // posix_fallocate不设置errno，而是返回错误码
+        int err = posix_fallocate(fd, 0, LOG_SEGMENT_SIZE);
+        if (err != 0) {
+            close(fd);
+            errno = err;
+            throw UnixError();
+        }
+        std::vector<char> zeros(LOG_BLOCK_SIZE * 256, 0);
+        for (int64_t off = 0; off < LOG_SEGMENT_SIZE; off += zeros.size()) {
+            if (pwrite(fd, zeros.data(), zeros.size(), off) != (ssize_t)zeros.size()) {
+                close(fd);
+                throw UnixError();
+            }
+        }
+        if (fsync(fd) < 0 || rename(tmp_name.c_str(), name.c_str()) < 0) {
+            close(fd);
+            throw UnixError();
+        }
+        close(fd);
+        log_max_seg_ = std::max(log_max_seg_, seg_no);
+    }
+    int fd = open(name.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw UnixError();
+    }
+    log_fds_[seg_no] = fd;
+    return fd;
+}
+
+/**
+ * @description:  读取日志文件内容
+ * @return {int} 返回读取的数据量，若为-1说明读取数据的起始位置超过了日志末尾或者已经被回收
+ * @param {char} *log_data 读取内容到log_data中
+ * @param {int} size 读取的数据量大小
+ * @param {int64_t} offset 读取的内容在日志中的位置，可以跨越多个日志段
+ */
+int DiskManager::read_log(char *log_data, int size, int64_t offset) {
+    // 日志末尾由打开日志后的扫描确定，扫描期间可以读到所有已经存在的段
+    int64_t limit = log_end_known_ ? log_end_.load() : (log_max_seg_ + 1) * LOG_SEGMENT_SIZE;
+    if (offset > limit || offset < log_begin_) {
+        return -1;
+    }
+    size = std::min<int64_t>(size, limit - offset);
+    int read_size = 0;
+    while (read_size < size) {
+        int64_t pos = offset + read_size;
+        int64_t seg_no = pos / LOG_SEGMENT_SIZE;
+        int len = std::min<int64_t>(size - read_size, (seg_no + 1) * LOG_SEGMENT_SIZE - pos);
+        ssize_t bytes_read = pread(log_segment_fd(seg_no), log_data + read_size, len, pos % LOG_SEGMENT_SIZE);
+        if (bytes_read != len) {
+            throw UnixError();
+        }
+        read_size += len;
+    }
+    return read_size;
+}
+
+/**
+ * @description: 写日志内容，追加到日志末尾
+ * 写入从末尾所在块的边界开始，连同上次写入时不满一块的部分一起补齐到整块后按位置写入段文件，再用fdatasync持久化
+ * @param {char} *log_data 要写入的日志内容
+ * @param {int} size 要写入的内容大小
+ */
+void DiskManager::write_log(char *log_data, int size) {
+    int64_t start = log_end_ - log_tail_.size();
+    std::vector<char> buf(log_tail_);
+    buf.insert(buf.end(), log_data, log_data + size);
+    size_t data_len = buf.size();
+    buf.resize((data_len + LOG_BLOCK_SIZE - 1) / LOG_BLOCK_SIZE * LOG_BLOCK_SIZE, 0);
+
+    // 段大小是块大小的整数倍，一个块不会跨越两个段
+    size_t written = 0;
+    while (written < buf.size()) {
+        int64_t pos = start + written;
+        int64_t seg_no = pos / LOG_SEGMENT_SIZE;
+        size_t len = std::min<int64_t>(buf.size() - written, (seg_no + 1) * LOG_SEGMENT_SIZE - pos);
+        int fd = log_segment_fd(seg_no);
+        if (pwrite(fd, buf.data() + written, len, pos % LOG_SEGMENT_SIZE) != (ssize_t)len || fdatasync(fd) < 0) {
+            throw UnixError();
+        }
+        written += len;
+    }
+    log_end_ = start + data_len;
+    size_t tail_len = data_len % LOG_BLOCK_SIZE;
+    log_tail_.assign(buf.begin() + (data_len - tail_len), buf.begin() + data_len);
+}
+
+/**
+ * @description: 设置日志末尾的位置，并读出末尾所在块中已有的日志，之后的写入从该块的边界开始
+ * @param {int64_t} log_end 日志末尾的位置
+ */
+void DiskManager::set_log_end(int64_t log_end) {
+    log_end_ = log_end;
+    log_end_known_ = true;
+    log_tail_.resize(log_end % LOG_BLOCK_SIZE);
+    if (!log_tail_.empty()) {
+        read_log(log_tail_.data(), log_tail_.size(), log_end - log_tail_.size());
+    }
+}
+
+/* 把日志的起始位置及该位置上的日志号写入dir中的控制文件，先写临时文件再改名，故障时控制文件总是完整的 */
+void DiskManager::write_log_control(int64_t log_begin, lsn_t begin_lsn, const std::string &dir) {
+    auto name = dir + "/" + LOG_CONTROL_FILE_NAME;
+    auto tmp_name = name + ".tmp";
+    int fd = open(tmp_name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (fd < 0) {
+        throw UnixError();
+    }
+    auto content = std::to_string(log_begin) + "\n" + std::to_string(begin_lsn) + "\n";
+    if (write(fd, content.data(), content.size()) != (ssize_t)content.size() || fsync(fd) < 0) {
+        close(fd);
+        throw UnixError();
+    }
+    close(fd);
+    if (rename(tmp_name.c_str(), name.c_str()) < 0) {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 检查点之后推进日志的起始位置，回收完全位于起始位置之前的日志段
+ * 回收的段改名为日志末尾之后的段，最多保留LOG_RECYCLE_SEGMENTS个备用段，其余的删除
+ * 回收的段中仍是旧的日志，日志管理器扫描日志时依靠日志号的连续性确定日志末尾
+ * 起始位置可能还没有写入日志，控制文件同时记录该位置上应有的日志号，打开日志时据此识别残留的旧日志
+ * @param {int64_t} log_begin 新的起始位置，必须是一条日志记录的开始
+ * @param {lsn_t} begin_lsn 起始位置上的日志记录的日志号，还没有写入时为下一个要分配的日志号
+ */
+void DiskManager::recycle_log(int64_t log_begin, lsn_t begin_lsn) {
+    if (log_begin <= log_begin_) {
+        return;
+    }
+    write_log_control(log_begin, begin_lsn);
+    int64_t old_seg = log_begin_ / LOG_SEGMENT_SIZE;
+    log_begin_ = log_begin;
+    log_begin_lsn_ = begin_lsn;
+    std::lock_guard<std::mutex> lock(log_latch_);
+    int64_t end_seg = log_end_ / LOG_SEGMENT_SIZE;
+    for (int64_t seg_no = old_seg; seg_no < log_begin / LOG_SEGMENT_SIZE; seg_no++) {
+        auto it = log_fds_.find(seg_no);
+        if (it != log_fds_.end()) {
+            close(it->second);
+            log_fds_.erase(it);
+        }
+        auto name = log_segment_name(seg_no);
+        if (log_max_seg_ - end_seg < LOG_RECYCLE_SEGMENTS) {
+            if (rename(name.c_str(), log_segment_name(++log_max_seg_).c_str()) < 0) {
+                throw UnixError();
+            }
+        } else if (unlink(name.c_str()) < 0) {
+            throw UnixError();
+        }
+    }
+}
+
+/**
+ * @description: 把日志中[begin, end)的部分复制到备份目录，段文件的编号和控制文件中的起始位置与原日志相同
+ * 段文件中end之后的部分填零，在备份目录上打开日志时扫描到end即停止
+ * @param {string&} dir 备份目录
+ * @param {int64_t} begin 复制的起始位置，必须是一条日志记录的开始
+ * @param {lsn_t} begin_lsn 起始位置上的日志记录的日志号
+ * @param {int64_t} end 复制的结束位置，必须已经写盘
+ */
+void DiskManager::backup_log(const std::string &dir, int64_t begin, lsn_t begin_lsn, int64_t end) {
+    std::vector<char> buf(LOG_BUFFER_SIZE);
+    for (int64_t seg_no = begin / LOG_SEGMENT_SIZE; seg_no <= end / LOG_SEGMENT_SIZE; seg_no++) {
+        auto name = dir + "/" + log_segment_name(seg_no);
+        int fd = open(name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+        if (fd < 0 || ftruncate(fd, LOG_SEGMENT_SIZE) < 0) {
+            throw UnixError();
+        }
+        int64_t pos = std::max(begin, seg_no * LOG_SEGMENT_SIZE);
+        int64_t seg_end = std::min(end, (seg_no + 1) * LOG_SEGMENT_SIZE);
+        while (pos < seg_end) {
+            int size = read_log(buf.data(), std::min<int64_t>(seg_end - pos, buf.size()), pos);
+            if (size <= 0 || pwrite(fd, buf.data(), size, pos % LOG_SEGMENT_SIZE) != size) {
+                close(fd);
+                throw UnixError();
+            }
+            pos += size;
+        }
+        if (fsync(fd) < 0) {
+            close(fd);
+            throw UnixError();
+        }
+        close(fd);
+    }
+    write_log_control(begin, begin_lsn, dir);
+}
+
+/**
+ * @description: 用一次顺序读读出文件中连续的多个页面，不改变文件的读写位置，可以与其他线程的读写并发
+ * @return {int} 读出的完整页面个数，读到文件末尾时少于num_pages
+ * @param {int} fd 文件句柄
+ * @param {page_id_t} page_no 第一个页面的页号
+ * @param {char*} offset 读出的内容，大小至少为num_pages * PAGE_SIZE
+ * @param {int} num_pages 读取的页面个数
+ */
+int DiskManager::read_pages(int fd, page_id_t page_no, char *offset, int num_pages) {
+    int os_fd = pin_file(fd);
+    size_t size = (size_t)num_pages * PAGE_SIZE;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pread(os_fd, offset + done, size - done, (off_t)page_no * PAGE_SIZE + done);
+        if (n < 0) {
+            unpin_file(fd);
+            throw UnixError();
+        }
+        if (n == 0) {
+            break;
+        }
+        done += n;
+    }
+    unpin_file(fd);
+    return done / PAGE_SIZE;
+}
+
+/**
+ * @description: 为打开的文件分配文件句柄并加入文件打开列表，此时还不打开系统文件句柄
+ * 优先复用已经关闭的文件的句柄，使句柄保持较小的编号
+ * @return {int} 分配的文件句柄
+ * @param {string} &path 文件所在路径
+ */
+int DiskManager::register_file(const std::string &path) {
+    std::lock_guard<std::mutex> lock(files_latch_);
+    if (path2fd_.count(path)) {
+        throw FileNotClosedError(path);
+    }
+    int fd;
+    if (!free_fds_.empty()) {
+        fd = *free_fds_.begin();
+        free_fds_.erase(free_fds_.begin());
+    } else if (next_fd_ < MAX_FD) {
+        fd = next_fd_++;
+    } else {
+        throw InternalError("DiskManager::register_file too many open files");
+    }
+    path2fd_[path] = fd;
+    fd2path_[fd] = path;
+    return fd;
+}
+
+/**
+ * @description: 把文件从文件打开列表中删除，关闭它的系统文件句柄，文件句柄留待复用
+ * @param {int} fd 打开的文件的文件句柄
+ */
+void DiskManager::unregister_file(int fd) {
+    std::lock_guard<std::mutex> lock(files_latch_);
+    auto found = fd2path_.find(fd);
+    if (found == fd2path_.end()) {
+        throw FileNotOpenError(fd);
+    }
+    int rc = 0;
+    auto it = os_files_.find(fd);
+    if (it != os_files_.end()) {
+        rc = close(it->second.os_fd);
+        os_lru_.erase(it->second.lru_pos);
+        os_files_.erase(it);
+    }
+    path2fd_.erase(found->second);
+    fd2path_.erase(found);
+    free_fds_.insert(fd);
+    if (rc == -1) {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 获得文件的系统文件句柄用于一次读写，没有打开时打开它，读写结束后必须调用unpin_file
+ * 打开的系统文件句柄达到MAX_OPEN_FILES时，先关闭最久未使用且没有正在读写的句柄
+ * @return {int} 系统文件句柄
+ * @param {int} fd 打开的文件的文件句柄
+ */
+int DiskManager::pin_file(int fd) {
+    std::lock_guard<std::mutex> lock(files_latch_);
+    auto it = os_files_.find(fd);
+    if (it != os_files_.end()) {
+        os_lru_.splice(os_lru_.begin(), os_lru_, it->second.lru_pos);
+        it->second.pins++;
+        return it->second.os_fd;
+    }
+    auto found = fd2path_.find(fd);
+    if (found == fd2path_.end()) {
+        throw FileNotOpenError(fd);
+    }
+    auto victim = os_lru_.rbegin();
+    while ((int)os_files_.size() >= MAX_OPEN_FILES && victim != os_lru_.rend()) {
+        auto victim_it = os_files_.find(*victim);
+        if (victim_it->second.pins > 0) {
+            victim++;
+            continue;
+        }
+        close(victim_it->second.os_fd);
+        os_files_.erase(victim_it);
+        victim = std::make_reverse_iterator(os_lru_.erase(std::next(victim).base()));
+    }
+    int os_fd = open(found->second.c_str(), O_RDWR);
+    if (os_fd == -1) {
+        throw UnixError();
+    }
+    os_lru_.push_front(fd);
+    os_files_[fd] = {.os_fd = os_fd, .pins = 1, .lru_pos = os_lru_.begin()};
+    return os_fd;
+}
+
+/**
+ * @description: 结束一次读写，之后该系统文件句柄可以被关闭
+ * @param {int} fd 打开的文件的文件句柄
+ */
+void DiskManager::unpin_file(int fd) {
+    std::lock_guard<std::mutex> lock(files_latch_);
+    os_files_.at(fd).pins--;
+}
+
+/**
+ * @description: 把文件截断为前num_pages个页面，之后从num_pages开始分配页面编号
+ * 调用者保证被截断的页面已经不在缓冲池中
+ * @param {int} fd 文件句柄
+ * @param {int} num_pages 截断后文件中的页面个数
+ */
+void DiskManager::truncate_file(int fd, int num_pages) {
+    int os_fd = pin_file(fd);
+    int rc = ftruncate(os_fd, (off_t)num_pages * PAGE_SIZE);
+    unpin_file(fd);
+    if (rc == -1) {
+        throw UnixError();
+    }
+    fd2pageno_[fd] = num_pages;
+}
+
+/**
+ * @description: 重命名文件，文件已经打开时保留它的文件句柄，已经打开的系统文件句柄仍然有效，重新打开时使用新的路径
+ * @param {string} &path 文件原来的路径
+ * @param {string} &new_path 文件新的路径，不能已经存在
+ */
+void DiskManager::rename_file(const std::string &path, const std::string &new_path) {
+    std::lock_guard<std::mutex> lock(files_latch_);
+    if (is_file(new_path)) {
+        throw FileExistsError(new_path);
+    }
+    if (rename(path.c_str(), new_path.c_str()) == -1) {
+        throw UnixError();
+    }
+    auto it = path2fd_.find(path);
+    if (it != path2fd_.end()) {
+        int fd = it->second;
+        path2fd_.erase(it);
+        path2fd_[new_path] = fd;
+        fd2path_[fd] = new_path;
+    }
 }
\ No newline at end of file
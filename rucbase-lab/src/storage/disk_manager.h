@@ -1,99 +1,162 @@
-/* Copyright (c) 2023 Renmin University of China
-RMDB is licensed under Mulan PSL v2.
-You can use this software according to the terms and conditions of the Mulan PSL v2.
-You may obtain a copy of Mulan PSL v2 at:
-        http://license.coscl.org.cn/MulanPSL2
-THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
-EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
-MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
-See the Mulan PSL v2 for more details. */
-
-#pragma once
-
-#include <fcntl.h>     
-#include <sys/stat.h>  
-#include <unistd.h>    
-
-#include <atomic>
-#include <fstream>
-#include <iostream>
-#include <string>
-#include <unordered_map>
-
-#include "common/config.h"
-#include "errors.h"  
-
-/**
- * @description: DiskManager的作用主要是根据上层的需要对磁盘文件进行操作
- */
-class DiskManager {
-   public:
-    explicit DiskManager();
-
-    ~DiskManager() = default;
-
-    void write_page(int fd, page_id_t page_no, const char *offset, int num_bytes);
-
-    void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
-
-    page_id_t allocate_page(int fd);
-
-    void deallocate_page(page_id_t page_id);
-
-    /*目录操作*/
-    bool is_dir(const std::string &path);
-
-    void create_dir(const std::string &path);
-
-    void destroy_dir(const std::string &path);
-
-    /*文件操作*/
-    bool is_file(const std::string &path);
-
-    void create_file(const std::string &path);
-
-    void destroy_file(const std::string &path);
-
-    int open_file(const std::string &path);
-
-    void close_file(int fd);
-
-    int get_file_size(const std::string &file_name);
-
-    std::string get_file_name(int fd);
-
-    int get_file_fd(const std::string &file_name);
-
-    /*日志操作*/
-    int read_log(char *log_data, int size, int offset);
-
-    void write_log(char *log_data, int size);
-
-    void SetLogFd(int log_fd) { log_fd_ = log_fd; }
-
-    int GetLogFd() { return log_fd_; }
-
-    /**
-     * @description: 设置文件已经分配的页面个数
-     * @param {int} fd 文件对应的文件句柄
-     * @param {int} start_page_no 已经分配的页面个数，即文件接下来从start_page_no开始分配页面编号
-     */
-    void set_fd2pageno(int fd, int start_page_no) { fd2pageno_[fd] = start_page_no; }
-
-    /**
-     * @description: 获得文件目前已分配的页面个数，即如果文件要分配一个新页面，需要从fd2pagenp_[fd]开始分配
-     * @return {page_id_t} 已分配的页面个数 
-     * @param {int} fd 文件对应的句柄
-     */
-    page_id_t get_fd2pageno(int fd) { return fd2pageno_[fd]; }
-
-    static constexpr int MAX_FD = 8192;
-
-   private:
-    // 文件打开列表，用于记录文件是否被打开
-    std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
-    std::unordered_map<int, std::string> fd2path_;  //<Page fd,Page文件磁盘路径>哈希表
-
-    int log_fd_ = -1;                             // WAL日志文件的文件句柄，默认为-1，代表未打开日志文件
-    std::atomic<page_id_t> fd2pageno_[MAX_FD]{};  // 文件中已经分配的页面个数，初始值为0
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <fcntl.h>     
+#include <sys/stat.h>  
+#include <unistd.h>    
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "errors.h"  
+
+/**
+ * @description: DiskManager的作用主要是根据上层的需要对磁盘文件进行操作
+ */
+class DiskManager {
+   public:
+    explicit DiskManager();
+
+    ~DiskManager() = default;
+
+    void write_page(int fd, page_id_t page_no, const char *offset, int num_bytes);
+
+    void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
+
+    int read_pages(int fd, page_id_t page_no, char *offset, int num_pages);
+
+    page_id_t allocate_page(int fd);
+
+    void deallocate_page(page_id_t page_id);
+
+    void truncate_file(int fd, int num_pages);
+
+    /*目录操作*/
+    bool is_dir(const std::string &path);
+
+    void create_dir(const std::string &path);
+
+    void destroy_dir(const std::string &path);
+
+    /*文件操作*/
+    bool is_file(const std::string &path);
+
+    void create_file(const std::string &path);
+
+    void destroy_file(const std::string &path);
+
+    void rename_file(const std::string &path, const std::string &new_path);
+
+    int open_file(const std::string &path);
+
+    void close_file(int fd);
+
+    int get_file_size(const std::string &file_name);
+
+    std::string get_file_name(int fd);
+
+    int get_file_fd(const std::string &file_name);
+
+    /*日志操作*/
+    void open_log();
+
+    void close_log();
+
+    int read_log(char *log_data, int size, int64_t offset);
+
+    void write_log(char *log_data, int size);
+
+    /* 日志中第一条仍然需要的记录的位置，由最近一次检查点确定 */
+    int64_t get_log_begin() { return log_begin_; }
+
+    /* 起始位置上的日志记录应有的日志号，控制文件中没有记录时为INVALID_LSN */
+    lsn_t get_log_begin_lsn() { return log_begin_lsn_; }
+
+    int64_t get_log_end() { return log_end_; }
+
+    void set_log_end(int64_t log_end);
+
+    void recycle_log(int64_t log_begin, lsn_t begin_lsn);
+
+    void backup_log(const std::string &dir, int64_t begin, lsn_t begin_lsn, int64_t end);
+
+    /**
+     * @description: 设置文件已经分配的页面个数
+     * @param {int} fd 文件对应的文件句柄
+     * @param {int} start_page_no 已经分配的页面个数，即文件接下来从start_page_no开始分配页面编号
+     */
+    void set_fd2pageno(int fd, int start_page_no) { fd2pageno_[fd] = start_page_no; }
+
+    /**
+     * @description: 获得文件目前已分配的页面个数，即如果文件要分配一个新页面，需要从fd2pagenp_[fd]开始分配
+     * @return {page_id_t} 已分配的页面个数 
+     * @param {int} fd 文件对应的句柄
+     */
+    page_id_t get_fd2pageno(int fd) { return fd2pageno_[fd]; }
+
+    static constexpr int MAX_FD = 8192;
+
+    static constexpr int MAX_OPEN_FILES = 256;  // 同时打开的系统文件句柄的上限
+
+   private:
+    /* 一个已经打开了系统文件句柄的文件 */
+    struct OsFile {
+        int os_fd;                          // 系统文件句柄
+        int pins;                           // 正在使用该句柄读写的次数，大于0时不能关闭
+        std::list<int>::iterator lru_pos;   // 在os_lru_中的位置
+    };
+
+    int register_file(const std::string &path);
+
+    void unregister_file(int fd);
+
+    int pin_file(int fd);
+
+    void unpin_file(int fd);
+
+    // 文件打开列表，用于记录文件是否被打开
+    // 上层看到的文件句柄是打开文件时分配的虚拟编号，在文件关闭前保持不变，系统文件句柄在第一次读写时才打开，
+    // 打开的系统文件句柄超过MAX_OPEN_FILES时关闭最久未使用的，之后再读写时重新打开
+    std::mutex files_latch_;                        // 保护文件打开列表和系统文件句柄
+    std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
+    std::unordered_map<int, std::string> fd2path_;  //<Page fd,Page文件磁盘路径>哈希表
+    std::unordered_map<int, OsFile> os_files_;      // 文件句柄 -> 已经打开的系统文件句柄
+    std::list<int> os_lru_;                         // 打开了系统文件句柄的文件，表头为最近使用的
+    std::set<int> free_fds_;                        // 关闭后可以复用的文件句柄，优先复用编号小的
+    int next_fd_ = 0;                               // 从未分配过的最小文件句柄
+
+    int log_segment_fd(int64_t seg_no);
+
+    void write_log_control(int64_t log_begin, lsn_t begin_lsn, const std::string &dir = ".");
+
+    /* 日志由编号连续的定长段文件组成，段seg_no保存日志中[seg_no * LOG_SEGMENT_SIZE, (seg_no + 1) * LOG_SEGMENT_SIZE)的内容 */
+    static std::string log_segment_name(int64_t seg_no) { return LOG_FILE_NAME + "." + std::to_string(seg_no); }
+
+    std::mutex log_latch_;                        // 保护日志段的打开和回收
+    std::map<int64_t, int> log_fds_;              // 已经打开的日志段：段号 -> 文件句柄
+    int64_t log_max_seg_ = -1;                    // 已经存在的编号最大的日志段，回收的段改名为它之后的段
+    std::atomic<int64_t> log_begin_{0};           // 日志中第一条仍然需要的记录的位置，检查点线程推进，其他线程读取
+    lsn_t log_begin_lsn_ = INVALID_LSN;           // 起始位置上的日志记录的日志号，只在打开日志时读取
+    std::atomic<int64_t> log_end_{0};             // 日志末尾的位置，下一次写日志从这里开始
+    bool log_end_known_ = false;                  // 打开日志后是否已经扫描出日志末尾
+    std::vector<char> log_tail_;                  // 日志末尾不满一块的部分，下次写日志时与新日志一起从块边界写入
+    std::atomic<page_id_t> fd2pageno_[MAX_FD]{};  // 文件中已经分配的页面个数，初始值为0
 };
\ No newline at end of file
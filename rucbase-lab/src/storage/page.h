@@ -80,7 +80,7 @@ class Page {
     /** The actual data that is stored within a page.
      *  该页面在bufferPool中的偏移地址
      */
-    char data_[PAGE_SIZE] = {};
+    alignas(8) char data_[PAGE_SIZE] = {};    // 按8字节对齐，页面中的行锁字需要原子访问
 
     /** 脏页判断 */
     bool is_dirty_ = false;
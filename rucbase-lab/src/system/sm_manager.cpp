@@ -10,10 +10,16 @@ See the Mulan PSL v2 for more details. */
 
 #include "sm_manager.h"
 
+#include <dirent.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <numeric>
+#include <thread>
 
 #include "index/ix.h"
 #include "record/rm.h"
@@ -48,6 +54,7 @@ void SmManager::create_db(const std::string& db_name) {
     //创建系统目录
     DbMeta *new_db = new DbMeta();
     new_db->name_ = db_name;
+    new_db->ix_format_ = IX_PAGE_FORMAT;
 
     // 注意，此处ofstream会在当前目录创建(如果没有此文件先创建)和打开一个名为DB_META_NAME的文件
     std::ofstream ofs(DB_META_NAME);
@@ -57,9 +64,6 @@ void SmManager::create_db(const std::string& db_name) {
 
     delete new_db;
 
-    // 创建日志文件
-    disk_manager_->create_file(LOG_FILE_NAME);
-
     // 回到根目录
     if (chdir("..") < 0) {
         throw UnixError();
@@ -81,11 +85,108 @@ void SmManager::drop_db(const std::string& db_name) {
 }
 
 /**
- * @description: 打开数据库，找到数据库对应的文件夹，并加载数据库元数据和相关文件
+ * @description: 获得表的一个数据文件的句柄，文件在第一次访问时打开
+ * @return {RmFileHandle*} 文件句柄，文件不属于任何表时返回nullptr
+ * @param {string&} file 数据文件名，非分区表与表同名，分区表为分区的数据文件名
+ */
+RmFileHandle* SmManager::get_file_handle(const std::string& file) {
+    std::lock_guard<std::mutex> lock(handle_latch_);
+    auto it = fhs_.find(file);
+    if (it != fhs_.end()) {
+        return it->second.get();
+    }
+    auto tab = db_.tabs_.find(file_tab_name(file));
+    if (tab == db_.tabs_.end()) {
+        return nullptr;
+    }
+    auto files = tab->second.get_files();
+    if (std::find(files.begin(), files.end(), file) == files.end()) {
+        return nullptr;
+    }
+    return fhs_.emplace(file, rm_manager_->open_file(file)).first->second.get();
+}
+
+/**
+ * @description: 获得数据文件上一个索引的句柄，索引文件在第一次访问时打开
+ * @return {IxIndexHandle*} 索引文件句柄
+ * @param {string&} file 索引所在的数据文件名
+ * @param {vector<ColMeta>&} index_cols 索引包含的字段
+ */
+IxIndexHandle* SmManager::get_index_handle(const std::string& file, const std::vector<ColMeta>& index_cols) {
+    auto ix_name = ix_manager_->get_index_name(file, index_cols);
+    std::lock_guard<std::mutex> lock(handle_latch_);
+    auto it = ihs_.find(ix_name);
+    if (it != ihs_.end()) {
+        return it->second.get();
+    }
+    return ihs_.emplace(ix_name, ix_manager_->open_index(file, index_cols)).first->second.get();
+}
+
+/**
+ * @description: 已经打开的数据文件句柄的快照，调用者持有meta_latch_，快照中的句柄不会被关闭
+ */
+std::vector<std::pair<std::string, RmFileHandle*>> SmManager::get_open_files() {
+    std::lock_guard<std::mutex> lock(handle_latch_);
+    std::vector<std::pair<std::string, RmFileHandle*>> files;
+    for (auto &entry : fhs_) {
+        files.emplace_back(entry.first, entry.second.get());
+    }
+    return files;
+}
+
+/**
+ * @description: 已经打开的索引文件句柄的快照，调用者持有meta_latch_，快照中的句柄不会被关闭
+ */
+std::vector<std::pair<std::string, IxIndexHandle*>> SmManager::get_open_indexes() {
+    std::lock_guard<std::mutex> lock(handle_latch_);
+    std::vector<std::pair<std::string, IxIndexHandle*>> indexes;
+    for (auto &entry : ihs_) {
+        indexes.emplace_back(entry.first, entry.second.get());
+    }
+    return indexes;
+}
+
+/**
+ * @description: 打开数据库，找到数据库对应的文件夹，并加载数据库元数据
+ * 表和索引文件在第一次访问时才打开，启动时间与表和索引的个数无关
+ * 上次关闭前没有来得及删除的文件已经不属于任何表，在这里删除
+ * 旧版本创建的索引的结点页面没有page_lsn，与当前的页面格式不同，只在第一次打开时由数据文件重建
  * @param {string&} db_name 数据库名称，与文件夹同名
  */
 void SmManager::open_db(const std::string& db_name) {
-    
+    if (!is_dir(db_name)) {
+        throw DatabaseNotFoundError(db_name);
+    }
+    if (chdir(db_name.c_str()) < 0) {
+        throw UnixError();
+    }
+    // 加载数据库元数据，物化视图的定义也一并加载
+    std::ifstream ifs(DB_META_NAME);
+    ifs >> db_;
+    disk_manager_->open_log();
+    if (DIR* dir = opendir(".")) {
+        while (dirent* entry = readdir(dir)) {
+            if (strstr(entry->d_name, DROPPED_FILE_SUFFIX.c_str()) != nullptr) {
+                unlink(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+    if (db_.ix_format_ != IX_PAGE_FORMAT) {
+        for (auto &[tab_name, tab] : db_.tabs_) {
+            if (tab.indexes.empty()) {
+                continue;
+            }
+            for (auto &file : tab.get_files()) {
+                rebuild_indexes(file);
+            }
+        }
+        // 重建的索引写盘之后才记录新的格式，故障后再次打开时重新重建
+        flush_all_pages();
+        db_.ix_format_ = IX_PAGE_FORMAT;
+        flush_meta();
+    }
+    start_purger();
 }
 
 /**
@@ -101,7 +202,145 @@ void SmManager::flush_meta() {
  * @description: 关闭数据库并把数据落盘
  */
 void SmManager::close_db() {
-    
+    stop_purger();
+    flush_meta();
+    save_warm_list();
+    for (auto &entry : fhs_) {
+        rm_manager_->close_file(entry.second.get());
+    }
+    fhs_.clear();
+    for (auto &entry : ihs_) {
+        ix_manager_->close_index(entry.second.get());
+    }
+    ihs_.clear();
+    disk_manager_->close_log();
+    db_.name_.clear();
+    db_.tabs_.clear();
+    db_.views_.clear();
+    if (chdir("..") < 0) {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 把所有表和索引文件的脏页以及它们的文件头刷盘，用于检查点
+ * 没有打开过的文件在缓冲池中没有页面，文件头也没有变化，不需要刷盘
+ * 索引的根结点、页面数和空闲页面链表只在文件头中，持有root_latch_写盘，文件头与写盘的结点属于同一棵树
+ */
+void SmManager::flush_all_pages() {
+    std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+    for (auto &[file, fh] : get_open_files()) {
+        buffer_pool_manager_->flush_all_pages(fh->GetFd());
+        rm_manager_->flush_file_hdr(fh);
+    }
+    for (auto &[file, ih] : get_open_indexes()) {
+        std::lock_guard<std::mutex> root_lock(ih->get_root_latch());
+        buffer_pool_manager_->flush_all_pages(ih->get_fd());
+        ix_manager_->flush_file_hdr(ih);
+    }
+}
+
+/**
+ * @description: 把缓冲池中表和索引文件的页面按热度从高到低写入WARM_FILE_NAME，每行为文件名和页号
+ * 文件句柄在重启后会变化，因此记录文件名；先写临时文件再改名，故障时列表文件总是完整的
+ */
+void SmManager::save_warm_list() {
+    std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+    std::unordered_map<int, std::string> fd2name;
+    for (auto &[file, fh] : get_open_files()) {
+        fd2name[fh->GetFd()] = file;
+    }
+    for (auto &[ix_name, ih] : get_open_indexes()) {
+        fd2name[ih->get_fd()] = ix_name;
+    }
+    auto tmp_name = WARM_FILE_NAME + ".tmp";
+    {
+        std::ofstream ofs(tmp_name);
+        for (auto &page_id : buffer_pool_manager_->get_hot_pages()) {
+            auto it = fd2name.find(page_id.fd);
+            if (it != fd2name.end()) {
+                ofs << it->second << ' ' << page_id.page_no << '\n';
+            }
+        }
+    }
+    if (rename(tmp_name.c_str(), WARM_FILE_NAME.c_str()) < 0) {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 按上次保存的页面列表预热缓冲池，在后台与正常的请求并发执行
+ * 最热的页面先装入，每批页面按文件和页号排序后合并为大的顺序读，缓冲池没有空闲帧时停止
+ */
+void SmManager::warm_up() {
+    std::ifstream ifs(WARM_FILE_NAME);
+    std::vector<std::pair<std::string, page_id_t>> batch;
+    std::string file;
+    page_id_t page_no;
+    bool has_free = true;
+    while (has_free && ifs >> file >> page_no) {
+        batch.emplace_back(file, page_no);
+        if (batch.size() == WARM_BATCH_PAGES) {
+            has_free = warm_up_batch(batch);
+            batch.clear();
+        }
+    }
+    if (has_free) {
+        warm_up_batch(batch);
+    }
+}
+
+/**
+ * @description: 装入一批页面，期间持有meta_latch_的共享锁，文件不会被删除，已经删除的文件中的页面被跳过
+ * 批中出现的文件按需打开
+ * @return {bool} 缓冲池是否还有空闲帧
+ * @param {vector<pair<string, page_id_t>>&} batch 文件名和页号
+ */
+bool SmManager::warm_up_batch(const std::vector<std::pair<std::string, page_id_t>>& batch) {
+    std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+    std::unordered_map<std::string, int> name2fd;
+    for (auto &entry : batch) {
+        name2fd.emplace(entry.first, -1);
+    }
+    for (auto &[tab_name, tab] : db_.tabs_) {
+        for (auto &file : tab.get_files()) {
+            if (name2fd.count(file)) {
+                name2fd[file] = get_file_handle(file)->GetFd();
+            }
+            for (auto &index : tab.indexes) {
+                auto ix_name = ix_manager_->get_index_name(file, index.cols);
+                if (name2fd.count(ix_name)) {
+                    name2fd[ix_name] = get_index_handle(file, index.cols)->get_fd();
+                }
+            }
+        }
+    }
+    std::vector<PageId> pages;
+    for (auto &entry : batch) {
+        int fd = name2fd[entry.first];
+        if (fd >= 0) {
+            pages.push_back({.fd = fd, .page_no = entry.second});
+        }
+    }
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+    std::vector<char> buf((size_t)WARM_READ_PAGES * PAGE_SIZE);
+    for (size_t i = 0; i < pages.size();) {
+        // 同一文件中页号连续的页面合并为一次顺序读
+        size_t j = i + 1;
+        while (j < pages.size() && j - i < WARM_READ_PAGES && pages[j].fd == pages[i].fd &&
+               pages[j].page_no == pages[j - 1].page_no + 1) {
+            j++;
+        }
+        uint64_t write_backs = buffer_pool_manager_->get_write_backs();
+        int n = disk_manager_->read_pages(pages[i].fd, pages[i].page_no, buf.data(), j - i);
+        if (n > 0 && !buffer_pool_manager_->install_pages(pages[i], n, buf.data(), write_backs)) {
+            return false;
+        }
+        i = j;
+    }
+    return true;
 }
 
 /**
@@ -153,8 +392,11 @@ void SmManager::desc_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context 
+ * @param {PartitionMeta&} part 表的分区方式，非分区表的type为PART_NONE
+ * @param {int} hidden_len 记录末尾不属于任何字段的字节数，物化视图用来保存元组的血缘
  */
-void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context) {
+void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                             const PartitionMeta& part, int hidden_len) {
     if (db_.is_table(tab_name)) {
         throw TableExistsError(tab_name);
     }
@@ -172,33 +414,808 @@ void SmManager::create_table(const std::string& tab_name, const std::vector<ColD
         curr_offset += col_def.len;
         tab.cols.push_back(col);
     }
+    if (part.is_partitioned()) {
+        check_partition(tab, part);
+        tab.part = part;
+    }
     // Create & open record file
-    int record_size = curr_offset;  // record_size就是col meta所占的大小（表的元数据也是以记录的形式进行存储的）
-    rm_manager_->create_file(tab_name, record_size);
+    int record_size = curr_offset + hidden_len;  // record_size就是col meta所占的大小（表的元数据也是以记录的形式进行存储的）
+    if (hidden_len > 0) {
+        tab.record_size = record_size;
+    }
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    for (auto &file : tab.get_files()) {
+        rm_manager_->create_file(file, record_size);
+    }
     db_.tabs_[tab_name] = tab;
-    // fhs_[tab_name] = rm_manager_->open_file(tab_name);
-    fhs_.emplace(tab_name, rm_manager_->open_file(tab_name));
 
     flush_meta();
 }
 
 /**
- * @description: 删除表
+ * @description: 删除表，删除文件之前写TRUNCATE日志，故障后重做时被删除的表的修改不会写入之后重新创建的同名表
  * @param {string&} tab_name 表的名称
  * @param {Context*} context
  */
 void SmManager::drop_table(const std::string& tab_name, Context* context) {
-    
+    lock_table_exclusive(tab_name, context);
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    // 物化视图只能通过DROP MATERIALIZED VIEW删除，被视图引用的基表不能删除
+    if (db_.is_view(tab_name)) {
+        throw ViewReadOnlyError(tab_name);
+    }
+    auto views = db_.get_views_on(tab_name);
+    if (!views.empty()) {
+        throw ViewDependencyError(tab_name, views[0]->name);
+    }
+    check_index_build(tab_name);
+    TabMeta &tab = db_.get_table(tab_name);
+    log_truncate(tab.get_files(), context);
+    for (auto &file : tab.get_files()) {
+        drop_file(tab, file);
+    }
+    db_.tabs_.erase(tab_name);
+    stats_.erase(tab_name);
+
+    flush_meta();
+}
+
+/**
+ * @description: 清空表，把表的数据文件和索引文件替换为新建的空文件，旧文件由后台线程删除，耗时与表的大小无关
+ * 先写TRUNCATE日志并刷盘再替换文件，故障后重做日志时再次替换，之前的修改不会重新出现
+ * 清空不能撤销，因此不能在显式事务中执行
+ * @param {string&} tab_name 表的名称
+ * @param {Context*} context
+ */
+void SmManager::truncate_table(const std::string& tab_name, Context* context) {
+    if (context->txn_ != nullptr && context->txn_->get_txn_mode()) {
+        throw DdlInTransactionError("TRUNCATE");
+    }
+    lock_table_exclusive(tab_name, context);
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    // 清空基表不会产生删除增量，物化视图无法感知
+    if (db_.is_view(tab_name)) {
+        throw ViewReadOnlyError(tab_name);
+    }
+    auto views = db_.get_views_on(tab_name);
+    if (!views.empty()) {
+        throw ViewDependencyError(tab_name, views[0]->name);
+    }
+    check_index_build(tab_name);
+    auto files = db_.get_table(tab_name).get_files();
+    log_truncate(files, context);
+    for (auto &file : files) {
+        reset_file(file);
+    }
+    stats_.erase(tab_name);
+}
+
+/**
+ * @description: 删除或清空数据文件之前为每个文件写TRUNCATE日志并刷盘
+ * 重做到该日志时文件被替换为空文件，之前写入同名文件的修改被清除，删除后重新创建的同名表不会重做出旧表的记录
+ * @param {vector<string>&} files 被删除或清空的数据文件
+ * @param {Context*} context 不在事务中时不写日志
+ */
+void SmManager::log_truncate(const std::vector<std::string>& files, Context* context) {
+    if (context->txn_ == nullptr) {
+        return;
+    }
+    for (auto &file : files) {
+        TruncateLogRecord truncate_log(context->txn_->get_transaction_id(), file);
+        context->log_mgr_->add_txn_log(context->txn_, &truncate_log);
+    }
+    context->log_mgr_->flush_log_to_disk();
+}
+
+/**
+ * @description: 把表的一个数据文件及其上的索引文件替换为新建的空文件，用于TRUNCATE及其日志的重做
+ * 调用者需要持有meta_latch_的排他锁，文件所属的表已经被删除时不做任何操作
+ * @param {string&} file 数据文件名
+ */
+void SmManager::reset_file(const std::string& file) {
+    auto tab_name = file_tab_name(file);
+    if (!db_.is_table(tab_name)) {
+        return;
+    }
+    TabMeta &tab = db_.get_table(tab_name);
+    auto files = tab.get_files();
+    if (std::find(files.begin(), files.end(), file) == files.end()) {
+        return;
+    }
+    drop_file(tab, file);
+    int record_size = tab.get_record_size();
+    rm_manager_->create_file(file, record_size);
+    for (auto &index : tab.indexes) {
+        ix_manager_->create_index(file, index.cols);
+    }
+}
+
+/**
+ * @description: 删除表的一个数据文件及其上的索引文件，文件改名后交给后台线程删除，同名的文件可以立即重新创建
+ * @param {TabMeta&} tab 数据文件所属的表
+ * @param {string&} file 数据文件名，非分区表与表同名，分区表为分区的数据文件名
+ */
+void SmManager::drop_file(const TabMeta& tab, const std::string& file) {
+    std::lock_guard<std::mutex> lock(handle_latch_);
+    for (auto &index : tab.indexes) {
+        auto ix_name = ix_manager_->get_index_name(file, index.cols);
+        int fd = -1;
+        auto ih = ihs_.find(ix_name);
+        if (ih != ihs_.end()) {
+            fd = ih->second->get_fd();
+            ihs_.erase(ih);
+        }
+        detach_file(ix_name, fd);
+    }
+    int fd = -1;
+    auto fh = fhs_.find(file);
+    if (fh != fhs_.end()) {
+        fd = fh->second->GetFd();
+        fhs_.erase(fh);
+    }
+    detach_file(file, fd);
 }
 
 /**
- * @description: 创建索引
+ * @description: 把被删除的文件改名并加入后台删除队列，调用者需要持有handle_latch_
+ * 文件的页面仍在缓冲池中，文件句柄要等这些页面被丢弃后才能关闭和复用
+ * @param {string&} path 被删除的文件
+ * @param {int} fd 文件已经打开时的文件句柄，没有打开时为-1
+ */
+void SmManager::detach_file(const std::string& path, int fd) {
+    auto dropped = path + DROPPED_FILE_SUFFIX + std::to_string(dropped_seq_++);
+    disk_manager_->rename_file(path, dropped);
+    {
+        std::lock_guard<std::mutex> lock(purge_latch_);
+        dropped_files_.push_back(DroppedFile{dropped, fd});
+    }
+    purge_cv_.notify_one();
+}
+
+/**
+ * @description: 在表的每个数据文件上加排他锁，等待表上其他事务结束，不在事务中时不加锁
+ * 等待表锁时不持有元数据锁：DML先加表意向锁再获取元数据共享锁，DDL持有表排他锁之后才获取元数据锁，两者不会互相等待
+ * 等待期间表的数据文件被替换时，在新文件上重新加锁
+ * @param {string&} tab_name 表的名称
+ * @param {Context*} context
+ */
+void SmManager::lock_table_exclusive(const std::string& tab_name, Context* context) {
+    if (context->txn_ == nullptr) {
+        return;
+    }
+    std::vector<int> fds;
+    while (true) {
+        std::vector<int> curr_fds;
+        {
+            std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+            if (!db_.is_table(tab_name)) {
+                throw TableNotFoundError(tab_name);
+            }
+            for (auto &file : db_.get_table(tab_name).get_files()) {
+                curr_fds.push_back(get_file_handle(file)->GetFd());
+            }
+        }
+        if (curr_fds == fds) {
+            return;
+        }
+        for (int fd : curr_fds) {
+            context->lock_mgr_->lock_exclusive_on_table(context->txn_, fd);
+        }
+        fds = std::move(curr_fds);
+    }
+}
+
+/**
+ * @description: DML写数据文件之前加表意向写锁，再获取元数据共享锁，加锁顺序与DDL相同，不在事务中时只获取元数据共享锁
+ * 等待表锁时不持有元数据锁，等待期间文件被TRUNCATE替换为新文件时，在新文件上重新加锁
+ * @return {shared_lock} 元数据共享锁，持有期间表上的索引集合和数据文件不变
+ * @param {string&} file 要写的数据文件名
+ * @param {Context*} context
+ */
+std::shared_lock<std::shared_mutex> SmManager::lock_file_for_write(const std::string& file, Context* context) {
+    int fd = -1;
+    while (true) {
+        std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+        auto fh = get_file_handle(file);
+        // 等待表锁期间表已经被删除
+        if (fh == nullptr) {
+            throw TableNotFoundError(file_tab_name(file));
+        }
+        if (context->txn_ == nullptr || fh->GetFd() == fd) {
+            return meta_lock;
+        }
+        fd = fh->GetFd();
+        meta_lock.unlock();
+        context->lock_mgr_->lock_IX_on_table(context->txn_, fd);
+    }
+}
+
+/**
+ * @description: 启动后台删除文件的线程，逐个丢弃被删除文件在缓冲池中的页面，关闭文件句柄并删除文件
+ */
+void SmManager::start_purger() {
+    stop_purger_ = false;
+    purger_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(purge_latch_);
+        while (true) {
+            purge_cv_.wait(lock, [this] { return stop_purger_ || !dropped_files_.empty(); });
+            if (dropped_files_.empty()) {
+                break;
+            }
+            DroppedFile dropped = dropped_files_.front();
+            dropped_files_.pop_front();
+            lock.unlock();
+            try {
+                purge_file(dropped);
+            } catch (RMDBError &e) {
+                std::cerr << e.what() << std::endl;
+            }
+            lock.lock();
+        }
+    });
+}
+
+/**
+ * @description: 停止后台删除文件的线程，队列中剩余的文件删除完之后才返回
+ */
+void SmManager::stop_purger() {
+    if (!purger_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(purge_latch_);
+        stop_purger_ = true;
+    }
+    purge_cv_.notify_all();
+    purger_.join();
+}
+
+/**
+ * @description: 删除一个已经改名的文件，被固定的页面属于删除之前开始的读写，等它们结束后再丢弃
+ * @param {DroppedFile&} dropped 被删除的文件
+ */
+void SmManager::purge_file(const DroppedFile& dropped) {
+    if (dropped.fd >= 0) {
+        while (!buffer_pool_manager_->discard_pages(dropped.fd)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        disk_manager_->close_file(dropped.fd);
+    }
+    disk_manager_->destroy_file(dropped.path);
+}
+
+/**
+ * @description: 检查分区定义，范围分区的分区键必须为INT且上界严格递增，哈希分区的分区键不能为FLOAT
+ * @param {TabMeta&} tab 分区表的元数据
+ * @param {PartitionMeta&} part 分区定义
+ */
+void SmManager::check_partition(const TabMeta& tab, const PartitionMeta& part) {
+    auto col = std::find_if(tab.cols.begin(), tab.cols.end(),
+                            [&](const ColMeta& col) { return col.name == part.col_name; });
+    if (col == tab.cols.end()) {
+        throw ColumnNotFoundError(part.col_name);
+    }
+    if (part.type == PART_RANGE && col->type != TYPE_INT) {
+        throw InvalidPartitionError("range partition key must be INT");
+    }
+    if (part.type == PART_HASH && col->type == TYPE_FLOAT) {
+        throw InvalidPartitionError("hash partition key cannot be FLOAT");
+    }
+    if (part.names.empty()) {
+        throw InvalidPartitionError("at least one partition is required");
+    }
+    for (size_t i = 0; i < part.names.size(); i++) {
+        if (part.get_part_no(part.names[i]) != (int)i) {
+            throw PartitionExistsError(tab.name, part.names[i]);
+        }
+        if (part.type == PART_RANGE && i > 0 && part.bounds[i] <= part.bounds[i - 1]) {
+            throw InvalidPartitionError("partition bounds must be strictly increasing");
+        }
+    }
+}
+
+/**
+ * @description: 为范围分区表增加一个分区，新分区的上界必须大于已有的所有分区
+ * @param {string&} tab_name 表名称
+ * @param {string&} part_name 新分区的名称
+ * @param {long long} bound 新分区的上界（不含），PART_MAXVALUE表示MAXVALUE
+ * @param {Context*} context
+ */
+void SmManager::add_partition(const std::string& tab_name, const std::string& part_name, long long bound,
+                              Context* context) {
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    check_index_build(tab_name);
+    TabMeta &tab = db_.get_table(tab_name);
+    if (tab.part.type != PART_RANGE) {
+        throw InvalidPartitionError(tab_name + " is not range partitioned");
+    }
+    PartitionMeta part = tab.part;
+    part.names.push_back(part_name);
+    part.bounds.push_back(bound);
+    check_partition(tab, part);
+
+    auto file = tab_name + PART_FILE_SEP + part_name;
+    int record_size = tab.get_record_size();
+    rm_manager_->create_file(file, record_size);
+    for (auto &index : tab.indexes) {
+        ix_manager_->create_index(file, index.cols);
+    }
+    tab.part = part;
+
+    flush_meta();
+}
+
+/**
+ * @description: 删除范围分区表的一个分区，分区中的数据随数据文件和索引文件一起删除
+ * 与删除表一样先写TRUNCATE日志，之后重新增加的同名分区不会重做出被删除分区的记录
+ * @param {string&} tab_name 表名称
+ * @param {string&} part_name 分区名称
+ * @param {Context*} context
+ */
+void SmManager::drop_partition(const std::string& tab_name, const std::string& part_name, Context* context) {
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    check_index_build(tab_name);
+    TabMeta &tab = db_.get_table(tab_name);
+    if (tab.part.type != PART_RANGE) {
+        throw InvalidPartitionError(tab_name + " is not range partitioned");
+    }
+    int part_no = tab.part.get_part_no(part_name);
+    if (part_no < 0) {
+        throw PartitionNotFoundError(tab_name + "." + part_name);
+    }
+    if (tab.part.names.size() == 1) {
+        throw InvalidPartitionError("cannot drop the last partition of " + tab_name);
+    }
+    // 直接删除分区文件不会产生删除增量，物化视图无法感知
+    auto views = db_.get_views_on(tab_name);
+    if (!views.empty()) {
+        throw ViewDependencyError(tab_name, views[0]->name);
+    }
+    log_truncate({tab.get_part_file(part_no)}, context);
+    drop_file(tab, tab.get_part_file(part_no));
+    tab.part.names.erase(tab.part.names.begin() + part_no);
+    tab.part.bounds.erase(tab.part.bounds.begin() + part_no);
+
+    flush_meta();
+}
+
+/**
+ * @description: 增加字段，只修改元数据和数据文件头，耗时与表的大小无关
+ * 新字段位于记录末尾，已有页面中的记录保持原来的格式，读出时用默认值补齐新字段，之后新分配的页面使用新格式
+ * 与其他DDL一样不写日志，不能撤销，因此不能在显式事务中执行
+ * @param {string&} tab_name 表的名称
+ * @param {ColDef&} col_def 新字段的定义
+ * @param {Value*} default_val 新字段的默认值，没有默认值时为nullptr，已有记录中的新字段全部为0
+ * @param {Context*} context
+ */
+void SmManager::add_column(const std::string& tab_name, const ColDef& col_def, const Value* default_val,
+                           Context* context) {
+    if (context->txn_ != nullptr && context->txn_->get_txn_mode()) {
+        throw DdlInTransactionError("ALTER TABLE");
+    }
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    if (db_.is_view(tab_name)) {
+        throw ViewReadOnlyError(tab_name);
+    }
+    std::vector<char> defaults(col_def.len, 0);
+    if (default_val != nullptr) {
+        Value val = *default_val;
+        if (col_def.type == TYPE_FLOAT && val.type == TYPE_INT) {
+            val.set_float((float)val.int_val);
+        }
+        if (col_def.type != val.type) {
+            throw IncompatibleTypeError(coltype2str(col_def.type), coltype2str(val.type));
+        }
+        val.init_raw(col_def.len);
+        memcpy(defaults.data(), val.raw->data, col_def.len);
+    }
+    lock_table_exclusive(tab_name, context);
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    check_index_build(tab_name);
+    TabMeta &tab = db_.get_table(tab_name);
+    if (tab.is_col(col_def.name)) {
+        throw ColumnExistsError(col_def.name);
+    }
+    // 上次增加字段时文件头已经写盘而元数据没有写盘，文件中的记录比元数据中的长，新字段放在所有数据文件的记录末尾之后
+    int offset = tab.get_record_size();
+    std::vector<RmFileHandle*> fhs;
+    for (auto &file : tab.get_files()) {
+        auto fh = get_file_handle(file);
+        if (fh->get_file_hdr().num_old_layouts == RM_MAX_OLD_LAYOUTS) {
+            throw InvalidAlterColumnError("too many record formats in " + file + ", run VACUUM first");
+        }
+        offset = std::max(offset, fh->get_file_hdr().record_size);
+        fhs.push_back(fh);
+    }
+    if (offset + col_def.len > RM_MAX_RECORD_SIZE) {
+        throw InvalidRecordSizeError(offset + col_def.len);
+    }
+    // 文件头中的页面个数划定了旧格式页面的范围，写回文件头之前先写回这些页面，重做时它们已经在磁盘上
+    context->log_mgr_->flush_log_to_disk();
+    {
+        std::lock_guard<std::mutex> backup_lock(backup_latch_);
+        for (auto fh : fhs) {
+            // 记录末尾到新字段之间的部分不属于任何字段，默认值为0
+            std::vector<char> tail(offset + col_def.len - fh->get_file_hdr().record_size, 0);
+            memcpy(tail.data() + tail.size() - col_def.len, defaults.data(), col_def.len);
+            buffer_pool_manager_->flush_all_pages(fh->GetFd());
+            fh->add_layout(offset + col_def.len, tail.data());
+            rm_manager_->flush_file_hdr(fh);
+        }
+    }
+    tab.cols.push_back(ColMeta{.tab_name = tab_name,
+                               .name = col_def.name,
+                               .type = col_def.type,
+                               .len = col_def.len,
+                               .offset = offset,
+                               .index = false});
+    stats_.erase(tab_name);
+
+    flush_meta();
+}
+
+/**
+ * @description: 删除字段，只从元数据中隐藏该字段，记录中仍保留它的空间，其他字段的偏移量不变，耗时与表的大小无关
+ * 被索引、分区键或物化视图使用的字段不能删除
+ * @param {string&} tab_name 表的名称
+ * @param {string&} col_name 字段名称
+ * @param {Context*} context
+ */
+void SmManager::drop_column(const std::string& tab_name, const std::string& col_name, Context* context) {
+    if (context->txn_ != nullptr && context->txn_->get_txn_mode()) {
+        throw DdlInTransactionError("ALTER TABLE");
+    }
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    if (db_.is_view(tab_name)) {
+        throw ViewReadOnlyError(tab_name);
+    }
+    auto views = db_.get_views_on(tab_name);
+    if (!views.empty()) {
+        throw ViewDependencyError(tab_name, views[0]->name);
+    }
+    lock_table_exclusive(tab_name, context);
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    check_index_build(tab_name);
+    TabMeta &tab = db_.get_table(tab_name);
+    auto col = tab.get_col(col_name);
+    if (tab.cols.size() == 1) {
+        throw InvalidAlterColumnError("cannot drop the only column of " + tab_name);
+    }
+    if (tab.part.is_partitioned() && tab.part.col_name == col_name) {
+        throw InvalidAlterColumnError(col_name + " is the partition key of " + tab_name);
+    }
+    for (auto &index : tab.indexes) {
+        for (auto &index_col : index.cols) {
+            if (index_col.name == col_name) {
+                throw InvalidAlterColumnError(col_name + " is used by an index, drop the index first");
+            }
+        }
+    }
+    tab.record_size = tab.get_record_size();
+    tab.cols.erase(col);
+    stats_.erase(tab_name);
+
+    flush_meta();
+}
+
+/**
+ * @description: 在线创建索引，创建期间不阻塞表上的DML：先登记正在创建的索引使DML开始记录索引变更，
+ * 再在当前线程中完成快照扫描、批量装载和变更回放，最后只在发布索引时短暂持有元数据排他锁。
+ * 语句本身要等到索引发布后才返回；索引是唯一索引，表中已有重复的key时创建失败
  * @param {string&} tab_name 表的名称
  * @param {vector<string>&} col_names 索引包含的字段名称
  * @param {Context*} context
  */
 void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context) {
-    
+    auto build = std::make_shared<IndexBuild>();
+    {
+        std::unique_lock<std::shared_mutex> lock(meta_latch_);
+        TabMeta &tab = db_.get_table(tab_name);
+        if (tab.is_index(col_names)) {
+            throw IndexExistsError(tab_name, col_names);
+        }
+        for (auto &other : index_builds_) {
+            if (other->index.tab_name == tab_name && ix_manager_->get_index_name(tab_name, other->index.cols) ==
+                                                         ix_manager_->get_index_name(tab_name, col_names)) {
+                throw IndexExistsError(tab_name, col_names);
+            }
+        }
+        build->index.tab_name = tab_name;
+        build->index.col_tot_len = 0;
+        build->index.col_num = col_names.size();
+        for (auto &col_name : col_names) {
+            auto col = tab.get_col(col_name);
+            build->index.cols.push_back(*col);
+            build->index.col_tot_len += col->len;
+        }
+        // 注册之后DML对该表的修改都会记入build->changes
+        index_builds_.push_back(build);
+    }
+
+    std::exception_ptr error;
+    try {
+        build_index(*build, context);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // 在元数据锁下回放剩余的变更并发布索引，此后DML直接维护新索引
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    index_builds_.erase(std::find(index_builds_.begin(), index_builds_.end(), build));
+    if (error == nullptr) {
+        try {
+            replay_index_changes(*build, build->changes);
+            check_duplicates(*build, context);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    if (error != nullptr) {
+        for (auto &entry : build->ihs) {
+            ix_manager_->close_index(entry.second.get());
+            ix_manager_->destroy_index(entry.first, build->index.cols);
+        }
+        std::rethrow_exception(error);
+    }
+    TabMeta &tab = db_.get_table(tab_name);
+    {
+        std::lock_guard<std::mutex> handle_lock(handle_latch_);
+        for (auto &entry : build->ihs) {
+            ihs_.emplace(ix_manager_->get_index_name(entry.first, build->index.cols), std::move(entry.second));
+        }
+    }
+    for (auto &col : build->index.cols) {
+        tab.get_col(col.name)->index = true;
+    }
+    tab.indexes.push_back(build->index);
+
+    flush_meta();
+}
+
+/**
+ * @description: 创建索引：对每个数据文件做一次快照扫描，排序后批量装载到新的索引文件中，
+ * 再分批回放扫描期间DML记录的索引变更，剩余变更足够少时返回，由调用者在元数据锁下完成最后的回放
+ * @param {IndexBuild&} build 正在创建的索引
+ * @param {Context*} context
+ */
+void SmManager::build_index(IndexBuild& build, Context* context) {
+    auto &index = build.index;
+    std::vector<std::pair<std::string, RmFileHandle*>> files;
+    {
+        std::shared_lock<std::shared_mutex> lock(meta_latch_);
+        for (auto &file : db_.get_table(index.tab_name).get_files()) {
+            files.emplace_back(file, get_file_handle(file));
+        }
+    }
+
+    for (auto &[file, fh] : files) {
+        ix_manager_->create_index(file, index.cols);
+        build.ihs.emplace(file, ix_manager_->open_index(file, index.cols));
+        // 相同的key中扫描时没有先遇到的记录可能是扫描期间被删除的，留到发布前检查
+        load_index(fh, index, build.ihs.at(file).get(), context, [&](const char *key, const Rid &rid) {
+            build.duplicates.push_back({.is_insert = true,
+                                        .file = file,
+                                        .key = std::vector<char>(key, key + index.col_tot_len),
+                                        .rid = rid});
+        });
+    }
+
+    while (true) {
+        std::vector<IndexChange> changes;
+        {
+            std::lock_guard<std::mutex> lock(build.latch);
+            if (build.changes.size() <= (size_t)INDEX_BUILD_BATCH) {
+                break;
+            }
+            changes.swap(build.changes);
+        }
+        replay_index_changes(build, changes);
+    }
+}
+
+/**
+ * @description: 扫描数据文件生成索引键，按key排序后批量装载到空的索引中，相同的key只装载扫描时先遇到的一条
+ * @param {RmFileHandle*} fh 数据文件句柄
+ * @param {IndexMeta&} index 要装载的索引
+ * @param {IxIndexHandle*} ih 新建的空索引
+ * @param {Context*} context
+ * @param {function<void(const char*, const Rid&)>&} on_duplicate 处理没有装载的重复key及其记录
+ */
+void SmManager::load_index(RmFileHandle* fh, const IndexMeta& index, IxIndexHandle* ih, Context* context,
+                           const std::function<void(const char*, const Rid&)>& on_duplicate) {
+    std::vector<ColType> col_types;
+    std::vector<int> col_lens;
+    for (auto &col : index.cols) {
+        col_types.push_back(col.type);
+        col_lens.push_back(col.len);
+    }
+    std::vector<char> keys;
+    std::vector<Rid> rids;
+    for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+        auto rec = fh->get_record(scan.rid(), context);
+        keys.resize(keys.size() + index.col_tot_len);
+        char *key = keys.data() + keys.size() - index.col_tot_len;
+        for (auto &col : index.cols) {
+            memcpy(key, rec->data + col.offset, col.len);
+            key += col.len;
+        }
+        rids.push_back(scan.rid());
+        if (rids.size() % INDEX_BUILD_BATCH == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    auto key_at = [&](int i) { return keys.data() + (size_t)i * index.col_tot_len; };
+    std::vector<int> order(rids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return ix_compare(key_at(a), key_at(b), col_types, col_lens) < 0; });
+    std::vector<char> sorted_keys;
+    std::vector<Rid> sorted_rids;
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i > 0 && ix_compare(key_at(order[i]), key_at(order[i - 1]), col_types, col_lens) == 0) {
+            on_duplicate(key_at(order[i]), rids[order[i]]);
+            continue;
+        }
+        sorted_keys.insert(sorted_keys.end(), key_at(order[i]), key_at(order[i]) + index.col_tot_len);
+        sorted_rids.push_back(rids[order[i]]);
+    }
+    ih->bulk_load(sorted_keys.data(), sorted_rids.data(), sorted_rids.size());
+}
+
+/**
+ * @description: 按数据文件的内容重建其上的所有索引，用于故障恢复，调用者保证没有其他线程访问该数据文件
+ * 索引的修改不单独写日志，故障时B+树的结点可能只有一部分写了盘，逻辑重做无法修复结构不完整的树，因此丢弃旧的索引文件重新装载
+ * @param {string&} file 数据文件名
+ */
+void SmManager::rebuild_indexes(const std::string& file) {
+    auto tab_name = file_tab_name(file);
+    if (!db_.is_table(tab_name)) {
+        return;
+    }
+    TabMeta &tab = db_.get_table(tab_name);
+    auto fh = get_file_handle(file);
+    for (auto &index : tab.indexes) {
+        auto ix_name = ix_manager_->get_index_name(file, index.cols);
+        {
+            std::lock_guard<std::mutex> lock(handle_latch_);
+            int fd = -1;
+            auto ih = ihs_.find(ix_name);
+            if (ih != ihs_.end()) {
+                fd = ih->second->get_fd();
+                ihs_.erase(ih);
+            }
+            detach_file(ix_name, fd);
+        }
+        ix_manager_->create_index(file, index.cols);
+        auto ih = ix_manager_->open_index(file, index.cols);
+        load_index(fh, index, ih.get(), nullptr, [](const char *, const Rid &) {});
+        std::lock_guard<std::mutex> lock(handle_latch_);
+        ihs_.emplace(ix_name, std::move(ih));
+    }
+}
+
+/**
+ * @description: 按记录顺序把DML产生的索引变更回放到正在创建的索引上
+ * 快照扫描可能已经看到了某次变更的结果，因此回放是幂等的：删除只删除指向同一条记录的索引项，
+ * 插入时key已经指向另一条记录的变更记入build.duplicates，发布前再根据表的最终内容检查
+ * @param {IndexBuild&} build 正在创建的索引
+ * @param {vector<IndexChange>&} changes 待回放的变更，回放后清空
+ */
+void SmManager::replay_index_changes(IndexBuild& build, std::vector<IndexChange>& changes) {
+    for (auto &change : changes) {
+        auto ih = build.ihs.at(change.file).get();
+        std::vector<Rid> result;
+        bool exists = ih->get_value(change.key.data(), &result, nullptr);
+        if (!change.is_insert) {
+            if (exists && result[0] == change.rid) {
+                ih->delete_entry(change.key.data(), nullptr);
+            }
+        } else if (!exists) {
+            ih->insert_entry(change.key.data(), change.rid, nullptr);
+        } else if (result[0] != change.rid) {
+            build.duplicates.push_back(std::move(change));
+        }
+    }
+    changes.clear();
+}
+
+/**
+ * @description: 发布索引之前检查没有装入索引的重复key，调用者持有meta_latch_的排他锁，表上没有正在执行的DML
+ * 重复项指向的记录已经删除或者key已经改变时忽略它；索引项指向的记录已经失效时改为指向重复项；
+ * 两条记录的key都仍然相同时，表中存在重复的key，不能创建唯一索引
+ * @param {IndexBuild&} build 正在创建的索引
+ * @param {Context*} context
+ */
+void SmManager::check_duplicates(IndexBuild& build, Context* context) {
+    // 判断rid上是否存在一条key与索引项相同的记录
+    auto has_key = [&](const IndexChange &entry, const Rid &rid) {
+        auto fh = get_file_handle(entry.file);
+        if (rid.page_no >= fh->get_file_hdr().num_pages || !fh->is_record(rid)) {
+            return false;
+        }
+        auto rec = fh->get_record(rid, context);
+        int offset = 0;
+        for (auto &col : build.index.cols) {
+            if (memcmp(rec->data + col.offset, entry.key.data() + offset, col.len) != 0) {
+                return false;
+            }
+            offset += col.len;
+        }
+        return true;
+    };
+    for (auto &dup : build.duplicates) {
+        if (!has_key(dup, dup.rid)) {
+            continue;
+        }
+        auto ih = build.ihs.at(dup.file).get();
+        std::vector<Rid> result;
+        if (!ih->get_value(dup.key.data(), &result, nullptr)) {
+            ih->insert_entry(dup.key.data(), dup.rid, nullptr);
+        } else if (result[0] != dup.rid) {
+            if (has_key(dup, result[0])) {
+                std::vector<std::string> col_names;
+                for (auto &col : build.index.cols) {
+                    col_names.push_back(col.name);
+                }
+                throw IndexDuplicateKeyError(build.index.tab_name, col_names);
+            }
+            ih->delete_entry(dup.key.data(), nullptr);
+            ih->insert_entry(dup.key.data(), dup.rid, nullptr);
+        }
+    }
+    build.duplicates.clear();
+}
+
+/**
+ * @description: 把数据文件上的一次插入或删除记入该表上所有正在创建的索引，更新拆分为删除旧值和插入新值
+ * 调用者需要持有meta_latch_的共享锁
+ * @param {string&} file 数据文件名
+ * @param {char*} rec 插入的新记录或删除的旧记录
+ * @param {Rid&} rid 记录的位置
+ * @param {bool} is_insert 是否为插入
+ */
+void SmManager::record_index_change(const std::string& file, const char* rec, const Rid& rid, bool is_insert) {
+    auto tab_name = file_tab_name(file);
+    for (auto &build : index_builds_) {
+        if (build->index.tab_name != tab_name) {
+            continue;
+        }
+        IndexChange change = {.is_insert = is_insert, .file = file, .key = {}, .rid = rid};
+        for (auto &col : build->index.cols) {
+            change.key.insert(change.key.end(), rec + col.offset, rec + col.offset + col.len);
+        }
+        std::lock_guard<std::mutex> lock(build->latch);
+        build->changes.push_back(std::move(change));
+    }
+}
+
+/**
+ * @description: 表上有正在创建的索引时，不能删除表或增删分区，调用者需要持有meta_latch_的排他锁
+ * @param {string&} tab_name 表名称
+ */
+void SmManager::check_index_build(const std::string& tab_name) {
+    for (auto &build : index_builds_) {
+        if (build->index.tab_name == tab_name) {
+            throw IndexBuildInProgressError(tab_name);
+        }
+    }
 }
 
 /**
@@ -219,4 +1236,372 @@ void SmManager::drop_index(const std::string& tab_name, const std::vector<std::s
  */
 void SmManager::drop_index(const std::string& tab_name, const std::vector<ColMeta>& cols, Context* context) {
     
-}
\ No newline at end of file
+}
+
+/**
+ * @description: 创建物化视图，视图数据存放在与视图同名的普通表中，创建后立即根据基表计算视图内容
+ * @param {ViewMeta&} view 经过语义分析的视图定义
+ * @param {Context*} context
+ */
+void SmManager::create_view(const ViewMeta& view, Context* context) {
+    if (db_.is_table(view.name)) {
+        throw TableExistsError(view.name);
+    }
+    // 根据视图的输出列生成视图表的字段，不同基表中的同名字段以"表名_字段名"区分
+    std::vector<ColDef> col_defs;
+    for (auto &view_col : view.cols) {
+        if (view_col.agg == VIEW_AGG_COUNT) {
+            col_defs.push_back({.name = "count_all", .type = TYPE_INT, .len = sizeof(int)});
+            continue;
+        }
+        auto src = db_.get_table(view_col.src.tab_name).get_col(view_col.src.col_name);
+        if (view_col.agg == VIEW_AGG_SUM) {
+            col_defs.push_back({.name = "sum_" + src->name, .type = src->type, .len = src->len});
+            continue;
+        }
+        int same_name = std::count_if(view.cols.begin(), view.cols.end(), [&](const ViewCol &col) {
+            return col.agg == VIEW_AGG_NONE && col.src.col_name == view_col.src.col_name;
+        });
+        std::string name = same_name > 1 ? src->tab_name + "_" + src->name : src->name;
+        col_defs.push_back({.name = name, .type = src->type, .len = src->len});
+    }
+    create_table(view.name, col_defs, context, PartitionMeta(), view.lineage_len());
+    {
+        // 视图表为空，直接建立用于定位视图元组的索引
+        std::unique_lock<std::shared_mutex> lock(meta_latch_);
+        TabMeta &view_tab = db_.get_table(view.name);
+        for (auto &index : ViewMaintainer::view_indexes(view, view_tab)) {
+            ix_manager_->create_index(view.name, index.cols);
+            for (auto &col : index.cols) {
+                if (view_tab.is_col(col.name)) {
+                    view_tab.get_col(col.name)->index = true;
+                }
+            }
+            view_tab.indexes.push_back(index);
+        }
+        db_.views_[view.name] = view;
+        flush_meta();
+    }
+
+    view_maintainer_->populate(db_.views_[view.name], context);
+}
+
+/**
+ * @description: 删除物化视图及其数据表
+ * @param {string&} view_name 视图名称
+ * @param {Context*} context
+ */
+void SmManager::drop_view(const std::string& view_name, Context* context) {
+    db_.get_view(view_name);
+    db_.views_.erase(view_name);
+    drop_table(view_name, context);
+}
+
+/**
+ * @description: 创建存储过程，过程体已经由分析器检查过
+ * @param {ProcMeta&} proc 存储过程定义
+ * @param {Context*} context
+ */
+void SmManager::create_procedure(const ProcMeta& proc, Context* context) {
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    if (db_.is_proc(proc.name)) {
+        throw ProcedureExistsError(proc.name);
+    }
+    db_.procs_[proc.name] = proc;
+    flush_meta();
+}
+
+/**
+ * @description: 删除存储过程
+ * @param {string&} proc_name 存储过程名称
+ * @param {Context*} context
+ */
+void SmManager::drop_procedure(const std::string& proc_name, Context* context) {
+    std::unique_lock<std::shared_mutex> lock(meta_latch_);
+    db_.get_proc(proc_name);
+    db_.procs_.erase(proc_name);
+    flush_meta();
+}
+
+/**
+ * @description: 在线备份数据库，不阻塞DML，DDL等待备份结束
+ * 先确定备份需要的日志起点，再经缓冲池逐页复制表和索引文件，最后复制从起点到当前日志末尾的日志
+ * 复制期间页面仍在被修改，备份中的页面是一个模糊快照，起点之后的修改都在备份的日志中
+ * 备份目录本身就是一个数据库目录，以它启动数据库即为恢复：重做备份中的日志使页面一致，重建重做过的数据文件上的索引，
+ * 并回滚备份结束时未完成的事务
+ * @param {string&} path 备份目录，不能已经存在，相对路径相对于数据库目录所在的目录
+ * @param {Context*} context
+ */
+void SmManager::backup(const std::string& path, Context* context) {
+    // 当前工作目录是数据库目录
+    std::string dir = path[0] == '/' ? path : "../" + path;
+    if (is_dir(dir)) {
+        throw DatabaseExistsError(path);
+    }
+    std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+    std::lock_guard<std::mutex> backup_lock(backup_latch_);
+    LogManager* log_manager = context->log_mgr_;
+    int64_t log_begin = log_manager->begin_backup();
+    try {
+        if (mkdir(dir.c_str(), 0755) < 0) {
+            throw UnixError();
+        }
+        {
+            std::ofstream ofs(dir + "/" + DB_META_NAME);
+            ofs << db_;
+        }
+        // 按backup_rate_kb_限制复制页面的速率，超前时等待
+        auto start = std::chrono::steady_clock::now();
+        int64_t copied = 0;
+        auto throttle = [&] {
+            copied += PAGE_SIZE;
+            int rate = backup_rate_kb_;
+            if (rate > 0) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(copied * 1000000 / ((int64_t)rate * 1024)));
+            }
+        };
+        for (auto &[tab_name, tab] : db_.tabs_) {
+            for (auto &file : tab.get_files()) {
+                // 文件头只在内存中维护，复制内存中的文件头，之后追加的页面由恢复时重做日志创建
+                auto fh = get_file_handle(file);
+                RmFileHdr hdr = fh->get_file_hdr();
+                backup_file(dir + "/" + file, fh->GetFd(), (char *)&hdr, sizeof(hdr), hdr.num_pages, throttle);
+                for (auto &index : tab.indexes) {
+                    // 复制期间被修改的索引所在的数据文件在起点之后一定有日志，恢复时重做该文件并重建其上的索引，
+                    // 因此索引同样逐页复制，每复制一页只短暂持有root_latch_，得到完整的页面而不阻塞对索引的修改
+                    auto ih = get_index_handle(file, index.cols);
+                    std::vector<char> ix_hdr;
+                    int num_pages;
+                    {
+                        std::lock_guard<std::mutex> lock(ih->get_root_latch());
+                        IxFileHdr *file_hdr = ih->get_file_hdr();
+                        ix_hdr.resize(file_hdr->tot_len_);
+                        file_hdr->serialize(ix_hdr.data());
+                        num_pages = file_hdr->num_pages_;
+                    }
+                    backup_file(dir + "/" + ix_manager_->get_index_name(file, index.cols), ih->get_fd(), ix_hdr.data(),
+                                ix_hdr.size(), num_pages, throttle, &ih->get_root_latch());
+                }
+            }
+        }
+        log_manager->flush_log_to_disk();
+        disk_manager_->backup_log(dir, log_begin, log_manager->get_lsn_at(log_begin), disk_manager_->get_log_end());
+    } catch (...) {
+        log_manager->end_backup();
+        throw;
+    }
+    log_manager->end_backup();
+}
+
+/**
+ * @description: 把一个文件的页面经缓冲池复制到备份文件中，第0页为调用者给出的文件头
+ * @param {string&} dest 备份文件的路径
+ * @param {int} fd 被复制的文件
+ * @param {char*} hdr 文件头
+ * @param {int} hdr_len 文件头的长度
+ * @param {int} num_pages 复制的页面数量
+ * @param {function<void()>&} throttle 每复制一页调用一次，用于限速
+ * @param {mutex*} latch 不为nullptr时在它的保护下复制每一页，写备份文件和限速等待时不持有
+ */
+void SmManager::backup_file(const std::string& dest, int fd, const char* hdr, int hdr_len, int num_pages,
+                            const std::function<void()>& throttle, std::mutex* latch) {
+    int dest_fd = open(dest.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0666);
+    if (dest_fd < 0) {
+        throw UnixError();
+    }
+    bool ok = pwrite(dest_fd, hdr, hdr_len, 0) == hdr_len;
+    std::vector<char> buf(PAGE_SIZE);
+    for (int page_no = 1; ok && page_no < num_pages; page_no++) {
+        PageId page_id = {.fd = fd, .page_no = page_no};
+        {
+            std::unique_lock<std::mutex> lock;
+            if (latch != nullptr) {
+                lock = std::unique_lock<std::mutex>(*latch);
+            }
+            Page* page = buffer_pool_manager_->fetch_page(page_id);
+            if (page == nullptr) {
+                close(dest_fd);
+                throw InternalError("Buffer pool is full");
+            }
+            memcpy(buf.data(), page->get_data(), PAGE_SIZE);
+            buffer_pool_manager_->unpin_page(page_id, false);
+        }
+        ok = pwrite(dest_fd, buf.data(), PAGE_SIZE, (off_t)page_no * PAGE_SIZE) == PAGE_SIZE;
+        throttle();
+    }
+    if (!ok || fsync(dest_fd) < 0) {
+        close(dest_fd);
+        throw UnixError();
+    }
+    close(dest_fd);
+}
+
+/**
+ * @description: 整理表的数据文件，把文件末尾页面中的记录移动到前面页面的空闲槽位中，再截断末尾不再有记录的页面
+ * 期间持有表上的排他锁，只阻塞对该表的访问；每次移动写一条只重做的MOVE日志，移动不改变记录的内容，不需要撤销
+ * 截断前先写SHRINK日志并刷盘，故障后按日志顺序重做移动和截断
+ * 截断不能撤销，因此不能在显式事务中执行
+ * 增加字段之后，旧格式页面中的记录同样移到当前格式的页面中，下一次VACUUM把清空的旧格式页面改为当前格式
+ * @param {string&} tab_name 表的名称
+ * @param {Context*} context
+ */
+void SmManager::vacuum(const std::string& tab_name, Context* context) {
+    if (context->txn_ == nullptr) {
+        throw InternalError("VACUUM requires a transaction");
+    }
+    if (context->txn_->get_txn_mode()) {
+        throw DdlInTransactionError("VACUUM");
+    }
+    lock_table_exclusive(tab_name, context);
+    // 表上其他事务都已经结束，提前释放锁的事务的COMMIT日志也在日志缓冲区中，写盘之后被移动的记录不会再被撤销
+    context->log_mgr_->flush_log_to_disk();
+    std::shared_lock<std::shared_mutex> meta_lock(meta_latch_);
+    if (!db_.is_table(tab_name)) {
+        throw TableNotFoundError(tab_name);
+    }
+    // 整理会移动记录，物化视图中保存的血缘会失效
+    auto views = db_.get_views_on(tab_name);
+    if (!views.empty()) {
+        throw ViewDependencyError(tab_name, views[0]->name);
+    }
+    TabMeta &tab = db_.get_table(tab_name);
+    std::vector<std::pair<std::string, int>> files;
+    for (auto &file : tab.get_files()) {
+        auto fh = get_file_handle(file);
+        reformat_file(fh, context);
+        files.emplace_back(file, vacuum_file(file, fh, tab.indexes, context));
+    }
+    for (auto &[file, num_pages] : files) {
+        ShrinkLogRecord shrink_log(context->txn_->get_transaction_id(), file, num_pages);
+        context->log_mgr_->add_txn_log(context->txn_, &shrink_log);
+    }
+    context->log_mgr_->flush_log_to_disk();
+    std::lock_guard<std::mutex> backup_lock(backup_latch_);
+    for (auto &[file, num_pages] : files) {
+        get_file_handle(file)->truncate(num_pages);
+    }
+}
+
+/**
+ * @description: 旧格式的页面都已经清空时把它们改为当前格式，之后这些页面可以重新存放记录
+ * 清空这些页面的事务都已经结束，先把日志写盘，保证故障后这些事务不会被当作未完成事务撤销而把记录移回旧格式的槽位；
+ * 再把清零的页面写盘，最后写文件头，任何时刻故障，磁盘上的这些页面都是空页面
+ * @param {RmFileHandle*} fh 数据文件句柄，调用者持有表上的排他锁
+ * @param {Context*} context
+ */
+void SmManager::reformat_file(RmFileHandle* fh, Context* context) {
+    if (fh->get_file_hdr().num_old_layouts == 0) {
+        return;
+    }
+    context->log_mgr_->flush_log_to_disk();
+    std::lock_guard<std::mutex> backup_lock(backup_latch_);
+    if (fh->reformat_old_pages()) {
+        buffer_pool_manager_->flush_all_pages(fh->GetFd());
+        rm_manager_->flush_file_hdr(fh);
+    }
+}
+
+/**
+ * @description: 整理一个数据文件，当前格式的页面从前向后寻找有空闲槽位的页面，从后向前寻找有记录的页面，两者相遇时停止；
+ * 之后把旧格式页面中的记录移到当前格式页面的空闲槽位中，当前格式的页面都已满时在文件末尾分配新页面
+ * @param {string&} file 数据文件名
+ * @param {RmFileHandle*} fh 数据文件句柄
+ * @param {vector<IndexMeta>&} indexes 表上的索引
+ * @param {Context*} context
+ * @return {int} 整理后文件需要保留的页面个数
+ */
+int SmManager::vacuum_file(const std::string& file, RmFileHandle* fh, const std::vector<IndexMeta>& indexes,
+                           Context* context) {
+    int num_records_per_page = fh->get_file_hdr().num_records_per_page;
+    int first_current = fh->get_file_hdr().first_current_page();
+    // 在[dst, end)中寻找当前格式页面的空闲槽位，dst之前的页面都已满
+    int dst = first_current;
+    auto find_free_slot = [&](int end) {
+        for (; dst < end; dst++) {
+            RmPageHandle dst_page = fh->fetch_page_handle(dst);
+            int dst_slot = Bitmap::first_bit(false, dst_page.bitmap, num_records_per_page);
+            buffer_pool_manager_->unpin_page(dst_page.page->get_page_id(), false);
+            if (dst_slot < num_records_per_page) {
+                return dst_slot;
+            }
+        }
+        return num_records_per_page;
+    };
+    int src = fh->get_file_hdr().num_pages - 1;
+    while (src >= first_current) {
+        RmPageHandle src_page = fh->fetch_page_handle(src);
+        int src_slot = Bitmap::first_bit(true, src_page.bitmap, num_records_per_page);
+        buffer_pool_manager_->unpin_page(src_page.page->get_page_id(), false);
+        if (src_slot == num_records_per_page) {
+            src--;
+            continue;
+        }
+        int dst_slot = find_free_slot(src);
+        if (dst >= src) {
+            break;
+        }
+        move_record(file, fh, indexes, Rid{src, src_slot}, Rid{dst, dst_slot}, context);
+    }
+    int num_pages = std::max(src + 1, first_current);
+    for (src = RM_FIRST_RECORD_PAGE; src < first_current; src++) {
+        while (true) {
+            RmPageHandle src_page = fh->fetch_page_handle(src);
+            int capacity = src_page.layout.num_records_per_page;
+            int src_slot = Bitmap::first_bit(true, src_page.bitmap, capacity);
+            buffer_pool_manager_->unpin_page(src_page.page->get_page_id(), false);
+            if (src_slot == capacity) {
+                break;
+            }
+            int dst_slot = find_free_slot(fh->get_file_hdr().num_pages);
+            if (dst_slot == num_records_per_page) {
+                RmPageHandle dst_page = fh->create_new_page_handle();
+                dst = dst_page.page->get_page_id().page_no;
+                dst_slot = 0;
+                buffer_pool_manager_->unpin_page(dst_page.page->get_page_id(), true);
+            }
+            move_record(file, fh, indexes, Rid{src, src_slot}, Rid{dst, dst_slot}, context);
+            num_pages = std::max(num_pages, dst + 1);
+        }
+    }
+    return num_pages;
+}
+
+/**
+ * @description: 把一条记录从src移动到dst，同时修改索引项，记录的内容不变，物化视图不需要维护
+ * 插入和删除写在同一条MOVE日志中，记录的行锁字随记录移动
+ * @param {string&} file 数据文件名
+ * @param {RmFileHandle*} fh 数据文件句柄
+ * @param {vector<IndexMeta>&} indexes 表上的索引
+ * @param {Rid&} src 记录原来的位置
+ * @param {Rid&} dst 记录移动到的空闲槽位
+ * @param {Context*} context
+ */
+void SmManager::move_record(const std::string& file, RmFileHandle* fh, const std::vector<IndexMeta>& indexes,
+                            const Rid& src, const Rid& dst, Context* context) {
+    auto rec = fh->get_record(src, context);
+    // 两个数据页面都固定到写完日志并记入page lsn之后，修改索引在写日志之后
+    Page *dst_page = fh->pin_page(dst.page_no);
+    Page *src_page = fh->pin_page(src.page_no);
+    fh->insert_record(dst, rec->data);
+    fh->delete_record(src, context);
+    fh->move_lock_word(src, dst);
+    MoveLogRecord move_log(context->txn_->get_transaction_id(), *rec, src, dst, file);
+    lsn_t lsn = context->log_mgr_->add_txn_log(context->txn_, &move_log);
+    fh->set_page_lsn(dst.page_no, lsn);
+    fh->set_page_lsn(src.page_no, lsn);
+    fh->unpin_page(src_page);
+    fh->unpin_page(dst_page);
+    for (auto &index : indexes) {
+        auto ih = get_index_handle(file, index.cols);
+        std::vector<char> key(index.col_tot_len);
+        int offset = 0;
+        for (auto &col : index.cols) {
+            memcpy(key.data() + offset, rec->data + col.offset, col.len);
+            offset += col.len;
+        }
+        ih->delete_entry(key.data(), context->txn_);
+        ih->insert_entry(key.data(), dst, context->txn_);
+    }
+    record_index_change(file, rec->data, src, false);
+    record_index_change(file, rec->data, dst, true);
+}
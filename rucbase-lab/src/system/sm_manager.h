@@ -10,10 +10,20 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
 #include "index/ix.h"
 #include "record/rm_file_handle.h"
 #include "sm_defs.h"
 #include "sm_meta.h"
+#include "sm_stats.h"
+#include "sm_view.h"
 #include "common/context.h"
 
 class Context;
@@ -24,17 +34,55 @@ struct ColDef {
     int len;           // Length of column
 };
 
+/* 在线创建索引期间DML对该表产生的一次索引变更 */
+struct IndexChange {
+    bool is_insert;             // true为插入索引项，false为删除索引项
+    std::string file;           // 变更所在的数据文件名
+    std::vector<char> key;      // 按正在创建的索引拼接好的key
+    Rid rid;
+};
+
+/* 一个正在在线创建的索引，快照扫描开始后DML产生的变更记入changes，由执行CREATE INDEX的线程回放 */
+struct IndexBuild {
+    IndexMeta index;                                                // 正在创建的索引
+    std::mutex latch;                                               // 保护changes
+    std::vector<IndexChange> changes;                               // 尚未回放的索引变更
+    std::vector<IndexChange> duplicates;                            // key已经指向其他记录、发布前需要检查的插入
+    std::unordered_map<std::string, std::unique_ptr<IxIndexHandle>> ihs;  // index name -> 已创建的索引文件
+};
+
+/* 一个等待后台删除的文件，已经改名并且不再属于任何表 */
+struct DroppedFile {
+    std::string path;   // 改名后的文件名
+    int fd;             // 删除时已经打开的文件句柄，没有打开时为-1
+};
+
 /* 系统管理器，负责元数据管理和DDL语句的执行 */
 class SmManager {
    public:
     DbMeta db_;             // 当前打开的数据库的元数据
-    std::unordered_map<std::string, std::unique_ptr<RmFileHandle>> fhs_;    // file name -> record file handle, 当前数据库中每张表的数据文件
-    std::unordered_map<std::string, std::unique_ptr<IxIndexHandle>> ihs_;   // file name -> index file handle, 当前数据库中每个索引的文件
+    // 元数据锁：DML算子执行期间持有共享锁，发布新索引等需要修改表上索引集合的操作持有排他锁
+    std::shared_mutex meta_latch_;
    private:
+    // 表和索引文件在第一次访问时才打开，打开后一直保留到删除或关闭数据库，文件头缓存在句柄中
+    std::unordered_map<std::string, std::unique_ptr<RmFileHandle>> fhs_;    // file name -> record file handle, 已经打开的数据文件
+    std::unordered_map<std::string, std::unique_ptr<IxIndexHandle>> ihs_;   // file name -> index file handle, 已经打开的索引文件
+    std::mutex handle_latch_;   // 保护fhs_和ihs_，持有meta_latch_时可以再获取它
     DiskManager* disk_manager_;
     BufferPoolManager* buffer_pool_manager_;
     RmManager* rm_manager_;
     IxManager* ix_manager_;
+    std::unique_ptr<ViewMaintainer> view_maintainer_;   // 物化视图的增量维护器
+    std::vector<std::shared_ptr<IndexBuild>> index_builds_;  // 正在在线创建的索引，由meta_latch_保护
+    StatsStore stats_;                                  // 执行时观测到的行数统计
+    std::atomic<int> backup_rate_kb_{BACKUP_RATE_KB};   // 在线备份复制页面的速率上限，单位KB/s，0表示不限速
+    std::mutex backup_latch_;   // 在线备份期间持有，VACUUM截断文件前获取，备份正在复制的页面不会被截断
+    int dropped_seq_ = 0;                       // 下一个被删除的文件改名时使用的序号，由handle_latch_保护
+    std::deque<DroppedFile> dropped_files_;     // 等待后台删除的文件
+    std::mutex purge_latch_;                    // 保护dropped_files_和stop_purger_
+    std::condition_variable purge_cv_;
+    std::thread purger_;                        // 后台删除文件的线程，打开数据库时启动，关闭数据库时删除完剩余的文件后退出
+    bool stop_purger_ = false;
 
    public:
     SmManager(DiskManager* disk_manager, BufferPoolManager* buffer_pool_manager, RmManager* rm_manager,
@@ -42,9 +90,10 @@ class SmManager {
         : disk_manager_(disk_manager),
           buffer_pool_manager_(buffer_pool_manager),
           rm_manager_(rm_manager),
-          ix_manager_(ix_manager) {}
+          ix_manager_(ix_manager),
+          view_maintainer_(std::make_unique<ViewMaintainer>(this)) {}
 
-    ~SmManager() {}
+    ~SmManager() { stop_purger(); }
 
     BufferPoolManager* get_bpm() { return buffer_pool_manager_; }
 
@@ -52,6 +101,16 @@ class SmManager {
 
     IxManager* get_ix_manager() { return ix_manager_; }  
 
+    ViewMaintainer* get_view_maintainer() { return view_maintainer_.get(); }
+
+    StatsStore* get_stats() { return &stats_; }
+
+    void set_backup_rate(int rate_kb) { backup_rate_kb_ = rate_kb; }
+
+    RmFileHandle* get_file_handle(const std::string& file);
+
+    IxIndexHandle* get_index_handle(const std::string& file, const std::vector<ColMeta>& index_cols);
+
     bool is_dir(const std::string& db_name);
 
     void create_db(const std::string& db_name);
@@ -64,17 +123,98 @@ class SmManager {
 
     void flush_meta();
 
+    void flush_all_pages();
+
+    void save_warm_list();
+
+    void warm_up();
+
     void show_tables(Context* context);
 
     void desc_table(const std::string& tab_name, Context* context);
 
-    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context);
+    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                      const PartitionMeta& part = PartitionMeta(), int hidden_len = 0);
 
     void drop_table(const std::string& tab_name, Context* context);
 
+    void truncate_table(const std::string& tab_name, Context* context);
+
+    void reset_file(const std::string& file);
+
+    void rebuild_indexes(const std::string& file);
+
     void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
 
     void drop_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
     
     void drop_index(const std::string& tab_name, const std::vector<ColMeta>& col_names, Context* context);
+
+    void add_partition(const std::string& tab_name, const std::string& part_name, long long bound, Context* context);
+
+    void drop_partition(const std::string& tab_name, const std::string& part_name, Context* context);
+
+    void add_column(const std::string& tab_name, const ColDef& col_def, const Value* default_val, Context* context);
+
+    void drop_column(const std::string& tab_name, const std::string& col_name, Context* context);
+
+    std::shared_lock<std::shared_mutex> lock_file_for_write(const std::string& file, Context* context);
+
+    void record_index_change(const std::string& file, const char* rec, const Rid& rid, bool is_insert);
+
+    void create_view(const ViewMeta& view, Context* context);
+
+    void drop_view(const std::string& view_name, Context* context);
+
+    void create_procedure(const ProcMeta& proc, Context* context);
+
+    void drop_procedure(const std::string& proc_name, Context* context);
+
+    void backup(const std::string& path, Context* context);
+
+    void vacuum(const std::string& tab_name, Context* context);
+
+   private:
+    std::vector<std::pair<std::string, RmFileHandle*>> get_open_files();
+
+    std::vector<std::pair<std::string, IxIndexHandle*>> get_open_indexes();
+
+    void log_truncate(const std::vector<std::string>& files, Context* context);
+
+    void drop_file(const TabMeta& tab, const std::string& file);
+
+    void detach_file(const std::string& path, int fd);
+
+    void lock_table_exclusive(const std::string& tab_name, Context* context);
+
+    void start_purger();
+
+    void stop_purger();
+
+    void purge_file(const DroppedFile& dropped);
+
+    void check_partition(const TabMeta& tab, const PartitionMeta& part);
+
+    void check_index_build(const std::string& tab_name);
+
+    void build_index(IndexBuild& build, Context* context);
+
+    void load_index(RmFileHandle* fh, const IndexMeta& index, IxIndexHandle* ih, Context* context,
+                    const std::function<void(const char*, const Rid&)>& on_duplicate);
+
+    void replay_index_changes(IndexBuild& build, std::vector<IndexChange>& changes);
+
+    void check_duplicates(IndexBuild& build, Context* context);
+
+    bool warm_up_batch(const std::vector<std::pair<std::string, page_id_t>>& batch);
+
+    void backup_file(const std::string& dest, int fd, const char* hdr, int hdr_len, int num_pages,
+                     const std::function<void()>& throttle, std::mutex* latch = nullptr);
+
+    void reformat_file(RmFileHandle* fh, Context* context);
+
+    int vacuum_file(const std::string& file, RmFileHandle* fh, const std::vector<IndexMeta>& indexes, Context* context);
+
+    void move_record(const std::string& file, RmFileHandle* fh, const std::vector<IndexMeta>& indexes, const Rid& src,
+                     const Rid& dst, Context* context);
 };
\ No newline at end of file
@@ -11,11 +11,13 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <algorithm>
+#include <climits>
 #include <iostream>
 #include <map>
 #include <string>
 #include <vector>
 
+#include "common/common.h"
 #include "errors.h"
 #include "sm_defs.h"
 
@@ -65,17 +67,139 @@ struct IndexMeta {
     }
 };
 
+/* 表的分区方式 */
+enum PartitionType { PART_NONE = 0, PART_RANGE, PART_HASH };
+
+/* 范围分区上界为MAXVALUE时保存的取值，分区键为INT，任何取值都小于该上界 */
+constexpr long long PART_MAXVALUE = LLONG_MAX;
+
+/* 分区的数据文件名为"表名@分区名"，分区上的索引文件名同样以该名称为前缀 */
+constexpr char PART_FILE_SEP = '@';
+
+/* 根据数据文件名获取所属表的名称 */
+inline std::string file_tab_name(const std::string &file_name) {
+    return file_name.substr(0, file_name.find(PART_FILE_SEP));
+}
+
+/* 分区元数据 */
+struct PartitionMeta {
+    PartitionType type = PART_NONE;     // 分区方式
+    std::string col_name;               // 分区键
+    std::vector<std::string> names;     // 分区名称，范围分区按上界递增排列
+    std::vector<long long> bounds;      // 范围分区每个分区的上界（不含），第i个分区包含[bounds[i-1], bounds[i])
+
+    bool is_partitioned() const { return type != PART_NONE; }
+
+    /* 根据分区名称获取分区序号，不存在时返回-1 */
+    int get_part_no(const std::string &part_name) const {
+        auto pos = std::find(names.begin(), names.end(), part_name);
+        return pos == names.end() ? -1 : pos - names.begin();
+    }
+
+    /* 根据分区键的取值定位元组所在的分区，范围分区中没有分区包含该取值时返回-1 */
+    int locate(const char *key, int len) const {
+        if (type == PART_RANGE) {
+            int val = *(const int *)key;
+            auto pos = std::upper_bound(bounds.begin(), bounds.end(), (long long)val);
+            return pos == bounds.end() ? -1 : pos - bounds.begin();
+        }
+        return hash_key(key, len) % names.size();
+    }
+
+    /* 范围分区中与[lower, upper]有交集的分区序号 */
+    std::vector<int> overlap(long long lower, long long upper) const {
+        std::vector<int> parts;
+        for (size_t i = 0; i < bounds.size(); i++) {
+            long long part_lower = i == 0 ? LLONG_MIN : bounds[i - 1];
+            if (part_lower <= upper && lower < bounds[i]) {
+                parts.push_back(i);
+            }
+        }
+        return parts;
+    }
+
+    /* 哈希分区使用FNV-1a，保证同一取值在不同进程中总是落在同一分区 */
+    static uint32_t hash_key(const char *key, int len) {
+        uint32_t hash = 2166136261u;
+        for (int i = 0; i < len; i++) {
+            hash = (hash ^ (unsigned char)key[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const PartitionMeta &part) {
+        os << part.type << ' ' << part.col_name << ' ' << part.names.size();
+        for (size_t i = 0; i < part.names.size(); i++) {
+            os << '\n' << part.names[i] << ' ' << (part.type == PART_RANGE ? part.bounds[i] : 0);
+        }
+        return os;
+    }
+
+    friend std::istream &operator>>(std::istream &is, PartitionMeta &part) {
+        int type;
+        size_t n;
+        is >> type >> part.col_name >> n;
+        part.type = static_cast<PartitionType>(type);
+        for (size_t i = 0; i < n; i++) {
+            std::string name;
+            long long bound;
+            is >> name >> bound;
+            part.names.push_back(name);
+            if (part.type == PART_RANGE) {
+                part.bounds.push_back(bound);
+            }
+        }
+        return is;
+    }
+};
+
 /* 表元数据 */
 struct TabMeta {
     std::string name;                   // 表名称
     std::vector<ColMeta> cols;          // 表包含的字段
     std::vector<IndexMeta> indexes;     // 表上建立的索引
+    PartitionMeta part;                 // 分区信息，非分区表的type为PART_NONE
+    int record_size = 0;                // 删除字段之后记录仍保留被删除字段的空间，为0时记录长度即最后一个字段的末尾
 
     TabMeta(){}
 
     TabMeta(const TabMeta &other) {
         name = other.name;
         for(auto col : other.cols) cols.push_back(col);
+        part = other.part;
+        record_size = other.record_size;
+    }
+
+    /* 获取表中记录的长度，包括已经删除的字段所占的空间 */
+    int get_record_size() const { return std::max(record_size, cols.back().offset + cols.back().len); }
+
+    /* 获取第part_no个分区的数据文件名 */
+    std::string get_part_file(size_t part_no) const { return name + PART_FILE_SEP + part.names[part_no]; }
+
+    /* 获取表的所有数据文件名，非分区表只有一个与表同名的数据文件 */
+    std::vector<std::string> get_files() const {
+        if (!part.is_partitioned()) {
+            return {name};
+        }
+        std::vector<std::string> files;
+        for (size_t i = 0; i < part.names.size(); i++) {
+            files.push_back(get_part_file(i));
+        }
+        return files;
+    }
+
+    /* 获取记录rec应当存放的数据文件名 */
+    std::string locate_file(const char *rec) const {
+        if (!part.is_partitioned()) {
+            return name;
+        }
+        auto col = std::find_if(cols.begin(), cols.end(), [&](const ColMeta &col) { return col.name == part.col_name; });
+        int part_no = part.locate(rec + col->offset, col->len);
+        if (part_no < 0) {
+            throw PartitionNotFoundError(name + " (" + part.col_name + " = " +
+                                         std::to_string(*(const int *)(rec + col->offset)) + ")");
+        }
+        return get_part_file(part_no);
     }
 
     /* 判断当前表中是否存在名为col_name的字段 */
@@ -154,6 +278,179 @@ struct TabMeta {
     }
 };
 
+/* 物化视图输出列的聚集类型，普通投影列为VIEW_AGG_NONE */
+enum ViewAggType { VIEW_AGG_NONE = 0, VIEW_AGG_COUNT, VIEW_AGG_SUM };
+
+/* 物化视图的输出列，与视图表中的字段按顺序一一对应 */
+struct ViewCol {
+    ViewAggType agg;    // 聚集类型
+    TabCol src;         // 源字段，COUNT(*)的源字段为{"*", "*"}
+
+    friend std::ostream &operator<<(std::ostream &os, const ViewCol &col) {
+        return os << col.agg << ' ' << col.src.tab_name << ' ' << col.src.col_name;
+    }
+
+    friend std::istream &operator>>(std::istream &is, ViewCol &col) {
+        return is >> col.agg >> col.src.tab_name >> col.src.col_name;
+    }
+};
+
+/* 物化视图元数据，视图数据存放在与视图同名的普通表中 */
+/* SPJ视图元组的血缘：产生该元组的一个基表元组所在的数据文件序号和位置 */
+struct ViewLineage {
+    int file_no;                        // 基表get_files()中的下标，非分区表为0
+    int page_no;
+    int slot_no;
+};
+
+/* SPJ视图在可见字段之后保存每个基表的血缘，视图表上以该名称的隐藏字段建立唯一索引，用户输入的标识符不能以下划线开头 */
+constexpr char VIEW_LINEAGE_COL[] = "__lineage";
+
+struct ViewMeta {
+    std::string name;                   // 视图名称，同时也是存放视图数据的表名称
+    std::vector<std::string> tabs;      // 视图引用的基表
+    std::vector<Condition> conds;       // 视图定义中的选择条件和连接条件，右值已按左侧字段初始化raw
+    std::vector<ViewCol> cols;          // 视图的输出列
+
+    /* 视图是否包含聚集列，包含聚集列时非聚集列即为分组列 */
+    bool has_agg() const {
+        return std::any_of(cols.begin(), cols.end(), [](const ViewCol &col) { return col.agg != VIEW_AGG_NONE; });
+    }
+
+    /* 视图元组中血缘所占的字节数，聚集视图按分组列定位元组，不保存血缘 */
+    int lineage_len() const { return has_agg() ? 0 : tabs.size() * sizeof(ViewLineage); }
+
+    /* 判断视图是否引用了指定基表 */
+    bool is_base_table(const std::string &tab_name) const {
+        return std::find(tabs.begin(), tabs.end(), tab_name) != tabs.end();
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const ViewMeta &view) {
+        os << view.name << '\n' << view.tabs.size();
+        for (auto &tab : view.tabs) {
+            os << ' ' << tab;
+        }
+        os << '\n' << view.conds.size() << '\n';
+        for (auto &cond : view.conds) {
+            os << cond.lhs_col.tab_name << ' ' << cond.lhs_col.col_name << ' ' << cond.op << ' ' << cond.is_rhs_val;
+            if (cond.is_rhs_val) {
+                // 右值以raw的十六进制形式保存，避免字符串中的空白字符破坏元数据格式
+                auto &raw = cond.rhs_val.raw;
+                os << ' ' << cond.rhs_val.type << ' ' << raw->size << ' ';
+                for (int i = 0; i < raw->size; i++) {
+                    os << "0123456789abcdef"[(raw->data[i] >> 4) & 0xf] << "0123456789abcdef"[raw->data[i] & 0xf];
+                }
+            } else {
+                os << ' ' << cond.rhs_col.tab_name << ' ' << cond.rhs_col.col_name;
+            }
+            os << '\n';
+        }
+        os << view.cols.size() << '\n';
+        for (auto &col : view.cols) {
+            os << col << '\n';
+        }
+        return os;
+    }
+
+    friend std::istream &operator>>(std::istream &is, ViewMeta &view) {
+        size_t n;
+        is >> view.name >> n;
+        for (size_t i = 0; i < n; i++) {
+            std::string tab;
+            is >> tab;
+            view.tabs.push_back(tab);
+        }
+        is >> n;
+        for (size_t i = 0; i < n; i++) {
+            Condition cond;
+            is >> cond.lhs_col.tab_name >> cond.lhs_col.col_name >> cond.op >> cond.is_rhs_val;
+            if (cond.is_rhs_val) {
+                ColType type;
+                int len;
+                std::string hex;
+                is >> type >> len >> hex;
+                cond.rhs_val.type = type;
+                cond.rhs_val.raw = std::make_shared<RmRecord>(len);
+                for (int j = 0; j < len; j++) {
+                    cond.rhs_val.raw->data[j] = (char)std::stoi(hex.substr(j * 2, 2), nullptr, 16);
+                }
+                if (type == TYPE_INT) {
+                    cond.rhs_val.int_val = *(int *)cond.rhs_val.raw->data;
+                } else if (type == TYPE_FLOAT) {
+                    cond.rhs_val.float_val = *(float *)cond.rhs_val.raw->data;
+                } else {
+                    cond.rhs_val.str_val = std::string(cond.rhs_val.raw->data, strnlen(cond.rhs_val.raw->data, len));
+                }
+            } else {
+                is >> cond.rhs_col.tab_name >> cond.rhs_col.col_name;
+            }
+            view.conds.push_back(cond);
+        }
+        is >> n;
+        for (size_t i = 0; i < n; i++) {
+            ViewCol col;
+            is >> col;
+            view.cols.push_back(col);
+        }
+        return is;
+    }
+};
+
+/* 存储过程的形式参数 */
+struct ProcParam {
+    std::string name;
+    ColType type;
+    int len;
+
+    friend std::ostream &operator<<(std::ostream &os, const ProcParam &param) {
+        return os << param.name << ' ' << param.type << ' ' << param.len;
+    }
+
+    friend std::istream &operator>>(std::istream &is, ProcParam &param) {
+        return is >> param.name >> param.type >> param.len;
+    }
+};
+
+/* 存储过程元数据，过程体保存原始的SQL文本，由分析器解析并缓存语法树 */
+struct ProcMeta {
+    std::string name;
+    std::vector<ProcParam> params;
+    std::string body;
+
+    friend std::ostream &operator<<(std::ostream &os, const ProcMeta &proc) {
+        os << proc.name << ' ' << proc.params.size() << '\n';
+        for (auto &param : proc.params) {
+            os << param << '\n';
+        }
+        // 过程体以十六进制形式保存，避免其中的空白字符破坏元数据格式
+        os << proc.body.size() << ' ';
+        for (char c : proc.body) {
+            os << "0123456789abcdef"[(c >> 4) & 0xf] << "0123456789abcdef"[c & 0xf];
+        }
+        return os;
+    }
+
+    friend std::istream &operator>>(std::istream &is, ProcMeta &proc) {
+        size_t n;
+        is >> proc.name >> n;
+        for (size_t i = 0; i < n; i++) {
+            ProcParam param;
+            is >> param;
+            proc.params.push_back(param);
+        }
+        std::string hex;
+        is >> n;
+        if (n > 0) {
+            is >> hex;
+        }
+        proc.body.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            proc.body[i] = (char)std::stoi(hex.substr(i * 2, 2), nullptr, 16);
+        }
+        return is;
+    }
+};
+
 // 注意重载了操作符 << 和 >>，这需要更底层同样重载TabMeta、ColMeta的操作符 << 和 >>
 /* 数据库元数据 */
 class DbMeta {
@@ -162,6 +459,9 @@ class DbMeta {
    private:
     std::string name_;                      // 数据库名称
     std::map<std::string, TabMeta> tabs_;   // 数据库中包含的表
+    std::map<std::string, ViewMeta> views_; // 数据库中包含的物化视图，视图数据表同时登记在tabs_中
+    std::map<std::string, ProcMeta> procs_; // 数据库中包含的存储过程
+    int ix_format_ = 0;                     // 索引结点页面的格式版本，旧版本的元数据文件中没有，读出为0
 
    public:
     // DbMeta(std::string name) : name_(name) {}
@@ -183,23 +483,118 @@ class DbMeta {
         return pos->second;
     }
 
+    /* 判断指定名称的表是否为物化视图 */
+    bool is_view(const std::string &view_name) const { return views_.find(view_name) != views_.end(); }
+
+    /* 获取指定名称物化视图的元数据 */
+    ViewMeta &get_view(const std::string &view_name) {
+        auto pos = views_.find(view_name);
+        if (pos == views_.end()) {
+            throw ViewNotFoundError(view_name);
+        }
+        return pos->second;
+    }
+
+    /* 获取引用了指定基表的所有物化视图 */
+    std::vector<ViewMeta *> get_views_on(const std::string &tab_name) {
+        std::vector<ViewMeta *> views;
+        for (auto &entry : views_) {
+            if (entry.second.is_base_table(tab_name)) {
+                views.push_back(&entry.second);
+            }
+        }
+        return views;
+    }
+
+    /* 判断数据库中是否存在指定名称的存储过程 */
+    bool is_proc(const std::string &proc_name) const { return procs_.find(proc_name) != procs_.end(); }
+
+    /* 获取指定名称存储过程的元数据 */
+    ProcMeta &get_proc(const std::string &proc_name) {
+        auto pos = procs_.find(proc_name);
+        if (pos == procs_.end()) {
+            throw ProcedureNotFoundError(proc_name);
+        }
+        return pos->second;
+    }
+
     // 重载操作符 <<
     friend std::ostream &operator<<(std::ostream &os, const DbMeta &db_meta) {
         os << db_meta.name_ << '\n' << db_meta.tabs_.size() << '\n';
         for (auto &entry : db_meta.tabs_) {
             os << entry.second << '\n';
         }
+        os << db_meta.views_.size() << '\n';
+        for (auto &entry : db_meta.views_) {
+            os << entry.second << '\n';
+        }
+        // 分区信息单独保存在最后，保持与旧版本元数据文件的兼容
+        size_t num_partitioned = std::count_if(db_meta.tabs_.begin(), db_meta.tabs_.end(),
+                                               [](const auto &entry) { return entry.second.part.is_partitioned(); });
+        os << num_partitioned << '\n';
+        for (auto &entry : db_meta.tabs_) {
+            if (entry.second.part.is_partitioned()) {
+                os << entry.first << ' ' << entry.second.part << '\n';
+            }
+        }
+        os << db_meta.procs_.size() << '\n';
+        for (auto &entry : db_meta.procs_) {
+            os << entry.second << '\n';
+        }
+        // 删除过字段的表的记录长度
+        size_t num_resized = std::count_if(db_meta.tabs_.begin(), db_meta.tabs_.end(),
+                                           [](const auto &entry) { return entry.second.record_size > 0; });
+        os << num_resized << '\n';
+        for (auto &entry : db_meta.tabs_) {
+            if (entry.second.record_size > 0) {
+                os << entry.first << ' ' << entry.second.record_size << '\n';
+            }
+        }
+        os << db_meta.ix_format_ << '\n';
         return os;
     }
 
     friend std::istream &operator>>(std::istream &is, DbMeta &db_meta) {
         size_t n;
+        db_meta.ix_format_ = 0;
         is >> db_meta.name_ >> n;
         for (size_t i = 0; i < n; i++) {
             TabMeta tab;
             is >> tab;
             db_meta.tabs_[tab.name] = tab;
         }
+        // 旧版本的元数据文件中没有物化视图部分、分区部分、存储过程部分、记录长度部分和索引格式部分
+        if (is >> n) {
+            for (size_t i = 0; i < n; i++) {
+                ViewMeta view;
+                is >> view;
+                db_meta.views_[view.name] = view;
+            }
+        }
+        if (is >> n) {
+            for (size_t i = 0; i < n; i++) {
+                std::string tab_name;
+                is >> tab_name;
+                is >> db_meta.tabs_.at(tab_name).part;
+            }
+        }
+        if (is >> n) {
+            for (size_t i = 0; i < n; i++) {
+                ProcMeta proc;
+                is >> proc;
+                db_meta.procs_[proc.name] = proc;
+            }
+        }
+        if (is >> n) {
+            for (size_t i = 0; i < n; i++) {
+                std::string tab_name;
+                is >> tab_name;
+                is >> db_meta.tabs_.at(tab_name).record_size;
+            }
+        }
+        if (is >> n) {
+            db_meta.ix_format_ = n;
+        }
         return is;
     }
 };
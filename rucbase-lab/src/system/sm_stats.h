@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common.h"
+
+/* 没有观测过的表的默认行数 */
+constexpr double STATS_DEFAULT_ROWS = 1000;
+/* 没有观测过的等值条件和其他比较条件的默认选择率 */
+constexpr double STATS_EQ_SELECTIVITY = 0.1;
+constexpr double STATS_RANGE_SELECTIVITY = 1.0 / 3;
+/* 最多保存的扫描形状个数，超过时淘汰最久没有使用的 */
+constexpr size_t STATS_MAX_SCANS = 4096;
+/* 同一形状的新观测值在平均值中所占的权重 */
+constexpr double STATS_FEEDBACK_WEIGHT = 0.5;
+
+/**
+ * @description: 统计信息，记录执行时在流水线中断点观测到的实际行数
+ * 表的行数来自无条件扫描；带条件扫描的行数按表名和条件的形状（字段和比较符，不含常量）记录，
+ * 同一形状的多次观测取加权平均，下次遇到相同形状的扫描时直接使用观测值，
+ * 没有观测值时用表的行数乘以各条件的默认选择率估计。形状个数有上限，按LRU淘汰
+ */
+class StatsStore {
+   public:
+    /* 估计表tab_name经过条件conds过滤后的行数 */
+    double estimate(const std::string &tab_name, const std::vector<Condition> &conds) {
+        std::lock_guard<std::mutex> lock(latch_);
+        auto observed = scan_rows_.find(signature(tab_name, conds));
+        if (observed != scan_rows_.end()) {
+            lru_.splice(lru_.begin(), lru_, observed->second.second);
+            return observed->second.first;
+        }
+        auto tab_rows = tab_rows_.find(tab_name);
+        double rows = tab_rows == tab_rows_.end() ? STATS_DEFAULT_ROWS : tab_rows->second;
+        for (auto &cond : conds) {
+            rows *= cond.op == OP_EQ ? STATS_EQ_SELECTIVITY : STATS_RANGE_SELECTIVITY;
+        }
+        return rows;
+    }
+
+    /* 记录表tab_name经过条件conds过滤后实际产生的行数 */
+    void feedback(const std::string &tab_name, const std::vector<Condition> &conds, size_t rows) {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (conds.empty()) {
+            tab_rows_[tab_name] = rows;
+        }
+        auto sig = signature(tab_name, conds);
+        auto observed = scan_rows_.find(sig);
+        if (observed != scan_rows_.end()) {
+            auto &avg = observed->second.first;
+            avg = conds.empty() ? rows : avg * (1 - STATS_FEEDBACK_WEIGHT) + rows * STATS_FEEDBACK_WEIGHT;
+            lru_.splice(lru_.begin(), lru_, observed->second.second);
+            return;
+        }
+        if (scan_rows_.size() >= STATS_MAX_SCANS) {
+            scan_rows_.erase(lru_.back());
+            lru_.pop_back();
+        }
+        lru_.push_front(sig);
+        scan_rows_.emplace(sig, std::make_pair((double)rows, lru_.begin()));
+    }
+
+    /* 删除表时清除该表的统计信息 */
+    void erase(const std::string &tab_name) {
+        std::lock_guard<std::mutex> lock(latch_);
+        tab_rows_.erase(tab_name);
+        for (auto it = lru_.begin(); it != lru_.end();) {
+            if (it->compare(0, tab_name.size() + 1, tab_name + "|") == 0) {
+                scan_rows_.erase(*it);
+                it = lru_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /* 当前保存的扫描形状个数 */
+    size_t num_scans() {
+        std::lock_guard<std::mutex> lock(latch_);
+        return scan_rows_.size();
+    }
+
+   private:
+    /* 扫描的形状：表名和按顺序排列的各个条件，与常量比较的条件不记录常量的取值 */
+    static std::string signature(const std::string &tab_name, const std::vector<Condition> &conds) {
+        std::string sig = tab_name + "|";
+        for (auto &cond : conds) {
+            sig += cond.lhs_col.col_name + " " + std::to_string(cond.op) + " ";
+            sig += cond.is_rhs_val ? "?" : cond.rhs_col.tab_name + "." + cond.rhs_col.col_name;
+            sig += "|";
+        }
+        return sig;
+    }
+
+    using ScanEntry = std::pair<double, std::list<std::string>::iterator>;
+
+    std::mutex latch_;
+    std::unordered_map<std::string, double> tab_rows_;     // 表名 -> 观测到的表行数
+    std::unordered_map<std::string, ScanEntry> scan_rows_; // 扫描形状 -> (观测到的扫描行数, 在lru_中的位置)
+    std::list<std::string> lru_;                            // 扫描形状，最近使用的在前
+};
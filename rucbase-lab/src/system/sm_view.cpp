@@ -0,0 +1,477 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sm_view.h"
+
+#include "index/ix.h"
+#include "record/rm.h"
+#include "sm_manager.h"
+
+/* 返回基表在视图定义中的下标 */
+static size_t get_tab_idx(const ViewMeta &view, const std::string &tab_name) {
+    return std::find(view.tabs.begin(), view.tabs.end(), tab_name) - view.tabs.begin();
+}
+
+/* 按索引字段从记录中拼接索引键 */
+static void make_index_key(const IndexMeta &index, const char *rec, char *key) {
+    int offset = 0;
+    for (int i = 0; i < index.col_num; ++i) {
+        memcpy(key + offset, rec + index.cols[i].offset, index.cols[i].len);
+        offset += index.cols[i].len;
+    }
+}
+
+/**
+ * @description: 将基表上的一次写操作传播到引用该基表的所有物化视图
+ * @param {WriteRecord&} write_rec 基表上的写操作，插入和更新后的新值从基表中读取
+ * @param {Context*} context
+ */
+void ViewMaintainer::apply(WriteRecord &write_rec, Context *context) {
+    // 写操作记录的是数据文件名，分区表需要换算成表名
+    auto tab_name = file_tab_name(write_rec.GetTableName());
+    auto views = sm_manager_->db_.get_views_on(tab_name);
+    if (views.empty()) {
+        return;
+    }
+    auto fh = sm_manager_->get_file_handle(write_rec.GetTableName());
+    auto files = sm_manager_->db_.get_table(tab_name).get_files();
+    int file_no = std::find(files.begin(), files.end(), write_rec.GetTableName()) - files.begin();
+    ViewLineage pos = {file_no, write_rec.GetRid().page_no, write_rec.GetRid().slot_no};
+    switch (write_rec.GetWriteType()) {
+        case WType::INSERT_TUPLE: {
+            auto rec = fh->get_record(write_rec.GetRid(), context);
+            for (auto view : views) {
+                propagate(*view, tab_name, rec->data, pos, 1, context);
+            }
+            break;
+        }
+        case WType::DELETE_TUPLE: {
+            for (auto view : views) {
+                propagate(*view, tab_name, write_rec.GetRecord().data, pos, -1, context);
+            }
+            break;
+        }
+        case WType::UPDATE_TUPLE: {
+            // 更新等价于先删除旧元组再插入新元组
+            auto rec = fh->get_record(write_rec.GetRid(), context);
+            for (auto view : views) {
+                propagate(*view, tab_name, write_rec.GetRecord().data, pos, -1, context);
+                propagate(*view, tab_name, rec->data, pos, 1, context);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @description: 根据基表当前内容计算视图的初始内容，即把第一张基表的每条元组都当作插入增量
+ * @param {ViewMeta&} view 物化视图元数据
+ * @param {Context*} context
+ */
+void ViewMaintainer::populate(const ViewMeta &view, Context *context) {
+    auto &tab_name = view.tabs[0];
+    auto files = sm_manager_->db_.get_table(tab_name).get_files();
+    for (size_t file_no = 0; file_no < files.size(); file_no++) {
+        auto fh = sm_manager_->get_file_handle(files[file_no]);
+        for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+            auto rec = fh->get_record(scan.rid(), context);
+            ViewLineage pos = {(int)file_no, scan.rid().page_no, scan.rid().slot_no};
+            propagate(view, tab_name, rec->data, pos, 1, context);
+        }
+    }
+}
+
+/**
+ * @description: 创建视图表时为其建立的索引，用于在增量维护时定位视图元组，避免扫描视图表
+ * @return {vector<IndexMeta>} SPJ视图返回血缘上的索引，有分组列的聚集视图返回分组列上的索引
+ * @param {ViewMeta&} view 物化视图元数据
+ * @param {TabMeta&} view_tab 视图表的元数据，SPJ视图的记录长度已包含血缘
+ */
+std::vector<IndexMeta> ViewMaintainer::view_indexes(const ViewMeta &view, const TabMeta &view_tab) {
+    IndexMeta index = {.tab_name = view.name, .col_tot_len = 0, .col_num = 0, .cols = {}};
+    if (!view.has_agg()) {
+        // 血缘不是视图表的字段，只出现在索引中，查询无法引用它
+        auto &last = view_tab.cols.back();
+        index.cols.push_back({.tab_name = view.name,
+                              .name = VIEW_LINEAGE_COL,
+                              .type = TYPE_STRING,
+                              .len = view.lineage_len(),
+                              .offset = last.offset + last.len,
+                              .index = true});
+    } else {
+        for (size_t i = 0; i < view.cols.size(); i++) {
+            if (view.cols[i].agg == VIEW_AGG_NONE) {
+                index.cols.push_back(view_tab.cols[i]);
+                index.cols.back().index = true;
+            }
+        }
+    }
+    if (index.cols.empty()) {
+        return {};
+    }
+    for (auto &col : index.cols) {
+        index.col_tot_len += col.len;
+    }
+    index.col_num = index.cols.size();
+    return {index};
+}
+
+void ViewMaintainer::propagate(const ViewMeta &view, const std::string &delta_tab, const char *delta_row,
+                               const ViewLineage &delta_pos, int sign, Context *context) {
+    std::vector<const char *> rows(view.tabs.size(), nullptr);
+    std::vector<ViewLineage> lineage(view.tabs.size());
+    lineage[get_tab_idx(view, delta_tab)] = delta_pos;
+    join_next(view, 0, delta_tab, delta_row, rows, lineage, sign, context);
+}
+
+void ViewMaintainer::join_next(const ViewMeta &view, size_t level, const std::string &delta_tab,
+                               const char *delta_row, std::vector<const char *> &rows,
+                               std::vector<ViewLineage> &lineage, int sign, Context *context) {
+    if (level == view.tabs.size()) {
+        merge_row(view, rows, lineage, sign, context);
+        return;
+    }
+    // 发生变化的基表只绑定增量元组，其余基表与其当前内容做连接
+    if (view.tabs[level] == delta_tab) {
+        rows[level] = delta_row;
+        if (eval_conds(view, level, rows)) {
+            join_next(view, level + 1, delta_tab, delta_row, rows, lineage, sign, context);
+        }
+        return;
+    }
+    auto bind = [&](RmFileHandle *fh, int file_no, const Rid &rid) {
+        auto rec = fh->get_record(rid, context);
+        rows[level] = rec->data;
+        lineage[level] = {file_no, rid.page_no, rid.slot_no};
+        if (eval_conds(view, level, rows)) {
+            join_next(view, level + 1, delta_tab, delta_row, rows, lineage, sign, context);
+        }
+    };
+    auto files = sm_manager_->db_.get_table(view.tabs[level]).get_files();
+    std::vector<char> key;
+    auto index = find_join_index(view, level, delta_tab, delta_row, rows, key);
+    for (size_t file_no = 0; file_no < files.size(); file_no++) {
+        auto fh = sm_manager_->get_file_handle(files[file_no]);
+        if (index != nullptr) {
+            // 连接字段上有索引时只查找与已绑定元组匹配的元组，每个增量的代价与基表大小无关
+            std::vector<Rid> result;
+            sm_manager_->get_index_handle(files[file_no], index->cols)->get_value(key.data(), &result,
+                                                                                  context->txn_);
+            for (auto &rid : result) {
+                bind(fh, file_no, rid);
+            }
+            continue;
+        }
+        for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+            bind(fh, file_no, scan.rid());
+        }
+    }
+}
+
+const IndexMeta *ViewMaintainer::find_join_index(const ViewMeta &view, size_t level, const std::string &delta_tab,
+                                                 const char *delta_row, const std::vector<const char *> &rows,
+                                                 std::vector<char> &key) {
+    auto &tab_name = view.tabs[level];
+    // 返回col_name的等值条件另一侧已经确定的取值，增量元组无论位于哪一层都已确定
+    auto bound_value = [&](const std::string &col_name) -> const char * {
+        for (auto &cond : view.conds) {
+            if (cond.op != OP_EQ) {
+                continue;
+            }
+            const TabCol *other = nullptr;
+            if (cond.lhs_col.tab_name == tab_name && cond.lhs_col.col_name == col_name) {
+                if (cond.is_rhs_val) {
+                    return cond.rhs_val.raw->data;
+                }
+                other = &cond.rhs_col;
+            } else if (!cond.is_rhs_val && cond.rhs_col.tab_name == tab_name && cond.rhs_col.col_name == col_name) {
+                other = &cond.lhs_col;
+            } else {
+                continue;
+            }
+            const char *row = nullptr;
+            if (other->tab_name == delta_tab) {
+                row = delta_row;
+            } else if (get_tab_idx(view, other->tab_name) < level) {
+                row = rows[get_tab_idx(view, other->tab_name)];
+            }
+            auto other_col = sm_manager_->db_.get_table(other->tab_name).get_col(other->col_name);
+            auto col = sm_manager_->db_.get_table(tab_name).get_col(col_name);
+            // 类型或长度不同的字段不能直接拼接成查找键
+            if (row != nullptr && other_col->type == col->type && other_col->len == col->len) {
+                return row + other_col->offset;
+            }
+        }
+        return nullptr;
+    };
+    for (auto &index : sm_manager_->db_.get_table(tab_name).indexes) {
+        key.assign(index.col_tot_len, 0);
+        int offset = 0;
+        bool usable = true;
+        for (auto &col : index.cols) {
+            auto value = bound_value(col.name);
+            if (value == nullptr) {
+                usable = false;
+                break;
+            }
+            memcpy(key.data() + offset, value, col.len);
+            offset += col.len;
+        }
+        if (usable) {
+            return &index;
+        }
+    }
+    return nullptr;
+}
+
+bool ViewMaintainer::eval_conds(const ViewMeta &view, size_t level, const std::vector<const char *> &rows) {
+    for (auto &cond : view.conds) {
+        size_t lhs_idx = get_tab_idx(view, cond.lhs_col.tab_name);
+        size_t rhs_idx = cond.is_rhs_val ? lhs_idx : get_tab_idx(view, cond.rhs_col.tab_name);
+        // 只求值在当前层才具备全部输入的条件，更早的条件已经在上层检查过
+        if (std::max(lhs_idx, rhs_idx) != level) {
+            continue;
+        }
+        auto lhs_col = sm_manager_->db_.get_table(cond.lhs_col.tab_name).get_col(cond.lhs_col.col_name);
+        const char *lhs = rows[lhs_idx] + lhs_col->offset;
+        const char *rhs;
+        if (cond.is_rhs_val) {
+            rhs = cond.rhs_val.raw->data;
+        } else {
+            auto rhs_col = sm_manager_->db_.get_table(cond.rhs_col.tab_name).get_col(cond.rhs_col.col_name);
+            rhs = rows[rhs_idx] + rhs_col->offset;
+        }
+        int cmp = ix_compare(lhs, rhs, lhs_col->type, lhs_col->len);
+        bool ok = false;
+        switch (cond.op) {
+            case OP_EQ: ok = cmp == 0; break;
+            case OP_NE: ok = cmp != 0; break;
+            case OP_LT: ok = cmp < 0; break;
+            case OP_GT: ok = cmp > 0; break;
+            case OP_LE: ok = cmp <= 0; break;
+            case OP_GE: ok = cmp >= 0; break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ViewMaintainer::merge_row(const ViewMeta &view, const std::vector<const char *> &rows,
+                               const std::vector<ViewLineage> &lineage, int sign, Context *context) {
+    TabMeta &view_tab = sm_manager_->db_.get_table(view.name);
+    auto fh = sm_manager_->get_file_handle(view.name);
+    RmRecord rec(fh->get_file_hdr().record_size);
+    memset(rec.data, 0, rec.size);
+
+    // 生成视图元组，聚集列中存放本次增量：COUNT为sign，SUM为sign乘以源字段的值
+    std::vector<size_t> key_cols;
+    for (size_t i = 0; i < view.cols.size(); i++) {
+        auto &view_col = view.cols[i];
+        auto &dst = view_tab.cols[i];
+        if (view_col.agg == VIEW_AGG_COUNT) {
+            *(int *)(rec.data + dst.offset) = sign;
+            continue;
+        }
+        auto src = sm_manager_->db_.get_table(view_col.src.tab_name).get_col(view_col.src.col_name);
+        const char *src_data = rows[get_tab_idx(view, view_col.src.tab_name)] + src->offset;
+        if (view_col.agg == VIEW_AGG_NONE) {
+            memcpy(rec.data + dst.offset, src_data, dst.len);
+            key_cols.push_back(i);
+        } else if (src->type == TYPE_INT) {
+            *(int *)(rec.data + dst.offset) = sign * *(const int *)src_data;
+        } else {
+            *(float *)(rec.data + dst.offset) = sign * *(const float *)src_data;
+        }
+    }
+
+    Rid rid;
+    if (!view.has_agg()) {
+        // SPJ视图按多重集语义维护，可见字段之后保存血缘，删除时移除由同一组基表元组产生的视图元组
+        auto &last = view_tab.cols.back();
+        int lineage_offset = last.offset + last.len;
+        if (lineage_offset + view.lineage_len() <= rec.size) {
+            memcpy(rec.data + lineage_offset, lineage.data(), view.lineage_len());
+        }
+        if (sign > 0) {
+            insert_view_row(view.name, rec.data, context);
+        } else if (find_lineage_row(view, rec.data, rid, context) ||
+                   find_view_row(view, rec.data, key_cols, rid, context)) {
+            delete_view_row(view.name, rid, context);
+        } else {
+            throw InternalError("Materialized view " + view.name + " is out of sync");
+        }
+        return;
+    }
+
+    if (!find_view_row(view, rec.data, key_cols, rid, context)) {
+        if (sign < 0) {
+            throw InternalError("Materialized view " + view.name + " is out of sync");
+        }
+        insert_view_row(view.name, rec.data, context);
+        return;
+    }
+    auto old_rec = fh->get_record(rid, context);
+    RmRecord new_rec(*old_rec);
+    int count = 0;
+    for (size_t i = 0; i < view.cols.size(); i++) {
+        auto &dst = view_tab.cols[i];
+        if (view.cols[i].agg == VIEW_AGG_NONE) {
+            continue;
+        }
+        if (dst.type == TYPE_INT) {
+            *(int *)(new_rec.data + dst.offset) += *(int *)(rec.data + dst.offset);
+        } else {
+            *(float *)(new_rec.data + dst.offset) += *(float *)(rec.data + dst.offset);
+        }
+        if (view.cols[i].agg == VIEW_AGG_COUNT) {
+            count = *(int *)(new_rec.data + dst.offset);
+        }
+    }
+    // 分组中已经没有元组，删除该分组
+    if (count == 0) {
+        delete_view_row(view.name, rid, context);
+    } else {
+        update_view_row(view.name, rid, new_rec.data, context);
+    }
+}
+
+bool ViewMaintainer::find_view_row(const ViewMeta &view, const char *buf, const std::vector<size_t> &key_cols,
+                                   Rid &rid, Context *context) {
+    TabMeta &view_tab = sm_manager_->db_.get_table(view.name);
+    auto fh = sm_manager_->get_file_handle(view.name);
+    auto match = [&](const char *data) {
+        for (auto i : key_cols) {
+            auto &col = view_tab.cols[i];
+            if (memcmp(data + col.offset, buf + col.offset, col.len) != 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // 如果视图表上有恰好包含全部key_cols的索引，通过索引定位，否则扫描视图表
+    for (auto &index : view_tab.indexes) {
+        bool usable = index.col_num == (int)key_cols.size() &&
+                      std::all_of(index.cols.begin(), index.cols.end(), [&](const ColMeta &col) {
+                          return std::any_of(key_cols.begin(), key_cols.end(),
+                                             [&](size_t i) { return view_tab.cols[i].name == col.name; });
+                      });
+        if (!usable) {
+            continue;
+        }
+        auto ih = sm_manager_->get_index_handle(view.name, index.cols);
+        std::vector<char> key(index.col_tot_len);
+        make_index_key(index, buf, key.data());
+        std::vector<Rid> result;
+        if (ih->get_value(key.data(), &result, context->txn_)) {
+            rid = result[0];
+            return true;
+        }
+        // 聚集视图中每个分组只有一条元组，索引中没有即不存在；SPJ视图中重复的元组不在索引中，需要继续扫描
+        if (view.has_agg()) {
+            return false;
+        }
+        break;
+    }
+
+    for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+        if (match(fh->get_record(scan.rid(), context)->data)) {
+            rid = scan.rid();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ViewMaintainer::find_lineage_row(const ViewMeta &view, const char *buf, Rid &rid, Context *context) {
+    for (auto &index : sm_manager_->db_.get_table(view.name).indexes) {
+        if (index.col_num != 1 || index.cols[0].name != VIEW_LINEAGE_COL) {
+            continue;
+        }
+        std::vector<Rid> result;
+        if (sm_manager_->get_index_handle(view.name, index.cols)->get_value(buf + index.cols[0].offset, &result,
+                                                                            context->txn_)) {
+            rid = result[0];
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+void ViewMaintainer::insert_view_row(const std::string &view_name, char *buf, Context *context) {
+    TabMeta &view_tab = sm_manager_->db_.get_table(view_name);
+    auto fh = sm_manager_->get_file_handle(view_name);
+    Page *page = fh->pin_insert_page();
+    Rid rid = fh->insert_record(buf, context);
+    if (context->txn_ != nullptr) {
+        auto write_rec = new WriteRecord(WType::INSERT_TUPLE, view_name, rid);
+        context->log_mgr_->add_write_log(context->txn_, write_rec, buf, fh);
+        context->txn_->append_write_record(write_rec);
+    }
+    fh->unpin_page(page);
+    for (auto &index : view_tab.indexes) {
+        auto ih = sm_manager_->get_index_handle(view_name, index.cols);
+        std::vector<char> key(index.col_tot_len);
+        make_index_key(index, buf, key.data());
+        ih->insert_entry(key.data(), rid, context->txn_);
+    }
+    sm_manager_->record_index_change(view_name, buf, rid, true);
+}
+
+void ViewMaintainer::delete_view_row(const std::string &view_name, const Rid &rid, Context *context) {
+    TabMeta &view_tab = sm_manager_->db_.get_table(view_name);
+    auto fh = sm_manager_->get_file_handle(view_name);
+    auto old_rec = fh->get_record(rid, context);
+    Page *page = fh->pin_page(rid.page_no);
+    fh->delete_record(rid, context);
+    if (context->txn_ != nullptr) {
+        auto write_rec = new WriteRecord(WType::DELETE_TUPLE, view_name, rid, *old_rec);
+        context->log_mgr_->add_write_log(context->txn_, write_rec, nullptr, fh);
+        context->txn_->append_write_record(write_rec);
+    }
+    fh->unpin_page(page);
+    for (auto &index : view_tab.indexes) {
+        auto ih = sm_manager_->get_index_handle(view_name, index.cols);
+        std::vector<char> key(index.col_tot_len);
+        make_index_key(index, old_rec->data, key.data());
+        ih->delete_entry(key.data(), context->txn_);
+    }
+    sm_manager_->record_index_change(view_name, old_rec->data, rid, false);
+}
+
+void ViewMaintainer::update_view_row(const std::string &view_name, const Rid &rid, char *buf, Context *context) {
+    TabMeta &view_tab = sm_manager_->db_.get_table(view_name);
+    auto fh = sm_manager_->get_file_handle(view_name);
+    auto old_rec = fh->get_record(rid, context);
+    Page *page = fh->pin_page(rid.page_no);
+    fh->update_record(rid, buf, context);
+    if (context->txn_ != nullptr) {
+        auto write_rec = new WriteRecord(WType::UPDATE_TUPLE, view_name, rid, *old_rec);
+        context->log_mgr_->add_write_log(context->txn_, write_rec, buf, fh);
+        context->txn_->append_write_record(write_rec);
+    }
+    fh->unpin_page(page);
+    for (auto &index : view_tab.indexes) {
+        auto ih = sm_manager_->get_index_handle(view_name, index.cols);
+        std::vector<char> old_key(index.col_tot_len);
+        std::vector<char> new_key(index.col_tot_len);
+        make_index_key(index, old_rec->data, old_key.data());
+        make_index_key(index, buf, new_key.data());
+        if (old_key != new_key) {
+            ih->delete_entry(old_key.data(), context->txn_);
+            ih->insert_entry(new_key.data(), rid, context->txn_);
+        }
+    }
+    sm_manager_->record_index_change(view_name, old_rec->data, rid, false);
+    sm_manager_->record_index_change(view_name, buf, rid, true);
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/context.h"
+#include "record/rm_defs.h"
+#include "sm_meta.h"
+
+class SmManager;
+
+/**
+ * @description: 物化视图的增量维护器
+ * DML算子每产生一条WriteRecord，就把对应基表元组的增量（插入为+1，删除为-1，更新拆分为-1和+1）
+ * 与其他基表的当前状态做连接（能用等值条件确定查找键时通过基表索引查找），再把结果合并到视图表中：
+ * SPJ视图插入视图元组，删除时通过血缘索引定位由该基表元组产生的视图元组；
+ * 聚集视图通过分组列上的索引定位视图元组并调整COUNT/SUM，分组计数归零时删除该元组。
+ * 视图表上的修改同样以WriteRecord记入当前事务，事务回滚时与基表修改一起撤销。
+ */
+class ViewMaintainer {
+   public:
+    explicit ViewMaintainer(SmManager *sm_manager) : sm_manager_(sm_manager) {}
+
+    /* 将基表上的一次写操作传播到引用该基表的所有物化视图 */
+    void apply(WriteRecord &write_rec, Context *context);
+
+    /* 创建视图表时建立的索引：SPJ视图为血缘上的索引，聚集视图为分组列上的索引 */
+    static std::vector<IndexMeta> view_indexes(const ViewMeta &view, const TabMeta &view_tab);
+
+    /* 创建物化视图时根据基表当前内容计算视图的初始内容 */
+    void populate(const ViewMeta &view, Context *context);
+
+   private:
+    /* 将基表delta_tab上位于delta_pos的一条元组的增量传播到视图view中，sign为+1或-1 */
+    void propagate(const ViewMeta &view, const std::string &delta_tab, const char *delta_row,
+                   const ViewLineage &delta_pos, int sign, Context *context);
+
+    /* 按基表顺序枚举连接结果，rows[i]为view.tabs[i]当前绑定的元组，lineage[i]为其位置 */
+    void join_next(const ViewMeta &view, size_t level, const std::string &delta_tab, const char *delta_row,
+                   std::vector<const char *> &rows, std::vector<ViewLineage> &lineage, int sign,
+                   Context *context);
+
+    /* 在第level个基表上寻找所有字段都与常量或已绑定元组等值的索引，并拼接出查找键 */
+    const IndexMeta *find_join_index(const ViewMeta &view, size_t level, const std::string &delta_tab,
+                                     const char *delta_row, const std::vector<const char *> &rows,
+                                     std::vector<char> &key);
+
+    /* 判断所有基表都已绑定到第level个表时才能求值的条件是否成立 */
+    bool eval_conds(const ViewMeta &view, size_t level, const std::vector<const char *> &rows);
+
+    /* 将一条连接结果合并到视图表中 */
+    void merge_row(const ViewMeta &view, const std::vector<const char *> &rows,
+                   const std::vector<ViewLineage> &lineage, int sign, Context *context);
+
+    /* 在视图表中查找key_cols字段与buf相同的一条元组 */
+    bool find_view_row(const ViewMeta &view, const char *buf, const std::vector<size_t> &key_cols, Rid &rid,
+                       Context *context);
+
+    /* 通过血缘索引查找与buf血缘相同的SPJ视图元组，视图没有血缘索引时返回false */
+    bool find_lineage_row(const ViewMeta &view, const char *buf, Rid &rid, Context *context);
+
+    void insert_view_row(const std::string &view_name, char *buf, Context *context);
+
+    void delete_view_row(const std::string &view_name, const Rid &rid, Context *context);
+
+    void update_view_row(const std::string &view_name, const Rid &rid, char *buf, Context *context);
+
+    SmManager *sm_manager_;
+};
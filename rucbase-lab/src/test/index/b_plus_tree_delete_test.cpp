@@ -65,7 +65,8 @@ class BPlusTreeTests : public ::testing::Test {
         coldef.push_back({"col1", TYPE_INT, 4});
         coldef.push_back({"col2", TYPE_INT, 4});
         sm_->create_table(TEST_FILE_NAME, coldef, nullptr);
-        sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
+        // 直接通过IxManager创建索引，SmManager不持有索引文件的句柄，测试点独占打开的索引文件
+        ix_manager_->create_index(TEST_FILE_NAME, {sm_->db_.get_table(TEST_FILE_NAME).cols[0]});
         assert(ix_manager_->exists(TEST_FILE_NAME, TEST_COL));
         // 打开测试文件
         ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
@@ -429,6 +430,45 @@ TEST_F(BPlusTreeTests, InsertAndDeleteTest2) {
     }
 }
 
+/**
+ * @brief 删除结点释放的页面放入空闲页面链表，之后分裂时优先复用，文件的页面数不再增长
+ */
+TEST_F(BPlusTreeTests, ReuseReleasedPagesTest) {
+    const int64_t scale = 200;
+    const int order = 4;
+
+    assert(order > 2 && order <= ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+
+    for (int64_t key = 1; key <= scale; key++) {
+        Rid rid = {.page_no = 0, .slot_no = static_cast<int32_t>(key)};
+        bool insert_ret = ih_->insert_entry((const char *)&key, rid, txn_.get());
+        ASSERT_EQ(insert_ret, true);
+    }
+    int num_pages = ih_->file_hdr_->num_pages_;
+    // 只保留最后一个key，合并结点释放的页面进入空闲页面链表，文件的页面数不变
+    for (int64_t key = 1; key < scale; key++) {
+        ASSERT_EQ(ih_->delete_entry((const char *)&key, txn_.get()), true);
+    }
+    EXPECT_NE(ih_->file_hdr_->first_free_page_no_, IX_NO_PAGE);
+    EXPECT_EQ(ih_->file_hdr_->num_pages_, num_pages);
+
+    // 重新插入时复用释放的页面，不再分配新页面
+    for (int64_t key = 1; key < scale; key++) {
+        Rid rid = {.page_no = 0, .slot_no = static_cast<int32_t>(key)};
+        bool insert_ret = ih_->insert_entry((const char *)&key, rid, txn_.get());
+        ASSERT_EQ(insert_ret, true);
+    }
+    EXPECT_EQ(ih_->file_hdr_->num_pages_, num_pages);
+    std::vector<Rid> rids;
+    for (int64_t key = 1; key <= scale; key++) {
+        rids.clear();
+        ih_->get_value((const char *)&key, &rids, txn_.get());
+        ASSERT_EQ(rids.size(), 1);
+        EXPECT_EQ(rids[0].slot_no, key);
+    }
+}
+
 /**
  * @brief 随机插入和删除多个键值对
  * 
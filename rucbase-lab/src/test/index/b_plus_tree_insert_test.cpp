@@ -65,7 +65,8 @@ class BPlusTreeTests : public ::testing::Test {
         coldef.push_back({"col1", TYPE_INT, 4});
         coldef.push_back({"col2", TYPE_INT, 4});
         sm_->create_table(TEST_FILE_NAME, coldef, nullptr);
-        sm_->create_index(TEST_FILE_NAME, TEST_COL, nullptr);
+        // 直接通过IxManager创建索引，SmManager不持有索引文件的句柄，测试点独占打开的索引文件
+        ix_manager_->create_index(TEST_FILE_NAME, {sm_->db_.get_table(TEST_FILE_NAME).cols[0]});
         assert(ix_manager_->exists(TEST_FILE_NAME, TEST_COL));
         // 打开测试文件
         ih_ = ix_manager_->open_index(TEST_FILE_NAME, TEST_COL);
@@ -0,0 +1,116 @@
+#include "optimizer/rewriter.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+static Condition col_val(const std::string &tab, const std::string &col, CompOp op, int val) {
+    Condition cond;
+    cond.lhs_col = {.tab_name = tab, .col_name = col};
+    cond.op = op;
+    cond.is_rhs_val = true;
+    cond.rhs_val.set_int(val);
+    return cond;
+}
+
+static Condition col_col(const std::string &lhs_tab, const std::string &lhs_col, CompOp op, const std::string &rhs_tab,
+                         const std::string &rhs_col) {
+    Condition cond;
+    cond.lhs_col = {.tab_name = lhs_tab, .col_name = lhs_col};
+    cond.op = op;
+    cond.is_rhs_val = false;
+    cond.rhs_col = {.tab_name = rhs_tab, .col_name = rhs_col};
+    return cond;
+}
+
+static bool has_cond(const std::vector<Condition> &conds, const std::string &tab, const std::string &col, CompOp op,
+                     int val) {
+    return std::any_of(conds.begin(), conds.end(), [&](const Condition &cond) {
+        return cond.is_rhs_val && cond.lhs_col.tab_name == tab && cond.lhs_col.col_name == col && cond.op == op &&
+               cond.rhs_val.int_val == val;
+    });
+}
+
+/**
+ * @brief 同一字段与自身比较的条件被折叠
+ */
+TEST(RewriterTest, ConstantFold) {
+    RewriteEngine rewriter;
+    std::vector<Condition> conds = {col_col("t", "a", OP_EQ, "t", "a"), col_val("t", "b", OP_GT, 1)};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+    ASSERT_EQ(conds.size(), 1);
+    EXPECT_TRUE(has_cond(conds, "t", "b", OP_GT, 1));
+
+    conds = {col_col("t", "a", OP_LT, "t", "a")};
+    EXPECT_FALSE(rewriter.rewrite(conds));
+}
+
+/**
+ * @brief 同一字段上没有公共解的条件被识别为矛盾
+ */
+TEST(RewriterTest, Contradiction) {
+    RewriteEngine rewriter;
+    std::vector<Condition> conds = {col_val("t", "a", OP_EQ, 1), col_val("t", "a", OP_EQ, 2)};
+    EXPECT_FALSE(rewriter.rewrite(conds));
+
+    conds = {col_val("t", "a", OP_GT, 5), col_val("t", "a", OP_LE, 5)};
+    EXPECT_FALSE(rewriter.rewrite(conds));
+
+    conds = {col_val("t", "a", OP_GE, 5), col_val("t", "a", OP_LE, 5), col_val("t", "a", OP_NE, 5)};
+    EXPECT_FALSE(rewriter.rewrite(conds));
+
+    conds = {col_val("t", "a", OP_GE, 5), col_val("t", "a", OP_LE, 5)};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+}
+
+/**
+ * @brief 重复的条件和被更严格的条件蕴含的条件被删除
+ */
+TEST(RewriterTest, Redundancy) {
+    RewriteEngine rewriter;
+    std::vector<Condition> conds = {col_val("t", "a", OP_GT, 3), col_val("t", "a", OP_GT, 5),
+                                    col_val("t", "a", OP_GE, 5), col_val("t", "a", OP_LT, 10),
+                                    col_val("t", "a", OP_NE, 20), col_val("t", "a", OP_NE, 7),
+                                    col_val("t", "a", OP_LT, 10)};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+    ASSERT_EQ(conds.size(), 3);
+    EXPECT_TRUE(has_cond(conds, "t", "a", OP_GT, 5));
+    EXPECT_TRUE(has_cond(conds, "t", "a", OP_LT, 10));
+    EXPECT_TRUE(has_cond(conds, "t", "a", OP_NE, 7));
+
+    conds = {col_val("t", "a", OP_LT, 9), col_val("t", "a", OP_EQ, 4), col_val("t", "a", OP_NE, 3)};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+    ASSERT_EQ(conds.size(), 1);
+    EXPECT_TRUE(has_cond(conds, "t", "a", OP_EQ, 4));
+}
+
+/**
+ * @brief 常量条件沿等值连接传递，等值连接本身也会传递
+ */
+TEST(RewriterTest, Transitive) {
+    RewriteEngine rewriter;
+    std::vector<Condition> conds = {col_col("t1", "a", OP_EQ, "t2", "b"), col_val("t2", "b", OP_EQ, 5)};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+    EXPECT_TRUE(has_cond(conds, "t1", "a", OP_EQ, 5));
+    auto derived = std::find_if(conds.begin(), conds.end(), [](const Condition &cond) {
+        return cond.is_rhs_val && cond.lhs_col.tab_name == "t1";
+    });
+    EXPECT_EQ(derived->rhs_val.raw, nullptr);
+
+    conds = {col_col("t1", "a", OP_EQ, "t2", "b"), col_col("t2", "b", OP_EQ, "t3", "c")};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+    EXPECT_EQ(conds.size(), 3);
+
+    // 推导出的条件与已有条件矛盾
+    conds = {col_col("t1", "a", OP_EQ, "t2", "b"), col_val("t2", "b", OP_EQ, 5), col_val("t1", "a", OP_GT, 6)};
+    EXPECT_FALSE(rewriter.rewrite(conds));
+
+    // 推导出的范围条件被更严格的条件消除，结果稳定
+    conds = {col_col("t1", "a", OP_EQ, "t2", "b"), col_val("t2", "b", OP_GT, 5), col_val("t1", "a", OP_GT, 7)};
+    EXPECT_TRUE(rewriter.rewrite(conds));
+    EXPECT_EQ(conds.size(), 3);
+    EXPECT_TRUE(has_cond(conds, "t1", "a", OP_GT, 7));
+    EXPECT_TRUE(has_cond(conds, "t2", "b", OP_GT, 7));
+}
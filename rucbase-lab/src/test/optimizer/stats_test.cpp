@@ -0,0 +1,75 @@
+#include "system/sm_stats.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+static Condition col_val(const std::string &tab, const std::string &col, CompOp op, int val) {
+    Condition cond;
+    cond.lhs_col = {.tab_name = tab, .col_name = col};
+    cond.op = op;
+    cond.is_rhs_val = true;
+    cond.rhs_val.set_int(val);
+    return cond;
+}
+
+/**
+ * @brief 没有观测值时用表的行数和默认选择率估计
+ */
+TEST(StatsTest, DefaultEstimate) {
+    StatsStore stats;
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {}), STATS_DEFAULT_ROWS);
+    stats.feedback("t", {}, 500);
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {}), 500);
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {col_val("t", "a", OP_EQ, 1)}), 500 * STATS_EQ_SELECTIVITY);
+}
+
+/**
+ * @brief 只有常量不同的扫描共用一个形状，观测值取加权平均
+ */
+TEST(StatsTest, ShapeIgnoresConstants) {
+    StatsStore stats;
+    stats.feedback("t", {col_val("t", "a", OP_EQ, 1)}, 10);
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {col_val("t", "a", OP_EQ, 2)}), 10);
+    stats.feedback("t", {col_val("t", "a", OP_EQ, 3)}, 30);
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {col_val("t", "a", OP_EQ, 4)}), 20);
+    EXPECT_EQ(stats.num_scans(), 1);
+
+    // 字段或比较符不同的扫描是不同的形状
+    stats.feedback("t", {col_val("t", "a", OP_GT, 1)}, 70);
+    stats.feedback("t", {col_val("t", "b", OP_EQ, 1)}, 80);
+    EXPECT_EQ(stats.num_scans(), 3);
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {col_val("t", "a", OP_GT, 9)}), 70);
+}
+
+/**
+ * @brief 形状个数达到上限时淘汰最久没有使用的形状
+ */
+TEST(StatsTest, EvictLeastRecentlyUsed) {
+    StatsStore stats;
+    for (size_t i = 0; i < STATS_MAX_SCANS; i++) {
+        stats.feedback("t" + std::to_string(i), {col_val("t", "a", OP_EQ, 0)}, i);
+    }
+    EXPECT_EQ(stats.num_scans(), STATS_MAX_SCANS);
+    // 使用t0之后，最久没有使用的是t1
+    EXPECT_DOUBLE_EQ(stats.estimate("t0", {col_val("t", "a", OP_EQ, 0)}), 0);
+    stats.feedback("new", {col_val("t", "a", OP_EQ, 0)}, 5);
+    EXPECT_EQ(stats.num_scans(), STATS_MAX_SCANS);
+    EXPECT_DOUBLE_EQ(stats.estimate("t0", {col_val("t", "a", OP_EQ, 0)}), 0);
+    EXPECT_DOUBLE_EQ(stats.estimate("t1", {col_val("t", "a", OP_EQ, 0)}), STATS_DEFAULT_ROWS * STATS_EQ_SELECTIVITY);
+    EXPECT_DOUBLE_EQ(stats.estimate("new", {col_val("t", "a", OP_EQ, 0)}), 5);
+}
+
+/**
+ * @brief 删除表时清除该表的所有形状
+ */
+TEST(StatsTest, EraseTable) {
+    StatsStore stats;
+    stats.feedback("t", {}, 100);
+    stats.feedback("t", {col_val("t", "a", OP_EQ, 1)}, 10);
+    stats.feedback("tt", {col_val("tt", "a", OP_EQ, 1)}, 10);
+    stats.erase("t");
+    EXPECT_EQ(stats.num_scans(), 1);
+    EXPECT_DOUBLE_EQ(stats.estimate("t", {}), STATS_DEFAULT_ROWS);
+}
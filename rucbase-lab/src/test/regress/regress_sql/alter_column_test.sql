@@ -0,0 +1,51 @@
+create table t (id int, pad char(200));
+create index t(id);
+insert into t values (1, 'r1');
+insert into t values (2, 'r2');
+insert into t values (3, 'r3');
+insert into t values (4, 'r4');
+insert into t values (5, 'r5');
+insert into t values (6, 'r6');
+insert into t values (7, 'r7');
+insert into t values (8, 'r8');
+insert into t values (9, 'r9');
+insert into t values (10, 'r10');
+insert into t values (11, 'r11');
+insert into t values (12, 'r12');
+insert into t values (13, 'r13');
+insert into t values (14, 'r14');
+insert into t values (15, 'r15');
+insert into t values (16, 'r16');
+insert into t values (17, 'r17');
+insert into t values (18, 'r18');
+insert into t values (19, 'r19');
+insert into t values (20, 'r20');
+alter table t add column c int default 5;
+alter table t add column d float;
+select id, c, d from t where id <= 3;
+select id, c from t where id = 19;
+update t set c = 9 where id = 2;
+update t set pad = 'x20' where id = 20;
+insert into t values (21, 'r21', 6, 1.5);
+select id, pad, c, d from t where id = 2;
+select id, pad, c from t where id = 20;
+select id, c, d from t where id = 21;
+select id, c from t where c <> 5;
+-- crash
+select id, c, d from t where c <> 5;
+select id, c from t where id = 2;
+delete from t where id <= 19;
+vacuum t;
+select id, pad, c from t;
+vacuum t;
+insert into t values (22, 'r22', 7, 2.5);
+select id, c, d from t;
+alter table t drop column pad;
+select * from t;
+alter table t add column e int default 8;
+-- restart
+select * from t;
+insert into t values (23, 3, 3.5, 4);
+-- crash
+select * from t;
+select * from t where id = 23;
@@ -0,0 +1,16 @@
+create table stock (s_id int, s_qty int, s_reserved int, s_price float);
+insert into stock values (1, 10, 2, 5.0);
+insert into stock values (2, 3, 3, 2.5);
+insert into stock values (3, 0, 0, 1.0);
+update stock set s_qty = s_qty - 1 where s_qty >= s_reserved + 1;
+select * from stock;
+update stock set s_price = s_price * 2 + 0.5, s_reserved = -s_reserved where s_id = 1;
+select * from stock where s_id = 1;
+update stock set s_qty = (s_qty + s_reserved) * 2 where s_id = 2;
+select s_qty from stock where s_id = 2;
+update stock set s_qty = s_qty / s_reserved;
+select * from stock;
+update stock set s_qty = s_price;
+select * from stock where s_id < -1 + 3;
+-- crash
+select * from stock;
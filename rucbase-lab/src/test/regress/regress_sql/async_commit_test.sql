@@ -0,0 +1,24 @@
+create table event (e_id int, e_kind char(4));
+set async_commit = maybe;
+set async_commit = on;
+insert into event values (1, 'a');
+insert into event values (2, 'a');
+-- sleep 1
+-- crash
+select * from event;
+-- session async
+set async_commit = on;
+insert into event values (3, 'a');
+-- session sync
+insert into event values (4, 's');
+-- crash
+select * from event;
+set async_commit = on;
+begin;
+insert into event values (5, 'a');
+update event set e_kind = 'u' where e_id = 1;
+commit;
+set async_commit = off;
+delete from event where e_id = 2;
+-- crash
+select * from event;
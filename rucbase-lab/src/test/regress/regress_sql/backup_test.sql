@@ -0,0 +1,27 @@
+create table goods (g_id int, g_name char(8), g_price int);
+create index goods(g_id);
+insert into goods values (1, 'apple', 5);
+insert into goods values (2, 'pear', 4);
+insert into goods values (3, 'plum', 7);
+update goods set g_price = 6 where g_id = 1;
+-- session open
+begin;
+insert into goods values (4, 'kiwi', 9);
+update goods set g_price = 1 where g_id = 2;
+-- session main
+backup to 'regress_backup_db';
+backup to 'regress_backup_db';
+insert into goods values (5, 'lime', 3);
+-- session open
+commit;
+-- session main
+select * from goods;
+-- open regress_backup_db
+-- sleep 1
+select * from goods;
+select g_name from goods where g_id = 1;
+select g_name from goods where g_id = 2;
+select g_name from goods where g_id = 4;
+select g_name from goods where g_id = 5;
+insert into goods values (6, 'fig', 2);
+select g_name from goods where g_id = 6;
@@ -0,0 +1,18 @@
+create table item (i_id int, i_name char(8), i_price float);
+insert into item values (1, 'pen', 1.5);
+insert into item values (2, 'ink', 2.5);
+insert into item values (3, 'pad', 3.5);
+insert into item values (2, 'cap', 4.5);
+create index item(i_id);
+select i_name from item where i_id = 2;
+delete from item where i_name = 'ink';
+create index item(i_id);
+select i_name from item where i_id = 2;
+create index item(i_id);
+update item set i_id = 4 where i_id = 3;
+select i_name from item where i_id = 4;
+select i_name from item where i_id = 3;
+-- crash
+select i_price from item where i_id = 4;
+create index item(i_name);
+select i_id from item where i_name = 'cap';
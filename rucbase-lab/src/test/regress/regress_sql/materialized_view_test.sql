@@ -0,0 +1,27 @@
+create table orders (o_id int, o_c_id int, o_amount int);
+create table customer (c_id int, c_name char(8));
+create index customer(c_id);
+insert into customer values (1, 'alice');
+insert into customer values (2, 'bob');
+insert into orders values (1, 1, 10);
+insert into orders values (2, 1, 10);
+insert into orders values (3, 2, 20);
+create materialized view order_names as select o_amount, c_name from orders, customer where orders.o_c_id = customer.c_id;
+create materialized view order_sums as select o_c_id, count(*), sum(o_amount) from orders group by o_c_id;
+select * from order_names;
+select * from order_sums;
+delete from orders where o_id = 1;
+update customer set c_name = 'carol' where c_id = 2;
+insert into orders values (4, 2, 25);
+select * from order_names;
+select * from order_sums;
+vacuum orders;
+-- crash
+delete from orders where o_id = 2;
+update orders set o_amount = 30 where o_id = 3;
+select * from order_names;
+select * from order_sums;
+drop materialized view order_names;
+drop materialized view order_sums;
+vacuum orders;
+select * from orders;
@@ -0,0 +1,29 @@
+create table sales (s_id int, s_month int, s_amount float) partition by range (s_month) (partition q1 values less than (4), partition q2 values less than (7));
+insert into sales values (1, 1, 10.5);
+insert into sales values (2, 3, 20.0);
+insert into sales values (3, 5, 30.0);
+insert into sales values (4, 9, 40.0);
+alter table sales add partition rest values less than (maxvalue);
+insert into sales values (4, 9, 40.0);
+create index sales(s_id);
+select * from sales where s_month < 4;
+select s_id from sales where s_month >= 5;
+select s_amount from sales where s_id = 3;
+update sales set s_amount = 35.0 where s_month = 5;
+delete from sales where s_id = 2;
+-- crash
+select * from sales;
+select s_month from sales where s_id = 4;
+alter table sales drop partition q1;
+select * from sales;
+insert into sales values (5, 2, 50.0);
+select s_id, s_amount from sales where s_id = 5;
+create table users (u_id int, u_name char(8)) partition by hash (u_id) partitions 4;
+insert into users values (1, 'a');
+insert into users values (2, 'b');
+insert into users values (3, 'c');
+insert into users values (4, 'd');
+insert into users values (5, 'e');
+select u_name from users where u_id = 3;
+delete from users where u_id = 4;
+select * from users;
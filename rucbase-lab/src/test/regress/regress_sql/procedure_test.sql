@@ -0,0 +1,22 @@
+create table account (a_id int, a_balance float);
+create table history (h_from int, h_to int, h_amount float);
+insert into account values (1, 100.0);
+insert into account values (2, 50.0);
+create procedure pay (src int, dst int, amount float) as $$ update account set a_balance = a_balance - $3 where a_id = $1; update account set a_balance = a_balance + $3 where a_id = $2; insert into history values ($1, $2, $3); select a_balance from account where a_id = $1; $$;
+call pay (1, 2, 30.0);
+call pay (2, 1, 5);
+select * from account;
+select * from history;
+create procedure pay () as $$ select * from account; $$;
+create procedure bad (x int) as $$ select * from nosuch; $$;
+create procedure bad (x int) as $$ select * from account where a_id = $2; $$;
+call pay (1, 2);
+call pay (1, 2, 'x');
+drop procedure pay;
+call pay (1, 2, 1.0);
+create procedure pay (id int) as $$ select a_balance from account where a_id = $1; $$;
+call pay (2);
+-- restart
+call pay (1);
+drop procedure pay;
+drop procedure pay;
@@ -0,0 +1,30 @@
+create table account (a_id int, a_name char(8), a_balance int);
+create index account(a_id);
+insert into account values (1, 'ann', 100);
+insert into account values (2, 'bob', 200);
+insert into account values (3, 'cat', 300);
+-- restart
+insert into account values (4, 'dan', 400);
+update account set a_balance = 150 where a_id = 1;
+delete from account where a_id = 2;
+-- session loser
+begin;
+insert into account values (5, 'eve', 500);
+update account set a_id = 6 where a_id = 3;
+delete from account where a_id = 4;
+-- session main
+-- crash
+-- sleep 1
+select * from account;
+select a_name from account where a_id = 3;
+select a_name from account where a_id = 4;
+select a_name from account where a_id = 5;
+select a_name from account where a_id = 6;
+insert into account values (2, 'bob', 250);
+insert into account values (5, 'eve', 500);
+update account set a_id = 7 where a_id = 4;
+-- crash
+select * from account;
+select a_name from account where a_id = 2;
+select a_name from account where a_id = 4;
+select a_name from account where a_id = 7;
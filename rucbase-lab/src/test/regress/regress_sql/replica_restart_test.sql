@@ -0,0 +1,32 @@
+create table stock (s_id int, s_qty int);
+create index stock(s_id);
+create table note (n_id int);
+insert into stock values (1, 10);
+insert into stock values (2, 20);
+-- replica
+-- sleep 1
+select * from stock;
+-- primary
+-- session loser
+begin;
+insert into stock values (3, 30);
+update stock set s_qty = 11 where s_id = 1;
+delete from stock where s_id = 2;
+-- session main
+insert into note values (1);
+-- sleep 1
+-- replica
+-- restart
+select * from stock;
+select s_qty from stock where s_id = 2;
+select s_qty from stock where s_id = 3;
+-- primary
+-- session loser
+commit;
+-- session main
+-- sleep 1
+-- replica
+select * from stock;
+select s_qty from stock where s_id = 1;
+select s_qty from stock where s_id = 2;
+select s_qty from stock where s_id = 3;
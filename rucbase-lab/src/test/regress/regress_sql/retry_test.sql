@@ -0,0 +1,16 @@
+create table counter (c_id int, c_value int);
+create index counter(c_id);
+insert into counter values (1, 0);
+insert into counter values (2, 0);
+begin;
+update counter set c_value = c_value + 1 where c_id = 1;
+insert into counter values (3, 0);
+-- session other
+update counter set c_value = c_value + 10 where c_id = 1;
+update counter set c_value = c_value + 10 where c_id = 2;
+select * from counter where c_id = 3;
+-- session main
+commit;
+-- session other
+update counter set c_value = c_value + 10 where c_id = 1;
+select * from counter;
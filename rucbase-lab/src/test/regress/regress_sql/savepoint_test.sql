@@ -0,0 +1,26 @@
+create table orders (o_id int, o_qty int);
+create index orders(o_id);
+insert into orders values (1, 10);
+begin;
+insert into orders values (2, 20);
+update orders set o_qty = o_qty / 0 where o_id = 2;
+insert into orders values (3, 'x');
+select * from orders;
+savepoint s1;
+insert into orders values (3, 30);
+update orders set o_id = 5 where o_id = 1;
+savepoint s2;
+delete from orders where o_id = 2;
+rollback to savepoint s2;
+select * from orders;
+rollback to s1;
+select * from orders;
+select o_qty from orders where o_id = 1;
+release savepoint s1;
+rollback to s1;
+insert into orders values (4, 40);
+commit;
+select * from orders;
+-- crash
+select * from orders;
+select o_qty from orders where o_id = 4;
@@ -0,0 +1,25 @@
+create table item (i_id int, i_name char(8), i_price float);
+create index item(i_id);
+insert into item values (1, 'pen', 1.5);
+insert into item values (2, 'ink', 3.0);
+begin read only;
+select * from item;
+insert into item values (3, 'cap', 0.5);
+update item set i_price = 2.0 where i_id = 1;
+create table other (o_id int);
+select i_name from item where i_id = 2;
+commit;
+begin;
+insert into item values (3, 'cap', 0.5);
+update item set i_id = 4, i_price = 9.0 where i_id = 1;
+delete from item where i_id = 2;
+select * from item;
+abort;
+select * from item;
+select i_name from item where i_id = 1;
+select i_name from item where i_id = 3;
+select i_name from item where i_id = 4;
+insert into item values (3, 'cap', 0.5);
+-- crash
+select * from item;
+select i_name from item where i_id = 2;
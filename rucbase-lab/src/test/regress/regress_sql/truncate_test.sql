@@ -0,0 +1,35 @@
+create table t (id int, name char(8));
+create index t(id);
+insert into t values (1, 'a');
+insert into t values (2, 'b');
+insert into t values (3, 'c');
+truncate table t;
+insert into t values (4, 'd');
+-- crash
+select * from t;
+select * from t where id = 1;
+insert into t values (1, 'a2');
+select * from t where id = 1;
+truncate table t;
+truncate table t;
+insert into t values (5, 'e');
+insert into t values (6, 'f');
+insert into t values (9, 'g');
+select * from t;
+drop table t;
+create table t (k int);
+insert into t values (7);
+select * from t;
+-- crash
+select * from t;
+insert into t values (8);
+-- restart
+select * from t;
+create table p (a int) partition by range (a) (partition p1 values less than (10), partition p2 values less than (20));
+insert into p values (1);
+insert into p values (15);
+alter table p drop partition p2;
+alter table p add partition p2 values less than (20);
+insert into p values (12);
+-- crash
+select * from p;
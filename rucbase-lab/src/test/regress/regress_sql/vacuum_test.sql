@@ -0,0 +1,92 @@
+create table t (id int, pad char(200));
+create index t(id);
+insert into t values (1, 'r1');
+insert into t values (2, 'r2');
+insert into t values (3, 'r3');
+insert into t values (4, 'r4');
+insert into t values (5, 'r5');
+insert into t values (6, 'r6');
+insert into t values (7, 'r7');
+insert into t values (8, 'r8');
+insert into t values (9, 'r9');
+insert into t values (10, 'r10');
+insert into t values (11, 'r11');
+insert into t values (12, 'r12');
+insert into t values (13, 'r13');
+insert into t values (14, 'r14');
+insert into t values (15, 'r15');
+insert into t values (16, 'r16');
+insert into t values (17, 'r17');
+insert into t values (18, 'r18');
+insert into t values (19, 'r19');
+insert into t values (20, 'r20');
+insert into t values (21, 'r21');
+insert into t values (22, 'r22');
+insert into t values (23, 'r23');
+insert into t values (24, 'r24');
+insert into t values (25, 'r25');
+insert into t values (26, 'r26');
+insert into t values (27, 'r27');
+insert into t values (28, 'r28');
+insert into t values (29, 'r29');
+insert into t values (30, 'r30');
+insert into t values (31, 'r31');
+insert into t values (32, 'r32');
+insert into t values (33, 'r33');
+insert into t values (34, 'r34');
+insert into t values (35, 'r35');
+insert into t values (36, 'r36');
+insert into t values (37, 'r37');
+insert into t values (38, 'r38');
+insert into t values (39, 'r39');
+insert into t values (40, 'r40');
+insert into t values (41, 'r41');
+insert into t values (42, 'r42');
+insert into t values (43, 'r43');
+insert into t values (44, 'r44');
+insert into t values (45, 'r45');
+insert into t values (46, 'r46');
+insert into t values (47, 'r47');
+insert into t values (48, 'r48');
+insert into t values (49, 'r49');
+insert into t values (50, 'r50');
+insert into t values (51, 'r51');
+insert into t values (52, 'r52');
+insert into t values (53, 'r53');
+insert into t values (54, 'r54');
+insert into t values (55, 'r55');
+insert into t values (56, 'r56');
+insert into t values (57, 'r57');
+insert into t values (58, 'r58');
+insert into t values (59, 'r59');
+insert into t values (60, 'r60');
+delete from t where id <= 45;
+vacuum t;
+select * from t;
+select * from t where id = 50;
+insert into t values (61, 'r61');
+-- crash
+select * from t;
+select * from t where id = 61;
+select * from t where id = 55;
+delete from t where id < 58;
+vacuum t;
+-- crash
+select * from t;
+begin;
+vacuum t;
+abort;
+vacuum nosuch;
+insert into t values (62, 'r62');
+-- restart
+select * from t;
+select * from t where id = 62;
+-- replica
+-- sleep 1
+-- primary
+delete from t where id < 61;
+vacuum t;
+-- sleep 1
+-- replica
+select * from t;
+select * from t where id = 62;
@@ -0,0 +1,219 @@
+import os
+import shutil
+import signal
+import socket
+import subprocess
+import sys
+import time
+
+# 回归测试：regress_sql中的每个用例为<name>.sql和<name>_output.txt
+# 用例中以"-- "开头的行是控制服务器的指令，其余每行是一条发给服务器的SQL：
+#   -- restart            正常关闭服务器后重启
+#   -- crash              kill -9服务器后重启，重启时执行故障恢复
+#   -- session <name>     之后的语句通过名为name的连接发送，默认连接名为main
+#   -- replica            之后的语句发给副本，第一次使用时正常关闭主库，复制主库的目录作为副本的初始数据后启动两者
+#   -- primary            之后的语句重新发给主库
+#   -- sleep <seconds>    等待一段时间，用于等待后台线程
+#   -- open <database>    正常关闭主库，以database目录（例如备份目录）启动新的主库，之后的语句发给它
+# 所有数据库output.txt的内容合在一起，与标准答案按行的多重集比较
+
+TESTS = ["materialized_view_test",
+         "partition_test",
+         "index_build_test",
+         "arithmetic_update_test",
+         "procedure_test",
+         "transaction_test",
+         "retry_test",
+         "savepoint_test",
+         "async_commit_test",
+         "recovery_test",
+         "replica_restart_test",
+         "backup_test",
+         "vacuum_test",
+         "truncate_test",
+         "alter_column_test"]
+
+FAILED_TESTS = []
+
+PORT = 8765
+REPLICA_PORT = 8766
+
+
+# current dir is root/build
+def get_test_name(test_case):
+    return "../src/test/regress/regress_sql/" + str(test_case) + ".sql"
+
+
+def get_output_name(test_case):
+    return "../src/test/regress/regress_sql/" + str(test_case) + "_output.txt"
+
+
+def build():
+    # root
+    os.chdir("../../../")
+    if os.path.exists("./build"):
+        os.system("rm -rf build")
+    os.mkdir("./build")
+    os.chdir("./build")
+    os.system("cmake ..")
+    os.system("make rmdb -j4")
+    os.chdir("..")
+
+
+class Server:
+    def __init__(self, database_name, port, primary=None):
+        self.database_name = database_name
+        self.port = port
+        self.primary = primary
+        self.proc = None
+        self.conns = {}
+
+    def start(self):
+        args = ["./bin/rmdb", self.database_name, "--port", str(self.port)]
+        if self.primary is not None:
+            args += ["--replica-of", self.primary]
+        self.proc = subprocess.Popen(args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        # 服务器完成恢复并开始监听之后才能连接
+        for _ in range(100):
+            try:
+                socket.create_connection(("127.0.0.1", self.port)).close()
+                return
+            except OSError:
+                time.sleep(0.1)
+        raise RuntimeError("server " + self.database_name + " did not start")
+
+    def stop(self, crash):
+        for conn in self.conns.values():
+            conn.close()
+        self.conns = {}
+        if crash:
+            self.proc.kill()
+        else:
+            self.proc.send_signal(signal.SIGINT)
+            # 监听循环阻塞在accept中，发起一次连接让它退出
+            try:
+                socket.create_connection(("127.0.0.1", self.port)).close()
+            except OSError:
+                pass
+        try:
+            self.proc.wait(timeout=30)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+            self.proc.wait()
+
+    def send(self, session, sql):
+        if session not in self.conns:
+            self.conns[session] = socket.create_connection(("127.0.0.1", self.port))
+        conn = self.conns[session]
+        conn.sendall(sql.encode() + b"\0")
+        data = b""
+        while not data.endswith(b"\0"):
+            recv = conn.recv(65536)
+            if not recv:
+                raise RuntimeError("connection was closed by server")
+            data += recv
+        return data.rstrip(b"\0").decode()
+
+
+def count_lines(ans_dict, file_name, sign):
+    # 没有执行过产生输出的语句的服务器不会创建output.txt
+    if not os.path.exists(file_name):
+        return
+    with open(file_name, "r") as hand:
+        for line in hand:
+            line = line.strip('\n')
+            if line == "":
+                continue
+            num = ans_dict.setdefault(line, 0)
+            ans_dict[line] = num + sign
+
+
+def run_test(test_case):
+    if test_case not in TESTS:
+        print(f"Test case '{test_case}' is not recognized.")
+        return
+    print("-----------Regress Unit Testing " + test_case + "...-----------")
+    database_name = "regress_test_db"
+    replica_name = "regress_replica_db"
+    with open(get_test_name(test_case), "r") as test_file:
+        opened = [line.split()[2] for line in test_file if line.startswith("-- open ")]
+    for name in [database_name, replica_name] + opened:
+        if os.path.exists(name):
+            os.system("rm -rf " + name)
+
+    primary = Server(database_name, PORT)
+    primary.start()
+    replica = None
+    target = primary
+    session = "main"
+    try:
+        with open(get_test_name(test_case), "r") as test_file:
+            for line in test_file:
+                line = line.strip()
+                if line == "":
+                    continue
+                if not line.startswith("-- "):
+                    target.send(session, line)
+                    continue
+                words = line[3:].split()
+                if words[0] in ["restart", "crash"]:
+                    target.stop(words[0] == "crash")
+                    target.start()
+                elif words[0] == "session":
+                    session = words[1]
+                elif words[0] == "replica":
+                    if replica is None:
+                        primary.stop(False)
+                        shutil.copytree(database_name, replica_name,
+                                        ignore=shutil.ignore_patterns("*.sock", "output.txt"))
+                        primary.start()
+                        replica = Server(replica_name, REPLICA_PORT, database_name)
+                        replica.start()
+                    target = replica
+                elif words[0] == "primary":
+                    target = primary
+                elif words[0] == "open":
+                    primary.stop(False)
+                    primary = Server(words[1], PORT)
+                    primary.start()
+                    target = primary
+                elif words[0] == "sleep":
+                    time.sleep(float(words[1]))
+    finally:
+        for server in [replica, primary]:
+            if server is not None:
+                server.stop(True)
+
+    # check result
+    ans_dict = {}
+    count_lines(ans_dict, get_output_name(test_case), 1)
+    count_lines(ans_dict, database_name + "/output.txt", -1)
+    if replica is not None:
+        count_lines(ans_dict, replica_name + "/output.txt", -1)
+    for name in opened:
+        count_lines(ans_dict, name + "/output.txt", -1)
+    mismatches = [line for line, num in ans_dict.items() if num != 0]
+    if len(mismatches) != 0:
+        FAILED_TESTS.append(test_case)
+        print("In Regress unit test:" + test_case + ", your answer mismatches standard answer:")
+        for line in mismatches:
+            print(("  missing " if ans_dict[line] > 0 else "  unexpected ") + line)
+
+
+if __name__ == "__main__":
+    # 不指定用例时运行全部用例，--no-build使用已经编译好的build目录
+    args = sys.argv[1:]
+    if "--no-build" in args:
+        args.remove("--no-build")
+        os.chdir("../../../")
+    else:
+        build()
+    os.chdir("./build")
+    for test_case in args if len(args) > 0 else TESTS:
+        run_test(test_case)
+    if len(FAILED_TESTS) != 0:
+        print("Your program fails the following test cases: ")
+        for failed_test in FAILED_TESTS:
+            print("[" + failed_test + "]  ")
+        sys.exit(1)
+    print("You have passed all regress unit test cases!")
@@ -427,3 +427,50 @@ TEST_F(BufferPoolManagerTest, ConcurrencyTest) {
 
     disk_manager_->close_file(fd);
 }
+
+/**
+ * @brief 预热在不持有缓冲池latch时读盘，读盘之后页面被读入、修改、写回并换出时，装入的必须是写回之后的版本
+ */
+TEST_F(BufferPoolManagerTest, WarmUpRereadsAfterWriteBack) {
+    const std::string filename = "warm_up_test";
+
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager);
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    Page *page = bpm->new_page(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->get_data(), PAGE_SIZE, "old");
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    EXPECT_EQ(true, bpm->delete_page(page_id));
+
+    // 预热线程记下写回次数后读盘，读到旧版本
+    uint64_t write_backs = bpm->get_write_backs();
+    std::vector<char> buf(PAGE_SIZE);
+    ASSERT_EQ(1, disk_manager_->read_pages(fd, page_id.page_no, buf.data(), 1));
+    EXPECT_EQ(0, strcmp(buf.data(), "old"));
+
+    // 装入之前页面被修改并写回，然后被换出
+    page = bpm->fetch_page(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->get_data(), PAGE_SIZE, "new");
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    EXPECT_EQ(true, bpm->delete_page(page_id));
+
+    EXPECT_EQ(true, bpm->install_pages(page_id, 1, buf.data(), write_backs));
+    page = bpm->fetch_page(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->get_data(), "new"));
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+
+    // 没有页面被写回时直接装入读到的内容，已经在缓冲池中的页面不被覆盖
+    snprintf(buf.data(), PAGE_SIZE, "stale");
+    EXPECT_EQ(true, bpm->install_pages(page_id, 1, buf.data(), bpm->get_write_backs()));
+    page = bpm->fetch_page(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->get_data(), "new"));
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+
+    disk_manager_->close_file(fd);
+}
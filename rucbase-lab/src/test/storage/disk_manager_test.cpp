@@ -1,5 +1,7 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+
 #include <cassert>
 #include <cstring>
 #include <unordered_map>
@@ -147,3 +149,109 @@ TEST_F(DiskManagerTest, PageOperation) {
     disk_manager_->destroy_file(filename);
     EXPECT_EQ(disk_manager_->is_file(filename), false);
 }
+
+/**
+ * @brief 测试日志操作：跨越日志段追加日志，重新打开后接着末尾写入，检查点之后回收日志段
+ */
+TEST_F(DiskManagerTest, LogOperation) {
+    // 清理残留的日志段和控制文件
+    if (system(("rm -f " + LOG_FILE_NAME + "*").c_str()) < 0) {
+        throw UnixError();
+    }
+    disk_manager_->open_log();
+    std::vector<char> expected;
+    std::vector<char> data(1000003);
+    while ((int64_t)expected.size() < LOG_SEGMENT_SIZE) {
+        rand_buf(data.data(), data.size());
+        disk_manager_->write_log(data.data(), data.size());
+        expected.insert(expected.end(), data.begin(), data.end());
+    }
+    disk_manager_->close_log();
+
+    // 重新打开日志，从不满一块的末尾继续写入
+    disk_manager_ = std::make_unique<DiskManager>();
+    disk_manager_->open_log();
+    disk_manager_->set_log_end(expected.size());
+    disk_manager_->write_log(data.data(), 100);
+    expected.insert(expected.end(), data.begin(), data.begin() + 100);
+    std::vector<char> buf(expected.size());
+    EXPECT_EQ(disk_manager_->read_log(buf.data(), buf.size(), 0), (int)expected.size());
+    EXPECT_EQ(buf, expected);
+
+    // 第一个段回收为日志末尾之后的备用段，日志的起始位置及该位置上的日志号记录在控制文件中
+    disk_manager_->recycle_log(LOG_SEGMENT_SIZE + 8, 42);
+    EXPECT_FALSE(disk_manager_->is_file(LOG_FILE_NAME + ".0"));
+    EXPECT_TRUE(disk_manager_->is_file(LOG_FILE_NAME + ".2"));
+    disk_manager_->close_log();
+    disk_manager_ = std::make_unique<DiskManager>();
+    disk_manager_->open_log();
+    EXPECT_EQ(disk_manager_->get_log_begin(), LOG_SEGMENT_SIZE + 8);
+    EXPECT_EQ(disk_manager_->get_log_begin_lsn(), 42);
+    disk_manager_->set_log_end(expected.size());
+    EXPECT_EQ(disk_manager_->read_log(buf.data(), 100, expected.size() - 100), 100);
+    EXPECT_EQ(std::memcmp(buf.data(), expected.data() + expected.size() - 100, 100), 0);
+    disk_manager_->close_log();
+}
+
+/**
+ * @brief 测试系统文件句柄缓存：打开的文件数超过MAX_OPEN_FILES时，关闭最久未使用的系统句柄，
+ *        再读写时重新打开，上层的文件句柄保持不变
+ */
+TEST_F(DiskManagerTest, OpenFileCache) {
+    auto count_os_fds = []() {
+        int cnt = 0;
+        for (int i = 0; i < 65536; i++) {
+            if (fcntl(i, F_GETFD) != -1) {
+                cnt++;
+            }
+        }
+        return cnt;
+    };
+    const int num_files = DiskManager::MAX_OPEN_FILES + 44;
+    int base_fds = count_os_fds();
+    std::vector<std::string> filenames(num_files);
+    std::vector<int> fds(num_files);
+    for (int i = 0; i < num_files; i++) {
+        filenames[i] = "OpenFileCacheTestFile" + std::to_string(i);
+        if (disk_manager_->is_file(filenames[i])) {
+            disk_manager_->destroy_file(filenames[i]);
+        }
+        disk_manager_->create_file(filenames[i]);
+        fds[i] = disk_manager_->open_file(filenames[i]);
+    }
+
+    // 每个文件写入一个内容不同的页面，系统句柄的个数不超过上限
+    char data[PAGE_SIZE];
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_files; i++) {
+        std::memset(data, i & 0xff, PAGE_SIZE);
+        std::memcpy(data, &i, sizeof(i));
+        disk_manager_->write_page(fds[i], 0, data, PAGE_SIZE);
+    }
+    EXPECT_LE(count_os_fds() - base_fds, DiskManager::MAX_OPEN_FILES);
+
+    // 逆序读回，前面的文件的系统句柄已经被关闭，需要重新打开
+    for (int i = num_files - 1; i >= 0; i--) {
+        std::memset(data, i & 0xff, PAGE_SIZE);
+        std::memcpy(data, &i, sizeof(i));
+        disk_manager_->read_page(fds[i], 0, buf, PAGE_SIZE);
+        EXPECT_EQ(std::memcmp(buf, data, PAGE_SIZE), 0);
+        EXPECT_EQ(disk_manager_->get_file_fd(filenames[i]), fds[i]);
+        EXPECT_EQ(disk_manager_->get_file_name(fds[i]), filenames[i]);
+    }
+    EXPECT_LE(count_os_fds() - base_fds, DiskManager::MAX_OPEN_FILES);
+
+    // 关闭后文件句柄可以复用，重新打开的文件读到之前写入的内容
+    disk_manager_->close_file(fds[0]);
+    int fd = disk_manager_->open_file(filenames[0]);
+    int zero = 0;
+    disk_manager_->read_page(fd, 0, buf, PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(buf, &zero, sizeof(zero)), 0);
+    fds[0] = fd;
+
+    for (int i = 0; i < num_files; i++) {
+        disk_manager_->close_file(fds[i]);
+        disk_manager_->destroy_file(filenames[i]);
+    }
+    EXPECT_EQ(count_os_fds(), base_fds);
+}
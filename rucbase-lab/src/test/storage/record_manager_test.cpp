@@ -9,6 +9,7 @@
 #include <ctime>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
 #define BUFFER_LENGTH 8192
@@ -223,4 +224,85 @@ TEST(RecordManagerTest, MultipleFilesTest) {
         std::string filename = filenames[i];
         rm_manager->destroy_file(filename);
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief 增加字段后已有页面保留原来的记录格式，读出时用默认值补齐新字段，新记录插入到新格式的页面，旧页面清空后改为新格式
+ */
+TEST(RecordManagerTest, LayoutTest) {
+    char *result = new char[BUFFER_LENGTH];
+    int offset = 0;
+    Context *context = new Context(nullptr, nullptr, nullptr, result, &offset);
+
+    auto disk_manager = std::make_unique<DiskManager>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
+
+    std::string filename = "layout.txt";
+    if (disk_manager->is_file(filename)) {
+        disk_manager->destroy_file(filename);
+    }
+    rm_manager->create_file(filename, 8);
+    auto file_handle = rm_manager->open_file(filename);
+
+    // 写满一个页面后再写一条，旧格式占两个页面，每条记录为(i, i)
+    int num_old = file_handle->file_hdr_.num_records_per_page + 1;
+    std::vector<Rid> rids;
+    for (int i = 0; i < num_old; i++) {
+        int buf[2] = {i, i};
+        rids.push_back(file_handle->insert_record(reinterpret_cast<char *>(buf), context));
+    }
+    int old_pages = file_handle->file_hdr_.num_pages;
+    ASSERT_EQ(old_pages, RM_FIRST_RECORD_PAGE + 2);
+
+    // 增加一个默认值为-1的INT字段
+    int default_val = -1;
+    file_handle->add_layout(12, reinterpret_cast<char *>(&default_val));
+    ASSERT_EQ(file_handle->file_hdr_.num_old_layouts, 1);
+    ASSERT_EQ(file_handle->file_hdr_.old_layouts[0].end_page_no, old_pages);
+    ASSERT_EQ(file_handle->file_hdr_.old_layouts[0].record_size, 8);
+    ASSERT_EQ(file_handle->file_hdr_.first_current_page(), old_pages);
+    ASSERT_LT(file_handle->file_hdr_.num_records_per_page, file_handle->file_hdr_.old_layouts[0].num_records_per_page);
+
+    // 记录格式保存在文件头中，重新打开文件后不变
+    rm_manager->close_file(file_handle.get());
+    file_handle = rm_manager->open_file(filename);
+    ASSERT_EQ(file_handle->file_hdr_.record_size, 12);
+    ASSERT_EQ(file_handle->file_hdr_.num_old_layouts, 1);
+
+    // 旧格式的记录读出时用默认值补齐
+    for (int i = 0; i < num_old; i++) {
+        auto rec = file_handle->get_record(rids[i], context);
+        ASSERT_EQ(rec->size, 12);
+        auto vals = reinterpret_cast<int *>(rec->data);
+        ASSERT_EQ(vals[0], i);
+        ASSERT_EQ(vals[1], i);
+        ASSERT_EQ(vals[2], -1);
+    }
+
+    // 新字段为默认值的记录可以写回旧格式的页面，否则需要插入到新格式的页面
+    int upd_buf[3] = {100, 100, -1};
+    ASSERT_TRUE(file_handle->fits_in_place(rids[0], reinterpret_cast<char *>(upd_buf)));
+    file_handle->update_record(rids[0], reinterpret_cast<char *>(upd_buf), context);
+    ASSERT_EQ(reinterpret_cast<int *>(file_handle->get_record(rids[0], context)->data)[0], 100);
+    int new_buf[3] = {200, 200, 5};
+    ASSERT_FALSE(file_handle->fits_in_place(rids[1], reinterpret_cast<char *>(new_buf)));
+    Rid new_rid = file_handle->insert_record(reinterpret_cast<char *>(new_buf), context);
+    ASSERT_GE(new_rid.page_no, old_pages);
+    ASSERT_TRUE(file_handle->fits_in_place(new_rid, reinterpret_cast<char *>(new_buf)));
+    ASSERT_EQ(memcmp(file_handle->get_record(new_rid, context)->data, new_buf, sizeof(new_buf)), 0);
+
+    // 旧格式的页面中还有记录时不能改格式，记录都删除后改为新格式并重新接收插入
+    ASSERT_FALSE(file_handle->reformat_old_pages());
+    for (auto &rid : rids) {
+        file_handle->delete_record(rid, context);
+    }
+    ASSERT_TRUE(file_handle->reformat_old_pages());
+    ASSERT_EQ(file_handle->file_hdr_.num_old_layouts, 0);
+    Rid rid = file_handle->insert_record(reinterpret_cast<char *>(new_buf), context);
+    ASSERT_LT(rid.page_no, old_pages);
+    ASSERT_EQ(memcmp(file_handle->get_record(rid, context)->data, new_buf, sizeof(new_buf)), 0);
+    ASSERT_EQ(memcmp(file_handle->get_record(new_rid, context)->data, new_buf, sizeof(new_buf)), 0);
+
+    rm_manager->close_file(file_handle.get());
+    rm_manager->destroy_file(filename);
+}
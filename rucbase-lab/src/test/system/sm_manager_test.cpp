@@ -0,0 +1,319 @@
+#include <dirent.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "storage/buffer_pool_manager.h"
+#include "system/sm.h"
+#include "record/rm.h"
+#include "recovery/log_manager.h"
+#include "transaction/concurrency/lock_manager.h"
+
+const std::string TEST_DB_NAME = "SmManagerTest_db";  // 以数据库名作为根目录
+const std::string TEST_TAB_NAME = "t";
+
+/** 对于每个测试点，先创建和打开数据库TEST_DB_NAME，再创建表TEST_TAB_NAME(id int) */
+class SmManagerTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::unique_ptr<LogManager> log_manager_;
+    std::unique_ptr<Context> context_;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(256, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), buffer_pool_manager_.get(), rm_manager_.get(),
+                                                  ix_manager_.get());
+        log_manager_ = std::make_unique<LogManager>(disk_manager_.get());
+        // 不在事务中执行DDL，不加锁也不写日志
+        context_ = std::make_unique<Context>(nullptr, log_manager_.get(), nullptr);
+        if (sm_manager_->is_dir(TEST_DB_NAME)) {
+            sm_manager_->drop_db(TEST_DB_NAME);
+        }
+        sm_manager_->create_db(TEST_DB_NAME);
+        sm_manager_->open_db(TEST_DB_NAME);
+        sm_manager_->create_table(TEST_TAB_NAME, {{"id", TYPE_INT, 4}}, context_.get());
+    }
+
+    void TearDown() override {
+        sm_manager_->close_db();
+        sm_manager_->drop_db(TEST_DB_NAME);
+    }
+
+    /* 当前目录下改名后等待删除的文件个数 */
+    int count_dropped_files() {
+        int count = 0;
+        DIR* dir = opendir(".");
+        while (dirent* entry = readdir(dir)) {
+            if (strstr(entry->d_name, DROPPED_FILE_SUFFIX.c_str()) != nullptr) {
+                count++;
+            }
+        }
+        closedir(dir);
+        return count;
+    }
+
+    Rid insert_id(RmFileHandle* fh, int id) { return fh->insert_record(reinterpret_cast<char*>(&id), context_.get()); }
+};
+
+/**
+ * @brief 清空表时旧文件还有被固定的页面，后台线程等待这些页面被释放后才删除旧文件，在此之前表名已经可以使用新文件
+ */
+TEST_F(SmManagerTest, ReuseNameBeforePurge) {
+    RmFileHandle* old_fh = sm_manager_->get_file_handle(TEST_TAB_NAME);
+    int old_fd = old_fh->GetFd();
+    Rid rid = insert_id(old_fh, 1);
+    // 模拟清空之前开始的一次读，固定旧文件的页面
+    Page* page = buffer_pool_manager_->fetch_page(PageId{old_fd, rid.page_no});
+    ASSERT_NE(page, nullptr);
+
+    sm_manager_->truncate_table(TEST_TAB_NAME, context_.get());
+    EXPECT_EQ(count_dropped_files(), 1);
+
+    // 同名的新文件立即可用，是一个空文件
+    RmFileHandle* new_fh = sm_manager_->get_file_handle(TEST_TAB_NAME);
+    EXPECT_NE(new_fh->GetFd(), old_fd);
+    EXPECT_EQ(new_fh->get_file_hdr().num_pages, 1);
+    Rid new_rid = insert_id(new_fh, 2);
+    EXPECT_EQ(*reinterpret_cast<int*>(new_fh->get_record(new_rid, context_.get())->data), 2);
+
+    // 被固定的页面仍然是旧文件的内容，读完释放之后旧文件才被删除
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(count_dropped_files(), 1);
+    buffer_pool_manager_->unpin_page(page->get_page_id(), false);
+    for (int i = 0; i < 500 && count_dropped_files() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(count_dropped_files(), 0);
+    EXPECT_EQ(*reinterpret_cast<int*>(new_fh->get_record(new_rid, context_.get())->data), 2);
+}
+
+/**
+ * @brief 删除表之后立即创建同名的表，新表使用新文件，旧文件由后台线程删除
+ */
+TEST_F(SmManagerTest, RecreateDroppedTable) {
+    insert_id(sm_manager_->get_file_handle(TEST_TAB_NAME), 1);
+    sm_manager_->drop_table(TEST_TAB_NAME, context_.get());
+    sm_manager_->create_table(TEST_TAB_NAME, {{"id", TYPE_INT, 4}, {"v", TYPE_INT, 4}}, context_.get());
+    RmFileHandle* fh = sm_manager_->get_file_handle(TEST_TAB_NAME);
+    EXPECT_EQ(fh->get_file_hdr().record_size, 8);
+    EXPECT_EQ(fh->get_file_hdr().num_pages, 1);
+    for (int i = 0; i < 500 && count_dropped_files() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(count_dropped_files(), 0);
+}
+
+/**
+ * @brief 上次关闭前没有来得及删除的文件在打开数据库时删除，表的文件不受影响
+ */
+TEST_F(SmManagerTest, CleanupOnOpen) {
+    insert_id(sm_manager_->get_file_handle(TEST_TAB_NAME), 1);
+    sm_manager_->close_db();
+    // 模拟故障前已经改名、还没有删除的数据文件和索引文件
+    std::ofstream(TEST_DB_NAME + "/" + TEST_TAB_NAME + DROPPED_FILE_SUFFIX + "0");
+    std::ofstream(TEST_DB_NAME + "/" + TEST_TAB_NAME + "_id.idx" + DROPPED_FILE_SUFFIX + "1");
+
+    sm_manager_->open_db(TEST_DB_NAME);
+    EXPECT_EQ(count_dropped_files(), 0);
+    EXPECT_TRUE(disk_manager_->is_file(TEST_TAB_NAME));
+    RmFileHandle* fh = sm_manager_->get_file_handle(TEST_TAB_NAME);
+    EXPECT_EQ(*reinterpret_cast<int*>(fh->get_record(Rid{1, 0}, context_.get())->data), 1);
+}
+
+/**
+ * @description: 读出表中一条记录的第col_no个INT字段
+ */
+static int get_int(SmManager* sm_manager, const std::string& tab_name, const Rid& rid, size_t col_no,
+                   Context* context) {
+    auto &col = sm_manager->db_.get_table(tab_name).cols[col_no];
+    auto rec = sm_manager->get_file_handle(tab_name)->get_record(rid, context);
+    return *reinterpret_cast<int*>(rec->data + col.offset);
+}
+
+/**
+ * @brief 增加字段时文件头已经写盘而元数据没有写盘，文件中的记录比元数据中的长，再次增加字段时新字段放在文件中记录的末尾之后
+ */
+TEST_F(SmManagerTest, AddColumnAfterLostMeta) {
+    Rid rid = insert_id(sm_manager_->get_file_handle(TEST_TAB_NAME), 1);
+    // 模拟增加一个默认值为3的字段时只写了文件头
+    RmFileHandle* fh = sm_manager_->get_file_handle(TEST_TAB_NAME);
+    int lost_default = 3;
+    fh->add_layout(8, reinterpret_cast<char*>(&lost_default));
+    rm_manager_->flush_file_hdr(fh);
+    ASSERT_EQ(sm_manager_->db_.get_table(TEST_TAB_NAME).get_record_size(), 4);
+
+    Value val;
+    val.set_int(7);
+    sm_manager_->add_column(TEST_TAB_NAME, {"v", TYPE_INT, 4}, &val, context_.get());
+    auto &tab = sm_manager_->db_.get_table(TEST_TAB_NAME);
+    EXPECT_EQ(tab.get_col("v")->offset, 8);
+    EXPECT_EQ(tab.get_record_size(), 12);
+    EXPECT_EQ(fh->get_file_hdr().record_size, 12);
+    EXPECT_EQ(get_int(sm_manager_.get(), TEST_TAB_NAME, rid, 0, context_.get()), 1);
+    EXPECT_EQ(get_int(sm_manager_.get(), TEST_TAB_NAME, rid, 1, context_.get()), 7);
+
+    // 重新打开数据库后元数据与文件一致
+    sm_manager_->close_db();
+    sm_manager_->open_db(TEST_DB_NAME);
+    EXPECT_EQ(sm_manager_->db_.get_table(TEST_TAB_NAME).get_col("v")->offset, 8);
+    EXPECT_EQ(sm_manager_->get_file_handle(TEST_TAB_NAME)->get_file_hdr().record_size, 12);
+    EXPECT_EQ(get_int(sm_manager_.get(), TEST_TAB_NAME, rid, 1, context_.get()), 7);
+}
+
+/**
+ * @brief 较老的DML在wait-die下等待DDL持有的表排他锁时不持有元数据锁，DDL仍能获取元数据排他锁，表锁释放后DML继续
+ */
+TEST_F(SmManagerTest, WriteWaitsForTableLockWithoutMetaLatch) {
+    LockManager lock_manager(DeadlockPolicy::WAIT_DIE);
+    Transaction older(0), younger(1);
+    older.set_start_ts(0);
+    younger.set_start_ts(1);
+    int fd = sm_manager_->get_file_handle(TEST_TAB_NAME)->GetFd();
+    ASSERT_TRUE(lock_manager.lock_exclusive_on_table(&younger, fd));
+
+    std::mutex latch;
+    std::condition_variable cv;
+    bool waiting = false;
+    lock_manager.set_wait_hook([&](txn_id_t) {
+        std::lock_guard<std::mutex> lock(latch);
+        waiting = true;
+        cv.notify_all();
+    });
+    Context context(&lock_manager, log_manager_.get(), &older);
+    std::thread writer([&] { auto meta_lock = sm_manager_->lock_file_for_write(TEST_TAB_NAME, &context); });
+    {
+        std::unique_lock<std::mutex> lock(latch);
+        cv.wait(lock, [&] { return waiting; });
+    }
+    EXPECT_TRUE(sm_manager_->meta_latch_.try_lock());
+    sm_manager_->meta_latch_.unlock();
+
+    EXPECT_TRUE(lock_manager.unlock(&younger, LockDataId(fd, LockDataType::TABLE)));
+    writer.join();
+    EXPECT_EQ(older.get_lock_set()->size(), 1);
+}
+
+/**
+ * @brief 没有活跃事务时检查点把起始位置推进到日志末尾，重新打开后该位置上残留的旧日志不被当作日志，日志号继续递增
+ */
+TEST_F(SmManagerTest, StaleLogAtCheckpointBegin) {
+    log_manager_->open();
+    for (txn_id_t txn_id = 0; txn_id < 3; txn_id++) {
+        BeginLogRecord begin_log(txn_id);
+        log_manager_->add_log_to_buffer(&begin_log);
+        CommitLogRecord commit_log(txn_id);
+        log_manager_->add_log_to_buffer(&commit_log);
+    }
+    log_manager_->checkpoint([] {});
+    lsn_t next_lsn = log_manager_->get_last_lsn() + 1;
+    // 模拟回收的段中残留的旧日志：起始位置上是一条日志号更小的记录
+    BeginLogRecord stale_log(0);
+    stale_log.lsn_ = 0;
+    char buf[LOG_HEADER_SIZE];
+    stale_log.serialize(buf);
+    disk_manager_->write_log(buf, LOG_HEADER_SIZE);
+
+    sm_manager_->close_db();
+    sm_manager_->open_db(TEST_DB_NAME);
+    log_manager_ = std::make_unique<LogManager>(disk_manager_.get());
+    log_manager_->open();
+    EXPECT_EQ(log_manager_->get_last_lsn() + 1, next_lsn);
+    EXPECT_EQ(log_manager_->get_log_size(), 0);
+}
+
+/**
+ * @brief 元数据中没有索引页面格式的旧数据库，打开时由数据文件重建所有索引，之后不再重建
+ */
+TEST_F(SmManagerTest, RebuildOldFormatIndexes) {
+    Rid rid = insert_id(sm_manager_->get_file_handle(TEST_TAB_NAME), 7);
+    sm_manager_->create_index(TEST_TAB_NAME, {"id"}, context_.get());
+    auto cols = sm_manager_->db_.get_table(TEST_TAB_NAME).indexes[0].cols;
+    sm_manager_->close_db();
+
+    // 模拟旧版本的数据库：元数据的最后一行没有索引页面格式，索引文件中没有记录
+    if (chdir(TEST_DB_NAME.c_str()) < 0) {
+        throw UnixError();
+    }
+    std::vector<std::string> lines;
+    {
+        std::ifstream ifs(DB_META_NAME);
+        for (std::string line; std::getline(ifs, line);) {
+            lines.push_back(line);
+        }
+    }
+    lines.pop_back();
+    {
+        std::ofstream ofs(DB_META_NAME);
+        for (auto &line : lines) {
+            ofs << line << '\n';
+        }
+    }
+    ix_manager_->destroy_index(TEST_TAB_NAME, cols);
+    ix_manager_->create_index(TEST_TAB_NAME, cols);
+    if (chdir("..") < 0) {
+        throw UnixError();
+    }
+
+    sm_manager_->open_db(TEST_DB_NAME);
+    int key = 7;
+    std::vector<Rid> result;
+    EXPECT_TRUE(sm_manager_->get_index_handle(TEST_TAB_NAME, cols)->get_value((char*)&key, &result, nullptr));
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0], rid);
+
+    // 元数据的最后一行记录了当前格式，再次打开时不再重建
+    std::ifstream ifs(DB_META_NAME);
+    std::string line, last;
+    while (std::getline(ifs, line)) {
+        last = line;
+    }
+    EXPECT_EQ(last, std::to_string(IX_PAGE_FORMAT));
+}
+
+/**
+ * @brief 增加和删除字段之后，元数据写出再读入得到相同的字段和记录长度
+ */
+TEST_F(SmManagerTest, DbMetaRoundTrip) {
+    Value val;
+    val.set_int(5);
+    sm_manager_->add_column(TEST_TAB_NAME, {"a", TYPE_INT, 4}, &val, context_.get());
+    sm_manager_->add_column(TEST_TAB_NAME, {"b", TYPE_STRING, 8}, nullptr, context_.get());
+    sm_manager_->drop_column(TEST_TAB_NAME, "b", context_.get());
+    sm_manager_->create_table("u", {{"k", TYPE_INT, 4}}, context_.get());
+
+    std::stringstream ss;
+    ss << sm_manager_->db_;
+    DbMeta db;
+    ss >> db;
+    for (auto &name : {TEST_TAB_NAME, std::string("u")}) {
+        auto &expected = sm_manager_->db_.get_table(name);
+        auto &actual = db.get_table(name);
+        EXPECT_EQ(actual.get_record_size(), expected.get_record_size());
+        EXPECT_EQ(actual.record_size, expected.record_size);
+        ASSERT_EQ(actual.cols.size(), expected.cols.size());
+        for (size_t i = 0; i < expected.cols.size(); i++) {
+            EXPECT_EQ(actual.cols[i].name, expected.cols[i].name);
+            EXPECT_EQ(actual.cols[i].type, expected.cols[i].type);
+            EXPECT_EQ(actual.cols[i].offset, expected.cols[i].offset);
+            EXPECT_EQ(actual.cols[i].len, expected.cols[i].len);
+        }
+    }
+    // 被删除字段的空间仍然保留在记录中
+    EXPECT_EQ(db.get_table(TEST_TAB_NAME).cols.size(), 2);
+    EXPECT_EQ(db.get_table(TEST_TAB_NAME).get_record_size(), 16);
+    EXPECT_EQ(db.get_table("u").record_size, 0);
+}
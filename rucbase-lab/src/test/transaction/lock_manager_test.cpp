@@ -0,0 +1,217 @@
+#include "transaction/concurrency/lock_manager.h"
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+static bool aborted(const std::function<void()> &request) {
+    try {
+        request();
+    } catch (TransactionAbortException &e) {
+        return true;
+    }
+    return false;
+}
+
+/* 记录进入等待的事务，测试线程据此等到申请者真正阻塞在锁上再继续 */
+class WaitSignal {
+   public:
+    explicit WaitSignal(LockManager &lock_manager) {
+        lock_manager.set_wait_hook([this](txn_id_t txn_id) {
+            std::lock_guard<std::mutex> lock(latch_);
+            waiting_.insert(txn_id);
+            cv_.notify_all();
+        });
+    }
+
+    void wait_for(txn_id_t txn_id) {
+        std::unique_lock<std::mutex> lock(latch_);
+        cv_.wait(lock, [&] { return waiting_.count(txn_id) != 0; });
+    }
+
+   private:
+    std::mutex latch_;
+    std::condition_variable cv_;
+    std::set<txn_id_t> waiting_;
+};
+
+/**
+ * @brief 冲突的锁请求按no-wait策略回滚申请者，相容的锁可以同时持有
+ */
+TEST(LockManagerTest, NoWaitConflict) {
+    LockManager lock_manager;
+    Transaction t0(0), t1(1);
+    Rid rid = {.page_no = 1, .slot_no = 0};
+
+    EXPECT_TRUE(lock_manager.lock_IX_on_table(&t0, 3));
+    EXPECT_TRUE(lock_manager.lock_IX_on_table(&t1, 3));
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t0, rid, 3));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_shared_on_record(&t1, rid, 3); }));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_shared_on_table(&t1, 3); }));
+
+    EXPECT_TRUE(lock_manager.unlock(&t0, LockDataId(3, rid, LockDataType::RECORD)));
+    EXPECT_EQ(t0.get_state(), TransactionState::SHRINKING);
+    EXPECT_TRUE(lock_manager.lock_shared_on_record(&t1, rid, 3));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_shared_on_record(&t0, rid, 3); }));
+}
+
+/**
+ * @brief 只有一个事务持有锁时可以升级，S与IX合并为SIX
+ */
+TEST(LockManagerTest, Upgrade) {
+    LockManager lock_manager;
+    Transaction t0(0), t1(1);
+
+    EXPECT_TRUE(lock_manager.lock_shared_on_table(&t0, 3));
+    EXPECT_TRUE(lock_manager.lock_IX_on_table(&t0, 3));
+    EXPECT_TRUE(lock_manager.lock_IS_on_table(&t1, 3));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_IX_on_table(&t1, 3); }));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_exclusive_on_table(&t0, 3); }));
+    EXPECT_EQ(t0.get_lock_set()->size(), 1);
+}
+
+/**
+ * @brief 提交时提前释放的锁被其他事务获得后，该事务依赖提前释放者的COMMIT日志
+ */
+TEST(LockManagerTest, EarlyReleaseDependency) {
+    LockManager lock_manager;
+    Transaction t0(0), t1(1), t2(2);
+    Rid rid = {.page_no = 1, .slot_no = 0};
+    LockDataId lock_data_id(3, rid, LockDataType::RECORD);
+
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t0, rid, 3));
+    EXPECT_TRUE(lock_manager.unlock(&t0, lock_data_id, 7));
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t1, rid, 3));
+    EXPECT_EQ(t1.get_commit_dep_lsn(), 7);
+
+    EXPECT_TRUE(lock_manager.unlock(&t1, lock_data_id));
+    lock_manager.on_commit_durable(lock_data_id, 7);
+    EXPECT_TRUE(lock_manager.lock_shared_on_record(&t2, rid, 3));
+    EXPECT_EQ(t2.get_commit_dep_lsn(), INVALID_LSN);
+}
+
+/**
+ * @brief wait-die：较老的事务等待较年轻的持有者释放锁，较年轻的事务遇到冲突时回滚
+ */
+TEST(LockManagerTest, WaitDie) {
+    LockManager lock_manager(DeadlockPolicy::WAIT_DIE);
+    Transaction t0(0), t1(1), t2(2);
+    t0.set_start_ts(0);
+    t1.set_start_ts(1);
+    t2.set_start_ts(2);
+    Rid rid = {.page_no = 1, .slot_no = 0};
+
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t1, rid, 3));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_shared_on_record(&t2, rid, 3); }));
+
+    WaitSignal signal(lock_manager);
+    std::thread older([&] { EXPECT_TRUE(lock_manager.lock_shared_on_record(&t0, rid, 3)); });
+    signal.wait_for(0);
+    EXPECT_TRUE(t0.get_lock_set()->empty());
+    EXPECT_TRUE(lock_manager.unlock(&t1, LockDataId(3, rid, LockDataType::RECORD)));
+    older.join();
+    EXPECT_EQ(t0.get_lock_set()->size(), 1);
+}
+
+/**
+ * @brief wound-wait：较老的事务令正在等锁的较年轻持有者回滚，较年轻的事务等待较老的持有者
+ */
+TEST(LockManagerTest, WoundWait) {
+    LockManager lock_manager(DeadlockPolicy::WOUND_WAIT);
+    Transaction t0(0), t1(1);
+    t0.set_start_ts(0);
+    t1.set_start_ts(1);
+    Rid rid0 = {.page_no = 1, .slot_no = 0};
+    Rid rid1 = {.page_no = 1, .slot_no = 1};
+
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t0, rid0, 3));
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t1, rid1, 3));
+    // t1等待t0持有的锁，t0再申请t1持有的锁时wound t1
+    WaitSignal signal(lock_manager);
+    std::thread younger([&] {
+        EXPECT_TRUE(aborted([&] { lock_manager.lock_exclusive_on_record(&t1, rid0, 3); }));
+        lock_manager.unlock(&t1, LockDataId(3, rid1, LockDataType::RECORD));
+    });
+    signal.wait_for(1);
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t0, rid1, 3));
+    younger.join();
+    EXPECT_TRUE(t1.is_wounded());
+    EXPECT_EQ(t0.get_lock_set()->size(), 2);
+}
+
+/**
+ * @brief 间隙锁：范围扫描持有的间隙读锁阻止向该间隙插入，插入意向锁之间相容，其他间隙不受影响
+ */
+TEST(LockManagerTest, GapLock) {
+    LockManager lock_manager;
+    Transaction t0(0), t1(1), t2(2);
+    Rid next = {.page_no = 1, .slot_no = 2};
+    Rid other = {.page_no = 1, .slot_no = 5};
+    Rid supremum = {.page_no = -1, .slot_no = -1};
+
+    EXPECT_TRUE(lock_manager.lock_IX_on_gap(&t1, other, 7));
+    EXPECT_TRUE(lock_manager.lock_IX_on_gap(&t2, other, 7));
+    EXPECT_TRUE(lock_manager.lock_shared_on_gap(&t0, next, 7));
+    EXPECT_TRUE(lock_manager.lock_shared_on_gap(&t0, supremum, 7));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_IX_on_gap(&t1, next, 7); }));
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_IX_on_gap(&t2, supremum, 7); }));
+    // 记录锁与同一位置上的间隙锁互不影响
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t1, next, 7));
+}
+
+/**
+ * @brief 表级意向锁走快速路径，申请S锁的事务等待快速路径上的IX锁释放，之后的IX锁进入锁表与S锁冲突
+ */
+TEST(LockManagerTest, FastPathIntentionLocks) {
+    LockManager lock_manager(DeadlockPolicy::WAIT_DIE);
+    Transaction t0(0), t1(1), t2(2), t3(3);
+    t0.set_start_ts(0);
+    t1.set_start_ts(1);
+    t2.set_start_ts(2);
+    t3.set_start_ts(3);
+
+    EXPECT_TRUE(lock_manager.lock_IX_on_table(&t0, 3));
+    EXPECT_TRUE(lock_manager.lock_IS_on_table(&t2, 3));
+    WaitSignal signal(lock_manager);
+    std::thread reader([&] { EXPECT_TRUE(lock_manager.lock_shared_on_table(&t1, 3)); });
+    signal.wait_for(1);
+    EXPECT_TRUE(t1.get_lock_set()->empty());
+    EXPECT_TRUE(lock_manager.unlock(&t0, LockDataId(3, LockDataType::TABLE)));
+    reader.join();
+    EXPECT_EQ(t1.get_lock_set()->size(), 1);
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_IX_on_table(&t3, 3); }));
+
+    // 快速路径锁的持有者一直不释放时，申请强锁的事务超时回滚
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_exclusive_on_table(&t1, 3); }));
+}
+
+/**
+ * @brief 行锁字：无竞争时只修改锁字，竞争时膨胀到锁表，锁表中的请求全部释放后恢复为轻量的锁字
+ */
+TEST(LockManagerTest, RecordLockWord) {
+    LockManager lock_manager;
+    Transaction t0(0), t1(1), t2(2);
+    std::map<txn_id_t, Transaction *> txns = {{0, &t0}, {1, &t1}, {2, &t2}};
+    lock_manager.set_txn_resolver([&](txn_id_t txn_id) { return txns.at(txn_id); });
+    Rid rid = {.page_no = 1, .slot_no = 0};
+    LockDataId lock_data_id(3, rid, LockDataType::RECORD);
+    std::atomic<uint64_t> word{0};
+
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t0, rid, 3, &word));
+    EXPECT_TRUE(lock_manager.lock_shared_on_record(&t0, rid, 3, &word));
+    EXPECT_TRUE(t0.get_lock_set()->empty());
+    EXPECT_EQ(t0.get_word_locks().size(), 1);
+    EXPECT_TRUE(aborted([&] { lock_manager.lock_shared_on_record(&t1, rid, 3, &word); }));
+
+    lock_manager.unlock_record_word(&t0, lock_data_id, &word);
+    EXPECT_EQ(word.load(), 0);
+    EXPECT_TRUE(lock_manager.lock_exclusive_on_record(&t1, rid, 3, &word));
+    lock_manager.unlock_record_word(&t1, lock_data_id, &word, 9);
+    EXPECT_TRUE(lock_manager.lock_shared_on_record(&t2, rid, 3, &word));
+    EXPECT_EQ(t2.get_commit_dep_lsn(), 9);
+}
@@ -10,16 +10,38 @@ See the Mulan PSL v2 for more details. */
 
 #include "lock_manager.h"
 
+#include <algorithm>
+#include <random>
+
+/* 行锁字的格式：低32位为持有者的事务ID，提前释放时为COMMIT日志号；第32、33位为锁模式；
+ * 第34位表示该行的锁已经膨胀到锁表；第35位表示锁已被提前释放；高16位为锁管理器的纪元 */
+static constexpr uint64_t WORD_SHARED = 1ULL << 32;
+static constexpr uint64_t WORD_EXCLUSIVE = 2ULL << 32;
+static constexpr uint64_t WORD_INFLATED = 1ULL << 34;
+static constexpr uint64_t WORD_RELEASED = 1ULL << 35;
+static constexpr uint64_t WORD_LOW_MASK = 0xffffffffULL;
+static constexpr int WORD_EPOCH_SHIFT = 48;
+
+LockManager::LockManager(DeadlockPolicy policy) : fast_path_(new FastPathSlot[LOCK_FAST_PATH_SLOTS]), policy_(policy) {
+    uint64_t epoch = std::random_device()() & 0xffff;
+    epoch_ = (epoch == 0 ? 1 : epoch) << WORD_EPOCH_SHIFT;
+}
+
 /**
  * @description: 申请行级共享锁
  * @return {bool} 加锁是否成功
  * @param {Transaction*} txn 要申请锁的事务对象指针
  * @param {Rid&} rid 加锁的目标记录ID 记录所在的表的fd
  * @param {int} tab_fd
+ * @param {atomic<uint64_t>*} lock_word 记录所在页面中的行锁字，文件没有行锁字时为nullptr
  */
-bool LockManager::lock_shared_on_record(Transaction* txn, const Rid& rid, int tab_fd) {
-    
-    return true;
+bool LockManager::lock_shared_on_record(Transaction* txn, const Rid& rid, int tab_fd,
+                                        std::atomic<uint64_t>* lock_word) {
+    LockDataId lock_data_id(tab_fd, rid, LockDataType::RECORD);
+    if (txn != nullptr && lock_word != nullptr) {
+        return lock_record_word(txn, lock_data_id, LockMode::SHARED, lock_word);
+    }
+    return lock(txn, lock_data_id, LockMode::SHARED);
 }
 
 /**
@@ -28,10 +50,15 @@ bool LockManager::lock_shared_on_record(Transaction* txn, const Rid& rid, int ta
  * @param {Transaction*} txn 要申请锁的事务对象指针
  * @param {Rid&} rid 加锁的目标记录ID
  * @param {int} tab_fd 记录所在的表的fd
+ * @param {atomic<uint64_t>*} lock_word 记录所在页面中的行锁字，文件没有行锁字时为nullptr
  */
-bool LockManager::lock_exclusive_on_record(Transaction* txn, const Rid& rid, int tab_fd) {
-
-    return true;
+bool LockManager::lock_exclusive_on_record(Transaction* txn, const Rid& rid, int tab_fd,
+                                           std::atomic<uint64_t>* lock_word) {
+    LockDataId lock_data_id(tab_fd, rid, LockDataType::RECORD);
+    if (txn != nullptr && lock_word != nullptr) {
+        return lock_record_word(txn, lock_data_id, LockMode::EXLUCSIVE, lock_word);
+    }
+    return lock(txn, lock_data_id, LockMode::EXLUCSIVE);
 }
 
 /**
@@ -41,8 +68,7 @@ bool LockManager::lock_exclusive_on_record(Transaction* txn, const Rid& rid, int
  * @param {int} tab_fd 目标表的fd
  */
 bool LockManager::lock_shared_on_table(Transaction* txn, int tab_fd) {
-    
-    return true;
+    return lock(txn, LockDataId(tab_fd, LockDataType::TABLE), LockMode::SHARED);
 }
 
 /**
@@ -52,8 +78,7 @@ bool LockManager::lock_shared_on_table(Transaction* txn, int tab_fd) {
  * @param {int} tab_fd 目标表的fd
  */
 bool LockManager::lock_exclusive_on_table(Transaction* txn, int tab_fd) {
-    
-    return true;
+    return lock(txn, LockDataId(tab_fd, LockDataType::TABLE), LockMode::EXLUCSIVE);
 }
 
 /**
@@ -63,8 +88,10 @@ bool LockManager::lock_exclusive_on_table(Transaction* txn, int tab_fd) {
  * @param {int} tab_fd 目标表的fd
  */
 bool LockManager::lock_IS_on_table(Transaction* txn, int tab_fd) {
-    
-    return true;
+    if (lock_fast_path(txn, tab_fd, LockMode::INTENTION_SHARED)) {
+        return true;
+    }
+    return lock(txn, LockDataId(tab_fd, LockDataType::TABLE), LockMode::INTENTION_SHARED);
 }
 
 /**
@@ -74,8 +101,34 @@ bool LockManager::lock_IS_on_table(Transaction* txn, int tab_fd) {
  * @param {int} tab_fd 目标表的fd
  */
 bool LockManager::lock_IX_on_table(Transaction* txn, int tab_fd) {
-    
-    return true;
+    if (lock_fast_path(txn, tab_fd, LockMode::INTENTION_EXCLUSIVE)) {
+        return true;
+    }
+    return lock(txn, LockDataId(tab_fd, LockDataType::TABLE), LockMode::INTENTION_EXCLUSIVE);
+}
+
+/**
+ * @description: 申请索引间隙上的共享锁，范围扫描对扫描到的每个索引项之前的间隙以及范围之后的第一个间隙加锁，
+ * 与插入意向锁冲突，从而阻止其他事务向扫描过的键范围插入新的索引项（幻读），范围之外的插入不受影响
+ * @return {bool} 返回加锁是否成功
+ * @param {Transaction*} txn 要申请锁的事务对象指针
+ * @param {Rid&} next_rid 间隙之后的索引项指向的记录，{-1, -1}表示最后一个索引项之后的间隙
+ * @param {int} index_fd 索引文件的fd
+ */
+bool LockManager::lock_shared_on_gap(Transaction* txn, const Rid& next_rid, int index_fd) {
+    return lock(txn, LockDataId(index_fd, next_rid, LockDataType::GAP), LockMode::SHARED);
+}
+
+/**
+ * @description: 申请索引间隙上的插入意向锁，插入和删除索引项之前对受影响的间隙加锁
+ * 插入意向锁之间相容，向同一间隙插入的事务互不阻塞，只与覆盖该间隙的范围扫描冲突
+ * @return {bool} 返回加锁是否成功
+ * @param {Transaction*} txn 要申请锁的事务对象指针
+ * @param {Rid&} next_rid 间隙之后的索引项指向的记录，{-1, -1}表示最后一个索引项之后的间隙
+ * @param {int} index_fd 索引文件的fd
+ */
+bool LockManager::lock_IX_on_gap(Transaction* txn, const Rid& next_rid, int index_fd) {
+    return lock(txn, LockDataId(index_fd, next_rid, LockDataType::GAP), LockMode::INTENTION_EXCLUSIVE);
 }
 
 /**
@@ -83,8 +136,511 @@ bool LockManager::lock_IX_on_table(Transaction* txn, int tab_fd) {
  * @return {bool} 返回解锁是否成功
  * @param {Transaction*} txn 要释放锁的事务对象指针
  * @param {LockDataId} lock_data_id 要释放的锁ID
+ * @param {lsn_t} commit_lsn 事务在COMMIT日志持久化之前提前释放锁时传入COMMIT日志号，否则为INVALID_LSN
+ */
+bool LockManager::unlock(Transaction* txn, LockDataId lock_data_id, lsn_t commit_lsn) {
+    if (unlock_fast_path(txn, lock_data_id, commit_lsn)) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(latch_);
+    auto it = lock_table_.find(lock_data_id);
+    if (it == lock_table_.end()) {
+        return false;
+    }
+    auto &queue = it->second;
+    auto req = std::find_if(queue.request_queue_.begin(), queue.request_queue_.end(),
+                            [&](const LockRequest &r) { return r.txn_id_ == txn->get_transaction_id(); });
+    if (req == queue.request_queue_.end()) {
+        return false;
+    }
+    auto slot = fast_path_slot(lock_data_id);
+    if (slot != nullptr && req->granted_ && is_strong(req->lock_mode_)) {
+        slot->strong_count_--;
+    }
+    queue.request_queue_.erase(req);
+    if (commit_lsn != INVALID_LSN && commit_lsn > queue.release_lsn_) {
+        queue.release_lsn_ = commit_lsn;
+    }
+    queue.group_lock_mode_ = group_mode(queue);
+    queue.cv_.notify_all();
+    if (queue.request_queue_.empty() && queue.release_lsn_ == INVALID_LSN) {
+        lock_table_.erase(it);
+    }
+    // 两阶段封锁：释放任何锁之后事务进入收缩阶段
+    if (txn->get_state() == TransactionState::GROWING) {
+        txn->set_state(TransactionState::SHRINKING);
+    }
+    return true;
+}
+
+/**
+ * @description: 提前释放锁的事务的COMMIT日志已经持久化，之后获得该锁的事务不再依赖它
+ * @param {LockDataId&} lock_data_id 提前释放的锁ID
+ * @param {lsn_t} commit_lsn 已经持久化的COMMIT日志号
+ */
+void LockManager::on_commit_durable(const LockDataId& lock_data_id, lsn_t commit_lsn) {
+    std::unique_lock<std::mutex> lock(latch_);
+    auto it = lock_table_.find(lock_data_id);
+    if (it == lock_table_.end() || it->second.release_lsn_ > commit_lsn) {
+        return;
+    }
+    it->second.release_lsn_ = INVALID_LSN;
+    if (it->second.request_queue_.empty()) {
+        lock_table_.erase(it);
+    }
+}
+
+/**
+ * @description: 申请锁，锁与其他事务已经持有的锁冲突时按policy_决定申请者等待还是回滚
+ * 事务已经持有该数据项上的锁时，把持有的锁升级为能同时覆盖两种锁的锁模式
+ * @return {bool} 加锁是否成功
+ * @param {Transaction*} txn 要申请锁的事务对象指针
+ * @param {LockDataId&} lock_data_id 加锁的目标
+ * @param {LockMode} lock_mode 申请的锁模式
+ * @param {atomic<uint64_t>*} lock_word 已经膨胀到锁表的行锁字，其他锁为nullptr
+ */
+bool LockManager::lock(Transaction* txn, const LockDataId& lock_data_id, LockMode lock_mode,
+                       std::atomic<uint64_t>* lock_word) {
+    // 不在事务中的访问（例如系统内部对数据文件的读写）不加锁
+    if (txn == nullptr) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(latch_);
+    if (lock_word != nullptr && !(is_live(lock_word->load()) && (lock_word->load() & WORD_INFLATED))) {
+        // 加锁表的锁之前行锁字已经恢复为轻量状态，重新走行锁字
+        lock.unlock();
+        return lock_record_word(txn, lock_data_id, lock_mode, lock_word);
+    }
+    if (txn->is_wounded()) {
+        throw TransactionAbortException(txn->get_transaction_id(), AbortReason::DEADLOCK_PREVENTION);
+    }
+    if (txn->get_state() == TransactionState::SHRINKING) {
+        throw TransactionAbortException(txn->get_transaction_id(), AbortReason::LOCK_ON_SHIRINKING);
+    }
+    if (txn->get_state() == TransactionState::DEFAULT) {
+        txn->set_state(TransactionState::GROWING);
+    }
+
+    auto &queue = lock_table_[lock_data_id];
+    auto slot = fast_path_slot(lock_data_id);
+    auto fast_held = txn->get_fast_path_locks().find(lock_data_id.fd_);
+    if (slot != nullptr && fast_held != txn->get_fast_path_locks().end()) {
+        // 事务通过快速路径持有该表的意向锁，先把它转入锁表，再按升级处理
+        bool exclusive = fast_held->second;
+        txn->get_fast_path_locks().erase(fast_held);
+        (exclusive ? slot->ix_count_ : slot->is_count_)--;
+        queue.request_queue_.emplace_back(txn, exclusive ? LockMode::INTENTION_EXCLUSIVE : LockMode::INTENTION_SHARED);
+        queue.request_queue_.back().granted_ = true;
+        queue.group_lock_mode_ = group_mode(queue);
+        queue.cv_.notify_all();
+    }
+    auto self = std::find_if(queue.request_queue_.begin(), queue.request_queue_.end(),
+                             [&](const LockRequest &r) { return r.txn_id_ == txn->get_transaction_id(); });
+    bool upgrade = self != queue.request_queue_.end();
+    LockMode target = upgrade ? combine(self->lock_mode_, lock_mode) : lock_mode;
+    if (upgrade && target == self->lock_mode_) {
+        return true;
+    }
+    if (!upgrade) {
+        // 新的申请先以未授予的状态入队，等待期间队列不会因为其他事务释放锁而被删除
+        self = queue.request_queue_.emplace(queue.request_queue_.end(), txn, target);
+    }
+    // 申请S/X/SIX锁时先关闭该表的快速路径，之后新的IS/IX锁都进入锁表，再等待已有的快速路径锁释放
+    bool strong = slot != nullptr && is_strong(target) && !(upgrade && is_strong(self->lock_mode_));
+    if (strong) {
+        slot->strong_count_++;
+    }
+    auto give_up = [&]() {
+        if (strong) {
+            slot->strong_count_--;
+        }
+        if (!upgrade) {
+            queue.request_queue_.erase(self);
+            if (queue.request_queue_.empty() && queue.release_lsn_ == INVALID_LSN) {
+                lock_table_.erase(lock_data_id);
+            }
+        }
+        throw TransactionAbortException(txn->get_transaction_id(), AbortReason::DEADLOCK_PREVENTION);
+    };
+
+    auto fast_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOCK_FAST_PATH_WAIT_MS);
+    while (true) {
+        std::vector<Transaction*> holders;
+        for (auto &req : queue.request_queue_) {
+            if (req.txn_id_ != txn->get_transaction_id() && req.granted_ && !compatible(req.lock_mode_, target)) {
+                holders.push_back(req.txn_);
+            }
+        }
+        bool fast_conflict = slot != nullptr && fast_path_conflict(*slot, target);
+        if (holders.empty() && !fast_conflict) {
+            break;
+        }
+        if (!holders.empty() && !should_wait(txn, holders)) {
+            give_up();
+        }
+        if (fast_conflict && policy_ == DeadlockPolicy::NO_WAIT) {
+            give_up();
+        }
+        waiting_.emplace(txn->get_transaction_id(), lock_data_id);
+        if (wait_hook_) {
+            wait_hook_(txn->get_transaction_id());
+        }
+        bool timeout = false;
+        if (fast_conflict) {
+            // 快速路径锁的持有者未知，无法比较时间戳，只能限时等待，超时后按死锁处理
+            timeout = queue.cv_.wait_until(lock, fast_deadline) == std::cv_status::timeout;
+        } else {
+            queue.cv_.wait(lock);
+        }
+        waiting_.erase(txn->get_transaction_id());
+        if (txn->is_wounded() || (timeout && fast_path_conflict(*slot, target))) {
+            give_up();
+        }
+    }
+
+    self->lock_mode_ = target;
+    if (!upgrade) {
+        self->granted_ = true;
+        if (lock_word != nullptr) {
+            txn->get_word_locks().push_back(lock_data_id);
+        } else {
+            txn->get_lock_set()->insert(lock_data_id);
+            txn->get_stmt_locks().push_back(lock_data_id);
+        }
+    }
+    queue.group_lock_mode_ = group_mode(queue);
+    // 锁由提前释放的事务转交而来，事务需要等该事务的COMMIT日志持久化后才能确认提交
+    if (queue.release_lsn_ > txn->get_commit_dep_lsn()) {
+        txn->set_commit_dep_lsn(queue.release_lsn_);
+    }
+    if (strong && slot->release_lsn_ > txn->get_commit_dep_lsn()) {
+        txn->set_commit_dep_lsn(slot->release_lsn_);
+    }
+    return true;
+}
+
+/**
+ * @description: 在页面中的行锁字上申请行锁，锁字空闲或已被提前释放时用一次CAS获得锁，不分配锁表中的加锁请求
+ * 只有其他事务持有锁字时才把它膨胀到锁表，之后该行的锁按锁表的规则等待或回滚
+ * @return {bool} 加锁是否成功
+ * @param {Transaction*} txn 要申请锁的事务对象指针
+ * @param {LockDataId&} lock_data_id 加锁的目标记录
+ * @param {LockMode} lock_mode SHARED或EXLUCSIVE
+ * @param {atomic<uint64_t>*} lock_word 记录所在页面中的行锁字，调用者在加锁期间固定该页面
+ */
+bool LockManager::lock_record_word(Transaction* txn, const LockDataId& lock_data_id, LockMode lock_mode,
+                                   std::atomic<uint64_t>* lock_word) {
+    if (txn->is_wounded()) {
+        throw TransactionAbortException(txn->get_transaction_id(), AbortReason::DEADLOCK_PREVENTION);
+    }
+    if (txn->get_state() == TransactionState::SHRINKING) {
+        throw TransactionAbortException(txn->get_transaction_id(), AbortReason::LOCK_ON_SHIRINKING);
+    }
+    if (txn->get_state() == TransactionState::DEFAULT) {
+        txn->set_state(TransactionState::GROWING);
+    }
+    uint64_t txn_id = static_cast<uint32_t>(txn->get_transaction_id());
+    uint64_t mode = lock_mode == LockMode::EXLUCSIVE ? WORD_EXCLUSIVE : WORD_SHARED;
+    uint64_t word = lock_word->load();
+    while (true) {
+        if (!is_live(word) || (word & WORD_RELEASED)) {
+            if (!lock_word->compare_exchange_weak(word, epoch_ | mode | txn_id)) {
+                continue;
+            }
+            // 锁由提前释放的事务转交而来，依赖它的COMMIT日志
+            lsn_t release_lsn = is_live(word) ? static_cast<lsn_t>(word & WORD_LOW_MASK) : INVALID_LSN;
+            if (release_lsn > txn->get_commit_dep_lsn()) {
+                txn->set_commit_dep_lsn(release_lsn);
+            }
+            txn->get_word_locks().push_back(lock_data_id);
+            return true;
+        }
+        if (word & WORD_INFLATED) {
+            return lock(txn, lock_data_id, lock_mode, lock_word);
+        }
+        if ((word & WORD_LOW_MASK) == txn_id) {
+            // 已经持有覆盖申请的锁，或者作为唯一的持有者由S升级为X
+            if ((word & WORD_EXCLUSIVE) || mode == WORD_SHARED ||
+                lock_word->compare_exchange_weak(word, epoch_ | mode | txn_id)) {
+                return true;
+            }
+            continue;
+        }
+        if (!inflate(lock_data_id, word, lock_word)) {
+            word = lock_word->load();
+        }
+    }
+}
+
+/**
+ * @description: 行锁字被其他事务持有时膨胀到锁表，持有者的锁转为锁表中已授予的请求
+ * @return {bool} 是否完成膨胀，锁字在此期间发生变化时返回false
+ * @param {LockDataId&} lock_data_id 行锁的目标记录
+ * @param {uint64_t} word 之前读到的锁字
+ * @param {atomic<uint64_t>*} lock_word 行锁字
+ */
+bool LockManager::inflate(const LockDataId& lock_data_id, uint64_t word, std::atomic<uint64_t>* lock_word) {
+    std::unique_lock<std::mutex> lock(latch_);
+    Transaction* owner = txn_resolver_ ? txn_resolver_(static_cast<txn_id_t>(word & WORD_LOW_MASK)) : nullptr;
+    if (owner == nullptr) {
+        // 持有者已经结束，锁字是遗留的
+        lock_word->compare_exchange_strong(word, 0);
+        return false;
+    }
+    if (!lock_word->compare_exchange_strong(word, epoch_ | WORD_INFLATED)) {
+        return false;
+    }
+    auto &queue = lock_table_[lock_data_id];
+    queue.request_queue_.emplace_back(owner, (word & WORD_EXCLUSIVE) ? LockMode::EXLUCSIVE : LockMode::SHARED);
+    queue.request_queue_.back().granted_ = true;
+    queue.group_lock_mode_ = group_mode(queue);
+    return true;
+}
+
+/**
+ * @description: 释放通过行锁字申请的行锁，锁字已经膨胀时在锁表中释放，锁表中不再有该行的请求时恢复为轻量的锁字
+ * @param {Transaction*} txn 要释放锁的事务对象指针
+ * @param {LockDataId&} lock_data_id 要释放的锁ID
+ * @param {atomic<uint64_t>*} lock_word 行锁字，调用者在释放期间固定该页面
+ * @param {lsn_t} commit_lsn 提前释放锁时传入COMMIT日志号，记录在锁字中转交给下一个持有者
+ */
+void LockManager::unlock_record_word(Transaction* txn, const LockDataId& lock_data_id,
+                                     std::atomic<uint64_t>* lock_word, lsn_t commit_lsn) {
+    uint64_t txn_id = static_cast<uint32_t>(txn->get_transaction_id());
+    uint64_t released = commit_lsn == INVALID_LSN ? 0 : epoch_ | WORD_RELEASED | static_cast<uint32_t>(commit_lsn);
+    uint64_t word = lock_word->load();
+    while (is_live(word) && !(word & (WORD_INFLATED | WORD_RELEASED)) && (word & WORD_LOW_MASK) == txn_id) {
+        if (lock_word->compare_exchange_weak(word, released)) {
+            if (txn->get_state() == TransactionState::GROWING) {
+                txn->set_state(TransactionState::SHRINKING);
+            }
+            return;
+        }
+    }
+    if (!is_live(word) || !(word & WORD_INFLATED)) {
+        return;
+    }
+    unlock(txn, lock_data_id, commit_lsn);
+    std::unique_lock<std::mutex> lock(latch_);
+    if (lock_table_.count(lock_data_id) == 0) {
+        uint64_t inflated = epoch_ | WORD_INFLATED;
+        lock_word->compare_exchange_strong(inflated, 0);
+    }
+}
+
+/* 锁字是否由本次运行写入，其他纪元的锁字视为空闲 */
+bool LockManager::is_live(uint64_t word) const {
+    return (word >> WORD_EPOCH_SHIFT) == (epoch_ >> WORD_EPOCH_SHIFT);
+}
+
+/**
+ * @description: 通过快速路径申请表级意向锁，表上没有S/X/SIX锁的持有者和等待者时只增加计数
+ * 计数增加后再次检查strong_count_，与申请强锁的事务先增加strong_count_再检查计数相对应，两者至少有一方看到对方
+ * @return {bool} 是否通过快速路径获得了锁，返回false时需要走锁表
+ * @param {Transaction*} txn 要申请锁的事务对象指针
+ * @param {int} tab_fd 目标表的fd
+ * @param {LockMode} lock_mode IS或IX
+ */
+bool LockManager::lock_fast_path(Transaction* txn, int tab_fd, LockMode lock_mode) {
+    // 需要回滚的事务由锁表路径抛出异常
+    if (txn == nullptr || tab_fd < 0 || tab_fd >= LOCK_FAST_PATH_SLOTS || txn->is_wounded() ||
+        txn->get_state() == TransactionState::SHRINKING) {
+        return false;
+    }
+    auto &locks = txn->get_fast_path_locks();
+    auto held = locks.find(tab_fd);
+    bool exclusive = lock_mode == LockMode::INTENTION_EXCLUSIVE;
+    if (held != locks.end() && (held->second || !exclusive)) {
+        return true;
+    }
+    LockDataId lock_data_id(tab_fd, LockDataType::TABLE);
+    if (held == locks.end() && txn->get_lock_set()->count(lock_data_id) > 0) {
+        // 已经在锁表中持有该表的锁
+        return false;
+    }
+    auto &slot = fast_path_[tab_fd];
+    auto &count = exclusive ? slot.ix_count_ : slot.is_count_;
+    if (slot.strong_count_ > 0) {
+        return false;
+    }
+    count++;
+    if (slot.strong_count_ > 0) {
+        release_fast_count(count, lock_data_id);
+        return false;
+    }
+    if (held != locks.end()) {
+        // IS升级为IX
+        release_fast_count(slot.is_count_, lock_data_id);
+    }
+    locks[tab_fd] = exclusive;
+    if (txn->get_lock_set()->insert(lock_data_id).second) {
+        txn->get_stmt_locks().push_back(lock_data_id);
+    }
+    if (txn->get_state() == TransactionState::DEFAULT) {
+        txn->set_state(TransactionState::GROWING);
+    }
+    return true;
+}
+
+/**
+ * @description: 释放通过快速路径持有的表级意向锁
+ * @return {bool} 事务是否通过快速路径持有该锁，返回false时需要在锁表中释放
  */
-bool LockManager::unlock(Transaction* txn, LockDataId lock_data_id) {
-   
+bool LockManager::unlock_fast_path(Transaction* txn, const LockDataId& lock_data_id, lsn_t commit_lsn) {
+    auto slot = fast_path_slot(lock_data_id);
+    if (txn == nullptr || slot == nullptr) {
+        return false;
+    }
+    auto &locks = txn->get_fast_path_locks();
+    auto held = locks.find(lock_data_id.fd_);
+    if (held == locks.end()) {
+        return false;
+    }
+    bool exclusive = held->second;
+    locks.erase(held);
+    lsn_t release_lsn = slot->release_lsn_;
+    while (commit_lsn > release_lsn && !slot->release_lsn_.compare_exchange_weak(release_lsn, commit_lsn)) {
+    }
+    release_fast_count(exclusive ? slot->ix_count_ : slot->is_count_, lock_data_id);
+    if (txn->get_state() == TransactionState::GROWING) {
+        txn->set_state(TransactionState::SHRINKING);
+    }
     return true;
-}
\ No newline at end of file
+}
+
+/* 表级锁可以走快速路径时返回该表的计数，否则返回nullptr */
+LockManager::FastPathSlot* LockManager::fast_path_slot(const LockDataId& lock_data_id) {
+    if (lock_data_id.type_ != LockDataType::TABLE || lock_data_id.fd_ < 0 || lock_data_id.fd_ >= LOCK_FAST_PATH_SLOTS) {
+        return nullptr;
+    }
+    return &fast_path_[lock_data_id.fd_];
+}
+
+/* 减少快速路径计数，有事务在等待强锁时唤醒它重新检查 */
+void LockManager::release_fast_count(std::atomic<int>& count, const LockDataId& lock_data_id) {
+    count--;
+    if (fast_path_[lock_data_id.fd_].strong_count_ > 0) {
+        std::unique_lock<std::mutex> lock(latch_);
+        auto it = lock_table_.find(lock_data_id);
+        if (it != lock_table_.end()) {
+            it->second.cv_.notify_all();
+        }
+    }
+}
+
+/**
+ * @description: 申请的锁与holders持有的锁冲突时，按当前策略决定申请者等待还是回滚
+ * wait-die和wound-wait都只允许一个方向的等待（分别为老等新和新等老），因此不会形成等待环
+ * @return {bool} 申请者是否等待，返回false时申请者回滚
+ * @param {Transaction*} txn 申请锁的事务
+ * @param {vector<Transaction*>&} holders 持有冲突锁的事务
+ */
+bool LockManager::should_wait(Transaction* txn, const std::vector<Transaction*>& holders) {
+    switch (policy_.load()) {
+        case DeadlockPolicy::WAIT_DIE:
+            return std::none_of(holders.begin(), holders.end(), [&](Transaction* h) { return older(h, txn); });
+        case DeadlockPolicy::WOUND_WAIT:
+            for (auto holder : holders) {
+                if (older(txn, holder)) {
+                    wound(holder);
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @description: 要求较年轻的事务回滚，它正在等锁时立即唤醒，否则在下次申请锁时回滚
+ * 已经进入提交流程、不再申请锁的事务可以正常提交，申请者等它释放锁即可
+ * @param {Transaction*} victim 被wound的事务
+ */
+void LockManager::wound(Transaction* victim) {
+    victim->set_wounded(true);
+    auto it = waiting_.find(victim->get_transaction_id());
+    if (it != waiting_.end()) {
+        lock_table_[it->second].cv_.notify_all();
+    }
+}
+
+/* 事务a是否比b老，开始时间戳相同时按事务ID比较，保证任意两个事务之间的先后唯一确定 */
+bool LockManager::older(Transaction* a, Transaction* b) {
+    if (a->get_start_ts() != b->get_start_ts()) {
+        return a->get_start_ts() < b->get_start_ts();
+    }
+    return a->get_transaction_id() < b->get_transaction_id();
+}
+
+/* 会与快速路径上的意向锁冲突的表级锁 */
+bool LockManager::is_strong(LockMode mode) {
+    return mode == LockMode::SHARED || mode == LockMode::EXLUCSIVE || mode == LockMode::S_IX;
+}
+
+/* 申请requested锁时是否与通过快速路径持有的意向锁冲突 */
+bool LockManager::fast_path_conflict(const FastPathSlot& slot, LockMode requested) {
+    if (requested == LockMode::EXLUCSIVE) {
+        return slot.is_count_ > 0 || slot.ix_count_ > 0;
+    }
+    return is_strong(requested) && slot.ix_count_ > 0;
+}
+
+/* 两个事务分别持有held和requested锁时是否相容 */
+bool LockManager::compatible(LockMode held, LockMode requested) {
+    switch (held) {
+        case LockMode::INTENTION_SHARED:
+            return requested != LockMode::EXLUCSIVE;
+        case LockMode::INTENTION_EXCLUSIVE:
+            return requested == LockMode::INTENTION_SHARED || requested == LockMode::INTENTION_EXCLUSIVE;
+        case LockMode::SHARED:
+            return requested == LockMode::INTENTION_SHARED || requested == LockMode::SHARED;
+        case LockMode::S_IX:
+            return requested == LockMode::INTENTION_SHARED;
+        default:
+            return false;
+    }
+}
+
+/* 持有held锁时是否已经具有requested锁的全部权限 */
+bool LockManager::covers(LockMode held, LockMode requested) {
+    if (held == requested || held == LockMode::EXLUCSIVE || requested == LockMode::INTENTION_SHARED) {
+        return true;
+    }
+    return held == LockMode::S_IX && (requested == LockMode::SHARED || requested == LockMode::INTENTION_EXCLUSIVE);
+}
+
+/* 同一事务先后申请held和requested锁时实际需要持有的锁 */
+LockManager::LockMode LockManager::combine(LockMode held, LockMode requested) {
+    if (covers(held, requested)) {
+        return held;
+    }
+    if (covers(requested, held)) {
+        return requested;
+    }
+    // 互不覆盖的只有S和IX
+    return LockMode::S_IX;
+}
+
+/* 加锁队列中已授予的锁里排他性最强的锁模式 */
+LockManager::GroupLockMode LockManager::group_mode(const LockRequestQueue& queue) {
+    bool has[5] = {false};
+    for (auto &req : queue.request_queue_) {
+        if (req.granted_) {
+            has[static_cast<int>(req.lock_mode_)] = true;
+        }
+    }
+    if (has[static_cast<int>(LockMode::EXLUCSIVE)]) {
+        return GroupLockMode::X;
+    }
+    if (has[static_cast<int>(LockMode::S_IX)] ||
+        (has[static_cast<int>(LockMode::SHARED)] && has[static_cast<int>(LockMode::INTENTION_EXCLUSIVE)])) {
+        return GroupLockMode::SIX;
+    }
+    if (has[static_cast<int>(LockMode::SHARED)]) {
+        return GroupLockMode::S;
+    }
+    if (has[static_cast<int>(LockMode::INTENTION_EXCLUSIVE)]) {
+        return GroupLockMode::IX;
+    }
+    return has[static_cast<int>(LockMode::INTENTION_SHARED)] ? GroupLockMode::IS : GroupLockMode::NON_LOCK;
+}
@@ -10,12 +10,21 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include <condition_variable>
 #include "transaction/transaction.h"
 
 static const std::string GroupLockModeStr[10] = {"NON_LOCK", "IS", "IX", "S", "X", "SIX"};
 
+/* 锁冲突时的处理策略：no-wait直接回滚申请者；wait-die中较老的申请者等待、较年轻的回滚；
+ * wound-wait中较老的申请者令较年轻的持有者回滚（wound）后等待、较年轻的申请者等待 */
+enum class DeadlockPolicy { NO_WAIT, WAIT_DIE, WOUND_WAIT };
+
 class LockManager {
     /* 加锁类型，包括共享锁、排他锁、意向共享锁、意向排他锁、SIX（意向排他锁+共享锁） */
     enum class LockMode { SHARED, EXLUCSIVE, INTENTION_SHARED, INTENTION_EXCLUSIVE, S_IX };
@@ -26,9 +35,10 @@ class LockManager {
     /* 事务的加锁申请 */
     class LockRequest {
     public:
-        LockRequest(txn_id_t txn_id, LockMode lock_mode)
-            : txn_id_(txn_id), lock_mode_(lock_mode), granted_(false) {}
+        LockRequest(Transaction* txn, LockMode lock_mode)
+            : txn_(txn), txn_id_(txn->get_transaction_id()), lock_mode_(lock_mode), granted_(false) {}
 
+        Transaction* txn_;  // 申请加锁的事务，用于比较时间戳和wound
         txn_id_t txn_id_;   // 申请加锁的事务ID
         LockMode lock_mode_;    // 事务申请加锁的类型
         bool granted_;          // 该事务是否已经被赋予锁
@@ -40,16 +50,27 @@ class LockManager {
         std::list<LockRequest> request_queue_;  // 加锁队列
         std::condition_variable cv_;            // 条件变量，用于唤醒正在等待加锁的申请，在no-wait策略下无需使用
         GroupLockMode group_lock_mode_ = GroupLockMode::NON_LOCK;   // 加锁队列的锁模式
+        lsn_t release_lsn_ = INVALID_LSN;   // 提前释放该锁的事务的COMMIT日志号，持久化之前获得锁的事务不能确认提交
+    };
+
+    /* 表级意向锁的快速路径：没有事务持有或等待S/X/SIX锁时，IS/IX锁只增减计数，不进入锁表 */
+    struct FastPathSlot {
+        std::atomic<int> is_count_{0};      // 通过快速路径持有的IS锁数量
+        std::atomic<int> ix_count_{0};      // 通过快速路径持有的IX锁数量
+        std::atomic<int> strong_count_{0};  // 在锁表中持有或等待S/X/SIX锁的事务数，大于0时IS/IX锁走锁表
+        std::atomic<lsn_t> release_lsn_{INVALID_LSN};   // 提前释放快速路径锁的事务中最大的COMMIT日志号
     };
 
 public:
-    LockManager() {}
+    LockManager(DeadlockPolicy policy = DeadlockPolicy::NO_WAIT);
 
     ~LockManager() {}
 
-    bool lock_shared_on_record(Transaction* txn, const Rid& rid, int tab_fd);
+    bool lock_shared_on_record(Transaction* txn, const Rid& rid, int tab_fd,
+                               std::atomic<uint64_t>* lock_word = nullptr);
 
-    bool lock_exclusive_on_record(Transaction* txn, const Rid& rid, int tab_fd);
+    bool lock_exclusive_on_record(Transaction* txn, const Rid& rid, int tab_fd,
+                                  std::atomic<uint64_t>* lock_word = nullptr);
 
     bool lock_shared_on_table(Transaction* txn, int tab_fd);
 
@@ -59,9 +80,59 @@ public:
 
     bool lock_IX_on_table(Transaction* txn, int tab_fd);
 
-    bool unlock(Transaction* txn, LockDataId lock_data_id);
+    bool lock_shared_on_gap(Transaction* txn, const Rid& next_rid, int index_fd);
+
+    bool lock_IX_on_gap(Transaction* txn, const Rid& next_rid, int index_fd);
+
+    bool unlock(Transaction* txn, LockDataId lock_data_id, lsn_t commit_lsn = INVALID_LSN);
+
+    void unlock_record_word(Transaction* txn, const LockDataId& lock_data_id, std::atomic<uint64_t>* lock_word,
+                            lsn_t commit_lsn = INVALID_LSN);
+
+    void on_commit_durable(const LockDataId& lock_data_id, lsn_t commit_lsn);
+
+    /* 行锁字中只有持有者的事务ID，膨胀时通过resolver找到持有者的事务对象 */
+    void set_txn_resolver(std::function<Transaction*(txn_id_t)> resolver) { txn_resolver_ = std::move(resolver); }
+
+    /* 事务开始等待锁时在持有latch_的情况下调用，测试据此确认申请者已经进入等待 */
+    void set_wait_hook(std::function<void(txn_id_t)> hook) { wait_hook_ = std::move(hook); }
+
+    DeadlockPolicy get_policy() { return policy_; }
+
+    void set_policy(DeadlockPolicy policy) { policy_ = policy; }
 
 private:
+    bool lock(Transaction* txn, const LockDataId& lock_data_id, LockMode lock_mode,
+              std::atomic<uint64_t>* lock_word = nullptr);
+
+    bool lock_record_word(Transaction* txn, const LockDataId& lock_data_id, LockMode lock_mode,
+                          std::atomic<uint64_t>* lock_word);
+    bool inflate(const LockDataId& lock_data_id, uint64_t word, std::atomic<uint64_t>* lock_word);
+    bool is_live(uint64_t word) const;
+
+    bool lock_fast_path(Transaction* txn, int tab_fd, LockMode lock_mode);
+    bool unlock_fast_path(Transaction* txn, const LockDataId& lock_data_id, lsn_t commit_lsn);
+    FastPathSlot* fast_path_slot(const LockDataId& lock_data_id);
+    void release_fast_count(std::atomic<int>& count, const LockDataId& lock_data_id);
+
+    bool should_wait(Transaction* txn, const std::vector<Transaction*>& holders);
+    void wound(Transaction* victim);
+
+    static bool older(Transaction* a, Transaction* b);
+
+    static bool is_strong(LockMode mode);
+    static bool fast_path_conflict(const FastPathSlot& slot, LockMode requested);
+    static bool compatible(LockMode held, LockMode requested);
+    static bool covers(LockMode held, LockMode requested);
+    static LockMode combine(LockMode held, LockMode requested);
+    static GroupLockMode group_mode(const LockRequestQueue& queue);
+
     std::mutex latch_;      // 用于锁表的并发
     std::unordered_map<LockDataId, LockRequestQueue> lock_table_;   // 全局锁表
+    std::unordered_map<txn_id_t, LockDataId> waiting_;  // 正在等待的事务及其等待的数据项，wound时用于唤醒
+    std::unique_ptr<FastPathSlot[]> fast_path_;     // 以表的fd为下标的快速路径计数
+    uint64_t epoch_;        // 行锁字的纪元，每次启动随机生成，纪元不同的锁字是上次运行遗留在页面中的，视为空闲
+    std::function<Transaction*(txn_id_t)> txn_resolver_;
+    std::function<void(txn_id_t)> wait_hook_;
+    std::atomic<DeadlockPolicy> policy_;    // 锁冲突的处理策略
 };
@@ -15,7 +15,10 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <thread>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "txn_defs.h"
 
@@ -23,7 +26,7 @@ class Transaction {
    public:
     explicit Transaction(txn_id_t txn_id, IsolationLevel isolation_level = IsolationLevel::SERIALIZABLE)
         : state_(TransactionState::DEFAULT), isolation_level_(isolation_level), txn_id_(txn_id) {
-        write_set_ = std::make_shared<std::deque<WriteRecord *>>();
+        // 写集合在第一次写操作时才分配，只读事务不需要
         lock_set_ = std::make_shared<std::unordered_set<LockDataId>>();
         index_latch_page_set_ = std::make_shared<std::deque<Page *>>();
         index_deleted_page_set_ = std::make_shared<std::deque<Page*>>();
@@ -51,8 +54,32 @@ class Transaction {
     inline lsn_t get_prev_lsn() { return prev_lsn_; }
     inline void set_prev_lsn(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
-    inline std::shared_ptr<std::deque<WriteRecord *>> get_write_set() { return write_set_; }  
-    inline void append_write_record(WriteRecord* write_record) { write_set_->push_back(write_record); }
+    inline void set_wounded(bool wounded) { wounded_ = wounded; }
+    inline bool is_wounded() { return wounded_; }
+
+    inline lsn_t get_commit_dep_lsn() { return commit_dep_lsn_; }
+    inline void set_commit_dep_lsn(lsn_t commit_dep_lsn) { commit_dep_lsn_ = commit_dep_lsn; }
+
+    inline void set_read_only(bool read_only) { read_only_ = read_only; }
+    inline bool is_read_only() { return read_only_; }
+
+    inline void set_async_commit(bool async_commit) { async_commit_ = async_commit; }
+    inline bool is_async_commit() { return async_commit_; }
+
+    /* 没有执行过写操作的事务是只读事务，提交时不需要写日志和刷盘 */
+    inline bool has_writes() { return write_set_ != nullptr && !write_set_->empty(); }
+
+    /* 写过日志的事务需要写COMMIT或ABORT日志结束，写集合可能为空，例如只做了TRUNCATE、VACUUM或者语句已经回滚 */
+    inline bool has_logs() { return prev_lsn_ != INVALID_LSN; }
+
+    // 没有写操作时返回空指针
+    inline std::shared_ptr<std::deque<WriteRecord *>> get_write_set() { return write_set_; }
+    inline void append_write_record(WriteRecord* write_record) {
+        if (write_set_ == nullptr) {
+            write_set_ = std::make_shared<std::deque<WriteRecord *>>();
+        }
+        write_set_->push_back(write_record);
+    }
 
     inline std::shared_ptr<std::deque<Page*>> get_index_deleted_page_set() { return index_deleted_page_set_; }
     inline void append_index_deleted_page(Page* page) { index_deleted_page_set_->push_back(page); }
@@ -62,17 +89,44 @@ class Transaction {
 
     inline std::shared_ptr<std::unordered_set<LockDataId>> get_lock_set() { return lock_set_; }
 
+    inline std::unordered_map<int, bool> &get_fast_path_locks() { return fast_path_locks_; }
+
+    inline std::vector<LockDataId> &get_word_locks() { return word_locks_; }
+
+    /* 语句开始时记录写集合和行锁字的位置，语句失败时只撤销之后的写操作并释放之后申请的锁 */
+    inline void begin_statement() {
+        stmt_write_mark_ = write_count();
+        stmt_word_lock_mark_ = word_locks_.size();
+        stmt_locks_.clear();
+    }
+    inline size_t write_count() { return write_set_ == nullptr ? 0 : write_set_->size(); }
+    inline size_t get_stmt_write_mark() { return stmt_write_mark_; }
+    inline size_t get_stmt_word_lock_mark() { return stmt_word_lock_mark_; }
+    inline std::vector<LockDataId> &get_stmt_locks() { return stmt_locks_; }
+
+    inline std::vector<std::pair<std::string, size_t>> &get_savepoints() { return savepoints_; }
+
    private:
     bool txn_mode_;                   // 用于标识当前事务为显式事务还是单条SQL语句的隐式事务
+    bool read_only_ = false;          // 事务是否声明为只读
+    bool async_commit_ = false;       // 提交时不等待COMMIT日志写盘，由后台线程在log_timeout内写盘
     TransactionState state_;          // 事务状态
     IsolationLevel isolation_level_;  // 事务的隔离级别，默认隔离级别为可串行化
     std::thread::id thread_id_;       // 当前事务对应的线程id
     lsn_t prev_lsn_;                  // 当前事务执行的最后一条操作对应的lsn，用于系统故障恢复
+    std::atomic<bool> wounded_{false};  // 在wound-wait策略下被较老的事务要求回滚，由锁管理器读写
+    lsn_t commit_dep_lsn_ = INVALID_LSN;  // 事务获得的锁由提前释放锁的事务转交时，这些事务中最大的COMMIT日志号
     txn_id_t txn_id_;                 // 事务的ID，唯一标识符
     timestamp_t start_ts_;            // 事务的开始时间戳
 
     std::shared_ptr<std::deque<WriteRecord *>> write_set_;  // 事务包含的所有写操作
     std::shared_ptr<std::unordered_set<LockDataId>> lock_set_;  // 事务申请的所有锁
+    std::vector<LockDataId> word_locks_;    // 通过页面中的行锁字申请的行锁，释放时需要找到对应的锁字
+    std::vector<LockDataId> stmt_locks_;    // 当前语句新申请的锁表中的锁（包括快速路径上的意向锁）
+    size_t stmt_write_mark_ = 0;            // 当前语句开始时写集合的大小
+    size_t stmt_word_lock_mark_ = 0;        // 当前语句开始时word_locks_的大小
+    std::vector<std::pair<std::string, size_t>> savepoints_;   // 按创建顺序排列的保存点名称和创建时写集合的大小
+    std::unordered_map<int, bool> fast_path_locks_;  // 通过快速路径持有意向锁的表的fd -> 是否为意向写锁，这些锁同样在lock_set_中
     std::shared_ptr<std::deque<Page*>> index_latch_page_set_;          // 维护事务执行过程中加锁的索引页面
     std::shared_ptr<std::deque<Page*>> index_deleted_page_set_;    // 维护事务执行过程中删除的索引页面
 };
@@ -9,8 +9,12 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "transaction_manager.h"
+
+#include <algorithm>
+
 #include "record/rm_file_handle.h"
 #include "system/sm_manager.h"
+#include "common/context.h"
 
 std::unordered_map<txn_id_t, Transaction *> TransactionManager::txn_map = {};
 
@@ -21,13 +25,32 @@ std::unordered_map<txn_id_t, Transaction *> TransactionManager::txn_map = {};
  * @param {LogManager*} log_manager 日志管理器指针
  */
 Transaction * TransactionManager::begin(Transaction* txn, LogManager* log_manager) {
-    // Todo:
-    // 1. 判断传入事务参数是否为空指针
-    // 2. 如果为空指针，创建新事务
-    // 3. 把开始事务加入到全局事务表中
-    // 4. 返回当前事务指针
-    
-    return nullptr;
+    // BEGIN日志推迟到事务的第一条日志之前写入，见LogManager::add_txn_log
+    if (txn == nullptr) {
+        txn = new Transaction(next_txn_id_++);
+        txn->set_start_ts(next_timestamp_++);
+    }
+    txn->set_state(TransactionState::GROWING);
+
+    std::unique_lock<std::mutex> lock(latch_);
+    txn_map[txn->get_transaction_id()] = txn;
+    return txn;
+}
+
+/**
+ * @description: 为恢复时发现的未完成事务重新建立事务对象，沿用日志中的事务ID，之后分配的事务ID大于它
+ * @return {Transaction*} 恢复出的事务
+ * @param {txn_id_t} txn_id 日志中的事务ID
+ */
+Transaction* TransactionManager::resume(txn_id_t txn_id) {
+    advance_txn_id(txn_id);
+    auto txn = new Transaction(txn_id);
+    txn->set_start_ts(next_timestamp_++);
+    txn->set_state(TransactionState::GROWING);
+
+    std::unique_lock<std::mutex> lock(latch_);
+    txn_map[txn_id] = txn;
+    return txn;
 }
 
 /**
@@ -36,13 +59,34 @@ Transaction * TransactionManager::begin(Transaction* txn, LogManager* log_manage
  * @param {LogManager*} log_manager 日志管理器指针
  */
 void TransactionManager::commit(Transaction* txn, LogManager* log_manager) {
-    // Todo:
-    // 1. 如果存在未提交的写操作，提交所有的写操作
-    // 2. 释放所有锁
-    // 3. 释放事务相关资源，eg.锁集
-    // 4. 把事务日志刷入磁盘中
-    // 5. 更新事务状态
-
+    if (txn->has_logs() && txn->is_async_commit()) {
+        // 异步提交：COMMIT日志进入缓冲区即返回，由后台线程写盘，故障时可能丢失最近log_timeout内提交的事务
+        // 日志按顺序写盘，之后获得这些锁的写事务提交时会连同本事务的COMMIT日志一起写盘，因此不转交COMMIT日志号
+        CommitLogRecord commit_log(txn->get_transaction_id());
+        log_manager->add_txn_log(txn, &commit_log);
+        release_locks(txn, INVALID_LSN);
+    } else if (txn->has_logs()) {
+        // COMMIT日志进入缓冲区后事务的结果已经确定，在等待刷盘之前提前释放锁，热点数据上的下一个事务不必等待本次写盘
+        // 获得这些锁的事务在本事务的COMMIT日志持久化之前不能确认提交
+        CommitLogRecord commit_log(txn->get_transaction_id());
+        lsn_t commit_lsn = log_manager->add_txn_log(txn, &commit_log);
+        std::vector<LockDataId> lock_ids(txn->get_lock_set()->begin(), txn->get_lock_set()->end());
+        lock_ids.insert(lock_ids.end(), txn->get_word_locks().begin(), txn->get_word_locks().end());
+        release_locks(txn, commit_lsn);
+        log_manager->flush_log_to_disk(commit_lsn);
+        for (auto &lock_data_id : lock_ids) {
+            lock_manager_->on_commit_durable(lock_data_id, commit_lsn);
+        }
+    } else {
+        // 没有写操作的事务跳过COMMIT日志和刷盘，只需等待它所依赖的提前释放锁的事务持久化
+        release_locks(txn, INVALID_LSN);
+        if (txn->get_commit_dep_lsn() != INVALID_LSN) {
+            log_manager->flush_log_to_disk(txn->get_commit_dep_lsn());
+        }
+    }
+    clear_write_set(txn);
+    txn->set_state(TransactionState::COMMITTED);
+    metrics_.committed++;
 }
 
 /**
@@ -51,11 +95,241 @@ void TransactionManager::commit(Transaction* txn, LogManager* log_manager) {
  * @param {LogManager} *log_manager 日志管理器指针
  */
 void TransactionManager::abort(Transaction * txn, LogManager *log_manager) {
-    // Todo:
-    // 1. 回滚所有写操作
-    // 2. 释放所有锁
-    // 3. 清空事务相关资源，eg.锁集
-    // 4. 把事务日志刷入磁盘中
-    // 5. 更新事务状态
-    
-}
\ No newline at end of file
+    if (txn->has_logs()) {
+        rollback_writes(txn, 0, log_manager);
+
+        AbortLogRecord abort_log(txn->get_transaction_id());
+        log_manager->add_txn_log(txn, &abort_log);
+        log_manager->flush_log_to_disk();
+    }
+    release_locks(txn, INVALID_LSN);
+    clear_write_set(txn);
+    txn->set_state(TransactionState::ABORTED);
+    metrics_.aborted++;
+}
+
+/**
+ * @description: 撤销事务当前语句的写操作，释放该语句新申请的锁，事务中之前的语句不受影响
+ * 失败语句的读结果没有返回给客户端，它新申请的锁保护的数据没有被事务中的其他语句访问过，提前释放不影响可串行化
+ * @param {Transaction*} txn 执行失败的语句所在的事务
+ * @param {LogManager*} log_manager 日志管理器指针
+ */
+void TransactionManager::rollback_statement(Transaction* txn, LogManager* log_manager) {
+    if (txn->get_state() == TransactionState::COMMITTED || txn->get_state() == TransactionState::ABORTED) {
+        return;
+    }
+    rollback_writes(txn, txn->get_stmt_write_mark(), log_manager);
+
+    // 释放这些锁不代表事务进入收缩阶段
+    TransactionState state = txn->get_state();
+    for (auto &lock_data_id : txn->get_stmt_locks()) {
+        lock_manager_->unlock(txn, lock_data_id);
+        txn->get_lock_set()->erase(lock_data_id);
+    }
+    auto &word_locks = txn->get_word_locks();
+    auto bpm = sm_manager_->get_bpm();
+    for (size_t i = txn->get_stmt_word_lock_mark(); i < word_locks.size(); i++) {
+        Page *page = bpm->fetch_page(PageId{word_locks[i].fd_, word_locks[i].rid_.page_no});
+        if (page == nullptr) {
+            lock_manager_->unlock(txn, word_locks[i]);
+            continue;
+        }
+        lock_manager_->unlock_record_word(txn, word_locks[i], rm_lock_word(page, word_locks[i].rid_.slot_no));
+        bpm->unpin_page(page->get_page_id(), true);
+    }
+    word_locks.erase(word_locks.begin() + txn->get_stmt_word_lock_mark(), word_locks.end());
+    txn->set_state(state);
+    txn->begin_statement();
+}
+
+/**
+ * @description: 在事务中创建保存点，同名的保存点被新的保存点替换
+ * @param {Transaction*} txn 当前事务
+ * @param {string&} name 保存点名称
+ */
+void TransactionManager::savepoint(Transaction* txn, const std::string& name) {
+    auto &savepoints = txn->get_savepoints();
+    auto it = std::find_if(savepoints.begin(), savepoints.end(), [&](auto &sp) { return sp.first == name; });
+    if (it != savepoints.end()) {
+        savepoints.erase(it);
+    }
+    savepoints.emplace_back(name, txn->write_count());
+}
+
+/**
+ * @description: 回滚到保存点，撤销保存点之后的写操作，保存点本身保留，之后创建的保存点被删除
+ * 保存点之后的语句可能已经把读到的数据返回给客户端，它们申请的锁保留到事务结束
+ * @param {Transaction*} txn 当前事务
+ * @param {string&} name 保存点名称
+ * @param {LogManager*} log_manager 日志管理器指针
+ */
+void TransactionManager::rollback_to_savepoint(Transaction* txn, const std::string& name, LogManager* log_manager) {
+    auto &savepoints = txn->get_savepoints();
+    auto it = std::find_if(savepoints.rbegin(), savepoints.rend(), [&](auto &sp) { return sp.first == name; });
+    if (it == savepoints.rend()) {
+        throw SavepointNotFoundError(name);
+    }
+    rollback_writes(txn, it->second, log_manager);
+    savepoints.erase(it.base(), savepoints.end());
+}
+
+/**
+ * @description: 删除保存点以及之后创建的保存点，不撤销任何写操作
+ * @param {Transaction*} txn 当前事务
+ * @param {string&} name 保存点名称
+ */
+void TransactionManager::release_savepoint(Transaction* txn, const std::string& name) {
+    auto &savepoints = txn->get_savepoints();
+    auto it = std::find_if(savepoints.rbegin(), savepoints.rend(), [&](auto &sp) { return sp.first == name; });
+    if (it == savepoints.rend()) {
+        throw SavepointNotFoundError(name);
+    }
+    savepoints.erase(std::prev(it.base()), savepoints.end());
+}
+
+/**
+ * @description: 按相反的顺序撤销写集合中从from开始的写操作并删除这些写操作记录，撤销期间仍持有写操作涉及的锁
+ * @param {Transaction*} txn 要撤销写操作的事务
+ * @param {size_t} from 第一条要撤销的写操作在写集合中的位置
+ * @param {LogManager*} log_manager 日志管理器指针
+ */
+void TransactionManager::rollback_writes(Transaction* txn, size_t from, LogManager* log_manager) {
+    auto write_set = txn->get_write_set();
+    if (write_set == nullptr || write_set->size() <= from) {
+        return;
+    }
+    std::shared_lock<std::shared_mutex> meta_lock(sm_manager_->meta_latch_);
+    Context context(lock_manager_, log_manager, nullptr);
+    while (write_set->size() > from) {
+        rollback_write(txn, write_set->back(), &context);
+        delete write_set->back();
+        write_set->pop_back();
+    }
+}
+
+/* 由记录生成索引键 */
+static std::vector<char> make_index_key(const IndexMeta &index, const char *rec) {
+    std::vector<char> key(index.col_tot_len);
+    int offset = 0;
+    for (auto &col : index.cols) {
+        memcpy(key.data() + offset, rec + col.offset, col.len);
+        offset += col.len;
+    }
+    return key;
+}
+
+/**
+ * @description: 撤销一条写操作，恢复数据文件中的记录和索引项
+ * 物化视图的修改有自己的写操作记录，不需要重新维护视图
+ * 撤销操作作为反向的修改写入事务的日志，重做时与原操作一起重做，故障后恢复出的未完成事务连同反向修改一起撤销
+ * 与正常的修改相同，在固定数据页面期间写日志，修改索引在写日志之后
+ * @param {Transaction*} txn 写操作所属的事务
+ * @param {WriteRecord*} write_rec 要撤销的写操作
+ * @param {Context*} context 不带事务的上下文，撤销操作本身不再产生写操作记录
+ */
+void TransactionManager::rollback_write(Transaction* txn, WriteRecord* write_rec, Context* context) {
+    auto &file = write_rec->GetTableName();
+    auto &rid = write_rec->GetRid();
+    auto fh = sm_manager_->get_file_handle(file);
+    auto &indexes = sm_manager_->db_.get_table(file_tab_name(file)).indexes;
+    auto get_ih = [&](const IndexMeta &index) {
+        return sm_manager_->get_index_handle(file, index.cols);
+    };
+    switch (write_rec->GetWriteType()) {
+        case WType::INSERT_TUPLE: {
+            auto rec = fh->get_record(rid, context);
+            Page *page = fh->pin_page(rid.page_no);
+            fh->delete_record(rid, context);
+            WriteRecord undo_rec(WType::DELETE_TUPLE, file, rid, *rec);
+            context->log_mgr_->add_write_log(txn, &undo_rec, nullptr, fh);
+            fh->unpin_page(page);
+            for (auto &index : indexes) {
+                get_ih(index)->delete_entry(make_index_key(index, rec->data).data(), nullptr);
+            }
+            sm_manager_->record_index_change(file, rec->data, rid, false);
+            break;
+        }
+        case WType::DELETE_TUPLE: {
+            auto &rec = write_rec->GetRecord();
+            Page *page = fh->pin_page(rid.page_no);
+            fh->insert_record(rid, rec.data);
+            WriteRecord undo_rec(WType::INSERT_TUPLE, file, rid);
+            context->log_mgr_->add_write_log(txn, &undo_rec, rec.data, fh);
+            fh->unpin_page(page);
+            for (auto &index : indexes) {
+                get_ih(index)->insert_entry(make_index_key(index, rec.data).data(), rid, nullptr);
+            }
+            sm_manager_->record_index_change(file, rec.data, rid, true);
+            break;
+        }
+        case WType::UPDATE_TUPLE: {
+            auto cur = fh->get_record(rid, context);
+            auto &old_rec = write_rec->GetRecord();
+            Page *page = fh->pin_page(rid.page_no);
+            fh->update_record(rid, old_rec.data, context);
+            WriteRecord undo_rec(WType::UPDATE_TUPLE, file, rid, *cur);
+            context->log_mgr_->add_write_log(txn, &undo_rec, old_rec.data, fh);
+            fh->unpin_page(page);
+            for (auto &index : indexes) {
+                auto cur_key = make_index_key(index, cur->data);
+                auto old_key = make_index_key(index, old_rec.data);
+                if (cur_key != old_key) {
+                    get_ih(index)->delete_entry(cur_key.data(), nullptr);
+                    get_ih(index)->insert_entry(old_key.data(), rid, nullptr);
+                }
+            }
+            sm_manager_->record_index_change(file, cur->data, rid, false);
+            sm_manager_->record_index_change(file, old_rec.data, rid, true);
+            break;
+        }
+    }
+}
+
+/**
+ * @description: 释放事务持有的所有锁
+ * @param {Transaction*} txn 已经结束的事务
+ * @param {lsn_t} commit_lsn 提交时提前释放锁传入COMMIT日志号，否则为INVALID_LSN
+ */
+void TransactionManager::release_locks(Transaction* txn, lsn_t commit_lsn) {
+    auto lock_set = txn->get_lock_set();
+    for (auto &lock_data_id : *lock_set) {
+        lock_manager_->unlock(txn, lock_data_id, commit_lsn);
+    }
+    lock_set->clear();
+    // 行锁字位于数据页中，释放时重新固定页面
+    auto bpm = sm_manager_->get_bpm();
+    for (auto &lock_data_id : txn->get_word_locks()) {
+        Page *page = bpm->fetch_page(PageId{lock_data_id.fd_, lock_data_id.rid_.page_no});
+        if (page == nullptr) {
+            // 页面已经随表文件截断或删除，锁字不复存在，只需释放可能已经膨胀到锁表中的锁
+            lock_manager_->unlock(txn, lock_data_id, commit_lsn);
+            continue;
+        }
+        auto lock_word = rm_lock_word(page, lock_data_id.rid_.slot_no);
+        lock_manager_->unlock_record_word(txn, lock_data_id, lock_word, commit_lsn);
+        bpm->unpin_page(page->get_page_id(), true);
+    }
+    txn->get_word_locks().clear();
+}
+
+/* 释放事务的写操作记录 */
+void TransactionManager::clear_write_set(Transaction* txn) {
+    auto write_set = txn->get_write_set();
+    if (write_set != nullptr) {
+        for (auto *write_record : *write_set) {
+            delete write_record;
+        }
+        write_set->clear();
+    }
+}
+
+/**
+ * @description: 从全局事务表中删除已经结束的事务并释放事务对象
+ * @param {Transaction*} txn 已经提交或回滚的事务
+ */
+void TransactionManager::release(Transaction* txn) {
+    std::unique_lock<std::mutex> lock(latch_);
+    txn_map.erase(txn->get_transaction_id());
+    lock.unlock();
+    delete txn;
+}
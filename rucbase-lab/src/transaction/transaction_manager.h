@@ -21,6 +21,14 @@ See the Mulan PSL v2 for more details. */
 /* 系统采用的并发控制算法，当前题目中要求两阶段封锁并发控制算法 */
 enum class ConcurrencyMode { TWO_PHASE_LOCKING = 0, BASIC_TO };
 
+/* 事务的运行统计，由SHOW METRICS输出 */
+struct TxnMetrics {
+    std::atomic<uint64_t> committed{0};         // 提交的事务数
+    std::atomic<uint64_t> aborted{0};           // 回滚的事务数
+    std::atomic<uint64_t> retried{0};           // 服务器自动重试隐式事务的次数
+    std::atomic<uint64_t> retry_exhausted{0};   // 重试次数用尽后把abort返回给客户端的语句数
+};
+
 class TransactionManager{
 public:
     explicit TransactionManager(LockManager *lock_manager, SmManager *sm_manager,
@@ -28,22 +36,48 @@ public:
         sm_manager_ = sm_manager;
         lock_manager_ = lock_manager;
         concurrency_mode_ = concurrency_mode;
+        lock_manager_->set_txn_resolver([this](txn_id_t txn_id) -> Transaction* {
+            std::unique_lock<std::mutex> lock(latch_);
+            auto it = txn_map.find(txn_id);
+            return it == txn_map.end() ? nullptr : it->second;
+        });
     }
     
     ~TransactionManager() = default;
 
     Transaction* begin(Transaction* txn, LogManager* log_manager);
 
+    Transaction* resume(txn_id_t txn_id);
+
+    /* 事务ID不持久化，重启后从日志中出现过的最大事务ID之后继续分配，避免与日志中的事务混淆 */
+    void advance_txn_id(txn_id_t txn_id) {
+        txn_id_t next = next_txn_id_.load();
+        while (next <= txn_id && !next_txn_id_.compare_exchange_weak(next, txn_id + 1)) {
+        }
+    }
+
     void commit(Transaction* txn, LogManager* log_manager);
 
     void abort(Transaction* txn, LogManager* log_manager);
 
+    void release(Transaction* txn);
+
+    void rollback_statement(Transaction* txn, LogManager* log_manager);
+
+    void savepoint(Transaction* txn, const std::string& name);
+
+    void rollback_to_savepoint(Transaction* txn, const std::string& name, LogManager* log_manager);
+
+    void release_savepoint(Transaction* txn, const std::string& name);
+
     ConcurrencyMode get_concurrency_mode() { return concurrency_mode_; }
 
     void set_concurrency_mode(ConcurrencyMode concurrency_mode) { concurrency_mode_ = concurrency_mode; }
 
     LockManager* get_lock_manager() { return lock_manager_; }
 
+    TxnMetrics& get_metrics() { return metrics_; }
+
     /**
      * @description: 获取事务ID为txn_id的事务对象
      * @return {Transaction*} 事务对象的指针
@@ -65,10 +99,19 @@ public:
     static std::unordered_map<txn_id_t, Transaction *> txn_map;     // 全局事务表，存放事务ID与事务对象的映射关系
 
 private:
+    void rollback_writes(Transaction* txn, size_t from, LogManager* log_manager);
+
+    void rollback_write(Transaction* txn, WriteRecord* write_rec, Context* context);
+
+    void release_locks(Transaction* txn, lsn_t commit_lsn);
+
+    void clear_write_set(Transaction* txn);
+
     ConcurrencyMode concurrency_mode_;      // 事务使用的并发控制算法，目前只需要考虑2PL
     std::atomic<txn_id_t> next_txn_id_{0};  // 用于分发事务ID
     std::atomic<timestamp_t> next_timestamp_{0};    // 用于分发事务时间戳
     std::mutex latch_;  // 用于txn_map的并发
     SmManager *sm_manager_;
     LockManager *lock_manager_;
+    TxnMetrics metrics_;
 };
\ No newline at end of file
@@ -60,13 +60,13 @@ class WriteRecord {
 
    private:
     WType wtype_;
-    std::string tab_name_;
+    std::string tab_name_;  // 记录所在的数据文件名，非分区表即表名，分区表为分区的数据文件名
     Rid rid_;
     RmRecord record_;
 };
 
-/* 多粒度锁，加锁对象的类型，包括记录和表 */
-enum class LockDataType { TABLE = 0, RECORD = 1 };
+/* 多粒度锁，加锁对象的类型，包括记录、表和索引中的间隙 */
+enum class LockDataType { TABLE = 0, RECORD = 1, GAP = 2 };
 
 /**
  * @description: 加锁对象的唯一标识
@@ -82,9 +82,9 @@ class LockDataId {
         rid_.slot_no = -1;
     }
 
-    /* 行级锁 */
+    /* 行级锁，或索引中的间隙锁：fd为索引文件，rid为间隙之后的索引项指向的记录，{-1, -1}表示最后一个索引项之后的间隙 */
     LockDataId(int fd, const Rid &rid, LockDataType type) {
-        assert(type == LockDataType::RECORD);
+        assert(type == LockDataType::RECORD || type == LockDataType::GAP);
         fd_ = fd;
         rid_ = rid;
         type_ = type;
@@ -95,8 +95,8 @@ class LockDataId {
             // fd_
             return static_cast<int64_t>(fd_);
         } else {
-            // fd_, rid_.page_no, rid.slot_no
-            return ((static_cast<int64_t>(type_)) << 63) | ((static_cast<int64_t>(fd_)) << 31) |
+            // type_, fd_, rid_.page_no, rid.slot_no
+            return ((static_cast<int64_t>(type_)) << 62) | ((static_cast<int64_t>(fd_)) << 31) |
                    ((static_cast<int64_t>(rid_.page_no)) << 16) | rid_.slot_no;
         }
     }